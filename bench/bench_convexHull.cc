@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+// bench_convexHull
+//
+// Time convexHull_2d and convexHull_3d over point count and distribution in
+// the unit box.  The hulls are cheap next to a tessellation, so they are worth
+// running at larger counts than the bench target uses, say
+//      bench_convexHull --n 1e5,1e6,1e7
+// The "cells" we report are the facets of the hull, and the boundary option
+// has no meaning here.  The --tessellators option picks the hulls by name.
+//------------------------------------------------------------------------------
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include "polytope.hh"
+#include "polytope_bench_utilities.hh"
+
+using namespace std;
+using namespace polytope;
+using namespace polytope::bench;
+
+namespace {
+
+// The resolution we hand the hulls, as the tessellators do.
+const double dx = 1.0e-10;
+
+//------------------------------------------------------------------------------
+// Run one hull over every distribution and count.
+//------------------------------------------------------------------------------
+template<int Dimension>
+void
+runHull(const string& hname,
+        PLC<Dimension, double> (*hull)(const vector<double>&, const double*, const double&),
+        const BenchOptions& opts,
+        BenchReport& report) {
+  if (not opts.wantTessellator(hname)) return;
+  double low[Dimension], high[Dimension];
+  for (unsigned j = 0; j != Dimension; ++j) {
+    low[j] = 0.0;
+    high[j] = 1.0;
+  }
+  for (unsigned id = 0; id != opts.distributions.size(); ++id) {
+    const string& dname = opts.distributions[id];
+    for (unsigned in = 0; in != opts.n.size(); ++in) {
+      vector<double> points;
+      generatePoints<Dimension>(dname, opts.n[in], low, high, InsideBox<Dimension>(low, high), opts.seed, points);
+      BenchRecord record;
+      record.param("hull", hname);
+      record.param("distribution", dname);
+      record.n = opts.n[in];
+      record.generators = points.size()/Dimension;
+      runCase(record, opts.reps, [&]() {
+          const PLC<Dimension, double> plc = hull(points, low, dx);
+          return unsigned(plc.facets.size());
+        });
+      report.add(record);
+    }
+  }
+}
+
+}
+
+// -----------------------------------------------------------------------
+// main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+#ifdef HAVE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  const BenchOptions opts = parseOptions("convexHull", argc, argv);
+  enableTimers(opts.stages);
+
+  BenchReport report("convexHull", opts.output, 1);
+  runHull<2>("convexHull_2d", &convexHull_2d<double>, opts, report);
+  runHull<3>("convexHull_3d", &convexHull_3d<double>, opts, report);
+
+#ifdef HAVE_MPI
+  MPI_Finalize();
+#endif
+  return 0;
+}
@@ -0,0 +1,150 @@
+//------------------------------------------------------------------------------
+// bench_distributed
+//
+// Time the DistributedTessellator in 2D over generator count, distribution
+// and boundary.  Every rank generates the same global set of points and
+// keeps one slab of them in x, so each domain has at most two neighbors
+// and a known share of the work.  The "curve" partition then repartitions
+// the slabs along a Hilbert curve, balancing the estimated cell costs, and
+// its time includes the repartitioning.  The reported time is the slowest
+// rank's.
+// Meant to be run under mpirun on a single node, see bench/CMakeLists.txt.
+//------------------------------------------------------------------------------
+#include <iostream>
+#include <vector>
+#include <string>
+#include <numeric>
+#include <algorithm>
+
+#include "polytope.hh"
+#include "polytope_bench_utilities.hh"
+#include "Boundary2D.hh"
+#include "repartitionGenerators.hh"
+
+#include "mpi.h"
+
+using namespace std;
+using namespace polytope;
+using namespace polytope::bench;
+
+namespace {
+
+//------------------------------------------------------------------------------
+// Wrap Boundary2D::testInside for generatePoints.
+//------------------------------------------------------------------------------
+struct InsideBoundary {
+  Boundary2D<double>* boundary;
+  explicit InsideBoundary(Boundary2D<double>& b): boundary(&b) {}
+  bool operator()(const double* p) const {
+    double pos[2] = {p[0], p[1]};
+    return boundary->testInside(pos);
+  }
+};
+
+int boundaryType(const string& name) {
+  if (name == "box")   return Boundary2D<double>::square;
+  if (name == "star")  return Boundary2D<double>::funkystar;
+  if (name == "holes") return Boundary2D<double>::mwithholes;
+  cerr << "Unknown boundary " << name << endl;
+  exit(1);
+}
+
+//------------------------------------------------------------------------------
+// Our slab of the global points: sort them by x and take the rank'th of
+// numProcs equal pieces.
+//------------------------------------------------------------------------------
+void slab(const vector<double>& points,
+          const int rank,
+          const int numProcs,
+          vector<double>& myPoints) {
+  const unsigned n = points.size()/2;
+  vector<unsigned> order(n);
+  iota(order.begin(), order.end(), 0U);
+  stable_sort(order.begin(), order.end(),
+              [&](const unsigned a, const unsigned b) { return points[2*a] < points[2*b]; });
+  const unsigned i0 = (uint64_t(n)*rank)/numProcs, i1 = (uint64_t(n)*(rank + 1))/numProcs;
+  myPoints.clear();
+  for (unsigned i = i0; i != i1; ++i) {
+    myPoints.push_back(points[2*order[i]]);
+    myPoints.push_back(points[2*order[i] + 1]);
+  }
+}
+
+}
+
+// -----------------------------------------------------------------------
+// main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+  MPI_Init(&argc, &argv);
+  int rank, numProcs;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+
+  const BenchOptions opts = parseOptions("distributed", argc, argv);
+  enableTimers(opts.stages);
+
+  // The serial tessellators we have, each wrapped in a DistributedTessellator.
+  vector<pair<string, Tessellator<2, double>*> > tessellators;
+#ifdef HAVE_BOOST_VORONOI
+  tessellators.push_back(make_pair(string("Boost"),
+                                   new DistributedTessellator<2, double>(new BoostTessellator<double>(), true, true)));
+#endif
+#ifdef HAVE_TRIANGLE
+  tessellators.push_back(make_pair(string("Triangle"),
+                                   new DistributedTessellator<2, double>(new TriangleTessellator<double>(), true, true)));
+#endif
+
+  BenchReport report("distributed", opts.output, numProcs);
+  for (unsigned ib = 0; ib != opts.boundaries.size(); ++ib) {
+    const string& bname = opts.boundaries[ib];
+    Boundary2D<double> boundary;
+    boundary.setDefaultBoundary(boundaryType(bname));
+    for (unsigned id = 0; id != opts.distributions.size(); ++id) {
+      const string& dname = opts.distributions[id];
+      for (unsigned in = 0; in != opts.n.size(); ++in) {
+        vector<double> points, myPoints;
+        generatePoints<2>(dname, opts.n[in], boundary.mLow, boundary.mHigh,
+                          InsideBoundary(boundary), opts.seed, points);
+        slab(points, rank, numProcs, myPoints);
+        for (unsigned it = 0; it != tessellators.size(); ++it) {
+          const string& tname = tessellators[it].first;
+          const Tessellator<2, double>& tessellator = *tessellators[it].second;
+          if (not opts.wantTessellator(tname)) continue;
+
+          const char* partitions[2] = {"slab", "curve"};
+          for (unsigned ip = 0; ip != 2; ++ip) {
+            const string partition = partitions[ip];
+            BenchRecord record;
+            record.param("tessellator", tname);
+            record.param("distribution", dname);
+            record.param("boundary", bname);
+            record.param("partition", partition);
+            record.n = opts.n[in];
+            record.generators = points.size()/2;
+            runDistributedCase(record, opts.reps, [&]() {
+                vector<double> generators = myPoints;
+                if (partition == "curve") {
+                  vector<pair<unsigned, unsigned> > origin;
+                  repartitionGenerators<2, double>(generators, vector<double>(), origin, HilbertSort, MPI_COMM_WORLD);
+                }
+                Tessellation<2, double> mesh;
+                if (bname == "box") {
+                  tessellator.tessellate(generators, boundary.mLow, boundary.mHigh, mesh);
+                } else {
+                  tessellator.tessellate(generators, boundary.mPLCpoints, boundary.mPLC, mesh);
+                }
+                return unsigned(mesh.cells.size());
+              }, MPI_COMM_WORLD);
+            if (rank == 0) report.add(record);
+          }
+        }
+      }
+    }
+  }
+
+  for (unsigned it = 0; it != tessellators.size(); ++it) delete tessellators[it].second;
+
+  MPI_Finalize();
+  return 0;
+}
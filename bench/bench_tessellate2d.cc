@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+// bench_tessellate2d
+//
+// Time the serial 2D tessellators over generator count, distribution and
+// boundary.  The box boundary uses the bounding box tessellate, while star
+// (Boundary2D funkystar) and holes (mwithholes) tessellate against the PLC,
+// which for the Boost tessellator is the clipQuantizedTessellation path.
+// BoostHilbert is the Boost tessellator with its generators Hilbert sorted
+// first.  VoroPP_2d only handles boxes.
+//------------------------------------------------------------------------------
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include "polytope.hh"
+#include "polytope_bench_utilities.hh"
+#include "Boundary2D.hh"
+
+using namespace std;
+using namespace polytope;
+using namespace polytope::bench;
+
+namespace {
+
+//------------------------------------------------------------------------------
+// Wrap Boundary2D::testInside for generatePoints.
+//------------------------------------------------------------------------------
+struct InsideBoundary {
+  Boundary2D<double>* boundary;
+  explicit InsideBoundary(Boundary2D<double>& b): boundary(&b) {}
+  bool operator()(const double* p) const {
+    double pos[2] = {p[0], p[1]};
+    return boundary->testInside(pos);
+  }
+};
+
+int boundaryType(const string& name) {
+  if (name == "box")   return Boundary2D<double>::square;
+  if (name == "star")  return Boundary2D<double>::funkystar;
+  if (name == "holes") return Boundary2D<double>::mwithholes;
+  cerr << "Unknown boundary " << name << endl;
+  exit(1);
+}
+
+}
+
+// -----------------------------------------------------------------------
+// main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+#ifdef HAVE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  const BenchOptions opts = parseOptions("tessellate2d", argc, argv);
+  enableTimers(opts.stages);
+
+  // The tessellators we have.
+  vector<pair<string, Tessellator<2, double>*> > tessellators;
+#ifdef HAVE_BOOST_VORONOI
+  tessellators.push_back(make_pair(string("Boost"), new BoostTessellator<double>()));
+  tessellators.push_back(make_pair(string("BoostHilbert"), new BoostTessellator<double>()));
+  tessellators.back().second->spatialSort(HilbertSort);
+#endif
+#ifdef HAVE_TRIANGLE
+  tessellators.push_back(make_pair(string("Triangle"), new TriangleTessellator<double>()));
+#endif
+#ifdef HAVE_VOROPP
+  tessellators.push_back(make_pair(string("VoroPP_2d"), new VoroPP_2d<double>()));
+#endif
+
+  BenchReport report("tessellate2d", opts.output, 1);
+  for (unsigned ib = 0; ib != opts.boundaries.size(); ++ib) {
+    const string& bname = opts.boundaries[ib];
+    Boundary2D<double> boundary;
+    boundary.setDefaultBoundary(boundaryType(bname));
+    for (unsigned id = 0; id != opts.distributions.size(); ++id) {
+      const string& dname = opts.distributions[id];
+      for (unsigned in = 0; in != opts.n.size(); ++in) {
+        vector<double> points;
+        generatePoints<2>(dname, opts.n[in], boundary.mLow, boundary.mHigh,
+                          InsideBoundary(boundary), opts.seed, points);
+        for (unsigned it = 0; it != tessellators.size(); ++it) {
+          const string& tname = tessellators[it].first;
+          const Tessellator<2, double>& tessellator = *tessellators[it].second;
+          if (not opts.wantTessellator(tname)) continue;
+          if (bname != "box" and not tessellator.handlesPLCs()) continue;
+
+          BenchRecord record;
+          record.param("tessellator", tname);
+          record.param("distribution", dname);
+          record.param("boundary", bname);
+          record.n = opts.n[in];
+          record.generators = points.size()/2;
+          runCase(record, opts.reps, [&]() {
+              Tessellation<2, double> mesh;
+              if (bname == "box") {
+                tessellator.tessellate(points, boundary.mLow, boundary.mHigh, mesh);
+              } else {
+                tessellator.tessellate(points, boundary.mPLCpoints, boundary.mPLC, mesh);
+              }
+              return unsigned(mesh.cells.size());
+            });
+          report.add(record);
+        }
+      }
+    }
+  }
+
+  for (unsigned it = 0; it != tessellators.size(); ++it) delete tessellators[it].second;
+
+#ifdef HAVE_MPI
+  MPI_Finalize();
+#endif
+  return 0;
+}
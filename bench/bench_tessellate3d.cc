@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------
+// bench_tessellate3d
+//
+// Time the serial 3D tessellators over generator count and distribution in
+// the unit cube.  We have no 3D star or holes boundaries, so only the box
+// boundary is run.
+//------------------------------------------------------------------------------
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include "polytope.hh"
+#include "polytope_bench_utilities.hh"
+
+using namespace std;
+using namespace polytope;
+using namespace polytope::bench;
+
+// -----------------------------------------------------------------------
+// main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+#ifdef HAVE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  const BenchOptions opts = parseOptions("tessellate3d", argc, argv);
+  enableTimers(opts.stages);
+
+  // The tessellators we have.
+  vector<pair<string, Tessellator<3, double>*> > tessellators;
+#ifdef HAVE_TETGEN
+  tessellators.push_back(make_pair(string("Tetgen"), new TetgenTessellator()));
+  tessellators.push_back(make_pair(string("TetgenHilbert"), new TetgenTessellator()));
+  tessellators.back().second->spatialSort(HilbertSort);
+#endif
+#ifdef HAVE_VOROPP
+  tessellators.push_back(make_pair(string("VoroPP_3d"), new VoroPP_3d<double>()));
+#endif
+
+  double low[3] = {0.0, 0.0, 0.0}, high[3] = {1.0, 1.0, 1.0};
+  BenchReport report("tessellate3d", opts.output, 1);
+  if (find(opts.boundaries.begin(), opts.boundaries.end(), "box") != opts.boundaries.end()) {
+    for (unsigned id = 0; id != opts.distributions.size(); ++id) {
+      const string& dname = opts.distributions[id];
+      for (unsigned in = 0; in != opts.n.size(); ++in) {
+        vector<double> points;
+        generatePoints<3>(dname, opts.n[in], low, high, InsideBox<3>(low, high), opts.seed, points);
+        for (unsigned it = 0; it != tessellators.size(); ++it) {
+          const string& tname = tessellators[it].first;
+          const Tessellator<3, double>& tessellator = *tessellators[it].second;
+          if (not opts.wantTessellator(tname)) continue;
+
+          BenchRecord record;
+          record.param("tessellator", tname);
+          record.param("distribution", dname);
+          record.param("boundary", "box");
+          record.n = opts.n[in];
+          record.generators = points.size()/3;
+          runCase(record, opts.reps, [&]() {
+              Tessellation<3, double> mesh;
+              tessellator.tessellate(points, low, high, mesh);
+              return unsigned(mesh.cells.size());
+            });
+          report.add(record);
+        }
+      }
+    }
+  }
+
+  for (unsigned it = 0; it != tessellators.size(); ++it) delete tessellators[it].second;
+
+#ifdef HAVE_MPI
+  MPI_Finalize();
+#endif
+  return 0;
+}
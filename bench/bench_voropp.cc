@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+// bench_voropp
+//
+// Time per cell of VoroPP_2d and VoroPP_3d as the generator count grows,
+// comparing the automatically sized Voro++ block grid against the old fixed
+// grid of 20 blocks per axis, in the unit box and the periodic unit box.
+// Only the box boundary is meaningful here.
+//------------------------------------------------------------------------------
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+
+#include "polytope.hh"
+#include "polytope_bench_utilities.hh"
+
+using namespace std;
+using namespace polytope;
+using namespace polytope::bench;
+
+namespace {
+
+// The block grid we used to default to.
+const unsigned fixedBlocks = 20;
+
+//------------------------------------------------------------------------------
+// Run one tessellator over every distribution, count and domain.
+//------------------------------------------------------------------------------
+template<int Dimension>
+void
+runTessellator(const string& tname,
+               const string& blocks,
+               const Tessellator<Dimension, double>& tessellator,
+               const BenchOptions& opts,
+               BenchReport& report) {
+  if (not opts.wantTessellator(tname)) return;
+  double low[Dimension], high[Dimension];
+  for (unsigned j = 0; j != Dimension; ++j) {
+    low[j] = 0.0;
+    high[j] = 1.0;
+  }
+  for (unsigned id = 0; id != opts.distributions.size(); ++id) {
+    const string& dname = opts.distributions[id];
+    for (unsigned in = 0; in != opts.n.size(); ++in) {
+      vector<double> points;
+      generatePoints<Dimension>(dname, opts.n[in], low, high, InsideBox<Dimension>(low, high), opts.seed, points);
+      for (unsigned periodic = 0; periodic != 2; ++periodic) {
+        BenchRecord record;
+        record.param("tessellator", tname);
+        record.param("blocks", blocks);
+        record.param("domain", periodic ? "periodic" : "box");
+        record.param("distribution", dname);
+        record.n = opts.n[in];
+        record.generators = points.size()/Dimension;
+        runCase(record, opts.reps, [&]() {
+            Tessellation<Dimension, double> mesh;
+            if (periodic) {
+              tessellator.tessellatePeriodic(points, low, high, mesh);
+            } else {
+              tessellator.tessellate(points, low, high, mesh);
+            }
+            return unsigned(mesh.cells.size());
+          });
+        report.add(record);
+      }
+    }
+  }
+}
+
+}
+
+// -----------------------------------------------------------------------
+// main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+#ifdef HAVE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  const BenchOptions opts = parseOptions("voropp", argc, argv);
+  enableTimers(opts.stages);
+
+  ostringstream fixed;
+  fixed << "fixed" << fixedBlocks;
+  BenchReport report("voropp", opts.output, 1);
+  runTessellator<2>("VoroPP_2d", "auto", VoroPP_2d<double>(), opts, report);
+  runTessellator<2>("VoroPP_2d", fixed.str(), VoroPP_2d<double>(fixedBlocks, fixedBlocks), opts, report);
+  runTessellator<3>("VoroPP_3d", "auto", VoroPP_3d<double>(), opts, report);
+  runTessellator<3>("VoroPP_3d", fixed.str(), VoroPP_3d<double>(fixedBlocks, fixedBlocks, fixedBlocks), opts, report);
+
+#ifdef HAVE_MPI
+  MPI_Finalize();
+#endif
+  return 0;
+}
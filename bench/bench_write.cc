@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+// bench_write
+//
+// Time writing 2D Boost tessellations of the unit box in each of the output
+// formats that need no third-party libraries: the ASCII OOGL OFF writer
+// (with the mesh faces as the PLC facets), polytope's native binary format,
+// binary VTU, and XDMF with raw binary data.  Each record carries the size
+// of the files written as the fileBytes counter.
+//------------------------------------------------------------------------------
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <cstdio>
+
+#include "polytope.hh"
+#include "polytope_write_OOGL.hh"
+#include "polytope_bench_utilities.hh"
+
+using namespace std;
+using namespace polytope;
+using namespace polytope::bench;
+
+namespace {
+
+uint64_t fileSize(const string& fileName) {
+  ifstream file(fileName.c_str(), ios::in | ios::binary | ios::ate);
+  return file ? uint64_t(file.tellg()) : 0;
+}
+
+}
+
+// -----------------------------------------------------------------------
+// main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+#ifdef HAVE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  const BenchOptions opts = parseOptions("write", argc, argv);
+  enableTimers(opts.stages);
+
+  double low[2] = {0.0, 0.0}, high[2] = {1.0, 1.0};
+  BoostTessellator<double> tessellator;
+  BenchReport report("write", opts.output, 1);
+  for (unsigned id = 0; id != opts.distributions.size(); ++id) {
+    const string& dname = opts.distributions[id];
+    for (unsigned in = 0; in != opts.n.size(); ++in) {
+      vector<double> points;
+      generatePoints<2>(dname, opts.n[in], low, high, InsideBox<2>(low, high), opts.seed, points);
+      Tessellation<2, double> mesh;
+      tessellator.tessellate(points, low, high, mesh);
+
+      // The cells' values, and the mesh as a PLC for the OOGL writer.
+      vector<double> cellID(mesh.cells.size());
+      for (unsigned i = 0; i != cellID.size(); ++i) cellID[i] = i;
+      map<string, double*> fields;
+      fields["cell_id"] = cellID.empty() ? 0 : &cellID[0];
+      PLC<2, double> plc;
+      for (unsigned i = 0; i != mesh.faces.size(); ++i) {
+        plc.facets.push_back(vector<int>(mesh.faces[i].begin(), mesh.faces[i].end()));
+      }
+
+      const char* formats[4] = {"OOGL", "Binary", "VTK", "XDMF"};
+      for (unsigned iformat = 0; iformat != 4; ++iformat) {
+        const string format = formats[iformat];
+        vector<string> files;
+        BenchRecord record;
+        record.param("format", format);
+        record.param("distribution", dname);
+        record.n = opts.n[in];
+        record.generators = points.size()/2;
+        runCase(record, opts.reps, [&]() {
+            if (format == "OOGL") {
+              writePLCtoOFF(plc, mesh.nodes, "bench_write.off");
+              files.assign(1, "bench_write.off");
+            } else if (format == "Binary") {
+              BinaryWriter<2, double>::write(mesh, "bench_write.ptess");
+              files.assign(1, "bench_write.ptess");
+            } else if (format == "VTK") {
+              VTKWriter<2, double>::write(mesh, fields, "bench_write.vtu");
+              files.assign(1, "bench_write.vtu");
+            } else {
+              XDMFWriter<2, double>::write(mesh, fields, "bench_write");
+              files.assign(1, "bench_write.xmf");
+              files.push_back("bench_write.bin");
+            }
+            return unsigned(mesh.cells.size());
+          });
+        uint64_t nbytes = 0;
+        for (unsigned k = 0; k != files.size(); ++k) {
+          nbytes += fileSize(files[k]);
+          remove(files[k].c_str());
+        }
+        record.counters.push_back(make_pair(string("fileBytes"), nbytes));
+        report.add(record);
+      }
+    }
+  }
+
+#ifdef HAVE_MPI
+  MPI_Finalize();
+#endif
+  return 0;
+}
@@ -0,0 +1,485 @@
+//------------------------------------------------------------------------------
+// The pieces shared by the polytope benchmarks: the generator distributions,
+// command line handling, timing of a case, and the JSON report.
+//
+// Every benchmark takes the same options:
+//   --n 1000,10000,...         generator counts
+//   --distributions a,b,...    uniform, clustered, lattice, kuzmin
+//   --boundaries a,b,...       box, star, holes
+//   --tessellators a,b,...     the tessellators to run (default all built)
+//   --reps 3                   repetitions of each case, we keep the fastest
+//   --seed 10483991            seed for the generator distributions
+//   --output file.json         where to write the results
+//   --no-stages                don't enable the pipeline timers
+//
+// Each case is run reps times and we report the fastest and mean wall clock
+// times, along with the stage timers and counters from timingUtilities.hh for
+// the fastest run.  Note enabling the timers turns on a few extra checks
+// (such as the cellsClipped counter), so use --no-stages when comparing
+// totals against an uninstrumented build.
+//------------------------------------------------------------------------------
+#ifndef __polytope_bench_utilities__
+#define __polytope_bench_utilities__
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <cmath>
+#include <cstdlib>
+#include <stdint.h>
+
+#include "polytope.hh"
+#include "timingUtilities.hh"
+
+#ifdef HAVE_MPI
+#include "mpi.h"
+#endif
+
+#ifdef HAVE_OPENMP
+#include "omp.h"
+#endif
+
+#ifndef BENCH_BUILD_TYPE
+#define BENCH_BUILD_TYPE ""
+#endif
+
+namespace polytope {
+namespace bench {
+
+//------------------------------------------------------------------------------
+// Our own random numbers, so a given seed gives the same generators on every
+// platform and every rank.
+//------------------------------------------------------------------------------
+class Random {
+public:
+  explicit Random(const uint64_t seed): mState(seed*2862933555777941757ULL + 3037000493ULL) {}
+  double uniform() {
+    mState = mState*6364136223846793005ULL + 1442695040888963407ULL;
+    return double(mState >> 11)*(1.0/9007199254740992.0);
+  }
+  double normal() {
+    const double u1 = std::max(uniform(), std::numeric_limits<double>::min());
+    const double u2 = uniform();
+    return std::sqrt(-2.0*std::log(u1))*std::cos(2.0*M_PI*u2);
+  }
+private:
+  uint64_t mState;
+};
+
+//------------------------------------------------------------------------------
+// A box which accepts every point, for the 3D benchmarks.
+//------------------------------------------------------------------------------
+template<int Dimension>
+struct InsideBox {
+  const double* low;
+  const double* high;
+  InsideBox(const double* l, const double* h): low(l), high(h) {}
+  bool operator()(const double* p) const {
+    for (unsigned j = 0; j != Dimension; ++j) {
+      if (p[j] < low[j] or p[j] > high[j]) return false;
+    }
+    return true;
+  }
+};
+
+//------------------------------------------------------------------------------
+// Generate about n points inside the region [low, high] accepted by inside:
+//   uniform   : uniformly random,
+//   clustered : gaussian clumps about a few random centers,
+//   lattice   : a cartesian lattice, jittered by a percent of the spacing,
+//   kuzmin    : the Kuzmin disk surface density (1 + r^2/a^2)^(-3/2) about
+//               the center of the box.
+// All but the lattice give exactly n points.  The lattice is the coarsest
+// one with at least n points inside, so it can give a few more.  The points
+// are returned shuffled so no tessellator sees a helpful input order.
+//------------------------------------------------------------------------------
+template<int Dimension, typename Inside>
+void
+generatePoints(const std::string& distribution,
+               const unsigned n,
+               const double* low,
+               const double* high,
+               const Inside& inside,
+               const uint64_t seed,
+               std::vector<double>& points) {
+  Random rng(seed);
+  points.clear();
+  points.reserve(Dimension*n);
+  double p[Dimension], center[Dimension], extent = 0.0;
+  unsigned i, j;
+  for (j = 0; j != Dimension; ++j) {
+    center[j] = 0.5*(low[j] + high[j]);
+    extent = std::max(extent, high[j] - low[j]);
+  }
+
+  if (distribution == "uniform") {
+    while (points.size() < Dimension*n) {
+      for (j = 0; j != Dimension; ++j) p[j] = low[j] + rng.uniform()*(high[j] - low[j]);
+      if (inside(p)) points.insert(points.end(), p, p + Dimension);
+    }
+
+  } else if (distribution == "clustered") {
+    const unsigned nclusters = std::max(4U, std::min(64U, n/2000));
+    const double sigma = 0.05*extent;
+    std::vector<double> centers;
+    while (centers.size() < Dimension*nclusters) {
+      for (j = 0; j != Dimension; ++j) p[j] = low[j] + rng.uniform()*(high[j] - low[j]);
+      if (inside(p)) centers.insert(centers.end(), p, p + Dimension);
+    }
+    while (points.size() < Dimension*n) {
+      const unsigned k = std::min(nclusters - 1, unsigned(rng.uniform()*nclusters));
+      for (j = 0; j != Dimension; ++j) p[j] = centers[Dimension*k + j] + sigma*rng.normal();
+      if (inside(p)) points.insert(points.end(), p, p + Dimension);
+    }
+
+  } else if (distribution == "lattice") {
+    unsigned m = std::max(2U, unsigned(std::pow(double(n), 1.0/Dimension)));
+    while (points.size() < Dimension*n) {
+      points.clear();
+      unsigned ntotal = 1;
+      for (j = 0; j != Dimension; ++j) ntotal *= m;
+      for (i = 0; i != ntotal; ++i) {
+        unsigned ii = i;
+        for (j = 0; j != Dimension; ++j) {
+          const double dx = (high[j] - low[j])/m;
+          p[j] = low[j] + ((ii % m) + 0.5 + 0.01*(rng.uniform() - 0.5))*dx;
+          ii /= m;
+        }
+        if (inside(p)) points.insert(points.end(), p, p + Dimension);
+      }
+      ++m;
+    }
+
+  } else if (distribution == "kuzmin") {
+    const double a = 0.1*extent;
+    while (points.size() < Dimension*n) {
+      const double u = std::min(rng.uniform(), 0.999999);
+      const double r = a*std::sqrt(1.0/((1.0 - u)*(1.0 - u)) - 1.0);
+      double dir[Dimension], dir2 = 0.0;
+      do {
+        dir2 = 0.0;
+        for (j = 0; j != Dimension; ++j) {
+          dir[j] = rng.normal();
+          dir2 += dir[j]*dir[j];
+        }
+      } while (dir2 == 0.0);
+      for (j = 0; j != Dimension; ++j) p[j] = center[j] + r*dir[j]/std::sqrt(dir2);
+      if (inside(p)) points.insert(points.end(), p, p + Dimension);
+    }
+
+  } else {
+    std::cerr << "Unknown distribution " << distribution << std::endl;
+    std::exit(1);
+  }
+
+  // Fisher-Yates on the points.
+  const unsigned np = points.size()/Dimension;
+  for (i = np; i > 1; --i) {
+    const unsigned k = std::min(i - 1, unsigned(rng.uniform()*i));
+    for (j = 0; j != Dimension; ++j) std::swap(points[Dimension*(i - 1) + j], points[Dimension*k + j]);
+  }
+}
+
+//------------------------------------------------------------------------------
+// The command line.
+//------------------------------------------------------------------------------
+struct BenchOptions {
+  std::vector<unsigned> n;
+  std::vector<std::string> distributions, boundaries, tessellators;
+  unsigned reps;
+  uint64_t seed;
+  std::string output;
+  bool stages;
+
+  BenchOptions(const std::string& name):
+    n(1, 10000),
+    distributions(),
+    boundaries(),
+    tessellators(),
+    reps(3),
+    seed(10483991),
+    output(name + ".json"),
+    stages(true) {
+    distributions.push_back("uniform");
+    distributions.push_back("clustered");
+    distributions.push_back("lattice");
+    distributions.push_back("kuzmin");
+    boundaries.push_back("box");
+    boundaries.push_back("star");
+    boundaries.push_back("holes");
+  }
+
+  bool wantTessellator(const std::string& name) const {
+    return tessellators.empty() or std::find(tessellators.begin(), tessellators.end(), name) != tessellators.end();
+  }
+};
+
+inline
+std::vector<std::string>
+splitList(const std::string& s) {
+  std::vector<std::string> result;
+  std::stringstream ss(s);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (not item.empty()) result.push_back(item);
+  }
+  return result;
+}
+
+inline
+BenchOptions
+parseOptions(const std::string& name, int argc, char** argv) {
+  BenchOptions result(name);
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg(argv[i]);
+    if (arg == "--no-stages") {
+      result.stages = false;
+      continue;
+    }
+    if (i + 1 == argc) {
+      std::cerr << name << ": missing value for " << arg << std::endl;
+      std::exit(1);
+    }
+    const std::string value(argv[++i]);
+    if (arg == "--n") {
+      const std::vector<std::string> ns = splitList(value);
+      result.n.clear();
+      for (unsigned k = 0; k != ns.size(); ++k) result.n.push_back(unsigned(std::atof(ns[k].c_str())));
+    } else if (arg == "--distributions") {
+      result.distributions = splitList(value);
+    } else if (arg == "--boundaries") {
+      result.boundaries = splitList(value);
+    } else if (arg == "--tessellators") {
+      result.tessellators = splitList(value);
+    } else if (arg == "--reps") {
+      result.reps = std::max(1, std::atoi(value.c_str()));
+    } else if (arg == "--seed") {
+      result.seed = std::strtoull(value.c_str(), 0, 10);
+    } else if (arg == "--output") {
+      result.output = value;
+    } else {
+      std::cerr << name << ": unknown option " << arg << std::endl;
+      std::exit(1);
+    }
+  }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// One benchmark case and its measurements.
+//------------------------------------------------------------------------------
+struct BenchRecord {
+  std::vector<std::pair<std::string, std::string> > params;
+  unsigned n, generators, cells, reps;
+  double minSeconds, meanSeconds;
+  std::vector<std::pair<std::string, double> > stages;
+  std::vector<std::pair<std::string, uint64_t> > counters;
+
+  BenchRecord(): params(), n(0), generators(0), cells(0), reps(0),
+                 minSeconds(0.0), meanSeconds(0.0), stages(), counters() {}
+  void param(const std::string& key, const std::string& value) {
+    params.push_back(std::make_pair(key, value));
+  }
+};
+
+// Copy the current stage timers and counters into the record.
+inline
+void
+captureStages(BenchRecord& record) {
+  record.stages.clear();
+  record.counters.clear();
+  const std::vector<std::string> tnames = timerNames(), cnames = counterNames();
+  for (unsigned k = 0; k != tnames.size(); ++k) record.stages.push_back(std::make_pair(tnames[k], timerSeconds(tnames[k])));
+  for (unsigned k = 0; k != cnames.size(); ++k) record.counters.push_back(std::make_pair(cnames[k], counterValue(cnames[k])));
+}
+
+//------------------------------------------------------------------------------
+// Time reps calls of f, which does the work of the case and returns the
+// number of cells it made.
+//------------------------------------------------------------------------------
+inline
+void
+runCase(BenchRecord& record,
+        const unsigned reps,
+        const std::function<unsigned()>& f) {
+  record.reps = reps;
+  record.minSeconds = std::numeric_limits<double>::max();
+  double total = 0.0;
+  for (unsigned r = 0; r != reps; ++r) {
+    resetTimers();
+    const Timing::Time t0 = Timing::currentTime();
+    record.cells = f();
+    const double dt = Timing::difference(t0, Timing::currentTime());
+    total += dt;
+    if (dt < record.minSeconds) {
+      record.minSeconds = dt;
+      captureStages(record);
+    }
+  }
+  record.meanSeconds = total/reps;
+}
+
+#ifdef HAVE_MPI
+//------------------------------------------------------------------------------
+// The same for a distributed case.  The time of a rep is the slowest rank's,
+// the cells are summed over ranks, and each stage timer reports its slowest
+// rank while the counters are summed.
+//------------------------------------------------------------------------------
+inline
+void
+runDistributedCase(BenchRecord& record,
+                   const unsigned reps,
+                   const std::function<unsigned()>& f,
+                   const MPI_Comm comm) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+  record.reps = reps;
+  record.minSeconds = std::numeric_limits<double>::max();
+  double total = 0.0;
+  for (unsigned r = 0; r != reps; ++r) {
+    resetTimers();
+    MPI_Barrier(comm);
+    const Timing::Time t0 = Timing::currentTime();
+    unsigned ncells = f();
+    double dt = Timing::difference(t0, Timing::currentTime());
+    MPI_Allreduce(MPI_IN_PLACE, &dt, 1, MPI_DOUBLE, MPI_MAX, comm);
+    MPI_Allreduce(MPI_IN_PLACE, &ncells, 1, MPI_UNSIGNED, MPI_SUM, comm);
+    record.cells = ncells;
+    total += dt;
+    if (dt < record.minSeconds) {
+      record.minSeconds = dt;
+
+      // Rank 0 names the stages, since some (the orphans) may not happen
+      // everywhere.  Names a rank never saw read as zero.
+      std::string names;
+      if (rank == 0) {
+        const std::vector<std::string> tnames = timerNames(), cnames = counterNames();
+        for (unsigned k = 0; k != tnames.size(); ++k) names += "t" + tnames[k] + "\n";
+        for (unsigned k = 0; k != cnames.size(); ++k) names += "c" + cnames[k] + "\n";
+      }
+      unsigned size = names.size();
+      MPI_Bcast(&size, 1, MPI_UNSIGNED, 0, comm);
+      names.resize(size);
+      if (size > 0) MPI_Bcast(&names[0], size, MPI_CHAR, 0, comm);
+      record.stages.clear();
+      record.counters.clear();
+      std::stringstream ss(names);
+      std::string line;
+      while (std::getline(ss, line)) {
+        const std::string name = line.substr(1);
+        if (line[0] == 't') {
+          double seconds = timerSeconds(name);
+          MPI_Allreduce(MPI_IN_PLACE, &seconds, 1, MPI_DOUBLE, MPI_MAX, comm);
+          record.stages.push_back(std::make_pair(name, seconds));
+        } else {
+          unsigned long long value = counterValue(name);
+          MPI_Allreduce(MPI_IN_PLACE, &value, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, comm);
+          record.counters.push_back(std::make_pair(name, uint64_t(value)));
+        }
+      }
+    }
+  }
+  record.meanSeconds = total/reps;
+}
+#endif
+
+//------------------------------------------------------------------------------
+// The JSON report: some information about the build and run, then a list
+// with one object per case.
+//------------------------------------------------------------------------------
+inline
+std::string
+jsonString(const std::string& s) {
+  std::string result = "\"";
+  for (unsigned k = 0; k != s.size(); ++k) {
+    if (s[k] == '"' or s[k] == '\\') result += '\\';
+    result += s[k];
+  }
+  return result + "\"";
+}
+
+class BenchReport {
+public:
+  BenchReport(const std::string& name, const std::string& filename, const int ranks):
+    mName(name),
+    mFilename(filename),
+    mRanks(ranks),
+    mRecords() {}
+
+  // Add a case, and rewrite the file so a case that dies doesn't lose the
+  // ones before it.
+  void add(const BenchRecord& record) {
+    mRecords.push_back(record);
+    write();
+    std::cout << std::left;
+    for (unsigned k = 0; k != record.params.size(); ++k) std::cout << std::setw(14) << record.params[k].second;
+    std::cout << std::right << std::setw(10) << record.generators
+              << std::setw(14) << std::scientific << std::setprecision(4) << record.minSeconds << " s"
+              << std::setw(14) << record.minSeconds/std::max(1U, record.cells) << " s/cell" << std::endl;
+  }
+
+  void write() const {
+    std::ofstream os(mFilename.c_str());
+    if (not os) {
+      std::cerr << mName << ": cannot write " << mFilename << std::endl;
+      std::exit(1);
+    }
+    int threads = 1;
+#ifdef HAVE_OPENMP
+    threads = omp_get_max_threads();
+#endif
+    os << std::setprecision(9) << "{\n"
+       << "  \"benchmark\": " << jsonString(mName) << ",\n"
+       << "  \"polytope_version\": \"" << POLYTOPE_VERSION_MAJOR << "." << POLYTOPE_VERSION_MINOR << "\",\n"
+       << "  \"build_type\": " << jsonString(BENCH_BUILD_TYPE) << ",\n"
+#ifdef NDEBUG
+       << "  \"assertions\": false,\n"
+#else
+       << "  \"assertions\": true,\n"
+#endif
+       << "  \"mpi_ranks\": " << mRanks << ",\n"
+       << "  \"openmp_threads\": " << threads << ",\n"
+       << "  \"results\": [";
+    for (unsigned i = 0; i != mRecords.size(); ++i) {
+      const BenchRecord& r = mRecords[i];
+      os << (i == 0 ? "\n" : ",\n") << "    {";
+      for (unsigned k = 0; k != r.params.size(); ++k) {
+        os << jsonString(r.params[k].first) << ": " << jsonString(r.params[k].second) << ", ";
+      }
+      os << "\"n\": " << r.n
+         << ", \"generators\": " << r.generators
+         << ", \"cells\": " << r.cells
+         << ", \"reps\": " << r.reps
+         << ", \"seconds_min\": " << r.minSeconds
+         << ", \"seconds_mean\": " << r.meanSeconds
+         << ", \"seconds_per_cell\": " << r.minSeconds/std::max(1U, r.cells)
+         << ",\n     \"stages\": {";
+      for (unsigned k = 0; k != r.stages.size(); ++k) {
+        os << (k == 0 ? "" : ", ") << jsonString(r.stages[k].first) << ": " << r.stages[k].second;
+      }
+      os << "},\n     \"counters\": {";
+      for (unsigned k = 0; k != r.counters.size(); ++k) {
+        os << (k == 0 ? "" : ", ") << jsonString(r.counters[k].first) << ": " << r.counters[k].second;
+      }
+      os << "}}";
+    }
+    os << "\n  ]\n}\n";
+  }
+
+private:
+  std::string mName, mFilename;
+  int mRanks;
+  std::vector<BenchRecord> mRecords;
+};
+
+}
+}
+
+#endif
@@ -21,6 +21,10 @@ macro(polytope_add_test name dependency_list)
       set(BUILD_TEST ${HAVE_BOOST_VORONOI})
     endif()
 
+    if (_dependency STREQUAL "VOROPP")
+      set(BUILD_TEST ${HAVE_VOROPP})
+    endif()
+
     if(_dependency STREQUAL "TETGEN")
       set(BUILD_TEST ${HAVE_TETGEN})
       list(APPEND TEST_LINK_LIBRARIES tetgen)
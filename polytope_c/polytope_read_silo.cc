@@ -9,9 +9,9 @@ namespace polytope
 {
 
 // Creates a C tessellation from a C++ one. This template is defined in 
-// polytope_tessellator.cc.
+// polytope_tessellator.cc, and consumes the C++ tessellation.
 template <int Dimension>
-void fill_tessellation(const Tessellation<Dimension, polytope_real_t>& t, polytope_tessellation_t* tess);
+void fill_tessellation(Tessellation<Dimension, polytope_real_t>& t, polytope_tessellation_t* tess);
 
 }
 
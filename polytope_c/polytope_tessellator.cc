@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include "polytope_c.h"
 #include "polytope.hh"
 #include "BoostTessellator.hh"
@@ -17,61 +19,60 @@ template <int Dimension>
 void fill_plc(polytope_plc_t* c_plc,
               polytope::PLC<Dimension, polytope_real_t>& plc);
 
-// This helper crafts a C polytope_tessellation object from a C++ Tessellation.
-template <int Dimension>
-void fill_tessellation(const Tessellation<Dimension, polytope_real_t>& t, polytope_tessellation_t* tess)
+// Flattens a nested array into Compressed Row Storage, releasing each row of
+// the nested array as soon as it has been copied so that the peak memory
+// footprint is roughly one copy of the data rather than two.  The rows are
+// copied bytewise, so T and U may differ only in signedness.
+template <typename T, typename U>
+void flatten_rows(std::vector<std::vector<T> >& rows, int** offsets, U** values)
 {
-  // Copy node coordinates.
-  tess->num_nodes = t.nodes.size()/Dimension;
-  tess->nodes = (polytope_real_t*)malloc(sizeof(polytope_real_t) * Dimension * tess->num_nodes);
-  copy(t.nodes.begin(), t.nodes.end(), tess->nodes);
-
-  // Copy cell-face data.
-  {
-    tess->num_cells = t.cells.size();
-    tess->cell_offsets = (int*)malloc(sizeof(int) * (tess->num_cells+1));
-    int size = 0;
-    for (size_t i = 0; i < t.cells.size(); ++i)
-      size += t.cells[i].size();
-    tess->cell_faces = (int*)malloc(sizeof(int) * (size+1));
-    int offset = 0;
-    for (size_t i = 0; i < t.cells.size(); ++i)
-    {
-      tess->cell_offsets[i] = offset;
-      for (size_t j = 0; j < t.cells[i].size(); ++j, ++offset)
-        tess->cell_faces[offset] = t.cells[i][j];
-    }
-    tess->cell_offsets[t.cells.size()] = offset;
-  }
-
-  // Copy face-node data.
+  static_assert(sizeof(T) == sizeof(U), "flatten_rows copies T bytewise into U");
+  const size_t n = rows.size();
+  *offsets = (int*)malloc(sizeof(int) * (n+1));
+  size_t size = 0;
+  for (size_t i = 0; i < n; ++i)
+    size += rows[i].size();
+  *values = (U*)malloc(sizeof(U) * (size+1));
+  int offset = 0;
+  for (size_t i = 0; i < n; ++i)
   {
-    tess->num_faces = t.faces.size();
-    tess->face_offsets = (int*)malloc(sizeof(int) * (tess->num_faces+1));
-    int size = 0;
-    for (size_t i = 0; i < t.faces.size(); ++i)
-      size += t.faces[i].size();
-    tess->face_nodes = (unsigned*)malloc(sizeof(unsigned) * (size+1));
-    int offset = 0;
-    for (size_t i = 0; i < t.faces.size(); ++i)
+    (*offsets)[i] = offset;
+    if (!rows[i].empty())
     {
-      tess->face_offsets[i] = offset;
-      for (size_t j = 0; j < t.faces[i].size(); ++j, ++offset)
-        tess->face_nodes[offset] = t.faces[i][j];
+      memcpy(*values + offset, &rows[i][0], sizeof(U) * rows[i].size());
+      offset += rows[i].size();
     }
-    tess->face_offsets[t.faces.size()] = offset;
+    std::vector<T>().swap(rows[i]);
   }
+  (*offsets)[n] = offset;
+  std::vector<std::vector<T> >().swap(rows);
+}
 
-  // Boundary nodes and faces.
-  tess->num_boundary_nodes = (int)t.boundaryNodes.size();
-  tess->boundary_nodes = (unsigned*)malloc(sizeof(unsigned) * tess->num_boundary_nodes);
-  copy(t.boundaryNodes.begin(), t.boundaryNodes.end(), tess->boundary_nodes);
+// Copies a flat array into a freshly malloc'd buffer and releases the source.
+template <typename T>
+T* release_array(std::vector<T>& v)
+{
+  T* result = (T*)malloc(sizeof(T) * v.size());
+  if (!v.empty())
+    memcpy(result, &v[0], sizeof(T) * v.size());
+  std::vector<T>().swap(v);
+  return result;
+}
 
-  tess->num_boundary_faces = (int)t.boundaryFaces.size();
-  tess->boundary_faces = (unsigned*)malloc(sizeof(unsigned) * tess->num_boundary_faces);
-  copy(t.boundaryFaces.begin(), t.boundaryFaces.end(), tess->boundary_faces);
+// This helper crafts a C polytope_tessellation object from a C++ Tessellation.
+// The C++ Tessellation is consumed in the process: each of its arrays is
+// released as soon as it has been transferred to the C struct, so callers
+// never hold two full copies of the mesh at once.
+template <int Dimension>
+void fill_tessellation(Tessellation<Dimension, polytope_real_t>& t, polytope_tessellation_t* tess)
+{
+  // Node coordinates.
+  tess->num_nodes = t.nodes.size()/Dimension;
+  tess->nodes = release_array(t.nodes);
 
-  // Cells attached to faces.
+  // Cells attached to faces.  We do these before the face-node data so the 
+  // face count is still available for checking.
+  tess->num_faces = t.faces.size();
   POLY_ASSERT(tess->num_faces == (int)t.faceCells.size());
   tess->face_cells = (int*)malloc(2 * tess->num_faces * sizeof(int));
   for (int f = 0; f < t.faceCells.size(); ++f)
@@ -79,6 +80,18 @@ void fill_tessellation(const Tessellation<Dimension, polytope_real_t>& t, polyto
     tess->face_cells[2*f] = t.faceCells[f][0];
     tess->face_cells[2*f+1] = (t.faceCells[f].size() == 2) ? t.faceCells[f][1] : -1;
   }
+  std::vector<std::vector<int> >().swap(t.faceCells);
+
+  // Cell-face and face-node data.
+  tess->num_cells = t.cells.size();
+  flatten_rows(t.cells, &tess->cell_offsets, &tess->cell_faces);
+  flatten_rows(t.faces, &tess->face_offsets, &tess->face_nodes);
+
+  // Boundary nodes and faces.
+  tess->num_boundary_nodes = (int)t.boundaryNodes.size();
+  tess->boundary_nodes = release_array(t.boundaryNodes);
+  tess->num_boundary_faces = (int)t.boundaryFaces.size();
+  tess->boundary_faces = release_array(t.boundaryFaces);
 
   // Convex hull.
   if (!t.convexHull.empty())
@@ -89,41 +102,9 @@ void fill_tessellation(const Tessellation<Dimension, polytope_real_t>& t, polyto
 
   // Neighbor domain information.
   tess->num_neighbor_domains = (int)t.neighborDomains.size();
-  tess->neighbor_domains = (unsigned*)malloc(sizeof(unsigned) * tess->num_neighbor_domains);
-  copy(t.neighborDomains.begin(), t.neighborDomains.end(), tess->neighbor_domains);
-
-  {
-    tess->shared_node_domain_offsets = (int*)malloc(sizeof(int) * (tess->num_neighbor_domains + 1));
-    int size = 0;
-    for (size_t i = 0; i < t.sharedNodes.size(); ++i)
-      size += t.sharedNodes[i].size();
-    tess->shared_nodes = (unsigned*)malloc(sizeof(unsigned) * (size+1));
-    int offset = 0;
-    for (size_t i = 0; i < t.sharedNodes.size(); ++i)
-    {
-      tess->shared_node_domain_offsets[i] = offset;
-      for (size_t j = 0; j < t.sharedNodes[i].size(); ++j, ++offset)
-        tess->shared_nodes[offset] = t.sharedNodes[i][j];
-    }
-    tess->shared_node_domain_offsets[t.sharedNodes.size()] = offset;
-  }
-
-  {
-    tess->shared_face_domain_offsets = (int*)malloc(sizeof(int) * (tess->num_neighbor_domains + 1));
-    int size = 0;
-    for (size_t i = 0; i < t.sharedFaces.size(); ++i)
-      size += t.sharedFaces[i].size();
-    tess->shared_faces = (unsigned*)malloc(sizeof(unsigned) * (size+1));
-    int offset = 0;
-    for (size_t i = 0; i < t.sharedFaces.size(); ++i)
-    {
-      tess->shared_face_domain_offsets[i] = offset;
-      for (size_t j = 0; j < t.sharedFaces[i].size(); ++j, ++offset)
-        tess->shared_faces[offset] = t.sharedFaces[i][j];
-    }
-    tess->shared_face_domain_offsets[t.sharedFaces.size()] = offset;
-  }
-
+  tess->neighbor_domains = release_array(t.neighborDomains);
+  flatten_rows(t.sharedNodes, &tess->shared_node_domain_offsets, &tess->shared_nodes);
+  flatten_rows(t.sharedFaces, &tess->shared_face_domain_offsets, &tess->shared_faces);
 
   // Node->cell connectivity.
   // FIXME
@@ -199,8 +180,8 @@ void fill_tessellation(polytope_tessellation_t* tess, Tessellation<Dimension, po
 }
 
 // Template instantiations.
-template void fill_tessellation(const Tessellation<2, polytope_real_t>& t, polytope_tessellation_t* tess);
-template void fill_tessellation(const Tessellation<3, polytope_real_t>& t, polytope_tessellation_t* tess);
+template void fill_tessellation(Tessellation<2, polytope_real_t>& t, polytope_tessellation_t* tess);
+template void fill_tessellation(Tessellation<3, polytope_real_t>& t, polytope_tessellation_t* tess);
 template void fill_tessellation(polytope_tessellation_t* tess, Tessellation<2, polytope_real_t>& t);
 template void fill_tessellation(polytope_tessellation_t* tess, Tessellation<3, polytope_real_t>& t);
 
@@ -375,7 +356,7 @@ polytope_tessellator_t* triangle_tessellator_new()
 //------------------------------------------------------------------------
 
 //------------------------------------------------------------------------
-#ifdef HAVE_TETGEN
+#if defined(HAVE_TETGEN) && !defined(POLYTOPE_C_SINGLE_PRECISION)
 polytope_tessellator_t* tetgen_tessellator_new()
 {
   polytope_tessellator_t* t = (polytope_tessellator_t*)malloc(sizeof(polytope_tessellator_t));
@@ -71,8 +71,8 @@ polytope_tessellator_t* boost_tessellator_new();
 polytope_tessellator_t* triangle_tessellator_new();
 #endif
 
-#ifdef HAVE_TETGEN
-// Creates a 3D tessellator using TetGen.
+#if defined(HAVE_TETGEN) && !defined(POLYTOPE_C_SINGLE_PRECISION)
+// Creates a 3D tessellator using TetGen (double precision only).
 polytope_tessellator_t* tetgen_tessellator_new();
 #endif
 
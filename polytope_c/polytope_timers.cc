@@ -0,0 +1,75 @@
+#include <string.h>
+
+#include "polytope_c.h"
+#include "polytope.hh"
+#include "timingUtilities.hh"
+
+using namespace std;
+using namespace polytope;
+
+extern "C"
+{
+
+//------------------------------------------------------------------------
+void polytope_timers_enable(bool enable)
+{
+  enableTimers(enable);
+}
+//------------------------------------------------------------------------
+
+//------------------------------------------------------------------------
+bool polytope_timers_enabled()
+{
+  return timersEnabled();
+}
+//------------------------------------------------------------------------
+
+//------------------------------------------------------------------------
+void polytope_timers_reset()
+{
+  resetTimers();
+}
+//------------------------------------------------------------------------
+
+//------------------------------------------------------------------------
+double polytope_timer_seconds(const char* name)
+{
+  POLY_ASSERT(name != NULL);
+  return timerSeconds(name);
+}
+//------------------------------------------------------------------------
+
+//------------------------------------------------------------------------
+unsigned polytope_timer_calls(const char* name)
+{
+  POLY_ASSERT(name != NULL);
+  return timerCalls(name);
+}
+//------------------------------------------------------------------------
+
+//------------------------------------------------------------------------
+unsigned long long polytope_counter_value(const char* name)
+{
+  POLY_ASSERT(name != NULL);
+  return counterValue(name);
+}
+//------------------------------------------------------------------------
+
+//------------------------------------------------------------------------
+void polytope_timers_snprintf(char* str, int n)
+{
+  POLY_ASSERT(n > 0);
+  const string report = timersReport();
+  strncpy(str, report.c_str(), n);
+  str[n-1] = '\0';
+}
+//------------------------------------------------------------------------
+
+//------------------------------------------------------------------------
+void polytope_timers_fprintf(FILE* stream)
+{
+  fprintf(stream, "%s", timersReport().c_str());
+}
+//------------------------------------------------------------------------
+
+}
@@ -0,0 +1,47 @@
+#ifndef POLYTOPE_C_TIMERS_H
+#define POLYTOPE_C_TIMERS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// The timers and counters polytope keeps for the stages of each 
+// tessellation (delaunay, voronoiWalk, clipQuantizedTessellation, 
+// fillTessellation, findBoundaryElements, snapToBoundary, the MPI exchanges,
+// ...).  Nothing is recorded until they are enabled, and the totals 
+// accumulate over tessellations until they are reset.
+
+// Turns the timers on or off.
+void polytope_timers_enable(bool enable);
+
+// Returns true if the timers are on.
+bool polytope_timers_enabled(void);
+
+// Zeroes all the timers and counters.
+void polytope_timers_reset(void);
+
+// Returns the wall clock seconds recorded by the named timer (0 if unknown).
+double polytope_timer_seconds(const char* name);
+
+// Returns the number of times the named timer has run.
+unsigned polytope_timer_calls(const char* name);
+
+// Returns the value of the named counter (0 if unknown).
+unsigned long long polytope_counter_value(const char* name);
+
+// Writes a table of all the timers and counters to the given string, 
+// writing no more than n characters.
+void polytope_timers_snprintf(char* str, int n);
+
+// Writes a table of all the timers and counters to the given stream.
+void polytope_timers_fprintf(FILE* stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -23,14 +23,14 @@ void test1(polytope_tessellator_t* tessellator) {
   // Create the generators.
   const int nx = 3;
   int num_points = nx*nx;
-  double points[2*num_points];
-  const double x1 = 0.0, y1 = 0.0;
-  const double x2 = 1.0, y2 = 1.0;
-  const double dx = (x2 - x1)/nx, dy = (y2 - y1)/nx;
-  double low [2] = { FLT_MAX, FLT_MAX};
-  double high[2] = {-FLT_MAX, -FLT_MAX};
+  polytope_real_t points[2*num_points];
+  const polytope_real_t x1 = 0.0, y1 = 0.0;
+  const polytope_real_t x2 = 1.0, y2 = 1.0;
+  const polytope_real_t dx = (x2 - x1)/nx, dy = (y2 - y1)/nx;
+  polytope_real_t low [2] = { FLT_MAX, FLT_MAX};
+  polytope_real_t high[2] = {-FLT_MAX, -FLT_MAX};
   unsigned ix, iy, offset = 0;
-  double xi, yi;
+  polytope_real_t xi, yi;
   for (iy = 0; iy != nx; ++iy) {
     yi = y1 + (iy + 0.5)*dy;
     for (ix = 0; ix != nx; ++ix) {
@@ -45,8 +45,8 @@ void test1(polytope_tessellator_t* tessellator) {
   }
 
   // Construct a PLC to represent the boundary.
-  int num_plc_points = 8;
-  double plc_points[8] = {x1, y1, x2, y1, x2, y2, x1, y2};
+  int num_plc_points = 4;
+  polytope_real_t plc_points[8] = {x1, y1, x2, y1, x2, y2, x1, y2};
   polytope_plc_t* plc = polytope_plc_new(2);
   polytope_plc_add_facet(plc);
   polytope_plc_add_facet(plc);
@@ -137,7 +137,17 @@ main(int argc, char** argv)
   
   {
     printf("\nTest 1\n");
+    polytope_timers_enable(true);
     test1(tessellator);
+    polytope_timers_fprintf(stdout);
+    if (polytope_timer_calls("tessellate") != 2 ||
+        polytope_counter_value("cells") != 18)
+    {
+      printf("Unexpected timer results\n");
+      return 1;
+    }
+    polytope_timers_enable(false);
+    polytope_timers_reset();
   }
 
   {
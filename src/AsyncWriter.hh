@@ -0,0 +1,194 @@
+#ifndef POLYTOPE_ASYNC_WRITER_HH
+#define POLYTOPE_ASYNC_WRITER_HH
+
+#include <string>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <memory>
+
+#include "Tessellation.hh"
+#include "BinaryWriter.hh"
+#include "timingUtilities.hh"
+
+namespace polytope
+{
+
+//! \class AsyncWriter
+//! Writes tessellations on a background thread, so output overlaps with
+//! whatever the caller does next.  write() copies the tessellation and
+//! returns at once; the conversion and file output happen on the writer's
+//! thread, one write at a time in the order they were queued.  At most
+//! maxPending writes are held (queued or in progress): past that write()
+//! blocks until the oldest finishes, which bounds the memory held in copies.
+//!
+//! The write functions run on the background thread.  Anything they call
+//! must be safe to use from there: in particular, writers that communicate
+//! (SiloWriter's PMPIO batons) need MPI initialized with
+//! MPI_THREAD_MULTIPLE, and every rank must queue its writes in the same
+//! order.
+template <int Dimension, typename RealType>
+class AsyncWriter
+{
+  public:
+
+  typedef Tessellation<Dimension, RealType> TessellationType;
+
+  //! A function writing a tessellation out.
+  typedef std::function<void(const TessellationType&)> WriteFunction;
+
+  //! Completion handle for a write.  get() waits for it, and rethrows
+  //! anything the write function threw.
+  typedef std::shared_future<void> Handle;
+
+  explicit AsyncWriter(const unsigned maxPending = 2):
+    mMaxPending(maxPending > 0 ? maxPending : 1),
+    mNumPending(0),
+    mStop(false),
+    mThread()
+  {
+    mThread = std::thread(&AsyncWriter::run, this);
+  }
+
+  //! Finishes all queued writes.
+  ~AsyncWriter()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStop = true;
+    }
+    mQueueChanged.notify_all();
+    mThread.join();
+  }
+
+  //! Queue a write of the tessellation with the given function.
+  Handle write(const TessellationType& mesh, const WriteFunction& writeFunction)
+  {
+    // Wait for room before copying, so we never hold more than maxPending
+    // copies.
+    {
+      ScopedTimer timer("asyncWriteStall");
+      std::unique_lock<std::mutex> lock(mMutex);
+      mQueueChanged.wait(lock, [this]{ return mNumPending < mMaxPending; });
+      ++mNumPending;
+    }
+    // If the copy fails (say we run out of memory) give the slot back.
+    std::shared_ptr<Job> job;
+    try {
+      job.reset(new Job);
+      job->writeFunction = writeFunction;
+      snapshot(mesh, job->mesh);
+    } catch (...) {
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        --mNumPending;
+      }
+      mQueueChanged.notify_all();
+      throw;
+    }
+    Handle result = job->done.get_future().share();
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mQueue.push_back(job);
+    }
+    mQueueChanged.notify_all();
+    return result;
+  }
+
+  //! Queue a write to polytope's binary format (see BinaryWriter).
+  Handle writeBinary(const TessellationType& mesh, const std::string& fileName)
+  {
+    return write(mesh, [fileName](const TessellationType& m) {
+        BinaryWriter<Dimension, RealType>::write(m, fileName);
+      });
+  }
+
+  //! Wait for every write queued so far to finish.
+  void wait()
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mQueueChanged.wait(lock, [this]{ return mNumPending == 0; });
+  }
+
+  //! The number of writes queued or in progress.
+  unsigned numPending() const
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNumPending;
+  }
+
+  //! The most writes held at once.
+  unsigned maxPending() const { return mMaxPending; }
+
+  private:
+
+  struct Job {
+    TessellationType mesh;
+    WriteFunction writeFunction;
+    std::promise<void> done;
+  };
+
+  const unsigned mMaxPending;
+  unsigned mNumPending;
+  bool mStop;
+  std::deque<std::shared_ptr<Job> > mQueue;
+  mutable std::mutex mMutex;
+  std::condition_variable mQueueChanged;
+  std::thread mThread;
+
+  // The background thread: run the jobs until told to stop and the queue
+  // is empty.
+  void run()
+  {
+    while (true) {
+      std::shared_ptr<Job> job;
+      {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mQueueChanged.wait(lock, [this]{ return mStop or not mQueue.empty(); });
+        if (mQueue.empty()) return;
+        job = mQueue.front();
+        mQueue.pop_front();
+      }
+      try {
+        job->writeFunction(job->mesh);
+        job->done.set_value();
+      } catch (...) {
+        job->done.set_exception(std::current_exception());
+      }
+      job.reset();
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        --mNumPending;
+      }
+      mQueueChanged.notify_all();
+    }
+  }
+
+  // Tessellations can't be copied, so do it by hand.
+  static void snapshot(const TessellationType& mesh, TessellationType& copy)
+  {
+    copy.nodes = mesh.nodes;
+    copy.cells = mesh.cells;
+    copy.faces = mesh.faces;
+    copy.boundaryNodes = mesh.boundaryNodes;
+    copy.boundaryFaces = mesh.boundaryFaces;
+    copy.faceCells = mesh.faceCells;
+    copy.convexHull = mesh.convexHull;
+    copy.neighborDomains = mesh.neighborDomains;
+    copy.sharedNodes = mesh.sharedNodes;
+    copy.sharedFaces = mesh.sharedFaces;
+    copy.periodicFaces = mesh.periodicFaces;
+    copy.periodicFaceShifts = mesh.periodicFaceShifts;
+  }
+
+  // Disallowed.
+  AsyncWriter(const AsyncWriter&);
+  AsyncWriter& operator=(const AsyncWriter&);
+};
+
+}
+
+#endif
@@ -0,0 +1,265 @@
+#ifndef POLYTOPE_BINARY_READER_HH
+#define POLYTOPE_BINARY_READER_HH
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "Tessellation.hh"
+#include "BinaryUtils.hh"
+
+namespace polytope
+{
+
+//! A read-only view of a flat array in a mapped file.
+template <typename T>
+class BinaryArray
+{
+  public:
+
+  BinaryArray(): mData(0), mSize(0) {}
+  BinaryArray(const T* data, const uint64_t size): mData(data), mSize(size) {}
+
+  uint64_t size() const { return mSize; }
+  bool empty() const { return mSize == 0; }
+  const T* data() const { return mData; }
+  const T* begin() const { return mData; }
+  const T* end() const { return mData + mSize; }
+  const T& operator[](const uint64_t i) const
+  {
+    POLY_ASSERT(i < mSize);
+    return mData[i];
+  }
+
+  private:
+  const T* mData;
+  uint64_t mSize;
+};
+
+//! A read-only view of a ragged array stored in CSR form: row i is
+//! values[offsets[i]] to values[offsets[i+1]].
+template <typename T>
+class BinaryRaggedArray
+{
+  public:
+
+  BinaryRaggedArray(): mOffsets(), mValues() {}
+  BinaryRaggedArray(const BinaryArray<uint64_t>& offsets,
+                    const BinaryArray<T>& values): mOffsets(offsets), mValues(values) {}
+
+  //! The number of rows.
+  uint64_t size() const { return mOffsets.empty() ? 0 : mOffsets.size() - 1; }
+  bool empty() const { return size() == 0; }
+  const BinaryArray<uint64_t>& offsets() const { return mOffsets; }
+  const BinaryArray<T>& values() const { return mValues; }
+  BinaryArray<T> operator[](const uint64_t i) const
+  {
+    POLY_ASSERT(i < size());
+    return BinaryArray<T>(mValues.data() + mOffsets[i], mOffsets[i + 1] - mOffsets[i]);
+  }
+
+  //! Copy out to nested vectors.
+  void copy(std::vector<std::vector<T> >& result) const
+  {
+    result.resize(size());
+    for (uint64_t i = 0; i != size(); ++i)
+      result[i].assign(mValues.data() + mOffsets[i], mValues.data() + mOffsets[i + 1]);
+  }
+
+  private:
+  BinaryArray<uint64_t> mOffsets;
+  BinaryArray<T> mValues;
+};
+
+//! \class BinaryReader
+//! Reads tessellations written by BinaryWriter.  The file is mapped into
+//! memory, and the arrays are handed out as views into the mapping, so
+//! nothing is read from disk until it's touched.  The views are valid until
+//! the reader is closed or destroyed.
+template <int Dimension, typename RealType>
+class BinaryReader
+{
+  public:
+
+  BinaryReader(): mData(0), mSize(0), mSections(0), mNumSections(0) {}
+
+  //! Open the given file.
+  explicit BinaryReader(const std::string& fileName):
+    mData(0), mSize(0), mSections(0), mNumSections(0)
+  {
+    open(fileName);
+  }
+
+  ~BinaryReader() { close(); }
+
+  //! Map the given file, closing any file we already have open.
+  void open(const std::string& fileName)
+  {
+    close();
+    if (not Binary::littleEndianHost())
+      error("BinaryReader: the binary format is only supported on little-endian hosts");
+    const int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) error("BinaryReader: could not open " + fileName);
+    struct stat info;
+    if (fstat(fd, &info) != 0 or uint64_t(info.st_size) < sizeof(Binary::BinaryHeader)) {
+      ::close(fd);
+      error("BinaryReader: " + fileName + " is too short to be a tessellation file");
+    }
+    mSize = info.st_size;
+    void* data = mmap(0, mSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+      mSize = 0;
+      error("BinaryReader: could not map " + fileName);
+    }
+    mData = static_cast<const char*>(data);
+
+    // Check the header and index.
+    const Binary::BinaryHeader& header = *reinterpret_cast<const Binary::BinaryHeader*>(mData);
+    if (std::memcmp(header.magic, Binary::magic(), sizeof(header.magic)) != 0)
+      error("BinaryReader: " + fileName + " is not a tessellation file");
+    if (header.version > Binary::version)
+      error("BinaryReader: " + fileName + " was written by a newer version of polytope");
+    if (header.dimension != Dimension or header.realSize != sizeof(RealType))
+      error("BinaryReader: " + fileName + " holds a tessellation of a different dimension or precision");
+    if (header.fileSize != mSize or
+        sizeof(Binary::BinaryHeader) + header.numSections*sizeof(Binary::BinarySection) > mSize)
+      error("BinaryReader: " + fileName + " is truncated");
+    const Binary::BinarySection* sections =
+      reinterpret_cast<const Binary::BinarySection*>(mData + sizeof(Binary::BinaryHeader));
+    for (uint32_t i = 0; i != header.numSections; ++i) {
+      const Binary::BinarySection& section = sections[i];
+      if (section.offset % 8 != 0 or
+          section.offset > mSize or
+          section.count > (mSize - section.offset)/std::max(section.elementSize, 1u))
+        error("BinaryReader: " + fileName + " has a corrupt section index");
+    }
+    mSections = sections;
+    mNumSections = header.numSections;
+
+    // Check the ends of the ragged arrays, without touching the rows.
+    checkRagged(this->cells(), fileName);
+    checkRagged(this->faces(), fileName);
+    checkRagged(this->faceCells(), fileName);
+    checkRagged(this->sharedNodes(), fileName);
+    checkRagged(this->sharedFaces(), fileName);
+  }
+
+  //! Unmap the file.
+  void close()
+  {
+    if (mData != 0) munmap(const_cast<char*>(mData), mSize);
+    mData = 0;
+    mSize = 0;
+    mSections = 0;
+    mNumSections = 0;
+  }
+
+  //! Returns true if a file is open.
+  bool isOpen() const { return mData != 0; }
+
+  unsigned numNodes() const { return this->nodes().size()/Dimension; }
+  unsigned numCells() const { return this->cells().size(); }
+  unsigned numFaces() const { return this->faces().size(); }
+
+  //! Views of the members of the Tessellation.  Sections missing from the
+  //! file come back empty.
+  BinaryArray<RealType> nodes() const { return array<RealType>(Binary::NODES); }
+  BinaryRaggedArray<int> cells() const { return ragged<int>(Binary::CELL_OFFSETS, Binary::CELL_FACES); }
+  BinaryRaggedArray<unsigned> faces() const { return ragged<unsigned>(Binary::FACE_OFFSETS, Binary::FACE_NODES); }
+  BinaryRaggedArray<int> faceCells() const { return ragged<int>(Binary::FACE_CELL_OFFSETS, Binary::FACE_CELLS); }
+  BinaryArray<unsigned> boundaryNodes() const { return array<unsigned>(Binary::BOUNDARY_NODES); }
+  BinaryArray<unsigned> boundaryFaces() const { return array<unsigned>(Binary::BOUNDARY_FACES); }
+  BinaryArray<unsigned> neighborDomains() const { return array<unsigned>(Binary::NEIGHBOR_DOMAINS); }
+  BinaryRaggedArray<unsigned> sharedNodes() const { return ragged<unsigned>(Binary::SHARED_NODE_OFFSETS, Binary::SHARED_NODES); }
+  BinaryRaggedArray<unsigned> sharedFaces() const { return ragged<unsigned>(Binary::SHARED_FACE_OFFSETS, Binary::SHARED_FACES); }
+  BinaryArray<unsigned> periodicFaces() const { return array<unsigned>(Binary::PERIODIC_FACES); }
+  BinaryArray<int> periodicFaceShifts() const { return array<int>(Binary::PERIODIC_FACE_SHIFTS); }
+
+  //! Copy the whole file into a Tessellation.
+  void read(Tessellation<Dimension, RealType>& mesh) const
+  {
+    POLY_ASSERT(isOpen());
+    mesh.clear();
+    copy(this->nodes(), mesh.nodes);
+    this->cells().copy(mesh.cells);
+    this->faces().copy(mesh.faces);
+    this->faceCells().copy(mesh.faceCells);
+    copy(this->boundaryNodes(), mesh.boundaryNodes);
+    copy(this->boundaryFaces(), mesh.boundaryFaces);
+    copy(this->neighborDomains(), mesh.neighborDomains);
+    this->sharedNodes().copy(mesh.sharedNodes);
+    this->sharedFaces().copy(mesh.sharedFaces);
+    copy(this->periodicFaces(), mesh.periodicFaces);
+    copy(this->periodicFaceShifts(), mesh.periodicFaceShifts);
+  }
+
+  //! Read a Tessellation from the given file in one go.
+  static void read(Tessellation<Dimension, RealType>& mesh,
+                   const std::string& fileName)
+  {
+    BinaryReader reader(fileName);
+    reader.read(mesh);
+  }
+
+  private:
+
+  const char* mData;
+  uint64_t mSize;
+  const Binary::BinarySection* mSections;
+  uint32_t mNumSections;
+
+  const Binary::BinarySection* findSection(const uint32_t id) const
+  {
+    for (uint32_t i = 0; i != mNumSections; ++i) {
+      if (mSections[i].id == id) return &mSections[i];
+    }
+    return 0;
+  }
+
+  template <typename T>
+  BinaryArray<T> array(const uint32_t id) const
+  {
+    POLY_ASSERT(isOpen());
+    const Binary::BinarySection* section = findSection(id);
+    if (section == 0) return BinaryArray<T>();
+    if (section->elementSize != sizeof(T))
+      error("BinaryReader: unexpected element size in the section index");
+    return BinaryArray<T>(reinterpret_cast<const T*>(mData + section->offset), section->count);
+  }
+
+  template <typename T>
+  BinaryRaggedArray<T> ragged(const uint32_t offsetsID, const uint32_t valuesID) const
+  {
+    return BinaryRaggedArray<T>(array<uint64_t>(offsetsID), array<T>(valuesID));
+  }
+
+  template <typename T>
+  static void checkRagged(const BinaryRaggedArray<T>& rows, const std::string& fileName)
+  {
+    const BinaryArray<uint64_t>& offsets = rows.offsets();
+    if (offsets.empty()) return;
+    if (offsets[0] != 0 or offsets[offsets.size() - 1] != rows.values().size())
+      error("BinaryReader: " + fileName + " has inconsistent offsets");
+  }
+
+  template <typename T, typename U>
+  static void copy(const BinaryArray<T>& values, std::vector<U>& result)
+  {
+    result.assign(values.begin(), values.end());
+  }
+
+  // Disallowed.
+  BinaryReader(const BinaryReader&);
+  BinaryReader& operator=(const BinaryReader&);
+};
+
+}
+
+#endif
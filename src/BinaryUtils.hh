@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+// The layout of polytope's native binary tessellation files, shared by
+// BinaryWriter and BinaryReader.
+//
+// A file is a header, an index of sections, and the sections themselves:
+//
+//   BinaryHeader         magic "POLYTESS", format version, dimension, the
+//                        size of a real value, the number of sections, and
+//                        the size of the file.
+//   BinarySection[n]     for each section its id, element size, byte
+//                        offset, and number of elements.
+//   sections             flat little-endian arrays, each starting on an
+//                        8 byte boundary.
+//
+// Ragged arrays (cells, faces, faceCells, sharedNodes, sharedFaces) are stored
+// in CSR form as two sections: numRows + 1 uint64 offsets, and the values.
+// Readers skip sections they don't know, so new ones can be added without
+// bumping the version.
+//------------------------------------------------------------------------------
+#ifndef POLYTOPE_BINARY_UTILS_HH
+#define POLYTOPE_BINARY_UTILS_HH
+
+#include <stdint.h>
+
+namespace polytope {
+
+namespace Binary {
+
+// The current format version.
+const uint32_t version = 1;
+
+// The file header.
+struct BinaryHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t dimension;
+  uint32_t realSize;
+  uint32_t numSections;
+  uint64_t fileSize;
+};
+
+// An entry in the section index.
+struct BinarySection {
+  uint32_t id;
+  uint32_t elementSize;
+  uint64_t offset;
+  uint64_t count;
+};
+
+// The section ids.  Never renumber these, only append.
+enum SectionID {
+  NODES = 1,
+  CELL_OFFSETS = 2,
+  CELL_FACES = 3,
+  FACE_OFFSETS = 4,
+  FACE_NODES = 5,
+  FACE_CELL_OFFSETS = 6,
+  FACE_CELLS = 7,
+  BOUNDARY_NODES = 8,
+  BOUNDARY_FACES = 9,
+  NEIGHBOR_DOMAINS = 10,
+  SHARED_NODE_OFFSETS = 11,
+  SHARED_NODES = 12,
+  SHARED_FACE_OFFSETS = 13,
+  SHARED_FACES = 14,
+  PERIODIC_FACES = 15,
+  PERIODIC_FACE_SHIFTS = 16
+};
+
+inline
+const char*
+magic() {
+  return "POLYTESS";
+}
+
+// The file is little-endian and read in place, so we only handle
+// little-endian hosts.
+inline
+bool
+littleEndianHost() {
+  const uint16_t one = 1;
+  return *reinterpret_cast<const unsigned char*>(&one) == 1;
+}
+
+// Round a byte offset up to the alignment of the sections.
+inline
+uint64_t
+align(const uint64_t offset) {
+  return (offset + 7) & ~uint64_t(7);
+}
+
+}
+
+}
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef POLYTOPE_BINARY_WRITER_HH
+#define POLYTOPE_BINARY_WRITER_HH
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstring>
+#include <stdint.h>
+
+#include "Tessellation.hh"
+#include "BinaryUtils.hh"
+
+namespace polytope
+{
+
+//! \class BinaryWriter
+//! This class provides a static interface for writing tessellations to
+//! polytope's native binary format (see BinaryUtils.hh).  Unlike SiloWriter
+//! it needs no third-party libraries, and the files it writes can be mapped
+//! straight into memory by BinaryReader.
+template <int Dimension, typename RealType>
+class BinaryWriter
+{
+  public:
+
+  //! Write the tessellation to the given file, replacing it if it exists.
+  //! The convex hull is not stored.
+  static void write(const Tessellation<Dimension, RealType>& mesh,
+                    const std::string& fileName)
+  {
+    if (not Binary::littleEndianHost())
+      error("BinaryWriter: the binary format is only supported on little-endian hosts");
+    POLY_ASSERT(sizeof(int) == 4 and sizeof(unsigned) == 4);
+
+    // Lay out the sections.
+    std::vector<Binary::BinarySection> sections;
+    addSection(sections, Binary::NODES, sizeof(RealType), mesh.nodes.size());
+    addRaggedSections(sections, Binary::CELL_OFFSETS, Binary::CELL_FACES, mesh.cells);
+    addRaggedSections(sections, Binary::FACE_OFFSETS, Binary::FACE_NODES, mesh.faces);
+    addRaggedSections(sections, Binary::FACE_CELL_OFFSETS, Binary::FACE_CELLS, mesh.faceCells);
+    addSection(sections, Binary::BOUNDARY_NODES, sizeof(unsigned), mesh.boundaryNodes.size());
+    addSection(sections, Binary::BOUNDARY_FACES, sizeof(unsigned), mesh.boundaryFaces.size());
+    addSection(sections, Binary::NEIGHBOR_DOMAINS, sizeof(unsigned), mesh.neighborDomains.size());
+    addRaggedSections(sections, Binary::SHARED_NODE_OFFSETS, Binary::SHARED_NODES, mesh.sharedNodes);
+    addRaggedSections(sections, Binary::SHARED_FACE_OFFSETS, Binary::SHARED_FACES, mesh.sharedFaces);
+    addSection(sections, Binary::PERIODIC_FACES, sizeof(unsigned), mesh.periodicFaces.size());
+    addSection(sections, Binary::PERIODIC_FACE_SHIFTS, sizeof(int), mesh.periodicFaceShifts.size());
+    uint64_t offset = Binary::align(sizeof(Binary::BinaryHeader) +
+                                    sections.size()*sizeof(Binary::BinarySection));
+    for (unsigned i = 0; i != sections.size(); ++i) {
+      sections[i].offset = offset;
+      offset = Binary::align(offset + sections[i].elementSize*sections[i].count);
+    }
+
+    Binary::BinaryHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, Binary::magic(), sizeof(header.magic));
+    header.version = Binary::version;
+    header.dimension = Dimension;
+    header.realSize = sizeof(RealType);
+    header.numSections = sections.size();
+    header.fileSize = offset;
+
+    // Write it all out.
+    std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (not file)
+      error("BinaryWriter: could not open " + fileName + " for writing");
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&sections[0]), sections.size()*sizeof(Binary::BinarySection));
+    unsigned isection = 0;
+    writeArray(file, sections[isection++], mesh.nodes);
+    writeRagged(file, sections, isection, mesh.cells);
+    writeRagged(file, sections, isection, mesh.faces);
+    writeRagged(file, sections, isection, mesh.faceCells);
+    writeArray(file, sections[isection++], mesh.boundaryNodes);
+    writeArray(file, sections[isection++], mesh.boundaryFaces);
+    writeArray(file, sections[isection++], mesh.neighborDomains);
+    writeRagged(file, sections, isection, mesh.sharedNodes);
+    writeRagged(file, sections, isection, mesh.sharedFaces);
+    writeArray(file, sections[isection++], mesh.periodicFaces);
+    writeArray(file, sections[isection++], mesh.periodicFaceShifts);
+    POLY_ASSERT(isection == sections.size());
+    pad(file, header.fileSize);
+    if (not file)
+      error("BinaryWriter: failed writing " + fileName);
+  }
+
+  private:
+
+  static void addSection(std::vector<Binary::BinarySection>& sections,
+                         const uint32_t id,
+                         const uint32_t elementSize,
+                         const uint64_t count)
+  {
+    Binary::BinarySection section;
+    section.id = id;
+    section.elementSize = elementSize;
+    section.offset = 0;
+    section.count = count;
+    sections.push_back(section);
+  }
+
+  template <typename T>
+  static void addRaggedSections(std::vector<Binary::BinarySection>& sections,
+                                const uint32_t offsetsID,
+                                const uint32_t valuesID,
+                                const std::vector<std::vector<T> >& rows)
+  {
+    uint64_t n = 0;
+    for (unsigned i = 0; i != rows.size(); ++i) n += rows[i].size();
+    addSection(sections, offsetsID, sizeof(uint64_t), rows.size() + 1);
+    addSection(sections, valuesID, sizeof(T), n);
+  }
+
+  // Pad the file out to the given offset.
+  static void pad(std::ofstream& file, const uint64_t offset)
+  {
+    static const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    const uint64_t position = file.tellp();
+    POLY_ASSERT(position <= offset and offset - position < 8);
+    file.write(zeros, offset - position);
+  }
+
+  template <typename T>
+  static void writeArray(std::ofstream& file,
+                         const Binary::BinarySection& section,
+                         const std::vector<T>& values)
+  {
+    POLY_ASSERT(section.elementSize == sizeof(T) and section.count == values.size());
+    pad(file, section.offset);
+    if (not values.empty())
+      file.write(reinterpret_cast<const char*>(&values[0]), values.size()*sizeof(T));
+  }
+
+  template <typename T>
+  static void writeRagged(std::ofstream& file,
+                          const std::vector<Binary::BinarySection>& sections,
+                          unsigned& isection,
+                          const std::vector<std::vector<T> >& rows)
+  {
+    std::vector<uint64_t> offsets(1, 0);
+    offsets.reserve(rows.size() + 1);
+    for (unsigned i = 0; i != rows.size(); ++i) offsets.push_back(offsets.back() + rows[i].size());
+    writeArray(file, sections[isection++], offsets);
+    const Binary::BinarySection& section = sections[isection++];
+    POLY_ASSERT(section.elementSize == sizeof(T) and section.count == offsets.back());
+    pad(file, section.offset);
+    for (unsigned i = 0; i != rows.size(); ++i) {
+      if (not rows[i].empty())
+        file.write(reinterpret_cast<const char*>(&rows[i][0]), rows[i].size()*sizeof(T));
+    }
+  }
+};
+
+}
+
+#endif
@@ -577,6 +577,7 @@ adoptOrphans(const vector<RealType>& points,
 // Explicit instantiation
 //------------------------------------------------------------------------------
 template class BoostOrphanage<double>;
+template class BoostOrphanage<float>;
 
 } //end polytope namespace
 
@@ -24,6 +24,7 @@
 #include "Segment.hh"
 
 #include "RegisterBoostPolygonTypes.hh"
+#include "timingUtilities.hh"
 
 // Fast predicate for determining colinearity of points.
 extern double orient2d(double* pa, double* pb, double* pc);
@@ -84,9 +85,12 @@ tessellateQuantized(QuantizedTessellation& result) const {
 
   // Invoke the Boost.Voronoi diagram constructor
   VD voronoi;
+  ScopedTimer timer("delaunay");
   construct_voronoi(generators.begin(), generators.end(),
                     // bounds.begin(), bounds.end(),
                     &voronoi);  
+  timer.stop();
+  ScopedTimer walkTimer("voronoiWalk");
   // POLY_ASSERT(voronoi.num_cells() == numGenerators + result.guardGenerators.size());
 
   // Read out the Voronoi topology to our intermediate QuantizedTessellation format.
@@ -176,5 +180,6 @@ tessellateQuantized(QuantizedTessellation& result) const {
 // Explicit instantiation.
 //------------------------------------------------------------------------------
 template class BoostTessellator<double>;
+template class BoostTessellator<float>;
 
 } //end polytope namespace
@@ -26,8 +26,10 @@ template<typename RealType>
 class BoostTessellator: public Tessellator<2, RealType> {
 public:
 
-  // The Boost.Polygon Voronoi diagram
-  typedef boost::polygon::voronoi_diagram<RealType> VD;
+  // The Boost.Polygon Voronoi diagram.  Boost only provides the robust
+  // vertex comparisons in double, and we round the vertices back onto the
+  // integer lattice anyway, so this is double whatever RealType is.
+  typedef boost::polygon::voronoi_diagram<double> VD;
 
   // Some useful typedefs
   typedef int                 CoordHash;
@@ -49,6 +51,9 @@ public:
   // The name of the tessellator
   std::string name() const { return "BoostTessellator"; }
 
+  // Boost.Voronoi keeps no global state.
+  bool threadSafe() const { return true; }
+
   //! Returns the accuracy to which this tessellator can distinguish coordinates.
   //! Should be returned appropriately for normalized coordinates, i.e., if all
   //! coordinates are in the range xi \in [0,1], what is the minimum allowed 
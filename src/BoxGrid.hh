@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+// Integer bounding boxes binned on a uniform grid, so we can find the ones
+// meeting a given box without looking at them all.  The clipping uses these
+// to find the cells, orphans and boundary facets near one another.
+//
+// Boxes which only touch count as meeting.  An id may be inserted again with
+// a new box, in which case its old bins are ignored.
+//------------------------------------------------------------------------------
+#ifndef __polytope_BoxGrid__
+#define __polytope_BoxGrid__
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <stdint.h>
+#include "polytope_internal.hh"
+
+namespace polytope {
+namespace internal {
+
+template<int nDim, typename IntType>
+class BoxGrid {
+public:
+
+  struct Box {
+    int64_t low[nDim], high[nDim];
+    Box() {
+      std::fill(low, low + nDim, std::numeric_limits<int64_t>::max());
+      std::fill(high, high + nDim, std::numeric_limits<int64_t>::min());
+    }
+
+    // Grow the box to take in a point with coordinates p[0], ..., p[nDim-1].
+    template<typename PointType>
+    void expand(const PointType& p) {
+      for (unsigned j = 0; j != nDim; ++j) {
+        low[j] = std::min(low[j], int64_t(p[j]));
+        high[j] = std::max(high[j], int64_t(p[j]));
+      }
+    }
+    void grow(const int64_t dx) {
+      for (unsigned j = 0; j != nDim; ++j) {
+        low[j] -= dx;
+        high[j] += dx;
+      }
+    }
+    bool meets(const Box& other) const {
+      for (unsigned j = 0; j != nDim; ++j) {
+        if (high[j] < other.low[j] or other.high[j] < low[j]) return false;
+      }
+      return true;
+    }
+  };
+
+  // The bin size should be about the size of a cell.
+  explicit BoxGrid(const int64_t binSize):
+    mBinSize(std::max(int64_t(1), binSize)),
+    mBoxes(),
+    mBins() {}
+
+  void insert(const unsigned id, const Box& box) {
+    if (id >= mBoxes.size()) mBoxes.resize(id + 1);
+    mBoxes[id] = box;
+    int64_t first[nDim], last[nDim], index[nDim];
+    binRange(box, first, last);
+    std::copy(first, first + nDim, index);
+    do {
+      mBins[binKey(index)].push_back(id);
+    } while (nextBin(first, last, index));
+  }
+
+  const Box& box(const unsigned id) const {
+    POLY_ASSERT(id < mBoxes.size());
+    return mBoxes[id];
+  }
+
+  // The ids whose boxes meet box, in increasing order.
+  void query(const Box& box, std::vector<unsigned>& ids) const {
+    ids.clear();
+    int64_t first[nDim], last[nDim], index[nDim];
+    binRange(box, first, last);
+    std::copy(first, first + nDim, index);
+    do {
+      typename std::unordered_map<uint64_t, std::vector<unsigned> >::const_iterator itr = mBins.find(binKey(index));
+      if (itr == mBins.end()) continue;
+      for (unsigned m = 0; m != itr->second.size(); ++m) {
+        if (box.meets(mBoxes[itr->second[m]])) ids.push_back(itr->second[m]);
+      }
+    } while (nextBin(first, last, index));
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+  }
+
+private:
+  int64_t mBinSize;
+  std::vector<Box> mBoxes;
+  std::unordered_map<uint64_t, std::vector<unsigned> > mBins;
+
+  // Each bin index gets an equal share of the bits of the key.
+  static const unsigned keyBits = 64/nDim;
+
+  int64_t bin(const int64_t x) const {
+    return (x >= 0 ? x/mBinSize : -((-x - 1)/mBinSize) - 1);
+  }
+
+  void binRange(const Box& box, int64_t* first, int64_t* last) const {
+    for (unsigned j = 0; j != nDim; ++j) {
+      first[j] = bin(box.low[j]);
+      last[j] = bin(box.high[j]);
+    }
+  }
+
+  // Step to the next bin in [first, last], the first index fastest.
+  static bool nextBin(const int64_t* first, const int64_t* last, int64_t* index) {
+    for (unsigned j = 0; j != nDim; ++j) {
+      if (index[j] < last[j]) {
+        ++index[j];
+        return true;
+      }
+      index[j] = first[j];
+    }
+    return false;
+  }
+
+  static uint64_t binKey(const int64_t* index) {
+    const uint64_t mask = ~uint64_t(0) >> (64 - keyBits);
+    uint64_t result = uint64_t(index[0]) & mask;
+    for (unsigned j = 1; j < nDim; ++j) result = (result << keyBits) | (uint64_t(index[j]) & mask);
+    return result;
+  }
+};
+
+}
+}
+
+#else
+
+namespace polytope {
+namespace internal {
+template<int nDim, typename IntType> class BoxGrid;
+}
+}
+
+#endif
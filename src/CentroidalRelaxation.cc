@@ -0,0 +1,242 @@
+//------------------------------------------------------------------------
+// CentroidalRelaxation
+//------------------------------------------------------------------------
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+
+#include "polytope.hh"
+#include "CentroidalRelaxation.hh"
+#include "computeMeshGeometry.hh"
+
+#ifdef HAVE_MPI
+#include "polytope_parallel_utilities.hh"
+#endif
+
+namespace polytope {
+
+using namespace std;
+
+namespace {
+
+//------------------------------------------------------------------------------
+// Seconds elapsed since start.
+//------------------------------------------------------------------------------
+inline
+double
+secondsSince(const chrono::steady_clock::time_point& start) {
+  return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+}
+
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+CentroidalRelaxation<Dimension, RealType>::
+CentroidalRelaxation(const Tessellator<Dimension, RealType>& tessellator,
+                     const unsigned maxIterations,
+                     const RealType tolerance,
+                     const RealType relaxation):
+  mTessellator(tessellator),
+  mMaxIterations(maxIterations),
+  mTolerance(tolerance),
+  mRelaxation(relaxation),
+  mSpatialSort(HilbertSort),
+  mConverged(false),
+  mDisplacements(),
+  mTessellateTimes(),
+  mCentroidTimes(),
+  mLow(0),
+  mHigh(0),
+  mPLCpoints(0),
+  mPLC(0) {
+  this->relaxation(relaxation);
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+CentroidalRelaxation<Dimension, RealType>::
+~CentroidalRelaxation() {
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+void
+CentroidalRelaxation<Dimension, RealType>::
+relaxation(const RealType x) {
+  if (not (x > 0 and x <= 1)) error("CentroidalRelaxation: relaxation must be in (0, 1].");
+  mRelaxation = x;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+unsigned
+CentroidalRelaxation<Dimension, RealType>::
+relax(vector<RealType>& points,
+      RealType* low,
+      RealType* high,
+      Tessellation<Dimension, RealType>& mesh) {
+  mLow = low;
+  mHigh = high;
+  vector<RealType> corners(low, low + Dimension);
+  corners.insert(corners.end(), high, high + Dimension);
+  const unsigned result = this->iterate(points, corners, mesh);
+  mLow = mHigh = 0;
+  return result;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+unsigned
+CentroidalRelaxation<Dimension, RealType>::
+relax(vector<RealType>& points,
+      const vector<RealType>& PLCpoints,
+      const PLC<Dimension, RealType>& geometry,
+      Tessellation<Dimension, RealType>& mesh) {
+  mPLCpoints = &PLCpoints;
+  mPLC = &geometry;
+  const unsigned result = this->iterate(points, PLCpoints, mesh);
+  mPLCpoints = 0;
+  mPLC = 0;
+  return result;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+unsigned
+CentroidalRelaxation<Dimension, RealType>::
+relax(vector<RealType>& points,
+      const ReducedPLC<Dimension, RealType>& geometry,
+      Tessellation<Dimension, RealType>& mesh) {
+  return this->relax(points, geometry.points, geometry, mesh);
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+unsigned
+CentroidalRelaxation<Dimension, RealType>::
+iterate(vector<RealType>& points,
+        const vector<RealType>& boundaryPoints,
+        Tessellation<Dimension, RealType>& mesh) {
+  POLY_ASSERT(points.size() % Dimension == 0);
+  POLY_ASSERT((mLow != 0 and mHigh != 0) or (mPLCpoints != 0 and mPLC != 0));
+  const unsigned n = points.size()/Dimension;
+  unsigned i, j;
+  mConverged = false;
+  mDisplacements.clear();
+  mTessellateTimes.clear();
+  mCentroidTimes.clear();
+
+  // The length scale displacements are measured against.  The boundary is
+  // the same on every domain, so this is too.
+  RealType xmin[Dimension], xmax[Dimension];
+  geometry::computeBoundingBox<Dimension, RealType>(boundaryPoints, false, xmin, xmax);
+  double length = 0.0;
+  for (j = 0; j != Dimension; ++j) length = max(length, double(xmax[j] - xmin[j]));
+  POLY_ASSERT(length > 0.0);
+  const double tol2 = double(mTolerance)*double(mTolerance)*length*length;
+
+  // Sort the generators once up front and keep them in that order for
+  // every tessellation.
+  const vector<unsigned> order = spatialOrderIndices<Dimension, RealType>(points, mSpatialSort);
+  vector<RealType> generators(points.size()), centroids(points.size());
+  for (i = 0; i != n; ++i) {
+    copy(&points[Dimension*order[i]], &points[Dimension*order[i]] + Dimension, &generators[Dimension*i]);
+  }
+
+  while (true) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    mesh.clear();
+    if (mLow != 0) {
+      mTessellator.tessellate(generators, mLow, mHigh, mesh);
+    } else {
+      mTessellator.tessellate(generators, *mPLCpoints, *mPLC, mesh);
+    }
+    POLY_ASSERT(mesh.cells.size() == n);
+    mTessellateTimes.push_back(secondsSince(start));
+
+    start = chrono::steady_clock::now();
+    double maxDisplacement2 = this->computeCentroids(mesh, generators, centroids);
+#ifdef HAVE_MPI
+    if (this->distributed()) {
+      const MPI_Comm comm = dynamic_cast<const DistributedTessellator<Dimension, RealType>&>(mTessellator).communicator();
+      maxDisplacement2 = allReduce(maxDisplacement2, MPI_MAX, comm);
+    }
+#endif
+    mDisplacements.push_back(sqrt(maxDisplacement2)/length);
+
+    // Stop before moving anything, so the mesh always matches the generators.
+    mConverged = (maxDisplacement2 <= tol2);
+    const bool done = (mConverged or mDisplacements.size() > mMaxIterations);
+    if (not done) {
+      const RealType w = mRelaxation;
+#pragma omp parallel for schedule(static)
+      for (int k = 0; k < int(generators.size()); ++k) {
+        generators[k] += w*(centroids[k] - generators[k]);
+      }
+    }
+    mCentroidTimes.push_back(secondsSince(start));
+    if (done) break;
+  }
+
+  // Hand back the generators and cells in the caller's order.
+  for (i = 0; i != n; ++i) {
+    copy(&generators[Dimension*i], &generators[Dimension*i] + Dimension, &points[Dimension*order[i]]);
+  }
+  if (mSpatialSort != NoSpatialSort) restoreSpatialOrder(order, mesh);
+  return mDisplacements.size();
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+double
+CentroidalRelaxation<Dimension, RealType>::
+computeCentroids(const Tessellation<Dimension, RealType>& mesh,
+                 const vector<RealType>& generators,
+                 vector<RealType>& centroids) const {
+  const int n = mesh.cells.size();
+  vector<RealType> volumes;
+  computeMeshGeometry(mesh, volumes, centroids);
+  double result = 0.0;
+#pragma omp parallel for schedule(static) reduction(max:result)
+  for (int i = 0; i < n; ++i) {
+    double d2 = 0.0;
+    for (unsigned j = 0; j != Dimension; ++j) {
+      const double dx = double(centroids[Dimension*i + j]) - double(generators[Dimension*i + j]);
+      d2 += dx*dx;
+    }
+    result = max(result, d2);
+  }
+  return result;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+bool
+CentroidalRelaxation<Dimension, RealType>::
+distributed() const {
+#ifdef HAVE_MPI
+  return dynamic_cast<const DistributedTessellator<Dimension, RealType>*>(&mTessellator) != 0;
+#else
+  return false;
+#endif
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Explicit instantiation
+//------------------------------------------------------------------------------
+template class CentroidalRelaxation<2, double>;
+template class CentroidalRelaxation<3, double>;
+template class CentroidalRelaxation<2, float>;
+template class CentroidalRelaxation<3, float>;
+
+}
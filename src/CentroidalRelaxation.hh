@@ -0,0 +1,123 @@
+//----------------------------------------------------------------------------//
+// CentroidalRelaxation
+//
+// Drives a set of generators toward a centroidal Voronoi tessellation (CVT)
+// by Lloyd iteration: tessellate, move each generator toward the centroid of
+// its cell, and repeat until the generators stop moving.
+//
+// Any Tessellator may be used.  With a DistributedTessellator each domain
+// relaxes its own generators and the convergence test is reduced across all
+// domains, so every domain takes the same number of iterations.
+//----------------------------------------------------------------------------//
+#ifndef POLYTOPE_CENTROIDALRELAXATION_HH
+#define POLYTOPE_CENTROIDALRELAXATION_HH
+
+#include <vector>
+
+#include "polytope.hh"
+#include "spatialOrderIndices.hh"
+
+namespace polytope {
+
+template<int Dimension, typename RealType>
+class CentroidalRelaxation {
+
+  //--------------------------- Public Interface ---------------------------//
+public:
+
+  //! Constructor.
+  //! \param tessellator The Tessellator used for each iteration.
+  //! \param maxIterations The maximum number of times the generators are moved.
+  //! \param tolerance Stop once no generator moves further than this fraction
+  //!                  of the size of the boundary in an iteration.
+  //! \param relaxation The fraction of the way each generator is moved toward
+  //!                   its cell centroid per iteration (1 is plain Lloyd).
+  CentroidalRelaxation(const Tessellator<Dimension, RealType>& tessellator,
+                       const unsigned maxIterations = 100,
+                       const RealType tolerance = RealType(1.0e-4),
+                       const RealType relaxation = RealType(1.0));
+  ~CentroidalRelaxation();
+
+  //! Relax the generators inside the box specified by \a low and \a high.
+  //! On return points holds the relaxed generators (in the caller's order)
+  //! and mesh their tessellation.  Returns the number of tessellations done.
+  unsigned relax(std::vector<RealType>& points,
+                 RealType* low,
+                 RealType* high,
+                 Tessellation<Dimension, RealType>& mesh);
+
+  //! Relax the generators inside the given PLC.
+  unsigned relax(std::vector<RealType>& points,
+                 const std::vector<RealType>& PLCpoints,
+                 const PLC<Dimension, RealType>& geometry,
+                 Tessellation<Dimension, RealType>& mesh);
+
+  //! Relax the generators inside the given ReducedPLC.
+  unsigned relax(std::vector<RealType>& points,
+                 const ReducedPLC<Dimension, RealType>& geometry,
+                 Tessellation<Dimension, RealType>& mesh);
+
+  // Convergence parameters.
+  unsigned maxIterations() const { return mMaxIterations; }
+  void maxIterations(const unsigned x) { mMaxIterations = x; }
+  RealType tolerance() const { return mTolerance; }
+  void tolerance(const RealType x) { mTolerance = x; }
+  RealType relaxation() const { return mRelaxation; }
+  void relaxation(const RealType x);
+
+  //! The generators are put in this order once before iterating (default
+  //! HilbertSort), so every tessellation sees them in a cache friendly order
+  //! without sorting them again.
+  SpatialSort spatialSort() const { return mSpatialSort; }
+  void spatialSort(const SpatialSort x) { mSpatialSort = x; }
+
+  // Diagnostics from the last call to relax.  There is one entry per
+  // tessellation in each history.
+  bool converged() const { return mConverged; }
+  unsigned numIterations() const { return mDisplacements.size(); }
+
+  //! The largest distance any generator would have moved to its centroid,
+  //! as a fraction of the boundary size.
+  const std::vector<double>& displacements() const { return mDisplacements; }
+
+  //! Wall clock seconds spent tessellating and computing centroids.
+  const std::vector<double>& tessellateTimes() const { return mTessellateTimes; }
+  const std::vector<double>& centroidTimes() const { return mCentroidTimes; }
+
+  //--------------------------- Private Interface --------------------------//
+private:
+  const Tessellator<Dimension, RealType>& mTessellator;
+  unsigned mMaxIterations;
+  RealType mTolerance, mRelaxation;
+  SpatialSort mSpatialSort;
+  bool mConverged;
+  std::vector<double> mDisplacements, mTessellateTimes, mCentroidTimes;
+
+  // The boundary of the current call to relax.
+  RealType* mLow;
+  RealType* mHigh;
+  const std::vector<RealType>* mPLCpoints;
+  const PLC<Dimension, RealType>* mPLC;
+
+  // Run the iteration against whichever boundary has been set.
+  unsigned iterate(std::vector<RealType>& points,
+                   const std::vector<RealType>& boundaryPoints,
+                   Tessellation<Dimension, RealType>& mesh);
+
+  // Compute the centroid of every cell, returning the largest distance
+  // (squared) from a generator to its centroid.
+  double computeCentroids(const Tessellation<Dimension, RealType>& mesh,
+                          const std::vector<RealType>& generators,
+                          std::vector<RealType>& centroids) const;
+
+  // Is this iteration shared by several domains?
+  bool distributed() const;
+
+  // Forbidden methods.
+  CentroidalRelaxation(const CentroidalRelaxation&);
+  CentroidalRelaxation& operator=(const CentroidalRelaxation&);
+};
+
+}
+
+#endif
@@ -25,6 +25,7 @@
 #include "mortonOrderIndices.hh"
 #include "checkDistributedTessellation.hh"
 #include "PLC_Boost_2d.hh"
+#include "timingUtilities.hh"
 
 #ifndef NDEBUG
 #define DEBUG_MODE true
@@ -65,7 +66,8 @@ outputTessellation(const polytope::Tessellation<Dimension, RealType>& mesh,
                    const string name,
                    const int rank,
                    const vector<RealType>& cellField,
-                   const string cellFieldName) {
+                   const string cellFieldName,
+                   const MPI_Comm comm) {
 #ifdef HAVE_SILO
   POLY_ASSERT(cellField.size() == mesh.cells.size());
   const string meshName = "DEBUG_DistributedTessellator_" + name;
@@ -85,7 +87,7 @@ outputTessellation(const polytope::Tessellation<Dimension, RealType>& mesh,
   cellFields[cellFieldName] = &cf[0];
   cerr << "Writing " << name << " with " << mesh.cells.size() << " cells." << endl;
   polytope::SiloWriter<Dimension, RealType>::write(mesh, fields, fields, fields, cellFields, meshName);
-  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Barrier(comm);
 #endif
 }
 
@@ -99,10 +101,12 @@ template<int Dimension, typename RealType>
 DistributedTessellator<Dimension, RealType>::
 DistributedTessellator(Tessellator<Dimension, RealType>* tessellator,
                        bool assumeControl,
-                       bool buildCommunicationInfo):
+                       bool buildCommunicationInfo,
+                       MPI_Comm communicator):
   mSerialTessellator(tessellator),
   mAssumeControl(assumeControl),
   mBuildCommunicationInfo(buildCommunicationInfo),
+  mComm(communicator),
   mType(unbounded),
   mLow(0),
   mHigh(0),
@@ -196,17 +200,16 @@ computeDistributedTessellation(const vector<RealType>& points,
   typedef KeyTraits::Key Key;
   const bool visIntermediateMeshes = false;
 
-  // Parallel configuration.
+  // Parallel configuration.  The serial tessellators reduce their bounding
+  // boxes over the default communicator, so point that at ours meanwhile.
   int rank, numProcs;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+  MPI_Comm_rank(mComm, &rank);
+  MPI_Comm_size(mComm, &numProcs);
+  CommunicatorScope commScope(mComm);
 
   const unsigned nlocal = points.size() / Dimension;
-
-  // Compute the bounding box for normalizing our coordinates.
   RealType rlow[Dimension], rhigh[Dimension]; //, genLow[Dimension];
-  this->computeBoundingBox(points, rlow, rhigh);
-  
+
   // Copy points to generator vector
   vector<RealType> generators;
   copy(points.begin(), points.end(), back_inserter(generators));
@@ -241,17 +244,19 @@ computeDistributedTessellation(const vector<RealType>& points,
   if (numProcs > 1) {
 
     // Store the collection of sorted neighbor domains
+    ScopedTimer neighborTimer("computeDomainNeighbors");
     mesh.neighborDomains = this->computeDomainNeighbors(points, visIntermediateMeshes);
+    neighborTimer.stop();
 
     POLY_BEGIN_CONTRACT_SCOPE;
     {
       for (unsigned sendProc = 0; sendProc != numProcs; ++sendProc) {
         unsigned numOthers = mesh.neighborDomains.size();
         vector<unsigned> otherNeighbors(mesh.neighborDomains);
-        MPI_Bcast(&numOthers, 1, MPI_UNSIGNED, sendProc, MPI_COMM_WORLD);
+        MPI_Bcast(&numOthers, 1, MPI_UNSIGNED, sendProc, mComm);
         if (numOthers > 0) {
           otherNeighbors.resize(numOthers);
-          MPI_Bcast(&(otherNeighbors.front()), numOthers, MPI_UNSIGNED, sendProc, MPI_COMM_WORLD);
+          MPI_Bcast(&(otherNeighbors.front()), numOthers, MPI_UNSIGNED, sendProc, mComm);
           POLY_ASSERT(rank == sendProc or
                       count(mesh.neighborDomains.begin(), mesh.neighborDomains.end(), sendProc) == 
                       count(otherNeighbors.begin(), otherNeighbors.end(), rank));
@@ -262,50 +267,80 @@ computeDistributedTessellation(const vector<RealType>& points,
 
     // For now we're not going to clever, just send all our generators to our 
     // potential neighbor set.  Pack 'em up.
+    ScopedTimer exchangeTimer("mpiGeneratorExchange");
     vector<char> localBuffer;
     serialize(generators, localBuffer);
     unsigned localBufferSize = localBuffer.size();
+    incrementCounter("mpiBytesSent", uint64_t(localBufferSize)*mesh.neighborDomains.size());
 
-    // Fire off our sends asynchronously.
+    // Post the receives for our neighbors' buffer sizes, then fire off our
+    // sends asynchronously.
+    const unsigned numNeighbors = mesh.neighborDomains.size();
+    vector<unsigned> recvSizes(numNeighbors, 0);
+    vector<MPI_Request> recvRequests(2*numNeighbors, MPI_REQUEST_NULL);
+    for (unsigned idomain = 0; idomain != numNeighbors; ++idomain) {
+      MPI_Irecv(&recvSizes[idomain], 1, MPI_UNSIGNED, mesh.neighborDomains[idomain], 1, mComm, &recvRequests[idomain]);
+    }
     vector<MPI_Request> sendRequests;
-    sendRequests.reserve(2*mesh.neighborDomains.size());
+    sendRequests.reserve(2*numNeighbors);
     for (vector<unsigned>::const_iterator otherItr = mesh.neighborDomains.begin();
          otherItr != mesh.neighborDomains.end();
          ++otherItr) {
       const unsigned otherProc = *otherItr;
       sendRequests.push_back(MPI_Request());
-      MPI_Isend(&localBufferSize, 1, MPI_UNSIGNED, otherProc, 1, MPI_COMM_WORLD, &sendRequests.back());
+      MPI_Isend(&localBufferSize, 1, MPI_UNSIGNED, otherProc, 1, mComm, &sendRequests.back());
       if (localBufferSize > 0) {
         sendRequests.push_back(MPI_Request());
-        MPI_Isend(&localBuffer.front(), localBufferSize, MPI_CHAR, otherProc, 2, MPI_COMM_WORLD, &sendRequests.back());
+        MPI_Isend(&localBuffer.front(), localBufferSize, MPI_CHAR, otherProc, 2, mComm, &sendRequests.back());
       }
     }
-    POLY_ASSERT(sendRequests.size() <= 2*mesh.neighborDomains.size());
+    POLY_ASSERT(sendRequests.size() <= 2*numNeighbors);
 
-    // Get the info from each of our neighbors and append it to the result.
-    // Simultaneously build the mapping of local generator ID to domain.
-    for (vector<unsigned>::const_iterator otherItr = mesh.neighborDomains.begin();
-         otherItr != mesh.neighborDomains.end();
-         ++otherItr) {
-      const unsigned otherProc = *otherItr;
-      unsigned bufSize;
-      MPI_Status recvStatus1, recvStatus2;
-      MPI_Recv(&bufSize, 1, MPI_UNSIGNED, otherProc, 1, MPI_COMM_WORLD, &recvStatus1);
-      if (bufSize > 0) {
-        vector<char> buffer(bufSize, '\0');
-        MPI_Recv(&buffer.front(), bufSize, MPI_CHAR, otherProc, 2, MPI_COMM_WORLD, &recvStatus2);
-        vector<char>::const_iterator itr = buffer.begin();
-        vector<RealType> otherGenerators;
-        deserialize(otherGenerators, itr, buffer.end());
-        POLY_ASSERT(itr == buffer.end());
-        copy(otherGenerators.begin(), otherGenerators.end(), back_inserter(generators));
-        gen2domain.resize(generators.size()/Dimension, otherProc);
+    // Take the neighbors' generators in whatever order they arrive rather
+    // than waiting on each neighbor in turn: as each size comes in post the
+    // receive for its buffer, and unpack each buffer as soon as it lands.
+    // Unpacking is the only work done here; nothing else this rank does
+    // before the tessellation is independent of the remote generators, so
+    // mpiGeneratorWait is latency we don't hide.
+    vector<vector<char> > recvBuffers(numNeighbors);
+    vector<vector<RealType> > otherGenerators(numNeighbors);
+    {
+      ScopedTimer waitTimer("mpiGeneratorWait");
+      while (numNeighbors > 0) {
+        int index;
+        MPI_Status recvStatus;
+        MPI_Waitany(recvRequests.size(), &recvRequests.front(), &index, &recvStatus);
+        if (index == MPI_UNDEFINED) break;
+        if (unsigned(index) < numNeighbors) {
+          if (recvSizes[index] > 0) {
+            recvBuffers[index].resize(recvSizes[index]);
+            MPI_Irecv(&recvBuffers[index].front(), recvSizes[index], MPI_CHAR, mesh.neighborDomains[index], 2,
+                      mComm, &recvRequests[numNeighbors + index]);
+          }
+        } else {
+          const unsigned idomain = index - numNeighbors;
+          vector<char>::const_iterator itr = recvBuffers[idomain].begin();
+          deserialize(otherGenerators[idomain], itr, recvBuffers[idomain].end());
+          POLY_ASSERT(itr == recvBuffers[idomain].end());
+          vector<char>().swap(recvBuffers[idomain]);
+        }
       }
     }
 
+    // Append them to the result in neighbor order, so the cell numbering
+    // doesn't depend on message timing, and build the mapping of generator
+    // ID to domain.
+    for (unsigned idomain = 0; idomain != numNeighbors; ++idomain) {
+      generators.insert(generators.end(), otherGenerators[idomain].begin(), otherGenerators[idomain].end());
+      gen2domain.resize(generators.size()/Dimension, mesh.neighborDomains[idomain]);
+    }
+
     // Make sure all our sends are completed.
-    vector<MPI_Status> sendStatus(sendRequests.size());
-    MPI_Waitall(sendRequests.size(), &sendRequests.front(), &sendStatus.front());
+    if (not sendRequests.empty()) {
+      vector<MPI_Status> sendStatus(sendRequests.size());
+      MPI_Waitall(sendRequests.size(), &sendRequests.front(), &sendStatus.front());
+    }
+    exchangeTimer.stop();
   }
   POLY_ASSERT(gen2domain.size() == generators.size()/Dimension);
 
@@ -325,14 +360,14 @@ computeDistributedTessellation(const vector<RealType>& points,
   
   if (visIntermediateMeshes)
   {
-    outputTessellation(mesh, generators, "fullMesh", rank, vector<RealType>(mesh.cells.size()), "dummy");
+    outputTessellation(mesh, generators, "fullMesh", rank, vector<RealType>(mesh.cells.size()), "dummy", mComm);
   }
 
   // // Blago!
   // {
   //    Tessellation<Dimension, RealType> uMesh;
   //    this->mSerialTessellator->tessellate(generators, uMesh);
-  //    outputTessellation(uMesh, generators, "unboundedFullMesh", rank, vector<RealType>(mesh.cells.size()), "dummy");
+  //    outputTessellation(uMesh, generators, "unboundedFullMesh", rank, vector<RealType>(mesh.cells.size()), "dummy", mComm);
   // }
   // // Blago!
 
@@ -402,7 +437,7 @@ computeDistributedTessellation(const vector<RealType>& points,
     //       cerr << endl;
     //     }
     //   }
-    //   MPI_Barrier(MPI_COMM_WORLD);
+    //   MPI_Barrier(mComm);
     // }
     // // Blago!
 
@@ -423,7 +458,7 @@ computeDistributedTessellation(const vector<RealType>& points,
     //          cerr << "Node " << i << ":  ( " << mesh.nodes[Dimension*i] << " , " << mesh.nodes[Dimension*i+1] << " ) " << endl;
     //       }
     //    }
-    //    MPI_Barrier(MPI_COMM_WORLD);
+    //    MPI_Barrier(mComm);
     // }
     // // Blago!
 
@@ -439,7 +474,7 @@ computeDistributedTessellation(const vector<RealType>& points,
     //       cerr << endl;
     //     }
     //   }
-    //   MPI_Barrier(MPI_COMM_WORLD);
+    //   MPI_Barrier(mComm);
     // }
     // // Blago!
 
@@ -531,213 +566,161 @@ computeDistributedTessellation(const vector<RealType>& points,
   //       cerr << endl;
   //     }
   //   }
-  //   MPI_Barrier(MPI_COMM_WORLD);
+  //   MPI_Barrier(mComm);
   // }
   // // Blago!
 
 
-  // Remove the elements of the tessellation corresponding to
-  // other domains generators, and renumber the resulting elements.
-  vector<unsigned> cellMask(mesh.cells.size(), 1);
-  fill(cellMask.begin() + nlocal, cellMask.end(), 0);
-  deleteCells(mesh, cellMask);
-
-  if (visIntermediateMeshes)
-  {
-    outputTessellation(mesh, generators, "finalMesh", rank, vector<RealType>(mesh.cells.size()), "dummy");
-  }
-
-
-  // Remove any neighbors we don't actually share any info with.
-  unsigned numNeighbors = mesh.neighborDomains.size();
-  for (int i = numNeighbors - 1; i != -1; --i) {
-    if (mesh.sharedNodes[i].size() == 0 and mesh.sharedFaces[i].size() == 0) {
-      // cerr << "Removing neighbor " << i << " of " << numNeighbors << endl;
-      mesh.neighborDomains.erase(mesh.neighborDomains.begin() + i);
-      mesh.sharedNodes.erase(mesh.sharedNodes.begin() + i);
-      mesh.sharedFaces.erase(mesh.sharedFaces.begin() + i);
+  // In parallel we need to make sure the shared nodes are bit perfect the
+  // same: the lowest numbered domain sharing a node sends its coordinates to
+  // the others.  Only the nodes of our own cells survive removing the other
+  // domains' cells below, so we can work out the exchange now and post it
+  // first, letting the messages travel while the cells are removed.
+  const unsigned nNodes0 = mesh.nodes.size()/Dimension;
+  const bool exchangeNodes = (mBuildCommunicationInfo and numProcs > 1);
+  vector<unsigned> localNode, recvSizes, sendSizes;
+  vector<vector<unsigned> > recvNodes;
+  vector<vector<RealType> > recvCoords;
+  list<vector<RealType> > sendCoords;
+  vector<MPI_Request> recvRequests, sendRequests;
+  if (exchangeNodes) {
+    ScopedTimer exchangeTimer("mpiNodeExchange");
+    const unsigned numNeighbors = mesh.neighborDomains.size();
+    POLY_ASSERT(mesh.sharedNodes.size() == numNeighbors and mesh.sharedFaces.size() == numNeighbors);
+
+    // The nodes which will survive.
+    localNode.assign(nNodes0, 0);
+    for (unsigned icell = 0; icell != nlocal; ++icell) {
+      for (vector<int>::const_iterator faceItr = mesh.cells[icell].begin();
+           faceItr != mesh.cells[icell].end();
+           ++faceItr) {
+        const vector<unsigned>& faceNodes = mesh.faces[*faceItr < 0 ? ~(*faceItr) : *faceItr];
+        for (unsigned k = 0; k != faceNodes.size(); ++k) localNode[faceNodes[k]] = 1;
+      }
     }
-  }
-  numNeighbors = mesh.neighborDomains.size();
-
-  // // Blago!
-  // cerr << "2nd communicating with : ";
-  // copy(mesh.neighborDomains.begin(), 
-  //      mesh.neighborDomains.end(), 
-  //      ostream_iterator<unsigned>(cerr, " "));
-  // cerr << endl;
-  // MPI_Barrier(MPI_COMM_WORLD);
-  // // Blago!
-
-  // // Blago!
-  // for (unsigned procID = 0; procID != numProcs; ++procID) {
-  //   if (procID == rank) {
-  //     for (unsigned iproc = 0; iproc != mesh.neighborDomains.size(); ++iproc) {
-  //       cerr << rank << " <-> " << mesh.neighborDomains[iproc] << " : " << mesh.nodes.size()/Dimension << endl;
-  //       cerr << "  Nodes : ";
-  //       copy(mesh.sharedNodes[iproc].begin(), mesh.sharedNodes[iproc].end(), ostream_iterator<unsigned>(cerr, " "));
-  //       cerr << endl;
-  //     }
-  //   }
-  //   MPI_Barrier(MPI_COMM_WORLD);
-  // }
-  // // Blago!
-
-  // In parallel we need to make sure the shared nodes are bit perfect the same.
-  if (numProcs > 1) {
 
     // Figure out which domain owns the shared nodes.
-    const unsigned nNodes = mesh.nodes.size()/Dimension;
-    vector<unsigned> ownNode(nNodes, rank);
+    vector<unsigned> ownNode(nNodes0, rank);
     for (unsigned idomain = 0; idomain != numNeighbors; ++idomain) {
       for (vector<unsigned>::const_iterator itr = mesh.sharedNodes[idomain].begin();
            itr != mesh.sharedNodes[idomain].end();
            ++itr) {
-        POLY_ASSERT(*itr < nNodes);
-        ownNode[*itr] = std::min(ownNode[*itr], mesh.neighborDomains[idomain]);
+        POLY_ASSERT(*itr < nNodes0);
+        if (localNode[*itr] == 1) ownNode[*itr] = std::min(ownNode[*itr], mesh.neighborDomains[idomain]);
       }
     }
 
-    // // Blago!
-    // for (unsigned p = 0; p != numProcs; ++p) {
-    //   if (p == rank) {
-    //     for (unsigned i = 0; i != mesh.nodes.size()/Dimension; ++i) {
-    //       if (abs(mesh.nodes[2*i] - 0.411765) + abs(mesh.nodes[2*i+1] - 0.235294) < 1.0e-5) {
-    //         cerr << "Domain " << rank << " thinks node owned by " << ownNode[i] << endl;
-    //       }
-    //     }
-    //   }
-    //   MPI_Barrier(MPI_COMM_WORLD);
-    // }
-    // // Blago!
-
-    // // Blago!
-    // for (unsigned idomain = 0; idomain != numNeighbors; ++idomain){
-    //    if ((rank == 0 and mesh.neighborDomains[idomain] == 7) or
-    //        (rank == 7 and mesh.neighborDomains[idomain] == 0)) {
-    //       cerr << " shares " << mesh.sharedNodes[idomain].size() 
-    //            << " nodes with " << mesh.neighborDomains[idomain] << endl;
-    //       for (unsigned i=0; i != mesh.sharedNodes[idomain].size(); ++i){
-    //          unsigned inode = mesh.sharedNodes[idomain][i];
-    //          cerr << "   Node " << inode << " @ (" << mesh.nodes[2*inode] 
-    //               << "," << mesh.nodes[2*inode+1] << ")"
-    //               << "  own? " << (ownNode[inode] == rank ? "YES" : "NO") << endl;
-    //       }
-    //    }      
-    // }
-    // MPI_Barrier(MPI_COMM_WORLD);
-    // // Blago!
-
-    // Post the sends for any nodes we own, and note which nodes we expect to receive.
-#ifdef DEBUG_MODE
-    vector<unsigned> bufSizes(numNeighbors, 0);
-#endif
-    list<vector<double> > sendCoords;
-    list<vector<unsigned> > allRecvNodes;
-    vector<MPI_Request> sendRequests;
+    // Post the receives for the nodes we expect, and the sends for any
+    // nodes we own.  Neighbors we won't share anything with once the other
+    // domains' cells are gone don't get any messages.
+    recvNodes.resize(numNeighbors);
+    recvCoords.resize(numNeighbors);
+    recvSizes.assign(numNeighbors, 0);
+    sendSizes.assign(numNeighbors, 0);
+    recvRequests.assign(2*numNeighbors, MPI_REQUEST_NULL);
     sendRequests.reserve(2*numNeighbors);
     for (unsigned idomain = 0; idomain != numNeighbors; ++idomain) {
+      const unsigned otherProc = mesh.neighborDomains[idomain];
       vector<unsigned> sendNodes;
-      allRecvNodes.push_back(vector<unsigned>());
-      vector<unsigned>& recvNodes = allRecvNodes.back();
+      bool shared = not mesh.sharedFaces[idomain].empty();
       for (vector<unsigned>::const_iterator itr = mesh.sharedNodes[idomain].begin();
            itr != mesh.sharedNodes[idomain].end();
            ++itr) {
-        POLY_ASSERT(ownNode[*itr] <= rank);
-        if (ownNode[*itr] == rank) {
-          sendNodes.push_back(*itr);
-        } else if (ownNode[*itr] == mesh.neighborDomains[idomain]) {
-          recvNodes.push_back(*itr);
+        if (localNode[*itr] == 1) {
+          shared = true;
+          POLY_ASSERT(ownNode[*itr] <= rank);
+          if (ownNode[*itr] == rank) {
+            sendNodes.push_back(*itr);
+          } else if (ownNode[*itr] == otherProc) {
+            recvNodes[idomain].push_back(*itr);
+          }
         }
       }
+      if (not shared) continue;
 
-
-      // // Blago!
-      // for (unsigned ii=0; ii<sendNodes.size(); ++ii){
-      //    unsigned inode = sendNodes[ii];
-      //    cerr << "sending node " << inode << " @ (" << mesh.nodes[2*inode] << "," 
-      //         << mesh.nodes[2*inode+1] << ") to processor " << mesh.neighborDomains[idomain] << endl;
-      // }
-      // for (unsigned ii=0; ii<recvNodes.size(); ++ii){
-      //    unsigned inode = recvNodes[ii];
-      //    cerr << "receiving node " << inode << " @ (" << mesh.nodes[2*inode] << "," 
-      //         << mesh.nodes[2*inode+1] << ") from processor " << mesh.neighborDomains[idomain] << endl;
-      // }
-      // // Blago!
-
-
-      // Send any nodes we have for this neighbor.
 #ifdef DEBUG_MODE
-      bufSizes[idomain] = Dimension*sendNodes.size();
+      MPI_Irecv(&recvSizes[idomain], 1, MPI_UNSIGNED, otherProc, 9, mComm, &recvRequests[idomain]);
+      sendSizes[idomain] = Dimension*sendNodes.size();
       sendRequests.push_back(MPI_Request());
-      MPI_Isend(&bufSizes[idomain], 1, MPI_UNSIGNED,
-                mesh.neighborDomains[idomain], 9, MPI_COMM_WORLD, &sendRequests.back());
+      MPI_Isend(&sendSizes[idomain], 1, MPI_UNSIGNED, otherProc, 9, mComm, &sendRequests.back());
 #endif
+      if (recvNodes[idomain].size() > 0) {
+        recvCoords[idomain].resize(Dimension*recvNodes[idomain].size());
+        MPI_Irecv(&recvCoords[idomain].front(), recvCoords[idomain].size(), DataTypeTraits<RealType>::MpiDataType(),
+                  otherProc, 10, mComm, &recvRequests[numNeighbors + idomain]);
+      }
       if (sendNodes.size() > 0) {
         sendCoords.push_back(DimensionTraits<Dimension, RealType>::extractCoords(mesh.nodes, sendNodes));
         vector<RealType>& coords = sendCoords.back();
         POLY_ASSERT(coords.size() == Dimension*sendNodes.size());
+        incrementCounter("mpiBytesSent", sizeof(RealType)*coords.size());
         sendRequests.push_back(MPI_Request());
-        MPI_Isend(&coords.front(), Dimension*sendNodes.size(), DataTypeTraits<RealType>::MpiDataType(),
-                  mesh.neighborDomains[idomain], 10, MPI_COMM_WORLD, &sendRequests.back());
+        MPI_Isend(&coords.front(), coords.size(), DataTypeTraits<RealType>::MpiDataType(),
+                  otherProc, 10, mComm, &sendRequests.back());
       }
     }
     POLY_ASSERT(sendRequests.size() <= 2*numNeighbors);
+  }
 
-    // Iterate over the neighbors again and look for any receive information.
-    list<vector<unsigned> >::const_iterator recvNodesItr = allRecvNodes.begin();
-    for (unsigned idomain = 0; idomain != numNeighbors; ++idomain, ++recvNodesItr) {
-      POLY_ASSERT(recvNodesItr != allRecvNodes.end());
-      const vector<unsigned>& recvNodes = *recvNodesItr;
+  // Remove the elements of the tessellation corresponding to
+  // other domains generators, and renumber the resulting elements.
+  vector<unsigned> cellMask(mesh.cells.size(), 1);
+  fill(cellMask.begin() + nlocal, cellMask.end(), 0);
+  deleteCells(mesh, cellMask);
 
-#ifdef DEBUG_MODE
-      unsigned otherSize;
-      MPI_Status recvStatus;
-      MPI_Recv(&otherSize, 1, MPI_UNSIGNED, mesh.neighborDomains[idomain], 9, MPI_COMM_WORLD, &recvStatus);
-      POLY_ASSERT2(otherSize == Dimension*recvNodes.size(),
-              "Bad message size (" << mesh.neighborDomains[idomain] << " " << otherSize << ") (" << rank << " " << Dimension*recvNodes.size() << ")");
-#endif
+  if (visIntermediateMeshes)
+  {
+    outputTessellation(mesh, generators, "finalMesh", rank, vector<RealType>(mesh.cells.size()), "dummy", mComm);
+  }
 
-      if (recvNodes.size() > 0) {
-        vector<RealType> recvCoords(Dimension*recvNodes.size());
-        MPI_Status recvStatus;
-        MPI_Recv(&recvCoords.front(), Dimension*recvNodes.size(), DataTypeTraits<RealType>::MpiDataType(),
-                 mesh.neighborDomains[idomain], 10, MPI_COMM_WORLD, &recvStatus);
-
-        // // Blago!
-        // if (otherSize != Dimension*recvNodes.size()) {
-        //   cout << "Bad message size from " << mesh.neighborDomains[idomain] << " being sent to " << rank << endl;
-        //   cout << "Other coordinates : ";
-        //   copy(recvCoords.begin(), recvCoords.end(), ostream_iterator<RealType>(cout, " "));
-        //   cout << endl;
-        //   cout << "My coordinates : ";
-        //   for (unsigned j = 0; j != recvNodes.size(); ++j) {
-        //     const unsigned i = recvNodes[j];
-        //     for (unsigned k = 0; k != Dimension; ++k) cout << mesh.nodes[Dimension*i + k] << " ";
-        //   }
-        //   cout << endl;
-        //   POLY_ASSERT(false);
-        // }
-        // // Blago!
-
-        // Unpack the coordinates to the receive nodes.
-        for (unsigned j = 0; j != recvNodes.size(); ++j) {
-          const unsigned i = recvNodes[j];
-          for (unsigned k = 0; k != Dimension; ++k) {
-            mesh.nodes[Dimension*i + k] = recvCoords[Dimension*j + k];
-          }
+  // Unpack the owners' node coordinates as they arrive.  deleteCells keeps
+  // the surviving nodes in order, so their new indices are the running count
+  // of survivors.
+  if (exchangeNodes) {
+    ScopedTimer waitTimer("mpiNodeWait");
+    const unsigned numNeighbors = recvNodes.size();
+    vector<unsigned> old2new(localNode);
+    internal::exclusiveScan(old2new);
+    while (not recvRequests.empty()) {
+      int index;
+      MPI_Status recvStatus;
+      MPI_Waitany(recvRequests.size(), &recvRequests.front(), &index, &recvStatus);
+      if (index == MPI_UNDEFINED) break;
+      if (unsigned(index) < numNeighbors) {
+        POLY_ASSERT2(recvSizes[index] == Dimension*recvNodes[index].size(),
+                     "Bad message size (" << mesh.neighborDomains[index] << " " << recvSizes[index] << ") ("
+                     << rank << " " << Dimension*recvNodes[index].size() << ")");
+      } else {
+        const unsigned idomain = index - numNeighbors;
+        const vector<unsigned>& nodes = recvNodes[idomain];
+        const vector<RealType>& coords = recvCoords[idomain];
+        for (unsigned j = 0; j != nodes.size(); ++j) {
+          POLY_ASSERT(localNode[nodes[j]] == 1);
+          const unsigned i = old2new[nodes[j]];
+          for (unsigned k = 0; k != Dimension; ++k) mesh.nodes[Dimension*i + k] = coords[Dimension*j + k];
         }
       }
     }
 
-    // Wait until all our send are complete.
-    vector<MPI_Status> sendStatus(sendRequests.size());
-    MPI_Waitall(sendRequests.size(), &sendRequests.front(), &sendStatus.front());
+    // Wait until all our sends are complete.
+    if (not sendRequests.empty()) {
+      vector<MPI_Status> sendStatus(sendRequests.size());
+      MPI_Waitall(sendRequests.size(), &sendRequests.front(), &sendStatus.front());
+    }
+
+    // Remove any neighbors we don't actually share any info with.
+    for (int i = numNeighbors - 1; i != -1; --i) {
+      if (mesh.sharedNodes[i].size() == 0 and mesh.sharedFaces[i].size() == 0) {
+        mesh.neighborDomains.erase(mesh.neighborDomains.begin() + i);
+        mesh.sharedNodes.erase(mesh.sharedNodes.begin() + i);
+        mesh.sharedFaces.erase(mesh.sharedFaces.begin() + i);
+      }
+    }
   }
 
   // Post-conditions.
 #ifdef DEBUG_MODE
-  const string msg = checkDistributedTessellation(mesh);
+  const string msg = checkDistributedTessellation(mesh, mComm);
   if (msg != "ok" and rank == 0) cerr << msg;
   POLY_ASSERT(msg == "ok");
 #endif
@@ -823,8 +806,8 @@ computeBoundingBox(const vector<RealType>& points,
 
   // Find the global results.
   for (unsigned j = 0; j != Dimension; ++j) {
-    rlow[j] = allReduce(rlow[j], MPI_MIN, MPI_COMM_WORLD);
-    rhigh[j] = allReduce(rhigh[j], MPI_MAX, MPI_COMM_WORLD);
+    rlow[j] = allReduce(rlow[j], MPI_MIN, mComm);
+    rhigh[j] = allReduce(rhigh[j], MPI_MAX, mComm);
   }
 }
 
@@ -848,8 +831,8 @@ computeDomainNeighbors(const vector<RealType>& points,
 
   // Parallel configuration.
   int rank, numProcs;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+  MPI_Comm_rank(mComm, &rank);
+  MPI_Comm_size(mComm, &numProcs);
   
   // Compute the local bounding box
   RealType rlow[Dimension], rhigh[Dimension];
@@ -914,7 +897,7 @@ computeDomainNeighbors(const vector<RealType>& points,
         POLY_ASSERT(*itr < localMesh.cells.size());
         vis[*itr] = 1.0;
       }
-      outputTessellation(localMesh, points, "localMesh", rank, vis, "visible");
+      outputTessellation(localMesh, points, "localMesh", rank, vis, "visible", mComm);
     }
       
     // Serialize the hull + extra visible points and send to all
@@ -923,9 +906,9 @@ computeDomainNeighbors(const vector<RealType>& points,
     for (unsigned sendProc = 0; sendProc != numProcs; ++sendProc) {
       vector<char> buffer = localBuffer;
       unsigned bufSize = localBuffer.size();
-      MPI_Bcast(&bufSize, 1, MPI_UNSIGNED, sendProc, MPI_COMM_WORLD);
+      MPI_Bcast(&bufSize, 1, MPI_UNSIGNED, sendProc, mComm);
       buffer.resize(bufSize);
-      MPI_Bcast(&buffer.front(), bufSize, MPI_CHAR, sendProc, MPI_COMM_WORLD);
+      MPI_Bcast(&buffer.front(), bufSize, MPI_CHAR, sendProc, mComm);
       vector<char>::const_iterator itr = buffer.begin();
       ConvexHull newHull;
       deserialize(newHull, itr, buffer.end());
@@ -985,7 +968,7 @@ computeDomainNeighbors(const vector<RealType>& points,
       const unsigned procOwner = bisectSearch(domainCellOffset, i);
       owner[i] = RealType(procOwner);
     }
-    outputTessellation(visibleMesh, allVisibleGenerators, "visibleMesh", rank, owner, "domainOwner");
+    outputTessellation(visibleMesh, allVisibleGenerators, "visibleMesh", rank, owner, "domainOwner", mComm);
   }
 
 
@@ -1040,5 +1023,7 @@ computeDomainNeighbors(const vector<RealType>& points,
 //------------------------------------------------------------------------------
 template class DistributedTessellator<2, double>;
 template class DistributedTessellator<3, double>;
+template class DistributedTessellator<2, float>;
+template class DistributedTessellator<3, float>;
 
 }
@@ -15,6 +15,8 @@
 #ifndef __Polytope_DistributedTessellator__
 #define __Polytope_DistributedTessellator__
 
+#include "mpi.h"
+
 #include "Tessellator.hh"
 
 namespace polytope {
@@ -30,9 +32,14 @@ public:
   //! \param serialTessellator A serial implementation of Tessellator.
   //! \param assumeControl If set to true, the DistributedTessellator will 
   //!                      assume control of the serial tessellator.
+  //! \param communicator The ranks sharing the tessellation.  Every
+  //!                     collective runs on this communicator, so disjoint
+  //!                     communicators (see splitCommunicator) can each
+  //!                     tessellate their own problem at the same time.
   DistributedTessellator(Tessellator<Dimension, RealType>* serialTessellator,
                          bool assumeControl = true,
-                         bool buildCommunicationInfo = false);
+                         bool buildCommunicationInfo = false,
+                         MPI_Comm communicator = MPI_COMM_WORLD);
   virtual ~DistributedTessellator();
 
   // Note the DistributedTesselator doesn't know which of the boundary treatments
@@ -114,6 +121,9 @@ public:
   //! delta in x.
   virtual RealType degeneracy() const { return mSerialTessellator->degeneracy(); }
 
+  //! The communicator the tessellation is distributed over.
+  MPI_Comm communicator() const { return mComm; }
+
 protected:
   // Define an enum to keep track of which type of tessellation is currently
   // being called.
@@ -126,6 +136,7 @@ protected:
   // Private data.
   Tessellator<Dimension, RealType>* mSerialTessellator;
   bool mAssumeControl, mBuildCommunicationInfo;
+  MPI_Comm mComm;
   mutable TessellationType mType;
   mutable RealType *mLow, *mHigh;
   mutable const std::vector<RealType>* mPLCpointsPtr;
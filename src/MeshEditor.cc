@@ -3,14 +3,51 @@
 //------------------------------------------------------------------------
 #include <limits>
 #include <numeric>
+#include <stdint.h>
 
 #include "polytope.hh"
 #include "MeshEditor.hh"
+#include "polytope_thread_utilities.hh"
+
+#ifdef HAVE_MPI
+#include "polytope_parallel_utilities.hh"
+#endif
 
 namespace polytope {
 
 using namespace std;
 
+namespace {
+
+//------------------------------------------------------------------------------
+// Pack the edge between two nodes into a single sortable key, with the
+// smaller node index in the high word.
+//------------------------------------------------------------------------------
+inline
+uint64_t
+edgeKey(const unsigned i, const unsigned j) {
+  POLY_ASSERT(i != j);
+  return (i < j ? (uint64_t(i) << 32) | j : (uint64_t(j) << 32) | i);
+}
+
+//------------------------------------------------------------------------------
+// Look up the index of the edge between two nodes, given the sorted unique
+// edge keys and the edge index of each.
+//------------------------------------------------------------------------------
+inline
+unsigned
+findEdge(const vector<uint64_t>& edgeKeys,
+         const vector<unsigned>& keyToEdge,
+         const unsigned i,
+         const unsigned j) {
+  const uint64_t key = edgeKey(i, j);
+  vector<uint64_t>::const_iterator itr = lower_bound(edgeKeys.begin(), edgeKeys.end(), key);
+  POLY_ASSERT(itr != edgeKeys.end() and *itr == key);
+  return keyToEdge[itr - edgeKeys.begin()];
+}
+
+}
+
 //------------------------------------------------------------------------------
 template<int Dimension, typename RealType>
 MeshEditor<Dimension, RealType>::
@@ -53,7 +90,19 @@ template<int Dimension, typename RealType>
 void
 MeshEditor<Dimension, RealType>::
 deleteFaces(const std::vector<unsigned>& facesToDelete) {
-  POLY_ASSERT2(false, "This routine is currently not implemented");  
+  // Pre-conditions
+  POLY_ASSERT2(!facesToDelete.empty(), "No faces specified by deletion");
+  const unsigned nfaces = mMesh.faces.size();
+  mFaceMask = std::vector<unsigned>(nfaces, 1);
+  for (std::vector<unsigned>::const_iterator itr = facesToDelete.begin();
+       itr != facesToDelete.end(); ++itr) {
+    POLY_ASSERT(*itr < nfaces);
+    mFaceMask[*itr] = 0;
+  }
+  computeMasks();
+  cleanMesh();
+  // Post-conditions
+  POLY_ASSERT(mCellMask.empty() and mFaceMask.empty() and mNodeMask.empty());
 }
 //------------------------------------------------------------------------------
 
@@ -62,7 +111,19 @@ template<int Dimension, typename RealType>
 void
 MeshEditor<Dimension, RealType>::
 deleteNodes(const std::vector<unsigned>& nodesToDelete) {
-  POLY_ASSERT2(false, "This routine is currently not implemented");
+  // Pre-conditions
+  POLY_ASSERT2(!nodesToDelete.empty(), "No nodes specified by deletion");
+  const unsigned nnodes = mMesh.nodes.size()/Dimension;
+  mNodeMask = std::vector<unsigned>(nnodes, 1);
+  for (std::vector<unsigned>::const_iterator itr = nodesToDelete.begin();
+       itr != nodesToDelete.end(); ++itr) {
+    POLY_ASSERT(*itr < nnodes);
+    mNodeMask[*itr] = 0;
+  }
+  computeMasks();
+  cleanMesh();
+  // Post-conditions
+  POLY_ASSERT(mCellMask.empty() and mFaceMask.empty() and mNodeMask.empty());
 }
 //------------------------------------------------------------------------------
 
@@ -108,139 +169,155 @@ flagEdgesForCleaning(const RealType edgeTol,
   const unsigned ncells0 = mMesh.cells.size();
   const unsigned nfaces0 = mMesh.faces.size();
   const unsigned nnodes0 = mMesh.nodes.size()/Dimension;
-
-  // Map edges to a mesh ID, compute maximum edge lengths per cell, and map cells
-  // to edges
-  // //EdgeMap edgeToID;
-  map<EdgeType, int> edgeToIndex;
-  map<int, EdgeType> indexToEdge;
-  map<unsigned, vector<unsigned> > cellToEdges, borderNodesToBorderFaces;
-  set<unsigned> borderNodes;
-  vector<RealType> edgeLength;
-  RealType length;
+  const unsigned none = numeric_limits<unsigned>::max();
   unsigned inode0, inode1;
-  // //int edgeCount = 0;
+
+  // The edges of each face in CSR form: face i owns the entries
+  // [faceEdgeOffsets[i], faceEdgeOffsets[i+1]) of faceEdges.  In 2D a face
+  // is its own single edge.
+  vector<unsigned> faceEdgeOffsets(nfaces0 + 1, 0);
+  for (unsigned iface = 0; iface != nfaces0; ++iface) {
+    const unsigned nfaceNodes = mMesh.faces[iface].size();
+    POLY_ASSERT(nfaceNodes >= 2);
+    faceEdgeOffsets[iface] = (nfaceNodes == 2) ? 1 : nfaceNodes;
+  }
+  const unsigned nfaceEdges = internal::exclusiveScan(faceEdgeOffsets);
+  vector<pair<uint64_t, unsigned> > keys(nfaceEdges);
+#pragma omp parallel for schedule(static)
+  for (int iface = 0; iface < int(nfaces0); ++iface) {
+    const vector<unsigned>& faceNodes = mMesh.faces[iface];
+    const unsigned nfaceNodes = faceNodes.size();
+    for (unsigned k = faceEdgeOffsets[iface]; k != faceEdgeOffsets[iface + 1]; ++k) {
+      const unsigned j = k - faceEdgeOffsets[iface];
+      POLY_ASSERT(faceNodes[j] < nnodes0 and faceNodes[(j + 1) % nfaceNodes] < nnodes0);
+      keys[k] = make_pair(edgeKey(faceNodes[j], faceNodes[(j + 1) % nfaceNodes]), k);
+    }
+  }
+
+  // Sort the packed edge keys to find the unique edges.  For now faceEdges
+  // holds the position of each edge among the sorted unique keys.
+  sort(keys.begin(), keys.end());
+  vector<uint64_t> edgeKeys;
+  vector<unsigned> faceEdges(nfaceEdges);
+  for (unsigned k = 0; k != nfaceEdges; ++k) {
+    if (k == 0 or keys[k].first != keys[k - 1].first) edgeKeys.push_back(keys[k].first);
+    faceEdges[keys[k].second] = edgeKeys.size() - 1;
+  }
+  vector<pair<uint64_t, unsigned> >().swap(keys);
+  const unsigned nedges0 = edgeKeys.size();
+
+  // Number the edges in the order they are first met walking the faces of
+  // each cell.  The greedy choice of edges to collapse below depends on this
+  // order, so keep it.  Along the way pick up the border nodes, and the
+  // border faces around each of them (again in CSR form).
+  vector<unsigned> keyToEdge(nedges0, none), borderFaceCounts(nnodes0 + 1, 0);
+  unsigned nedges = 0;
   for (unsigned icell = 0; icell != ncells0; ++icell) {
-    vector<unsigned> cellEdgeIDs;
     for (vector<int>::const_iterator itr = mMesh.cells[icell].begin();
-	 itr != mMesh.cells[icell].end(); ++itr) {
-      const unsigned iface = (*itr < 0) ? ~(*itr) : *itr;
-      POLY_ASSERT(iface < mMesh.faces.size());
-      const unsigned nfaceNodes = mMesh.faces[iface].size();
-      POLY_ASSERT(nfaceNodes >= 2);
+         itr != mMesh.cells[icell].end(); ++itr) {
+      const unsigned iface = internal::positiveID(*itr);
+      POLY_ASSERT(iface < nfaces0);
       const unsigned nfaceCells = mMesh.faceCells[iface].size();
       POLY_ASSERT(nfaceCells == 1 or nfaceCells == 2);
       if (nfaceCells == 1) {
-        for (std::vector<unsigned>::iterator nodeItr = mMesh.faces[iface].begin();
-             nodeItr != mMesh.faces[iface].end(); ++nodeItr) {
-          borderNodes.insert(*nodeItr);
-          borderNodesToBorderFaces[*nodeItr].push_back(iface);
-        }
+        for (vector<unsigned>::const_iterator nodeItr = mMesh.faces[iface].begin();
+             nodeItr != mMesh.faces[iface].end(); ++nodeItr) ++borderFaceCounts[*nodeItr];
       }
-      const unsigned maxNodeIndex = (nfaceNodes == 2) ? 1 : nfaceNodes;
-      for (unsigned inode = 0; inode != maxNodeIndex; ++inode) {
-        inode0 = mMesh.faces[iface][inode];
-        inode1 = mMesh.faces[iface][(inode+1) % nfaceNodes];
-        POLY_ASSERT(inode0 != inode1);
-        POLY_ASSERT(inode0 < mMesh.nodes.size()/Dimension and
-                    inode1 < mMesh.nodes.size()/Dimension);
-        const EdgeType edge = internal::hashEdge(inode0, inode1);
-        const unsigned nedges = edgeToIndex.size();
-        // const int iedge = internal::addKeyToMap<EdgeType,internal::pairCompare<unsigned, unsigned> >(edge, edgeToIndex);
-        const int iedge = internal::addKeyToMap(edge, edgeToIndex);
-        if (iedge == nedges) {
-           indexToEdge[iedge] = edge;
-           length = geometry::distance<Dimension, RealType>
-              (&mMesh.nodes[Dimension*inode0], &mMesh.nodes[Dimension*inode1]);
-           edgeLength.push_back(length);
+      for (unsigned k = faceEdgeOffsets[iface]; k != faceEdgeOffsets[iface + 1]; ++k) {
+        if (keyToEdge[faceEdges[k]] == none) keyToEdge[faceEdges[k]] = nedges++;
+      }
+    }
+  }
+  POLY_ASSERT(nedges == nedges0);
+  vector<unsigned> borderFaceOffsets(borderFaceCounts);
+  vector<unsigned> borderFaces(internal::exclusiveScan(borderFaceOffsets));
+  fill(borderFaceCounts.begin(), borderFaceCounts.end(), 0);
+  for (unsigned icell = 0; icell != ncells0; ++icell) {
+    for (vector<int>::const_iterator itr = mMesh.cells[icell].begin();
+         itr != mMesh.cells[icell].end(); ++itr) {
+      const unsigned iface = internal::positiveID(*itr);
+      if (mMesh.faceCells[iface].size() == 1) {
+        for (vector<unsigned>::const_iterator nodeItr = mMesh.faces[iface].begin();
+             nodeItr != mMesh.faces[iface].end(); ++nodeItr) {
+          borderFaces[borderFaceOffsets[*nodeItr] + borderFaceCounts[*nodeItr]++] = iface;
         }
-        cellEdgeIDs.push_back(iedge);
-
-        // // typename EdgeMap::left_const_iterator lItr = edgeToID.left.find(edge);
-	// // if (lItr == edgeToID.left.end()) {
-	// //   edgeToID.insert(typename EdgeMap::value_type(edge, edgeCount));
-	// //   length = geometry::distance<Dimension, RealType>
-	// //     (&mMesh.nodes[Dimension*inode0], &mMesh.nodes[Dimension*inode1]);
-	// //   edgeLength.push_back(length);
-	// //   cellEdgeIDs.push_back(edgeCount);
-	// //   ++edgeCount;
-	// // } else {
-	// //   cellEdgeIDs.push_back(lItr->second);
-	// // }
       }
     }
-    cellToEdges[icell] = cellEdgeIDs;
   }
-  POLY_ASSERT(edgeToIndex.size() == edgeLength.size());
-  POLY_ASSERT(cellToEdges.size() == ncells0);
-  POLY_ASSERT(edgeToIndex.size() == indexToEdge.size());
-  const unsigned nedges0 = edgeToIndex.size();
-
-  // Create a simple lookup for the border nodes. Also create a lookup
-  // for corner nodes: nodes corresponding to 
-  set<unsigned> cornerNodes;
-  // vector<unsigned> isBorderNode(nnodes0, 0), isCornerNode(nnodes0, 0);
-  for (set<unsigned>::const_iterator nodeItr = borderNodes.begin();
-       nodeItr != borderNodes.end(); 
-       ++nodeItr) {
-    POLY_ASSERT(*nodeItr < nnodes0);
-    // isBorderNode[*nodeItr] = 1;
-    vector<unsigned> borderFaces = borderNodesToBorderFaces[*nodeItr];
-    POLY_ASSERT(borderFaces.size() == 2);
-    vector<unsigned> otherNodes;
-    for (vector<unsigned>::const_iterator faceItr = borderFaces.begin();
-         faceItr != borderFaces.end();
-         ++faceItr) {
-      const unsigned iface = *faceItr;
-      POLY_ASSERT(iface < mMesh.faces.size());
-      POLY_ASSERT(mMesh.faceCells[iface].size() == 1);
-      POLY_ASSERT(mMesh.faces[iface].size() == 2);
-      const unsigned otherNode = (mMesh.faces[iface][0] == *nodeItr) ?
-         mMesh.faces[iface][1] : mMesh.faces[iface][0];
-      otherNodes.push_back(otherNode);
+
+  // Renumber the face edges, unpack the edge nodes, and measure the edges.
+  vector<unsigned> edgeNodes(2*nedges0);
+  vector<RealType> edgeLength(nedges0);
+#pragma omp parallel for schedule(static)
+  for (int k = 0; k < int(nfaceEdges); ++k) faceEdges[k] = keyToEdge[faceEdges[k]];
+#pragma omp parallel for schedule(static)
+  for (int i = 0; i < int(nedges0); ++i) {
+    const unsigned iedge = keyToEdge[i];
+    const unsigned n0 = unsigned(edgeKeys[i] >> 32);
+    const unsigned n1 = unsigned(edgeKeys[i] & 0xffffffffu);
+    edgeNodes[2*iedge    ] = n0;
+    edgeNodes[2*iedge + 1] = n1;
+    edgeLength[iedge] = geometry::distance<Dimension, RealType>
+      (&mMesh.nodes[Dimension*n0], &mMesh.nodes[Dimension*n1]);
+  }
+
+  // Flag the border nodes, and the corner nodes among them: border nodes
+  // whose two border faces are not collinear.
+  vector<char> isBorderNode(nnodes0, 0), isCornerNode(nnodes0, 0);
+#pragma omp parallel for schedule(static)
+  for (int i = 0; i < int(nnodes0); ++i) {
+    const unsigned k0 = borderFaceOffsets[i];
+    if (borderFaceOffsets[i + 1] > k0) {
+      POLY_ASSERT(borderFaceOffsets[i + 1] - k0 == 2);
+      isBorderNode[i] = 1;
+      unsigned otherNodes[2];
+      for (unsigned k = 0; k != 2; ++k) {
+        const unsigned iface = borderFaces[k0 + k];
+        POLY_ASSERT(mMesh.faceCells[iface].size() == 1);
+        POLY_ASSERT(mMesh.faces[iface].size() == 2);
+        otherNodes[k] = (mMesh.faces[iface][0] == unsigned(i)) ? mMesh.faces[iface][1] : mMesh.faces[iface][0];
+      }
+      const bool collinear =
+        geometry::collinear<Dimension, RealType>(&mMesh.nodes[Dimension*i],
+                                                 &mMesh.nodes[Dimension*otherNodes[0]],
+                                                 &mMesh.nodes[Dimension*otherNodes[1]],
+                                                 1.0e-8);
+      if (not collinear) isCornerNode[i] = 1;
     }
-    POLY_ASSERT(otherNodes.size() == 2);
-    
-    const bool collinear = 
-       geometry::collinear<Dimension, RealType>(&mMesh.nodes[2*(*nodeItr)],
-                                                &mMesh.nodes[2*otherNodes[0]],
-                                                &mMesh.nodes[2*otherNodes[1]],
-                                                1.0e-8);
-    if (not collinear) cornerNodes.insert(*nodeItr);// isCornerNode[*nodeItr] = 1;
   }
-  
+
   // Compute the maximum edge length for the cells around an edge
+  vector<RealType> maxCellEdge(ncells0, 0.0);
+#pragma omp parallel for schedule(static)
+  for (int icell = 0; icell < int(ncells0); ++icell) {
+    for (vector<int>::const_iterator itr = mMesh.cells[icell].begin();
+         itr != mMesh.cells[icell].end(); ++itr) {
+      const unsigned iface = internal::positiveID(*itr);
+      for (unsigned k = faceEdgeOffsets[iface]; k != faceEdgeOffsets[iface + 1]; ++k) {
+        maxCellEdge[icell] = max(maxCellEdge[icell], edgeLength[faceEdges[k]]);
+      }
+    }
+  }
   vector<RealType> maxCellEdgeLength(nedges0, 0.0);
   for (unsigned icell = 0; icell != ncells0; ++icell) {
-    RealType maxCellEdge = 0.0;
-    vector<unsigned> edgeIDs = cellToEdges[icell];
-    for (vector<unsigned>::const_iterator itr = edgeIDs.begin();
-	 itr != edgeIDs.end();
-	 ++itr) maxCellEdge = max(maxCellEdge, edgeLength[*itr]);
-    for (vector<unsigned>::const_iterator itr = edgeIDs.begin();
-	 itr != edgeIDs.end();
-	 ++itr) maxCellEdgeLength[*itr] = max(maxCellEdgeLength[*itr], maxCellEdge);
+    for (vector<int>::const_iterator itr = mMesh.cells[icell].begin();
+         itr != mMesh.cells[icell].end(); ++itr) {
+      const unsigned iface = internal::positiveID(*itr);
+      for (unsigned k = faceEdgeOffsets[iface]; k != faceEdgeOffsets[iface + 1]; ++k) {
+        maxCellEdgeLength[faceEdges[k]] = max(maxCellEdgeLength[faceEdges[k]], maxCellEdge[icell]);
+      }
+    }
   }
   
   // Flag the edges we want to remove.
   vector<unsigned> edgeMask(nedges0, 1);
   vector<unsigned> nodeCollapse(nnodes0);
-  EdgeType edge;
   mNodeMask = vector<unsigned>(nnodes0, 1);
   for (unsigned i = 0; i != nnodes0; ++i) nodeCollapse[i] = i;
   for (unsigned iedge = 0; iedge != nedges0; ++iedge) {
-    POLY_ASSERT(indexToEdge.find(iedge) != indexToEdge.end());
-    edge = indexToEdge[iedge];
-
-    // // typename EdgeMap::right_const_iterator itr = edgeToID.right.find(iedge);
-    // // POLY_ASSERT(itr != edgeToID.right.end());
-    // // edge = itr->second;
-
-    inode0 = edge.first;
-    inode1 = edge.second;
-    const bool cornerEdge = (cornerNodes.find(inode0) != cornerNodes.end() or
-                             cornerNodes.find(inode1) != cornerNodes.end());
-                            //(isCornerNode[inode0] == 0 or isCornerNode[inode1] == 0));
+    inode0 = edgeNodes[2*iedge];
+    inode1 = edgeNodes[2*iedge + 1];
+    const bool cornerEdge = (isCornerNode[inode0] == 1 or isCornerNode[inode1] == 1);
     const bool cleanTest = (edgeLength[iedge] < edgeTol*maxCellEdgeLength[iedge] and
                             mNodeMask[inode0] == 1 and 
                             mNodeMask[inode1] == 1 and
@@ -248,11 +325,8 @@ flagEdgesForCleaning(const RealType edgeTol,
     if (cleanTest) {
       edgesClean = false;
       edgeMask[iedge] = 0;
-      const bool node1KeepTest = //isCornerNode[inode1] == 1 or 
-         (cornerNodes.find(inode1) != cornerNodes.end()) or
-         (borderNodes.find(inode1) != borderNodes.end() and
-          borderNodes.find(inode0) == borderNodes.end());
-         //(isBorderNode[inode1] == 1 and isBorderNode[inode0] == 0);
+      const bool node1KeepTest = (isCornerNode[inode1] == 1 or
+                                  (isBorderNode[inode1] == 1 and isBorderNode[inode0] == 0));
       unsigned keepNode   = node1KeepTest ? inode1 : inode0;
       unsigned deleteNode = node1KeepTest ? inode0 : inode1;
       mNodeMask[keepNode  ] = 2;
@@ -260,14 +334,14 @@ flagEdgesForCleaning(const RealType edgeTol,
       nodeCollapse[deleteNode] = keepNode;
     }
   }
-  replace_if(mNodeMask.begin(), mNodeMask.end(), bind2nd(equal_to<unsigned>(), 2), 1);
+  replace(mNodeMask.begin(), mNodeMask.end(), 2U, 1U);
 
   
 #ifdef HAVE_MPI
   // Parallel configuration.
   int rank, numProcs;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+  MPI_Comm_rank(defaultCommunicator(), &rank);
+  MPI_Comm_size(defaultCommunicator(), &numProcs);
 
   // TODO: Put in an all-reduced switch based on the edgesClean flag. After all, if
   //       all processors have clean mesh, why bother communicating?
@@ -307,17 +381,10 @@ flagEdgesForCleaning(const RealType edgeTol,
       domainNodeMaps[ineighbor] = nodeIndexToSharePosition;
 
       // Consider all edges on this domain. The shared ones consist of two shared nodes.
-      for (typename map<EdgeType, int>::const_iterator edgeItr = edgeToIndex.begin();
-           edgeItr != edgeToIndex.end();
-           ++edgeItr) {
-
-      // // for (typename EdgeMap::left_const_iterator edgeItr = edgeToID.left.begin();
-      // //      edgeItr != edgeToID.left.end(); ++edgeItr) {
-
-        const EdgeType edge  = edgeItr->first;
-        const unsigned iedge = edgeItr->second;
-        inode0 = edge.first;
-        inode1 = edge.second;
+      for (unsigned i = 0; i != nedges0; ++i) {
+        const unsigned iedge = keyToEdge[i];
+        inode0 = edgeNodes[2*iedge];
+        inode1 = edgeNodes[2*iedge + 1];
         POLY_ASSERT(inode0 < inode1);
         POLY_ASSERT(inode0 < mMesh.nodes.size()/Dimension and
                     inode1 < mMesh.nodes.size()/Dimension);
@@ -362,15 +429,7 @@ flagEdgesForCleaning(const RealType edgeTol,
         inode1 = mMesh.sharedNodes[ineighbor][ind1];
         POLY_ASSERT(inode0 < mMesh.nodes.size()/Dimension and
                     inode1 < mMesh.nodes.size()/Dimension);
-        const EdgeType edge = internal::hashEdge(inode0, inode1);
-
-        typename map<EdgeType, int>::const_iterator itr = edgeToIndex.find(edge);
-        POLY_ASSERT(itr != edgeToIndex.end());
-        
-        // // typename EdgeMap::left_const_iterator itr = edgeToID.left.find(edge);
-        // // POLY_ASSERT(itr != edgeToID.left.end());
-
-        const unsigned iedge = itr->second;
+        const unsigned iedge = findEdge(edgeKeys, keyToEdge, inode0, inode1);
         POLY_ASSERT(iedge < nedges0);
         sharedEdgeMask[ineighbor][edgeCount] = edgeMask[iedge];
       }
@@ -388,10 +447,10 @@ flagEdgesForCleaning(const RealType edgeTol,
       unsigned localBufferSize = localBuffer.size();
       const unsigned otherProc = *otherItr;
       sendRequests.push_back(MPI_Request());
-      MPI_Isend(&localBufferSize, 1, MPI_UNSIGNED, otherProc, 1, MPI_COMM_WORLD, &sendRequests.back());
+      MPI_Isend(&localBufferSize, 1, MPI_UNSIGNED, otherProc, 1, defaultCommunicator(), &sendRequests.back());
       if (localBufferSize > 0) {
         sendRequests.push_back(MPI_Request());
-        MPI_Isend(&localBuffer.front(), localBufferSize, MPI_CHAR, otherProc, 2, MPI_COMM_WORLD, &sendRequests.back());
+        MPI_Isend(&localBuffer.front(), localBufferSize, MPI_CHAR, otherProc, 2, defaultCommunicator(), &sendRequests.back());
       }
     }
     POLY_ASSERT(sendRequests.size() <= 2*mMesh.neighborDomains.size());
@@ -404,10 +463,10 @@ flagEdgesForCleaning(const RealType edgeTol,
       const unsigned otherProc = *otherItr;
       unsigned bufSize;
       MPI_Status recvStatus1, recvStatus2;
-      MPI_Recv(&bufSize, 1, MPI_UNSIGNED, otherProc, 1, MPI_COMM_WORLD, &recvStatus1);
+      MPI_Recv(&bufSize, 1, MPI_UNSIGNED, otherProc, 1, defaultCommunicator(), &recvStatus1);
       if (bufSize > 0) {
         vector<char> buffer(bufSize, '\0');
-        MPI_Recv(&buffer.front(), bufSize, MPI_CHAR, otherProc, 2, MPI_COMM_WORLD, &recvStatus2);
+        MPI_Recv(&buffer.front(), bufSize, MPI_CHAR, otherProc, 2, defaultCommunicator(), &recvStatus2);
         vector<char>::const_iterator itr = buffer.begin();
         vector<unsigned> otherEdgeMask;
         deserialize(otherEdgeMask, itr, buffer.end());
@@ -434,14 +493,7 @@ flagEdgesForCleaning(const RealType edgeTol,
         inode1 = mMesh.sharedNodes[i][ind1];
         POLY_ASSERT(inode0 < mMesh.nodes.size()/Dimension and
                     inode1 < mMesh.nodes.size()/Dimension);
-        const EdgeType edge = internal::hashEdge(inode0, inode1);
-        typename map<EdgeType, int>::const_iterator itr = edgeToIndex.find(edge);
-        POLY_ASSERT(itr != edgeToIndex.end());
-
-        // // typename EdgeMap::left_const_iterator itr = edgeToID.left.find(edge);
-        // // POLY_ASSERT(itr != edgeToID.left.end());
-
-        const unsigned iedge = itr->second;
+        const unsigned iedge = findEdge(edgeKeys, keyToEdge, inode0, inode1);
         POLY_ASSERT(iedge < nedges0);
         //POLY_ASSERT(edgeCount < neighborEdgeMasks[i].size());
         edgeMask[iedge] = max(edgeMask[iedge], neighborEdgeMasks[i][edgeCount]);
@@ -458,17 +510,10 @@ flagEdgesForCleaning(const RealType edgeTol,
     if (!edgesClean) {
       for (unsigned i = 0; i != nnodes0; ++i) nodeCollapse[i] = i;
       for (unsigned iedge = 0; iedge != nedges0; ++iedge) {
-        typename map<int, EdgeType>::const_iterator itr = indexToEdge.find(iedge);
-        POLY_ASSERT(itr != indexToEdge.end());
-
-        // // typename EdgeMap::right_const_iterator itr = edgeToID.right.find(iedge);
-        // // POLY_ASSERT(itr != edgeToID.right.end());
-
         if (edgeMask[iedge] == 0) {
-          const EdgeType edge = itr->second;
           const bool isShared = (sharedEdgeReverse[iedge].size() == 0) ? false : true;
-          inode0 = edge.first;
-          inode1 = edge.second;
+          inode0 = edgeNodes[2*iedge];
+          inode1 = edgeNodes[2*iedge + 1];
           const bool node0Shared = (sharedNodeReverse[inode0].size() == 0) ? false : true;
           const bool node1Shared = (sharedNodeReverse[inode1].size() == 0) ? false : true;
 
@@ -481,11 +526,11 @@ flagEdgesForCleaning(const RealType edgeTol,
             const unsigned ineighbor = sharedEdgeReverse[iedge][0];
             const unsigned ind0 = domainNodeMaps[ineighbor][inode0];
             const unsigned ind1 = domainNodeMaps[ineighbor][inode1];
-            if (ind1 < ind0) {inode0 = edge.second; inode1 = edge.first;}
+            if (ind1 < ind0) swap(inode0, inode1);
           }
 
           else if (node1Shared and !node0Shared) {
-             inode0 = edge.second; inode1 = edge.first;
+             swap(inode0, inode1);
           }
 
           mNodeMask[inode1] = 0;
@@ -508,25 +553,12 @@ flagEdgesForCleaning(const RealType edgeTol,
   // (Really only for 3D tessellations since edges=faces in 2D.)
   mFaceMask = std::vector<unsigned>(nfaces0, 1);
   if (!edgesClean) {
-    unsigned numActiveEdges;
-    for (unsigned iface = 0; iface != nfaces0; ++iface) {
-      numActiveEdges = 0;
-      const unsigned maxNodeIndex = (mMesh.faces[iface].size() == 2) ? 1 : mMesh.faces[iface].size();
-      for (unsigned inode = 0; inode != maxNodeIndex; ++inode) {
-        inode0 = mMesh.faces[iface][inode];
-        inode1 = mMesh.faces[iface][(inode+1) % mMesh.faces[iface].size()];
-        const EdgeType edge = internal::hashEdge(inode0, inode1);
-        typename map<EdgeType, int>::const_iterator itr = edgeToIndex.find(edge);
-        POLY_ASSERT(itr != edgeToIndex.end());
-	numActiveEdges += edgeMask[itr->second];
+#pragma omp parallel for schedule(static)
+    for (int iface = 0; iface < int(nfaces0); ++iface) {
+      unsigned numActiveEdges = 0;
+      for (unsigned k = faceEdgeOffsets[iface]; k != faceEdgeOffsets[iface + 1]; ++k) {
+        numActiveEdges += edgeMask[faceEdges[k]];
       }
-
-      // // Blago!
-      // cerr << "Face " << iface << ": " 
-      //      << "Num active edges = " << numActiveEdges << ": "
-      //      << (numActiveEdges >= minEdgesPerFace ? "KEEP!" : "EXTERMINATE!") << endl;
-      // // Blago!
-     
       if( numActiveEdges < minEdgesPerFace) mFaceMask[iface] = 0;
     }
   }
@@ -589,30 +621,23 @@ cleanMesh() {
   // Pre-conditions
   POLY_ASSERT(!mCellMask.empty() and !mFaceMask.empty() and !mNodeMask.empty());
 
-  // Original mesh sizes
-  const unsigned ncells0 = mMesh.cells.size();
-  const unsigned nfaces0 = mMesh.faces.size();
-  const unsigned nnodes0 = mMesh.nodes.size()/Dimension;
-
-  // Determine the new cell, face, and node numberings.
-  unsigned nnodes1 = 0, nfaces1 = 0, ncells1 = 0;
-  std::vector<unsigned> nodeMap(nnodes0), faceMap(nfaces0), cellMap(ncells0);
-  for (unsigned i = 0; i != nnodes0; ++i) {
-    nodeMap[i] = nnodes1;
-    if (mNodeMask[i] == 1) nnodes1++;
-  }
-  for (unsigned i = 0; i != nfaces0; ++i) {
-    faceMap[i] = nfaces1;
-    if (mFaceMask[i] == 1) nfaces1++;
-  }
-  for (unsigned i = 0; i != ncells0; ++i) {
-    if (mCellMask[i] == 1) cellMap[i] = ncells1++;
+  // Determine the new cell, face, and node numberings.  Deleted nodes map to
+  // nothing, so cleanMesh drops them from the faces that used them.
+  std::vector<unsigned> cellMap(mCellMask), faceMap(mFaceMask), nodeMap(mNodeMask);
+  const unsigned ncells1 = internal::exclusiveScan(cellMap);
+  const unsigned nfaces1 = internal::exclusiveScan(faceMap);
+  const unsigned nnodes1 = internal::exclusiveScan(nodeMap);
+  for (unsigned i = 0; i != nodeMap.size(); ++i) {
+    if (mNodeMask[i] == 0) nodeMap[i] = numeric_limits<unsigned>::max();
   }
 
   // Post-conditions
-  POLY_ASSERT(std::accumulate(mNodeMask.begin(), mNodeMask.end(), 0) == nnodes1);
-  POLY_ASSERT(std::accumulate(mFaceMask.begin(), mFaceMask.end(), 0) == nfaces1);
-  POLY_ASSERT(std::accumulate(mCellMask.begin(), mCellMask.end(), 0) == ncells1);
+  POLY_ASSERT(std::accumulate(mNodeMask.begin(), mNodeMask.end(), 0U) == nnodes1);
+  POLY_ASSERT(std::accumulate(mFaceMask.begin(), mFaceMask.end(), 0U) == nfaces1);
+  POLY_ASSERT(std::accumulate(mCellMask.begin(), mCellMask.end(), 0U) == ncells1);
+  POLY_CONTRACT_VAR(ncells1);
+  POLY_CONTRACT_VAR(nfaces1);
+  POLY_CONTRACT_VAR(nnodes1);
 
   cleanMesh(cellMap, faceMap, nodeMap);
 }
@@ -631,112 +656,128 @@ cleanMesh(std::vector<unsigned>& cellMap,
   POLY_ASSERT(!mCellMask.empty() and !mFaceMask.empty() and !mNodeMask.empty());
 
   // Original mesh sizes
-  const unsigned ncells0 = mMesh.cells.size();
-  const unsigned nfaces0 = mMesh.faces.size();
-  const unsigned nnodes0 = mMesh.nodes.size()/Dimension;
-  const unsigned ncells1 = std::accumulate(mCellMask.begin(), mCellMask.end(), 0);
-  const unsigned nfaces1 = std::accumulate(mFaceMask.begin(), mFaceMask.end(), 0);
-  const unsigned nnodes1 = std::accumulate(mNodeMask.begin(), mNodeMask.end(), 0);
-  
-  // // Count repeated node IDs to figure out which node positions need averaging
-  // internal::CounterMap<unsigned> nodeCount;
-  // for (unsigned i = 0; i != nnodes0; ++i)  ++nodeCount[nodeMap[i]];
-
-  // // Reconstruct the nodes.
-  // std::vector<RealType> newNodes(Dimension*nnodes1, 0.0);
-  // for (unsigned i = 0; i != nnodes0; ++i) {
-  //   const unsigned newID = nodeMap[i];
-  //   POLY_ASSERT(nodeCount[newID] == 1 or nodeCount[newID] == 2);
-  //   if (1) {//nodeCount[newID] == 1) {
-  //     for (unsigned j = 0; j != Dimension; ++j) 
-  //       newNodes[Dimension*newID+j] = mMesh.nodes[Dimension*i+j];
-  //   } else {
-  //     for (unsigned j = 0; j != Dimension; ++j)
-  //       newNodes[Dimension*newID+j] += 0.5*mMesh.nodes[Dimension*i+j];
-  //   }
-  // }
-  // mMesh.nodes = newNodes;
-  
-  std::vector<RealType> newNodes;
-  newNodes.reserve(Dimension*nnodes1);
-  for (unsigned i = 0; i != nnodes0; ++i) {
-    if (mNodeMask[i] == 1) {
-      std::copy(&mMesh.nodes[Dimension*i], &mMesh.nodes[Dimension*(i+1)], back_inserter(newNodes));
-    }
-  }
-  mMesh.nodes = newNodes;
-
-  // Reconstruct the faces.
-  std::vector<std::vector<unsigned> > newFaces;
-  std::vector<std::vector<int> > newFaceCells;
-  newFaces.reserve(nfaces1);
-  newFaceCells.reserve(nfaces1);
-  for (unsigned i = 0; i != nfaces0; ++i) {
+  const int ncells0 = mMesh.cells.size();
+  const int nfaces0 = mMesh.faces.size();
+  const int nnodes0 = mMesh.nodes.size()/Dimension;
+  const unsigned ncells1 = std::accumulate(mCellMask.begin(), mCellMask.end(), 0U);
+  const unsigned nfaces1 = std::accumulate(mFaceMask.begin(), mFaceMask.end(), 0U);
+  const unsigned nnodes1 = std::accumulate(mNodeMask.begin(), mNodeMask.end(), 0U);
+  const unsigned none = numeric_limits<unsigned>::max();
+  POLY_ASSERT(cellMap.size() == unsigned(ncells0) and
+              faceMap.size() == unsigned(nfaces0) and
+              nodeMap.size() == unsigned(nnodes0));
+
+  // Renumber the surviving faces and cells where they sit.  A node mapped to
+  // nothing is dropped from the faces, while a collapsed node is mapped onto
+  // the node it collapsed to.
+#pragma omp parallel for schedule(static)
+  for (int i = 0; i < nfaces0; ++i) {
     if (mFaceMask[i] == 1) {
-      newFaces.push_back(mMesh.faces[i]);
-      for (std::vector<unsigned>::iterator itr = newFaces.back().begin();
-           itr != newFaces.back().end(); 
-           ++itr) {
-         //POLY_ASSERT(nodeMap.find(*itr) != nodeMap.end());
-        *itr = nodeMap[*itr];
+      std::vector<unsigned>& faceNodes = mMesh.faces[i];
+      unsigned n = 0;
+      for (unsigned k = 0; k != faceNodes.size(); ++k) {
+        POLY_ASSERT(faceNodes[k] < unsigned(nnodes0));
+        if (nodeMap[faceNodes[k]] != none) faceNodes[n++] = nodeMap[faceNodes[k]];
       }
-      POLY_ASSERT(mMesh.faceCells[i].size() == 1 or
-		  mMesh.faceCells[i].size() == 2);
-      newFaceCells.push_back(std::vector<int>());
-      unsigned fc = (mMesh.faceCells[i][0] < 0 ? ~mMesh.faceCells[i][0] : mMesh.faceCells[i][0]);
-      if (mCellMask[fc] == 1) newFaceCells.back().push_back(mMesh.faceCells[i][0] < 0 ?
-                                                           ~cellMap[fc] :
-                                                           cellMap[fc]);
-      if (mMesh.faceCells[i].size() == 2) {
-        fc = (mMesh.faceCells[i][1] < 0 ? ~mMesh.faceCells[i][1] : mMesh.faceCells[i][1]);
-        if (mCellMask[fc] == 1) newFaceCells.back().push_back(mMesh.faceCells[i][1] < 0 ?
-                                                              ~cellMap[fc] :
-                                                              cellMap[fc]);
+      faceNodes.resize(n);
+      std::vector<int>& fcells = mMesh.faceCells[i];
+      POLY_ASSERT(fcells.size() == 1 or fcells.size() == 2);
+      n = 0;
+      for (unsigned k = 0; k != fcells.size(); ++k) {
+        const int fc = internal::positiveID(fcells[k]);
+        if (mCellMask[fc] == 1) fcells[n++] = (fcells[k] < 0 ? ~int(cellMap[fc]) : int(cellMap[fc]));
       }
-      POLY_ASSERT(newFaceCells.back().size() == 1 or
-		  newFaceCells.back().size() == 2);
+      fcells.resize(n);
+      POLY_ASSERT(fcells.size() == 1 or fcells.size() == 2);
     }
   }
-  mMesh.faces = newFaces;
-  mMesh.faceCells = newFaceCells;
-  
-
-  // Reconstruct the cells.  
-  std::vector<std::vector<int> > newCells;
-  newCells.resize(ncells1);
-  for (unsigned i = 0; i != ncells0; ++i) {
+#pragma omp parallel for schedule(static)
+  for (int i = 0; i < ncells0; ++i) {
     if (mCellMask[i] == 1) {
-      for (std::vector<int>::iterator itr = mMesh.cells[i].begin();
-           itr != mMesh.cells[i].end();
-           ++itr) {
-        const int iface = (*itr < 0 ? ~(*itr) : *itr);
-        //POLY_ASSERT(faceMap.find(iface) != faceMap.end());
-        if (mFaceMask[iface] == 1) {
-          // int newFace = (*itr >= 0 ? faceMap[iface] : ~faceMap[iface]);
-          newCells[i].push_back( *itr < 0 ? ~faceMap[iface] : faceMap[iface]);
-        }
+      std::vector<int>& cellFaces = mMesh.cells[i];
+      unsigned n = 0;
+      for (unsigned k = 0; k != cellFaces.size(); ++k) {
+        const int iface = internal::positiveID(cellFaces[k]);
+        if (mFaceMask[iface] == 1) cellFaces[n++] = (cellFaces[k] < 0 ? ~int(faceMap[iface]) : int(faceMap[iface]));
       }
+      cellFaces.resize(n);
     }
   }
-  mMesh.cells = newCells;  
+
+  // Compact everything in place.  Surviving elements only ever move down.
+  for (int i = 0; i < nnodes0; ++i) {
+    if (mNodeMask[i] == 1 and nodeMap[i] != unsigned(i)) {
+      POLY_ASSERT(nodeMap[i] < unsigned(i));
+      std::copy(&mMesh.nodes[Dimension*i], &mMesh.nodes[Dimension*i] + Dimension,
+                &mMesh.nodes[Dimension*nodeMap[i]]);
+    }
+  }
+  mMesh.nodes.resize(Dimension*nnodes1);
+  for (int i = 0; i < nfaces0; ++i) {
+    if (mFaceMask[i] == 1 and faceMap[i] != unsigned(i)) {
+      mMesh.faces[faceMap[i]].swap(mMesh.faces[i]);
+      mMesh.faceCells[faceMap[i]].swap(mMesh.faceCells[i]);
+    }
+  }
+  mMesh.faces.resize(nfaces1);
+  mMesh.faceCells.resize(nfaces1);
+  for (int i = 0; i < ncells0; ++i) {
+    if (mCellMask[i] == 1 and cellMap[i] != unsigned(i)) {
+      mMesh.cells[cellMap[i]].swap(mMesh.cells[i]);
+    }
+  }
+  mMesh.cells.resize(ncells1);
 
   // Update the shared nodes and faces.
   const unsigned numNeighbors = mMesh.sharedNodes.size();
   POLY_ASSERT(mMesh.sharedFaces.size() == numNeighbors);
   for (unsigned idomain = 0; idomain != numNeighbors; ++idomain) {
-    std::vector<unsigned> newNodes, newFaces;
-    for (std::vector<unsigned>::iterator itr = mMesh.sharedNodes[idomain].begin();
-         itr != mMesh.sharedNodes[idomain].end();
-         ++itr) {
-      if (mNodeMask[*itr] == 1) newNodes.push_back(nodeMap[*itr]);
+    std::vector<unsigned>& sharedNodes = mMesh.sharedNodes[idomain];
+    std::vector<unsigned>& sharedFaces = mMesh.sharedFaces[idomain];
+    unsigned n = 0;
+    for (unsigned k = 0; k != sharedNodes.size(); ++k) {
+      if (mNodeMask[sharedNodes[k]] == 1) sharedNodes[n++] = nodeMap[sharedNodes[k]];
+    }
+    sharedNodes.resize(n);
+    n = 0;
+    for (unsigned k = 0; k != sharedFaces.size(); ++k) {
+      if (mFaceMask[sharedFaces[k]] == 1) sharedFaces[n++] = faceMap[sharedFaces[k]];
+    }
+    sharedFaces.resize(n);
+  }
+
+  // Same for the periodic faces and their shifts.
+  {
+    POLY_ASSERT(mMesh.periodicFaceShifts.size() == Dimension*mMesh.periodicFaces.size());
+    unsigned n = 0;
+    for (unsigned k = 0; k != mMesh.periodicFaces.size(); ++k) {
+      const unsigned iface = mMesh.periodicFaces[k];
+      if (mFaceMask[iface] == 1 and mMesh.faceCells[faceMap[iface]].size() == 2) {
+        mMesh.periodicFaces[n] = faceMap[iface];
+        std::copy(&mMesh.periodicFaceShifts[Dimension*k], &mMesh.periodicFaceShifts[Dimension*k] + Dimension,
+                  &mMesh.periodicFaceShifts[Dimension*n]);
+        ++n;
+      }
+    }
+    mMesh.periodicFaces.resize(n);
+    mMesh.periodicFaceShifts.resize(Dimension*n);
+  }
+
+  // If the mesh knew its boundary, recompute it: removing elements can
+  // expose new boundary faces as well as delete old ones.
+  if (!mMesh.boundaryFaces.empty() or !mMesh.boundaryNodes.empty()) {
+    std::vector<unsigned> boundaryNodeMask(nnodes1, 0);
+    mMesh.boundaryFaces.clear();
+    for (unsigned i = 0; i != nfaces1; ++i) {
+      if (mMesh.faceCells[i].size() == 1) {
+        mMesh.boundaryFaces.push_back(i);
+        for (unsigned k = 0; k != mMesh.faces[i].size(); ++k) boundaryNodeMask[mMesh.faces[i][k]] = 1;
+      }
     }
-    for (std::vector<unsigned>::iterator itr = mMesh.sharedFaces[idomain].begin();
-         itr != mMesh.sharedFaces[idomain].end();
-         ++itr) {
-      if (mFaceMask[*itr] == 1) newFaces.push_back(faceMap[*itr]);
+    mMesh.boundaryNodes.clear();
+    for (unsigned i = 0; i != nnodes1; ++i) {
+      if (boundaryNodeMask[i] == 1) mMesh.boundaryNodes.push_back(i);
     }
-    mMesh.sharedNodes[idomain] = newNodes;
-    mMesh.sharedFaces[idomain] = newFaces;
   }
 
   // If there was a convex hull in the mesh, it's probably no longer valid.
@@ -790,34 +831,27 @@ void
 MeshEditor<Dimension, RealType>::
 computeFaceAndNodeMasks() {
   // Pre-conditions.
-  const unsigned ncells0 = mMesh.cells.size();
-  const unsigned nfaces0 = mMesh.faces.size();
+  const int ncells0 = mMesh.cells.size();
+  const int nfaces0 = mMesh.faces.size();
   const unsigned nnodes0 = mMesh.nodes.size()/Dimension;
-  POLY_ASSERT(mCellMask.size() == ncells0);
+  POLY_ASSERT(mCellMask.size() == unsigned(ncells0));
   POLY_ASSERT(mFaceMask.empty() and mNodeMask.empty());
   POLY_ASSERT(ncells0 == 0 or *max_element(mCellMask.begin(), mCellMask.end()) == 1);
+  POLY_CONTRACT_VAR(ncells0);
 
-  // Create masks for the nodes and faces.
+  // A face survives if either of its cells does, and a node if any
+  // surviving face uses it.
   mFaceMask = std::vector<unsigned>(nfaces0, 0);
   mNodeMask = std::vector<unsigned>(nnodes0, 0);
-  for (unsigned icell = 0; icell != ncells0; ++icell) {
-    if (mCellMask[icell] == 1) {
-      for (std::vector<int>::const_iterator faceItr = mMesh.cells[icell].begin();
-           faceItr != mMesh.cells[icell].end();
-           ++faceItr) {
-        const unsigned iface = (*faceItr >= 0 ? *faceItr : ~(*faceItr));
-        POLY_ASSERT(iface < nfaces0);
-        mFaceMask[iface] = 1;
-        for (std::vector<unsigned>::const_iterator nodeItr = mMesh.faces[iface].begin();
-             nodeItr != mMesh.faces[iface].end();
-             ++nodeItr) {
-          const unsigned inode = *nodeItr;
-          POLY_ASSERT(inode < nnodes0);
-          mNodeMask[inode] = 1;
-        }
-      }
+#pragma omp parallel for schedule(static)
+  for (int iface = 0; iface < nfaces0; ++iface) {
+    const std::vector<int>& fcells = mMesh.faceCells[iface];
+    for (unsigned k = 0; k != fcells.size(); ++k) {
+      POLY_ASSERT(internal::positiveID(fcells[k]) < ncells0);
+      if (mCellMask[internal::positiveID(fcells[k])] == 1) mFaceMask[iface] = 1;
     }
   }
+  flagNodesOfFaces();
 }
 //------------------------------------------------------------------------------
 
@@ -828,8 +862,17 @@ void
 MeshEditor<Dimension, RealType>::
 computeCellAndNodeMasks() {
   // Pre-conditions.
+  const int nfaces0 = mMesh.faces.size();
+  const unsigned nnodes0 = mMesh.nodes.size()/Dimension;
   POLY_ASSERT(mCellMask.empty() and mNodeMask.empty());
-  POLY_ASSERT2(false, "Not currently implemented");
+  POLY_ASSERT(mFaceMask.size() == unsigned(nfaces0));
+  POLY_CONTRACT_VAR(nfaces0);
+
+  // A node survives if any surviving face uses it, and a cell if any of its
+  // faces survive.
+  mNodeMask = std::vector<unsigned>(nnodes0, 0);
+  flagNodesOfFaces();
+  flagCellsOfFaces();
 }
 //------------------------------------------------------------------------------
 
@@ -840,8 +883,77 @@ void
 MeshEditor<Dimension, RealType>::
 computeCellAndFaceMasks() {
   // Pre-conditions.
+  const int nfaces0 = mMesh.faces.size();
+  const unsigned nnodes0 = mMesh.nodes.size()/Dimension;
   POLY_ASSERT(mCellMask.empty() and mFaceMask.empty());
-  POLY_ASSERT2(false, "Not currently implemented");
+  POLY_ASSERT(mNodeMask.size() == nnodes0);
+
+  // A face survives if it keeps enough nodes to still be a face: both of
+  // them in 2D, three in 3D.
+  const unsigned minNodesPerFace = (Dimension == 2 ? 2 : 3);
+  mFaceMask = std::vector<unsigned>(nfaces0, 0);
+#pragma omp parallel for schedule(static)
+  for (int iface = 0; iface < nfaces0; ++iface) {
+    unsigned n = 0;
+    for (unsigned k = 0; k != mMesh.faces[iface].size(); ++k) {
+      POLY_ASSERT(mMesh.faces[iface][k] < nnodes0);
+      n += mNodeMask[mMesh.faces[iface][k]];
+    }
+    if (n >= minNodesPerFace) mFaceMask[iface] = 1;
+  }
+
+  // Nodes left only on deleted faces go too, and cells go once all their
+  // faces have.
+  const std::vector<unsigned> nodeMask0(mNodeMask);
+  std::fill(mNodeMask.begin(), mNodeMask.end(), 0);
+  flagNodesOfFaces();
+#pragma omp parallel for schedule(static)
+  for (int i = 0; i < int(nnodes0); ++i) mNodeMask[i] *= nodeMask0[i];
+  flagCellsOfFaces();
+}
+//------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+void
+MeshEditor<Dimension, RealType>::
+flagNodesOfFaces() {
+  const int nfaces0 = mMesh.faces.size();
+  POLY_ASSERT(mFaceMask.size() == unsigned(nfaces0));
+  POLY_ASSERT(mNodeMask.size() == mMesh.nodes.size()/Dimension);
+#pragma omp parallel for schedule(static)
+  for (int iface = 0; iface < nfaces0; ++iface) {
+    if (mFaceMask[iface] == 1) {
+      for (unsigned k = 0; k != mMesh.faces[iface].size(); ++k) {
+        const unsigned inode = mMesh.faces[iface][k];
+        POLY_ASSERT(inode < mNodeMask.size());
+#pragma omp atomic write
+        mNodeMask[inode] = 1;
+      }
+    }
+  }
+}
+//------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+void
+MeshEditor<Dimension, RealType>::
+flagCellsOfFaces() {
+  const int ncells0 = mMesh.cells.size();
+  POLY_ASSERT(mFaceMask.size() == mMesh.faces.size());
+  mCellMask = std::vector<unsigned>(ncells0, 0);
+#pragma omp parallel for schedule(static)
+  for (int icell = 0; icell < ncells0; ++icell) {
+    for (unsigned k = 0; k != mMesh.cells[icell].size(); ++k) {
+      if (mFaceMask[internal::positiveID(mMesh.cells[icell][k])] == 1) {
+        mCellMask[icell] = 1;
+        break;
+      }
+    }
+  }
 }
 //------------------------------------------------------------------------------
 
@@ -851,12 +963,16 @@ computeCellAndFaceMasks() {
 //------------------------------------------------------------------------------
 template<> unsigned MeshEditor<2, double>::minEdgesPerFace = 1;
 template<> unsigned MeshEditor<3, double>::minEdgesPerFace = 3;
+template<> unsigned MeshEditor<2, float>::minEdgesPerFace = 1;
+template<> unsigned MeshEditor<3, float>::minEdgesPerFace = 3;
 
 //------------------------------------------------------------------------------
 // Explicit instantiation
 //------------------------------------------------------------------------------
 template class MeshEditor<2, double>;
 template class MeshEditor<3, double>;
+template class MeshEditor<2, float>;
+template class MeshEditor<3, float>;
   
 }// end polytope namespace
 
@@ -1113,8 +1229,8 @@ flagBoundaryEdgesForCleaning(const RealType edgeTol,
 #ifdef HAVE_MPI
   // Parallel configuration.
   int rank, numProcs;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+  MPI_Comm_rank(defaultCommunicator(), &rank);
+  MPI_Comm_size(defaultCommunicator(), &numProcs);
 
   // TODO: Put in an all-reduced switch based on the edgesClean flag. After all, if
   //       all processors have clean mesh, why bother communicating?
@@ -1211,10 +1327,10 @@ flagBoundaryEdgesForCleaning(const RealType edgeTol,
       unsigned localBufferSize = localBuffer.size();
       const unsigned otherProc = *otherItr;
       sendRequests.push_back(MPI_Request());
-      MPI_Isend(&localBufferSize, 1, MPI_UNSIGNED, otherProc, 1, MPI_COMM_WORLD, &sendRequests.back());
+      MPI_Isend(&localBufferSize, 1, MPI_UNSIGNED, otherProc, 1, defaultCommunicator(), &sendRequests.back());
       if (localBufferSize > 0) {
         sendRequests.push_back(MPI_Request());
-        MPI_Isend(&localBuffer.front(), localBufferSize, MPI_CHAR, otherProc, 2, MPI_COMM_WORLD, &sendRequests.back());
+        MPI_Isend(&localBuffer.front(), localBufferSize, MPI_CHAR, otherProc, 2, defaultCommunicator(), &sendRequests.back());
       }
     }
     POLY_ASSERT(sendRequests.size() <= 2*mMesh.neighborDomains.size());
@@ -1227,10 +1343,10 @@ flagBoundaryEdgesForCleaning(const RealType edgeTol,
       const unsigned otherProc = *otherItr;
       unsigned bufSize;
       MPI_Status recvStatus1, recvStatus2;
-      MPI_Recv(&bufSize, 1, MPI_UNSIGNED, otherProc, 1, MPI_COMM_WORLD, &recvStatus1);
+      MPI_Recv(&bufSize, 1, MPI_UNSIGNED, otherProc, 1, defaultCommunicator(), &recvStatus1);
       if (bufSize > 0) {
         vector<char> buffer(bufSize, '\0');
-        MPI_Recv(&buffer.front(), bufSize, MPI_CHAR, otherProc, 2, MPI_COMM_WORLD, &recvStatus2);
+        MPI_Recv(&buffer.front(), bufSize, MPI_CHAR, otherProc, 2, defaultCommunicator(), &recvStatus2);
         vector<char>::const_iterator itr = buffer.begin();
         vector<unsigned> otherEdgeMask;
         deserialize(otherEdgeMask, itr, buffer.end());
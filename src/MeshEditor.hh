@@ -40,12 +40,18 @@ public:
   ~MeshEditor();
 
   // Deletes the mesh elements for the specified indices and recomputes the 
-  // resulting mesh topology 
+  // resulting mesh topology.  Deleting an element also deletes whatever is
+  // left unused by it: cells all of whose faces are deleted, faces left with
+  // too few nodes (2 in 2D, 3 in 3D), and nodes no remaining face uses.
+  // Faces and nodes are simply removed from the cells and faces that refer
+  // to them, so it is up to the caller to leave a closed mesh.  The shared,
+  // periodic and (if set) boundary element lists are updated to match.
   void deleteCells(const std::vector<unsigned>& cellsToDelete);
   void deleteFaces(const std::vector<unsigned>& facesToDelete);
   void deleteNodes(const std::vector<unsigned>& nodesToDelete);
 
-  // Clean small edges in the mesh based on some tolerance
+  // Clean small edges in the mesh based on some tolerance.  In a distributed
+  // mesh this talks to the neighbor domains over defaultCommunicator().
   void cleanEdges(const RealType edgeTol);
 
   // Static variables
@@ -77,6 +83,10 @@ private:
   void computeCellAndNodeMasks();
   void computeCellAndFaceMasks();
 
+  // Flag the nodes of the faces, and the cells with faces, that survive
+  void flagNodesOfFaces();
+  void flagCellsOfFaces();
+
 
   //-----------------------===== Class Members =====--------------------------//
 
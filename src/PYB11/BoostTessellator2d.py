@@ -56,3 +56,4 @@ PYB11inject(TessellatorCommonMethods, BoostTessellator)
 #-------------------------------------------------------------------------------
 # Template instantiations
 BoostTessellator2d = PYB11TemplateClass(BoostTessellator, template_parameters="double", pyname="BoostTessellator")
+BoostTessellator2df = PYB11TemplateClass(BoostTessellator, template_parameters="float", pyname="BoostTessellatorf")
@@ -0,0 +1,140 @@
+from PYB11Generator import *
+
+@PYB11template("int Dimension", "RealType")
+class CentroidalRelaxation:
+    """Drives a set of generators toward a centroidal Voronoi tessellation (CVT)
+by Lloyd iteration: tessellate, move each generator toward the centroid of
+its cell, and repeat until the generators stop moving.
+
+Any Tessellator may be used.  With a DistributedTessellator each domain
+relaxes its own generators and the convergence test is reduced across all
+domains."""
+
+    #...........................................................................
+    # Constructors
+    @PYB11keepalive(1, 2)
+    def pyinit(self,
+               tessellator = "const Tessellator<%(Dimension)s, %(RealType)s>&",
+               maxIterations = ("const unsigned", "100"),
+               tolerance = ("const %(RealType)s", "1.0e-4"),
+               relaxation = ("const %(RealType)s", "1.0")):
+        "Construct with the Tessellator used for each iteration."
+        return
+
+    #...........................................................................
+    # Methods
+    @PYB11implementation("""[](CentroidalRelaxation<%(Dimension)s, %(RealType)s>& self,
+                               std::vector<%(RealType)s>& points,
+                               py::tuple low,
+                               py::tuple high,
+                               Tessellation<%(Dimension)s, %(RealType)s>& mesh) {
+                                   std::vector<%(RealType)s> clow, chigh;
+                                   for (auto i = 0; i < %(Dimension)s; ++i) {
+                                     clow.push_back(low[i].cast<%(RealType)s>());
+                                     chigh.push_back(high[i].cast<%(RealType)s>());
+                                   }
+                                   return self.relax(points, &clow.front(), &chigh.front(), mesh);
+                               }""")
+    def relaxBox(self,
+                 points = "std::vector<%(RealType)s>&",
+                 low = "py::tuple",
+                 high = "py::tuple",
+                 mesh = "Tessellation<%(Dimension)s, %(RealType)s>&"):
+        """Relax the generators inside the box (low, high).  On return points holds
+the relaxed generators and mesh their tessellation.  Returns the number of
+tessellations done."""
+        return "unsigned"
+
+    @PYB11pycppname("relax")
+    def relaxPLC(self,
+                 points = "std::vector<%(RealType)s>&",
+                 PLCpoints = "const std::vector<%(RealType)s>&",
+                 geometry = "const PLC<%(Dimension)s, %(RealType)s>&",
+                 mesh = "Tessellation<%(Dimension)s, %(RealType)s>&"):
+        "Relax the generators inside the given PLC."
+        return "unsigned"
+
+    @PYB11pycppname("relax")
+    def relaxReducedPLC(self,
+                        points = "std::vector<%(RealType)s>&",
+                        geometry = "const ReducedPLC<%(Dimension)s, %(RealType)s>&",
+                        mesh = "Tessellation<%(Dimension)s, %(RealType)s>&"):
+        "Relax the generators inside the given ReducedPLC."
+        return "unsigned"
+
+    @PYB11const
+    def converged(self):
+        "Did the last call to relax converge?"
+        return "bool"
+
+    @PYB11const
+    def numIterations(self):
+        "The number of tessellations done by the last call to relax."
+        return "unsigned"
+
+    @PYB11const
+    @PYB11returnpolicy("reference_internal")
+    def displacements(self):
+        "The largest distance any generator would have moved to its centroid each iteration, as a fraction of the boundary size."
+        return "const std::vector<double>&"
+
+    @PYB11const
+    @PYB11returnpolicy("reference_internal")
+    def tessellateTimes(self):
+        "Wall clock seconds spent tessellating each iteration."
+        return "const std::vector<double>&"
+
+    @PYB11const
+    @PYB11returnpolicy("reference_internal")
+    def centroidTimes(self):
+        "Wall clock seconds spent computing centroids each iteration."
+        return "const std::vector<double>&"
+
+    #...........................................................................
+    # Convergence parameters
+    @PYB11const
+    def maxIterations(self):
+        "The maximum number of times the generators are moved."
+        return "unsigned"
+
+    @PYB11pycppname("maxIterations")
+    def setmaxIterations(self,
+                         x = "const unsigned"):
+        return "void"
+
+    @PYB11const
+    def tolerance(self):
+        "Stop once no generator moves further than this fraction of the boundary size."
+        return "%(RealType)s"
+
+    @PYB11pycppname("tolerance")
+    def settolerance(self,
+                     x = "const %(RealType)s"):
+        return "void"
+
+    @PYB11const
+    def relaxation(self):
+        "The fraction of the way each generator is moved toward its centroid per iteration."
+        return "%(RealType)s"
+
+    @PYB11pycppname("relaxation")
+    def setrelaxation(self,
+                      x = "const %(RealType)s"):
+        return "void"
+
+    @PYB11const
+    def spatialSort(self):
+        "The space filling curve the generators are put in order along once before iterating."
+        return "SpatialSort"
+
+    @PYB11pycppname("spatialSort")
+    def setspatialSort(self,
+                       x = "const SpatialSort"):
+        return "void"
+
+#-------------------------------------------------------------------------------
+# Template instantiations
+CentroidalRelaxation2d = PYB11TemplateClass(CentroidalRelaxation, template_parameters=("2", "double"))
+CentroidalRelaxation3d = PYB11TemplateClass(CentroidalRelaxation, template_parameters=("3", "double"))
+CentroidalRelaxation2df = PYB11TemplateClass(CentroidalRelaxation, template_parameters=("2", "float"))
+CentroidalRelaxation3df = PYB11TemplateClass(CentroidalRelaxation, template_parameters=("3", "float"))
@@ -65,3 +65,5 @@ PYB11inject(TessellatorCommonMethods, DistributedTessellator)
 # Template instantiations
 DistributedTessellator2d = PYB11TemplateClass(DistributedTessellator, template_parameters=("2", "double"))
 DistributedTessellator3d = PYB11TemplateClass(DistributedTessellator, template_parameters=("3", "double"))
+DistributedTessellator2df = PYB11TemplateClass(DistributedTessellator, template_parameters=("2", "float"))
+DistributedTessellator3df = PYB11TemplateClass(DistributedTessellator, template_parameters=("3", "float"))
@@ -44,3 +44,5 @@ collapsing degenerate edges by some floating tolerance.
 # Template instantiations
 MeshEditor2d = PYB11TemplateClass(MeshEditor, template_parameters=("2", "double"))
 MeshEditor3d = PYB11TemplateClass(MeshEditor, template_parameters=("3", "double"))
+MeshEditor2df = PYB11TemplateClass(MeshEditor, template_parameters=("2", "float"))
+MeshEditor3df = PYB11TemplateClass(MeshEditor, template_parameters=("3", "float"))
@@ -48,3 +48,5 @@ generating point of the ith facet of the kth hole.""")
 # Template instantiations
 PLC2d = PYB11TemplateClass(PLC, template_parameters=("2", "double"))
 PLC3d = PYB11TemplateClass(PLC, template_parameters=("3", "double"))
+PLC2df = PYB11TemplateClass(PLC, template_parameters=("2", "float"))
+PLC3df = PYB11TemplateClass(PLC, template_parameters=("3", "float"))
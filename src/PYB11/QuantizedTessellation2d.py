@@ -111,3 +111,4 @@ coordinates."""
 #-------------------------------------------------------------------------------
 # Template instantiations
 QuantizedTessellation2d_KD = PYB11TemplateClass(QuantizedTessellation2d, template_parameters=("polytope::KeyTraits::Key", "double"), pyname="QuantizedTessellation2d")
+QuantizedTessellation2d_KF = PYB11TemplateClass(QuantizedTessellation2d, template_parameters=("polytope::KeyTraits::Key", "float"), pyname="QuantizedTessellation2df")
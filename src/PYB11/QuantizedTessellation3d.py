@@ -1,10 +1,10 @@
 from PYB11Generator import *
 
 @PYB11template("IntType", "RealType")
-class QuantizedTessellation2d:
-    """QuantizedTessellation2d
+class QuantizedTessellation3d:
+    """QuantizedTessellation3d
 
-An intermediate representation for 2D tessellations in integer
+An intermediate representation for 3D tessellations in integer
 coordinates."""
 
     PYB11typedefs = """
@@ -36,6 +36,11 @@ coordinates."""
                 xmax = "py::tuple"):
         "Construct with the given generators using the specified bounds."
 
+    def pyinit3(self,
+                generators = "const std::vector<IntPoint>&",
+                otherqmesh = "const QuantizedTessellation3d<%(IntType)s, %(RealType)s>&"):
+        "Construct as a copy of the given QuantizedMesh but with the given IntPoint generators."
+
     #...........................................................................
     # Methods
     @PYB11const
@@ -78,23 +83,25 @@ coordinates."""
     # Properties
     xmin = PYB11property("py::tuple",
                          getterraw = """[](const QuantizedTessellation3d<%(IntType)s, %(RealType)s>& self) {
-                             return py::make_tuple(self.xmin[0], self.xmin[1]);
+                             return py::make_tuple(self.xmin[0], self.xmin[1], self.xmin[2]);
                            }""",
                          setterraw = """[](QuantizedTessellation3d<%(IntType)s, %(RealType)s>& self,
                                            py::tuple val) {
                              self.xmin[0] = val[0].cast<%(RealType)s>();
                              self.xmin[1] = val[1].cast<%(RealType)s>();
+                             self.xmin[2] = val[2].cast<%(RealType)s>();
                            }""",
                          doc = "The minimum (real) coordinate")
 
     xmax = PYB11property("py::tuple",
                          getterraw = """[](const QuantizedTessellation3d<%(IntType)s, %(RealType)s>& self) {
-                             return py::make_tuple(self.xmax[0], self.xmax[1]);
+                             return py::make_tuple(self.xmax[0], self.xmax[1], self.xmax[2]);
                            }""",
                          setterraw = """[](QuantizedTessellation3d<%(IntType)s, %(RealType)s>& self,
                                            py::tuple val) {
                              self.xmax[0] = val[0].cast<%(RealType)s>();
                              self.xmax[1] = val[1].cast<%(RealType)s>();
+                             self.xmax[2] = val[2].cast<%(RealType)s>();
                            }""",
                          doc = "The maximum (real) coordinate")
 
@@ -112,3 +119,4 @@ coordinates."""
 #-------------------------------------------------------------------------------
 # Template instantiations
 QuantizedTessellation3d_KD = PYB11TemplateClass(QuantizedTessellation3d, template_parameters=("polytope::KeyTraits::Key", "double"), pyname="QuantizedTessellation3d")
+QuantizedTessellation3d_KF = PYB11TemplateClass(QuantizedTessellation3d, template_parameters=("polytope::KeyTraits::Key", "float"), pyname="QuantizedTessellation3df")
@@ -28,3 +28,5 @@ the points that are used in the facets of the PLC.""")
 # Template instantiations
 ReducedPLC2d = PYB11TemplateClass(ReducedPLC, template_parameters=("2", "double"))
 ReducedPLC3d = PYB11TemplateClass(ReducedPLC, template_parameters=("3", "double"))
+ReducedPLC2df = PYB11TemplateClass(ReducedPLC, template_parameters=("2", "float"))
+ReducedPLC3df = PYB11TemplateClass(ReducedPLC, template_parameters=("3", "float"))
@@ -36,3 +36,5 @@ PYB11inject(TessellatorCommonMethods, SerialDistributedTessellator)
 # Template instantiations
 SerialDistributedTessellator2d = PYB11TemplateClass(SerialDistributedTessellator, template_parameters=("2", "double"))
 SerialDistributedTessellator3d = PYB11TemplateClass(SerialDistributedTessellator, template_parameters=("3", "double"))
+SerialDistributedTessellator2df = PYB11TemplateClass(SerialDistributedTessellator, template_parameters=("2", "float"))
+SerialDistributedTessellator3df = PYB11TemplateClass(SerialDistributedTessellator, template_parameters=("3", "float"))
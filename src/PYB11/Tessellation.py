@@ -85,11 +85,21 @@ NOTE: we implicitly assume that any domains of rank less than ours we
       are receiving from, while any domains of greater rank we send
       to.""")
 
+    periodicFaces = PYB11readwrite(returnpolicy = "reference",
+                                   doc="""Periodic data structure: for tessellations of periodic boxes, the 
+indices of the faces that wrap across the box boundary.""")
+
+    periodicFaceShifts = PYB11readwrite(returnpolicy = "reference",
+                                        doc="""For each entry in periodicFaces, the Dimension integer lattice shifts
+(in units of the box lengths) which carry the generator of the second
+cell in faceCells to the image that neighbors the first cell across the
+face.  Stored as periodicFaceShifts[Dimension*i + j].""")
+
     #...........................................................................
     # A few handy properties that implement transformations on the Tessellation data.
     xnodes = PYB11property(getterraw="""[](const Tessellation<%(Dimension)s, %(RealType)s>& self) -> std::vector<%(RealType)s> { 
                                           const auto n = self.nodes.size()/%(Dimension)s;
-                                          std::vector<double> result(n);
+                                          std::vector<%(RealType)s> result(n);
                                           for (auto i = 0; i < n; ++i) result[i] = self.nodes[%(Dimension)s*i];
                                           return result;
                                         }""",
@@ -97,7 +107,7 @@ NOTE: we implicitly assume that any domains of rank less than ours we
 
     ynodes = PYB11property(getterraw="""[](const Tessellation<%(Dimension)s, %(RealType)s>& self) -> std::vector<%(RealType)s> { 
                                           const auto n = self.nodes.size()/%(Dimension)s;
-                                          std::vector<double> result(n);
+                                          std::vector<%(RealType)s> result(n);
                                           for (auto i = 0; i < n; ++i) result[i] = self.nodes[%(Dimension)s*i + 1];
                                           return result;
                                         }""",
@@ -106,7 +116,7 @@ NOTE: we implicitly assume that any domains of rank less than ours we
     znodes = PYB11property(getterraw="""[](const Tessellation<%(Dimension)s, %(RealType)s>& self) -> std::vector<%(RealType)s> { 
                                           if (%(Dimension)s != 3) throw py::type_error("Cannot extract z component from 2D Tessellation");
                                           const auto n = self.nodes.size()/%(Dimension)s;
-                                          std::vector<double> result(n);
+                                          std::vector<%(RealType)s> result(n);
                                           for (auto i = 0; i < n; ++i) result[i] = self.nodes[%(Dimension)s*i + 2];
                                           return result;
                                         }""",
@@ -148,3 +158,5 @@ NOTE: we implicitly assume that any domains of rank less than ours we
 # Template instantiations
 Tessellation2d = PYB11TemplateClass(Tessellation, template_parameters=("2", "double"))
 Tessellation3d = PYB11TemplateClass(Tessellation, template_parameters=("3", "double"))
+Tessellation2df = PYB11TemplateClass(Tessellation, template_parameters=("2", "float"))
+Tessellation3df = PYB11TemplateClass(Tessellation, template_parameters=("3", "float"))
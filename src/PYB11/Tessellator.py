@@ -26,10 +26,10 @@ geometries."""
                                py::tuple low,
                                py::tuple high,
                                Tessellation<%(Dimension)s, %(RealType)s>& mesh) {
-                                   std::vector<double> clow, chigh;
+                                   std::vector<%(RealType)s> clow, chigh;
                                    for (auto i = 0; i < %(Dimension)s; ++i) {
-                                     clow.push_back(low[i].cast<double>());
-                                     chigh.push_back(high[i].cast<double>());
+                                     clow.push_back(low[i].cast<%(RealType)s>());
+                                     chigh.push_back(high[i].cast<%(RealType)s>());
                                    }
                                    self.tessellate(points, &clow.front(), &chigh.front(), mesh);
                                }""")
@@ -199,6 +199,18 @@ delta in x."""
                       val = "const %(RealType)s"):
         return "void"
 
+    @PYB11const
+    def spatialSort(self):
+        """The space filling curve (if any) the generators are sorted along before
+being handed to the underlying Delaunay algorithm.  The cells of the
+tessellation are always returned in the caller's generator order."""
+        return "SpatialSort"
+
+    @PYB11pycppname("spatialSort")
+    def setspatialSort(self,
+                       x = "const SpatialSort"):
+        return "void"
+
     #...........................................................................
     # Protected methods
 #     @PYB11protected
@@ -229,3 +241,5 @@ PYB11inject(TessellatorCommonMethods, Tessellator, pure_virtual=True)
 # Template instantiations
 Tessellator2d = PYB11TemplateClass(Tessellator, template_parameters=("2", "double"))
 Tessellator3d = PYB11TemplateClass(Tessellator, template_parameters=("3", "double"))
+Tessellator2df = PYB11TemplateClass(Tessellator, template_parameters=("2", "float"))
+Tessellator3df = PYB11TemplateClass(Tessellator, template_parameters=("3", "float"))
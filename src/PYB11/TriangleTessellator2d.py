@@ -56,3 +56,4 @@ PYB11inject(TessellatorCommonMethods, TriangleTessellator)
 #-------------------------------------------------------------------------------
 # Template instantiations
 TriangleTessellator2d = PYB11TemplateClass(TriangleTessellator, template_parameters="double")
+TriangleTessellator2df = PYB11TemplateClass(TriangleTessellator, template_parameters="float")
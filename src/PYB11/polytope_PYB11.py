@@ -3,6 +3,9 @@
 from PYB11Generator import *
 
 PYB11includes = ['"polytope.hh"',
+                 '"CentroidalRelaxation.hh"',
+                 '"computeMeshGeometry.hh"',
+                 '"timingUtilities.hh"',
                  '"polytope_write_OOGL.hh"',
                  '"polytope_pybind11_helpers.hh"']
 
@@ -29,6 +32,12 @@ vector_of_vector_of_float    = PYB11_bind_vector("std::vector<float>", opaque=Tr
 vector_of_vector_of_double   = PYB11_bind_vector("std::vector<double>", opaque=True, local=True)
 vector_of_vector_of_string   = PYB11_bind_vector("std::vector<std::string>", opaque=True, local=True)
 
+#-------------------------------------------------------------------------------
+# Enums
+#-------------------------------------------------------------------------------
+SpatialSort = PYB11enum(("NoSpatialSort", "MortonSort", "HilbertSort"), export_values=True,
+                        doc="Space filling curves generators may be sorted along before tessellating.")
+
 #-------------------------------------------------------------------------------
 # Add the polytope classes
 #-------------------------------------------------------------------------------
@@ -38,6 +47,7 @@ from Tessellation import *
 from QuantizedTessellation2d import *
 from Tessellator import *
 from Tessellators import *
+from CentroidalRelaxation import *
 
 #from MeshEditor import *
 
@@ -55,6 +65,28 @@ writePLCtoOFF2d = PYB11TemplateFunction(writePLCtoOFF, pyname="writePLCtoOFF", t
                                                                                                     "Dimension": "2"})
 writePLCtoOFF3d = PYB11TemplateFunction(writePLCtoOFF, pyname="writePLCtoOFF", template_parameters={"RealType": "double",
                                                                                                     "Dimension": "3"})
+writePLCtoOFF2df = PYB11TemplateFunction(writePLCtoOFF, pyname="writePLCtoOFF", template_parameters={"RealType": "float",
+                                                                                                     "Dimension": "2"})
+writePLCtoOFF3df = PYB11TemplateFunction(writePLCtoOFF, pyname="writePLCtoOFF", template_parameters={"RealType": "float",
+                                                                                                     "Dimension": "3"})
+
+#...............................................................................
+@PYB11template("int Dimension", "RealType")
+@PYB11implementation("""[](const Tessellation<%(Dimension)s, %(RealType)s>& mesh) {
+                               std::vector<%(RealType)s> cellVolumes, cellCentroids, faceAreas, faceNormals, faceCentroids;
+                               computeMeshGeometry(mesh, cellVolumes, cellCentroids, faceAreas, faceNormals, faceCentroids);
+                               return py::make_tuple(cellVolumes, cellCentroids, faceAreas, faceNormals, faceCentroids);
+                           }""")
+def computeMeshGeometry(mesh = "const Tessellation<%(Dimension)s, %(RealType)s>&"):
+    """Compute the geometry of every cell and face of a tessellation in one pass.
+Returns the tuple (cellVolumes, cellCentroids, faceAreas, faceNormals, faceCentroids),
+with the centroids and normals flattened to Dimension values per element."""
+    return "py::tuple"
+
+computeMeshGeometry2d = PYB11TemplateFunction(computeMeshGeometry, template_parameters=("2", "double"), pyname="computeMeshGeometry")
+computeMeshGeometry3d = PYB11TemplateFunction(computeMeshGeometry, template_parameters=("3", "double"), pyname="computeMeshGeometry")
+computeMeshGeometry2df = PYB11TemplateFunction(computeMeshGeometry, template_parameters=("2", "float"), pyname="computeMeshGeometry")
+computeMeshGeometry3df = PYB11TemplateFunction(computeMeshGeometry, template_parameters=("3", "float"), pyname="computeMeshGeometry")
 
 #...............................................................................
 @PYB11template("int Dimension", "RealType")
@@ -157,6 +189,7 @@ def convexHull2d(points = "py::list",
     return "PLC<2, %(RealType)s>"
 
 constructConvexHull2d = PYB11TemplateFunction(convexHull2d, template_parameters="double")
+constructConvexHull2df = PYB11TemplateFunction(convexHull2d, template_parameters="float")
 
 #...............................................................................
 @PYB11template("RealType")
@@ -181,3 +214,44 @@ def convexHull3d(points = "py::list",
     return "PLC<3, %(RealType)s>"
 
 constructConvexHull3d = PYB11TemplateFunction(convexHull3d, template_parameters="double")
+constructConvexHull3df = PYB11TemplateFunction(convexHull3d, template_parameters="float")
+
+#-------------------------------------------------------------------------------
+# Timers and counters for the stages of each tessellation
+#-------------------------------------------------------------------------------
+def enableTimers(enable = ("const bool", "true")):
+    """Turn the tessellation timers and counters on (or off).  Nothing is recorded
+until they are enabled, and the totals accumulate until resetTimers."""
+    return "void"
+
+def timersEnabled():
+    "Are the tessellation timers on?"
+    return "bool"
+
+def resetTimers():
+    "Zero all the timers and counters."
+    return "void"
+
+def timerSeconds(name = "const std::string&"):
+    "The wall clock seconds recorded by the named timer (0 if unknown)."
+    return "double"
+
+def timerCalls(name = "const std::string&"):
+    "The number of times the named timer has run."
+    return "unsigned"
+
+def counterValue(name = "const std::string&"):
+    "The value of the named counter (0 if unknown)."
+    return "uint64_t"
+
+def timerNames():
+    "The names of all the timers that have run."
+    return "std::vector<std::string>"
+
+def counterNames():
+    "The names of all the counters that have been incremented."
+    return "std::vector<std::string>"
+
+def timersReport():
+    "A table of all the timers and counters, one per line."
+    return "std::string"
@@ -239,8 +239,8 @@ public:
     // All-reduce to ensure bounds are exact across processors.
 #ifdef HAVE_MPI
     for (unsigned j = 0; j != Dimension; ++j) {
-      low_new [j] = allReduce(low_new [j], MPI_MIN, MPI_COMM_WORLD);
-      high_new[j] = allReduce(high_new[j], MPI_MAX, MPI_COMM_WORLD);
+      low_new [j] = allReduce(low_new [j], MPI_MIN, defaultCommunicator());
+      high_new[j] = allReduce(high_new[j], MPI_MAX, defaultCommunicator());
     }
     rinf_new = 0.5*(high_new[0] - low_new[0]);
 #endif
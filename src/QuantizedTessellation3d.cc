@@ -48,10 +48,29 @@ QuantizedTessellation3d(const std::vector<RealType>& points,
   xmax[0] = xmax_in[0];
   xmax[1] = xmax_in[1];
   xmax[2] = xmax_in[2];
-  length = std::max(xmax[0] - xmin[0], xmax[1] - xmin[1]);
+  length = std::max(xmax[0] - xmin[0], std::max(xmax[1] - xmin[1], xmax[2] - xmin[2]));
   this->construct(points);
 }
 
+//------------------------------------------------------------------------------
+// Special copy constructor -- take all the state of other QuantizedTessellation
+// except use the given integer generators.
+//------------------------------------------------------------------------------
+template<typename IntType, typename RealType>
+QuantizedTessellation3d<IntType, RealType>::
+QuantizedTessellation3d(const std::vector<IntPoint>& generators,
+                        const QuantizedTessellation3d<IntType, RealType>& otherqmesh):
+  length(otherqmesh.length),
+  generators(generators),
+  guardGenerators(otherqmesh.guardGenerators),
+  nodes(),
+  edges(),
+  faces(),
+  cellFaces() {
+  std::copy(otherqmesh.xmin, otherqmesh.xmin + 3, xmin);
+  std::copy(otherqmesh.xmax, otherqmesh.xmax + 3, xmax);
+}
+
 //------------------------------------------------------------------------------
 // Convert real coordinates to integers.
 //------------------------------------------------------------------------------
@@ -85,7 +104,47 @@ template<typename IntType, typename RealType>
 void
 QuantizedTessellation3d<IntType, RealType>::
 fillTessellation(Tessellation<3, RealType>& mesh) const {
-  POLY_ASSERT2(false, "Implement me!");
+  const unsigned numNodes = nodes.size();
+  const unsigned numEdges = edges.size();
+  const unsigned numFaces = faces.size();
+  const unsigned numGenerators = generators.size();
+  mesh.nodes.resize(3*numNodes);
+  mesh.faces.resize(numFaces);
+  mesh.faceCells.resize(numFaces);
+  mesh.cells = cellFaces;
+  for (unsigned i = 0; i != numNodes; ++i) {
+    this->dequantize(&nodes[i].x, &mesh.nodes[3*i]);
+  }
+
+  // Each face is a loop of oriented edges: walk it to get the nodes.
+  for (unsigned i = 0; i != numFaces; ++i) {
+    const unsigned nedges = faces[i].size();
+    POLY_ASSERT(nedges >= 3);
+    mesh.faces[i].resize(nedges);
+    for (unsigned j = 0; j != nedges; ++j) {
+      const int k = faces[i][j];
+      if (k < 0) {
+        POLY_ASSERT2(~k < numEdges, k << " " << ~k << " " << numEdges);
+        mesh.faces[i][j] = edges[~k].second;
+      } else {
+        POLY_ASSERT2(k < numEdges, k << " " << numEdges);
+        mesh.faces[i][j] = edges[k].first;
+      }
+    }
+  }
+  for (unsigned i = 0; i != numGenerators; ++i) {
+    const unsigned nf = mesh.cells[i].size();
+    for (unsigned j = 0; j != nf; ++j) {
+      int k = mesh.cells[i][j];
+      if (k < 0) {
+        POLY_ASSERT2(~k < numFaces, k << " " << ~k << " " << numFaces);
+        mesh.faceCells[~k].push_back(~i);
+      } else {
+        POLY_ASSERT2(k < numFaces, k << " " << numFaces);
+        mesh.faceCells[k].push_back(i);
+      }
+    }
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -97,16 +156,28 @@ void
 QuantizedTessellation3d<IntType, RealType>::
 construct(const std::vector<RealType>& points) {
   POLY_ASSERT(points.size() % 3 == 0);
-  POLY_ASSERT(std::abs(xmax[0] - xmin[0] - length) < 1e-10*length);
-  POLY_ASSERT(std::abs(xmax[1] - xmin[1] - length) < 1e-10*length);
-  POLY_ASSERT(std::abs(xmax[2] - xmin[2] - length) < 1e-10*length);
   const int numGenerators = points.size()/3;
   generators.resize(numGenerators);
   for (unsigned i = 0; i < numGenerators; ++i) {
     this->quantize(&points[3*i], &generators[i].x);
     generators[i].index = i;
   }
-  POLY_ASSERT2(false, "Implement 3D guard generators!");
+
+  // The guard generators sit on the surface of the quantized box, on the
+  // corners, edge midpoints, and face centers, so every real cell is closed.
+  const unsigned nx = 2;
+  IntType dx = (coordMax - coordMin)/nx;
+  unsigned k = numGenerators;
+  for (unsigned iz = 0; iz <= nx; ++iz) {
+    for (unsigned iy = 0; iy <= nx; ++iy) {
+      for (unsigned ix = 0; ix <= nx; ++ix) {
+        if (ix == 0 or ix == nx or iy == 0 or iy == nx or iz == 0 or iz == nx) {
+          guardGenerators.push_back(IntPoint(coordMin + ix*dx, coordMin + iy*dx, coordMin + iz*dx, k++));
+        }
+      }
+    }
+  }
+  POLY_ASSERT(guardGenerators.size() == 26);
 }
 
 //------------------------------------------------------------------------------
@@ -121,4 +192,5 @@ IntType
 QuantizedTessellation3d<IntType, RealType>::coordMax = std::numeric_limits<IntType>::max()/3;
 
 template struct QuantizedTessellation3d<int, double>;
+template struct QuantizedTessellation3d<int, float>;
 }
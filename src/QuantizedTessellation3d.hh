@@ -22,6 +22,7 @@ struct QuantizedTessellation3d {
   
   RealType xmin[3], xmax[3], length, infRadius;
   std::vector<IntPoint> generators;
+  std::vector<IntPoint> guardGenerators;
 
   std::vector<IntPoint> nodes;
   std::vector<std::pair<int, int> > edges;
@@ -38,6 +39,10 @@ struct QuantizedTessellation3d {
                           const RealType xmin_in[3],
                           const RealType xmax_in[3]);
 
+  // Construct as a copy of the given QuantizedMesh but with the given IntPoint generators.
+  QuantizedTessellation3d(const std::vector<IntPoint>& generators,
+                          const QuantizedTessellation3d& otherqmesh);
+
   // Convert real coordinates to integers.
   void quantize(const RealType* realcoords, IntType* intcoords) const;
 
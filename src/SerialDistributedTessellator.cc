@@ -59,8 +59,9 @@ template<int Dimension, typename RealType>
 SerialDistributedTessellator<Dimension, RealType>::
 SerialDistributedTessellator(Tessellator<Dimension, RealType>* tessellator,
                              bool assumeControl,
-                             bool buildCommunicationInfo):
-  DistributedTessellator<Dimension, RealType>(tessellator, assumeControl, buildCommunicationInfo) {
+                             bool buildCommunicationInfo,
+                             MPI_Comm communicator):
+  DistributedTessellator<Dimension, RealType>(tessellator, assumeControl, buildCommunicationInfo, communicator) {
 }
 
 //------------------------------------------------------------------------------
@@ -82,8 +83,9 @@ computeDistributedTessellation(const vector<RealType>& points,
 
   // Parallel configuration.
   int rank, numProcs;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+  MPI_Comm_rank(this->mComm, &rank);
+  MPI_Comm_size(this->mComm, &numProcs);
+  CommunicatorScope commScope(this->mComm);
 
   // Get the full global set of generators from everyone.
   vector<RealType> generators;
@@ -93,10 +95,10 @@ computeDistributedTessellation(const vector<RealType>& points,
     serialize(points, localBuffer);
     for (unsigned sendProc = 0; sendProc != numProcs; ++sendProc) {
       unsigned bufSize = localBuffer.size();
-      MPI_Bcast(&bufSize, 1, MPI_UNSIGNED, sendProc, MPI_COMM_WORLD);
+      MPI_Bcast(&bufSize, 1, MPI_UNSIGNED, sendProc, this->mComm);
       vector<char> buffer = localBuffer;
       buffer.resize(bufSize);
-      MPI_Bcast(&buffer.front(), bufSize, MPI_CHAR, sendProc, MPI_COMM_WORLD);
+      MPI_Bcast(&buffer.front(), bufSize, MPI_CHAR, sendProc, this->mComm);
       vector<char>::const_iterator bufItr = buffer.begin();
       deserialize(generators, bufItr, buffer.end());
       POLY_ASSERT(bufItr == buffer.end());
@@ -123,7 +125,7 @@ computeDistributedTessellation(const vector<RealType>& points,
   //     cerr << "Writing serial mesh with " << mesh.cells.size() << endl;
   //     polytope::SiloWriter<Dimension, RealType>::write(mesh, nodeFields, edgeFields, faceFields, cellFields, "test_SerialDistributedTessellator_global_mesh");
   //   }
-  //   MPI_Barrier(MPI_COMM_WORLD);
+  //   MPI_Barrier(this->mComm);
   // }
   // // Blago!
 
@@ -207,13 +209,13 @@ computeDistributedTessellation(const vector<RealType>& points,
   //   cellFields["domain"] = &r2[0];
   //   cerr << "Writing final mesh with " << mesh.cells.size() << endl;
   //   polytope::SiloWriter<Dimension, RealType>::write(mesh, nodeFields, edgeFields, faceFields, cellFields, "test_SerialDistributedTessellator_final_mesh");
-  //   MPI_Barrier(MPI_COMM_WORLD);
+  //   MPI_Barrier(this->mComm);
   // }
   // // Blago!
 
   // Post-conditions.
 #ifndef NDEBUG
-  const string msg = checkDistributedTessellation(mesh);
+  const string msg = checkDistributedTessellation(mesh, this->mComm);
   if (msg != "ok" and rank == 0) cerr << msg;
   POLY_ASSERT(msg == "ok");
 #endif
@@ -224,5 +226,7 @@ computeDistributedTessellation(const vector<RealType>& points,
 //------------------------------------------------------------------------------
 template class SerialDistributedTessellator<2, double>;
 template class SerialDistributedTessellator<3, double>;
+template class SerialDistributedTessellator<2, float>;
+template class SerialDistributedTessellator<3, float>;
 
 }
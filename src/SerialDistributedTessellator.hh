@@ -31,9 +31,11 @@ public:
   //! \param serialTessellator A serial implementation of Tessellator.
   //! \param assumeControl If set to true, the DistributedTessellator will 
   //!                      assume control of the serial tessellator.
+  //! \param communicator The ranks sharing the tessellation.
   SerialDistributedTessellator(Tessellator<Dimension, RealType>* serialTessellator,
                                bool assumeControl = true,
-                               bool buildCommunicationInfo = false);
+                               bool buildCommunicationInfo = false,
+                               MPI_Comm communicator = MPI_COMM_WORLD);
   virtual ~SerialDistributedTessellator();
 
 protected:
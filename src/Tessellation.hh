@@ -43,6 +43,8 @@ class Tessellation
     neighborDomains.clear();
     sharedNodes.clear();
     sharedFaces.clear();
+    periodicFaces.clear();
+    periodicFaceShifts.clear();
   }
 
   //! Returns true if the tessellation is empty (not defined), 
@@ -103,6 +105,18 @@ class Tessellation
   //!       to.
   std::vector<std::vector<unsigned> > sharedNodes, sharedFaces;
 
+  //! Periodic data structure: for tessellations of periodic boxes, the 
+  //! indices of the faces that wrap across the box boundary.  Nodes are 
+  //! always stored inside the box, so the cells touching these faces 
+  //! see them through a periodic image.
+  std::vector<unsigned> periodicFaces;
+
+  //! For each entry in periodicFaces, the Dimension integer lattice shifts
+  //! (in units of the box lengths) which carry the generator of the second
+  //! cell in faceCells to the image that neighbors the first cell across the
+  //! face.  Stored as periodicFaceShifts[Dimension*i + j].
+  std::vector<int> periodicFaceShifts;
+
   //! Find the set of cells that touch each mesh node.
   std::vector<std::set<unsigned> > computeNodeCells()
   {
@@ -10,6 +10,7 @@
 #include "DimensionTraits.hh"
 #include "polytope_internal.hh"
 #include "polytope_geometric_utilities.hh"
+#include "spatialOrderIndices.hh"
 
 namespace polytope
 {
@@ -28,7 +29,7 @@ public:
   typedef typename DimensionTraits<Dimension, RealType>::QuantizedTessellation QuantizedTessellation;
 
   //! Default constructor.
-  Tessellator() {}
+  Tessellator(): mSpatialSort(NoSpatialSort) {}
 
   //! Destructor.
   virtual ~Tessellator() {}
@@ -57,6 +58,23 @@ public:
                           RealType* high,
                           Tessellation<Dimension, RealType>& mesh) const;
 
+  //! Generate a Voronoi tessellation for the given set of generator points
+  //! in a box specified by \a low and \a high which is periodic in every
+  //! direction.  All nodes of the resulting mesh lie inside the box, every
+  //! face has two cells, and the faces which wrap across the box boundary
+  //! are listed (with their lattice shifts) in mesh.periodicFaces and 
+  //! mesh.periodicFaceShifts.  No ghost generators are needed.
+  //! This default implementation issues an error explaining that the 
+  //! Tessellator does not support periodic boxes.
+  //! \param points A (Dimension*numPoints) array containing point coordinates.
+  //! \param low The coordinates of the "lower-left-near" box corner.
+  //! \param high The coordinates of the "upper-right-far" box corner.
+  //! \param mesh This will store the resulting tessellation.
+  virtual void tessellatePeriodic(const std::vector<RealType>& points,
+                                  RealType* low,
+                                  RealType* high,
+                                  Tessellation<Dimension, RealType>& mesh) const;
+
   //! Generate a Voronoi-like tessellation for the given set of generator 
   //! points and a description of the geometry in which they exist.
   //! The coordinates of these points are stored in point-major order and 
@@ -132,6 +150,15 @@ public:
   //! hell associated with elaborate inheritance hierarchies.
   virtual bool handlesPLCs() const { return true; }
 
+  //! Override this method to return true if this Tessellator can build
+  //! tessellations of periodic boxes with tessellatePeriodic.
+  virtual bool handlesPeriodicBoxes() const { return false; }
+
+  //! Override this method to return true if tessellateQuantized may be
+  //! called from several threads at once.  Tessellators wrapping libraries
+  //! with global state should leave this false.
+  virtual bool threadSafe() const { return false; }
+
   //! Required for all tessellators:
   //! Compute the quantized tessellation.  This is the basic method all
   //! Tessellator implementations must provide, on which the other tessellation methods
@@ -151,6 +178,16 @@ public:
   virtual RealType degeneracy() const = 0;
   virtual void degeneracy(const RealType val) const {};
 
+  //! Optionally sort the generators along a space filling curve before they
+  //! are handed to the underlying Delaunay algorithm.  Randomly ordered input
+  //! (common in particle codes) makes the Delaunay construction and the
+  //! Voronoi walk that follows jump around memory; sorting restores locality.
+  //! The cells of the resulting tessellation are always returned in the
+  //! caller's generator order.  Hilbert ordering generally gives the best
+  //! locality, particularly in 3D.
+  SpatialSort spatialSort() const { return mSpatialSort; }
+  void spatialSort(const SpatialSort x) { mSpatialSort = x; }
+
   protected:
 
   // //! This helper method creates a piecewise linear complex (PLC) 
@@ -165,7 +202,20 @@ public:
                                                 RealType* low,
                                                 RealType* high) const;
 
+  //! If a spatial sort has been requested, fill sortedPoints with the
+  //! generators in curve order and order[i] with the caller's index of the
+  //! ith sorted generator, and return true.  Otherwise return false.
+  bool sortGenerators(const std::vector<RealType>& points,
+                      std::vector<RealType>& sortedPoints,
+                      std::vector<unsigned>& order) const;
+
+  //! Renumber the cells of a tessellation built from sorted generators back
+  //! to the caller's order.  Does nothing if order is empty.
+  void restoreGeneratorOrder(const std::vector<unsigned>& order,
+                             Tessellation<Dimension, RealType>& mesh) const;
+
   private:
+  SpatialSort mSpatialSort;
 
   // Disallowed.
   Tessellator(const Tessellator&);
@@ -2,6 +2,8 @@
 #include "makeBoxPLC.hh"
 #include "findBoundaryElements.hh"
 #include "snapToBoundary.hh"
+#include "ErrorHandler.hh"
+#include "timingUtilities.hh"
 
 namespace polytope {
 
@@ -18,17 +20,35 @@ tessellate(const std::vector<RealType>& points,
   // Pre-conditions
   POLY_ASSERT(mesh.empty());
   POLY_ASSERT(points.size() > 0);
-  POLY_ASSERT(points.size() % 2 == 0);
+  POLY_ASSERT(points.size() % nDim == 0);
+  ScopedTimer timer("tessellate");
+
+  // Optionally put the generators in spatial order.
+  std::vector<RealType> sortedPoints;
+  std::vector<unsigned> order;
+  const std::vector<RealType>& generators = (this->sortGenerators(points, sortedPoints, order) ?
+                                             sortedPoints : points);
 
   // Invoke the descendant method to fill the quant mesh.
-  QuantizedTessellation quantmesh(points, points);
-  this->tessellateQuantized(quantmesh);
+  QuantizedTessellation quantmesh(generators, generators);
+  {
+    ScopedTimer stage("tessellateQuantized");
+    this->tessellateQuantized(quantmesh);
+  }
 
   // Copy the QuantTessellation to the output.
-  quantmesh.fillTessellation(mesh);
+  {
+    ScopedTimer stage("fillTessellation");
+    quantmesh.fillTessellation(mesh);
+    this->restoreGeneratorOrder(order, mesh);
+  }
 
   // Fill in the boundary elements.
-  findBoundaryElements(mesh, mesh.boundaryFaces, mesh.boundaryNodes);
+  {
+    ScopedTimer stage("findBoundaryElements");
+    findBoundaryElements(mesh, mesh.boundaryFaces, mesh.boundaryNodes);
+  }
+  incrementCounter("cells", mesh.cells.size());
 }
 
 //----------------------------------------------------------------------------
@@ -47,6 +67,20 @@ tessellate(const std::vector<RealType>& points,
   this->tessellate(points, geometry, mesh);
 }
 
+//----------------------------------------------------------------------------
+// Tessellate in a periodic box.
+//------------------------------------------------------------------------------
+template<int nDim, typename RealType>
+inline
+void
+Tessellator<nDim, RealType>::
+tessellatePeriodic(const std::vector<RealType>& points,
+                   RealType* low,
+                   RealType* high,
+                   Tessellation<nDim, RealType>& mesh) const {
+  error(this->name() + " does not support periodic boxes");
+}
+
 //----------------------------------------------------------------------------
 // Tessellate in a PLC.
 //------------------------------------------------------------------------------
@@ -62,23 +96,51 @@ tessellate(const std::vector<RealType>& points,
   // Pre-conditions
   POLY_ASSERT(mesh.empty());
   POLY_ASSERT(points.size() > 0);
-  POLY_ASSERT(points.size() % 2 == 0);
+  POLY_ASSERT(points.size() % nDim == 0);
+  ScopedTimer timer("tessellate");
+
+  // Optionally put the generators in spatial order.
+  std::vector<RealType> sortedPoints;
+  std::vector<unsigned> order;
+  const std::vector<RealType>& generators = (this->sortGenerators(points, sortedPoints, order) ?
+                                             sortedPoints : points);
 
   // Invoke the descendant method to fill the quant mesh.
-  QuantizedTessellation quantmesh(points, PLCpoints);
-  this->tessellateQuantized(quantmesh);
+  QuantizedTessellation quantmesh(generators, PLCpoints);
+  {
+    ScopedTimer stage("tessellateQuantized");
+    this->tessellateQuantized(quantmesh);
+  }
 
   // Clip against the boundary.
-  clipQuantizedTessellation(quantmesh, PLCpoints, geometry, *this);
+  {
+    ScopedTimer stage("clipQuantizedTessellation");
+    clipQuantizedTessellation(quantmesh, PLCpoints, geometry, *this);
+  }
 
   // Copy the QuantTessellation to the output.
-  quantmesh.fillTessellation(mesh);
+  {
+    ScopedTimer stage("fillTessellation");
+    quantmesh.fillTessellation(mesh);
+    this->restoreGeneratorOrder(order, mesh);
+  }
 
   // Fill in the boundary elements.
-  findBoundaryElements(mesh, mesh.boundaryFaces, mesh.boundaryNodes);
+  {
+    ScopedTimer stage("findBoundaryElements");
+    findBoundaryElements(mesh, mesh.boundaryFaces, mesh.boundaryNodes);
+  }
 
-  // Snap exactly to the bounding PLC.
-  snapToBoundary(mesh, PLCpoints, geometry, this->degeneracy());
+  // Snap exactly to the bounding PLC.  The clipped nodes are only as accurate
+  // as the quantized coordinates, in which a quantum is 5/(coordMax - coordMin)
+  // of the size of the PLC, so we allow at least that much.
+  {
+    ScopedTimer stage("snapToBoundary");
+    const RealType quantum = RealType(5.0)/(RealType(QuantizedTessellation::coordMax) -
+                                            RealType(QuantizedTessellation::coordMin));
+    snapToBoundary(mesh, PLCpoints, geometry, std::max(this->degeneracy(), quantum));
+  }
+  incrementCounter("cells", mesh.cells.size());
 }
 
 //----------------------------------------------------------------------------
@@ -187,4 +249,40 @@ tessellateDegenerate(const std::vector<RealType>& points,
   return this->tessellateDegenerate(points, geometry.points, geometry, tol, mesh);
 }
 
+//------------------------------------------------------------------------------
+// Sort the generators along a space filling curve, if requested.
+//------------------------------------------------------------------------------
+template<int nDim, typename RealType>
+inline
+bool
+Tessellator<nDim, RealType>::
+sortGenerators(const std::vector<RealType>& points,
+               std::vector<RealType>& sortedPoints,
+               std::vector<unsigned>& order) const {
+  sortedPoints.clear();
+  order.clear();
+  if (mSpatialSort == NoSpatialSort) return false;
+  ScopedTimer timer("spatialSort");
+  order = spatialOrderIndices<nDim, RealType>(points, mSpatialSort);
+  const unsigned n = order.size();
+  sortedPoints.resize(nDim*n);
+  for (unsigned i = 0; i != n; ++i) {
+    std::copy(&points[nDim*order[i]], &points[nDim*order[i]] + nDim, &sortedPoints[nDim*i]);
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Put the cells of a tessellation of sorted generators back in caller order.
+// Only the cell numbering changes: nodes and faces stay where they are.
+//------------------------------------------------------------------------------
+template<int nDim, typename RealType>
+inline
+void
+Tessellator<nDim, RealType>::
+restoreGeneratorOrder(const std::vector<unsigned>& order,
+                      Tessellation<nDim, RealType>& mesh) const {
+  restoreSpatialOrder(order, mesh);
+}
+
 }
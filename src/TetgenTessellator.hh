@@ -15,9 +15,9 @@
 #include <cmath>
 
 #include "Tessellator.hh"
+#include "QuantizedTessellation3d.hh"
 #include "Point.hh"
-#include "QuantTessellation.hh"
-#include "ReducedPLC.hh"
+#include "polytope_tessellator_utilities.hh"
 
 namespace polytope {
 
@@ -26,30 +26,22 @@ public:
   //-------------------- Public interface --------------------
   typedef double RealType;
 
+  // Typedefs for edges, coordinates, and points
+  typedef int                 CoordHash;
+  typedef std::pair<int, int> EdgeHash;
+  typedef Tessellator<3, RealType>::QuantizedTessellation QuantizedTessellation;
+  
+  // The typedefs that follow from this choice
+  typedef Point3<RealType>  RealPoint;
+  typedef Point3<CoordHash> IntPoint;
+
   // Constructor, destructor.
   TetgenTessellator();
   ~TetgenTessellator();
 
-  // Tessellate the given generators (unbounded).
-  void tessellate(const std::vector<RealType>& points,
-                  Tessellation<3, RealType>& mesh) const;
-
-  // Tessellate with a bounding box representing the boundaries.
-  void tessellate(const std::vector<RealType>& points,
-                  RealType* low,
-                  RealType* high,
-                  Tessellation<3, RealType>& mesh) const;
-
-  // Tessellate obeying the given boundaries.
-  void tessellate(const std::vector<RealType>& points,
-                  const std::vector<RealType>& PLCpoints,
-                  const PLC<3, RealType>& geometry,
-                  Tessellation<3, RealType>& mesh) const;
-
-  // Tessellate obeying the given boundaries expressed as a ReducedPLC.
-  void tessellate(const std::vector<RealType>& points,
-                  const ReducedPLC<3, RealType>& geometry,
-                  Tessellation<3, RealType>& mesh) const;
+  // Compute the nodes around a collection of generators.
+  // Required method for all Tessellators.
+  virtual void tessellateQuantized(QuantizedTessellation& result) const;
 
   // This Tessellator handles PLCs!
   bool handlesPLCs() const { return true; }
@@ -65,14 +57,7 @@ public:
 
 private:
   //-------------------- Private interface --------------------
-  typedef int64_t CoordHash;
-  static CoordHash coordMax;
   static RealType mDegeneracy;
-
-  // Internal method to compute the quantized tessellation.
-  void computeUnboundedQuantizedTessellation(const std::vector<RealType>& points,
-                                             const std::vector<RealType>& nonGeneratingPoints,
-                                             internal::QuantTessellation<3, RealType>& mesh) const;
 };
 
 }
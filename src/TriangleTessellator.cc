@@ -17,6 +17,7 @@
 #include "intersect.hh"
 #include "PLC_Boost_2d.hh"
 #include "polytope_plc_canned_geometries.hh"
+#include "timingUtilities.hh"
 
 // Pull in triangle. Since triangle isn't built to work out-of-the-box with C++, 
 // we slurp in its source here, bracketing it with the necessary dressing.
@@ -365,7 +366,10 @@ tessellateQuantized(QuantizedTessellation& result) const {
 
   // Compute the Delaunay triangularization of the generators.
   triangulateio delaunay;
+  ScopedTimer timer("delaunay");
   computeDelaunay(gencoords, delaunay);
+  timer.stop();
+  ScopedTimer walkTimer("voronoiWalk");
   
   // Find the circumcenters of each triangle, and build the set of triangles
   // associated with each generator.
@@ -505,5 +509,6 @@ tessellateQuantized(QuantizedTessellation& result) const {
 // Explicit instantiation.
 //------------------------------------------------------------------------------
 template class TriangleTessellator<double>;
+template class TriangleTessellator<float>;
 
 } // end polytope namespace
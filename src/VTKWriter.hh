@@ -0,0 +1,285 @@
+#ifndef POLYTOPE_VTK_WRITER_HH
+#define POLYTOPE_VTK_WRITER_HH
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <stdint.h>
+
+#include "Tessellation.hh"
+#include "BinaryUtils.hh"
+#include "polytope_write_utilities.hh"
+#include "timingUtilities.hh"
+
+namespace polytope
+{
+
+//! \class VTKWriter
+//! This class provides a static interface for writing tessellations to VTK
+//! XML unstructured grid (.vtu) files, which ParaView and VisIt read
+//! directly.  2D cells are written as VTK_POLYGONs and 3D cells as
+//! VTK_POLYHEDRONs.  The arrays go into the file as raw appended binary
+//! data, streamed from the tessellation in large blocks, so no third-party
+//! libraries are needed and writing runs at about the speed of the disk.
+template <int Dimension, typename RealType>
+class VTKWriter
+{
+  public:
+
+  typedef Tessellation<Dimension, RealType> TessellationType;
+
+  //! Write the tessellation and a set of cell-centered fields, each with a
+  //! value per cell, to the given file.
+  static void write(const TessellationType& mesh,
+                    const std::map<std::string, RealType*>& cellFields,
+                    const std::string& fileName)
+  {
+    ScopedTimer timer("writeVTK");
+    std::ofstream file;
+    internal::openOutputFile(file, fileName, "VTKWriter");
+    const unsigned numNodes = mesh.nodes.size()/Dimension;
+    const unsigned numCells = mesh.cells.size();
+
+    // Size up the cells: the connectivity holds the distinct nodes of each
+    // cell, and in 3D there's also the stream of faces.
+    uint64_t connectivitySize = 0, faceStreamSize = 0;
+    std::vector<int> mark;
+    if (Dimension == 2) {
+      for (unsigned i = 0; i != numCells; ++i) connectivitySize += mesh.cells[i].size();
+    } else {
+      mark.assign(numNodes, -1);
+      for (unsigned i = 0; i != numCells; ++i) {
+        forEachCellNode(mesh, i, mark, [&connectivitySize](const unsigned) { ++connectivitySize; });
+        faceStreamSize += cellFaceStreamSize(mesh, i);
+      }
+    }
+
+    // Lay out the appended data.  Each array is preceded by its size in
+    // bytes.
+    uint64_t offset = 0;
+    std::stringstream xml;
+    xml << "<?xml version=\"1.0\"?>\n"
+        << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"" << byteOrder()
+        << "\" header_type=\"UInt64\">\n"
+        << "  <UnstructuredGrid>\n"
+        << "    <Piece NumberOfPoints=\"" << numNodes << "\" NumberOfCells=\"" << numCells << "\">\n"
+        << "      <Points>\n";
+    dataArray(xml, realName(), "", 3, offset, 3*uint64_t(numNodes)*sizeof(RealType));
+    xml << "      </Points>\n"
+        << "      <Cells>\n";
+    dataArray(xml, "Int32", "connectivity", 1, offset, connectivitySize*sizeof(int32_t));
+    dataArray(xml, "Int64", "offsets", 1, offset, uint64_t(numCells)*sizeof(int64_t));
+    dataArray(xml, "UInt8", "types", 1, offset, numCells);
+    if (Dimension == 3) {
+      dataArray(xml, "Int32", "faces", 1, offset, faceStreamSize*sizeof(int32_t));
+      dataArray(xml, "Int64", "faceoffsets", 1, offset, uint64_t(numCells)*sizeof(int64_t));
+    }
+    xml << "      </Cells>\n"
+        << "      <CellData>\n";
+    for (typename std::map<std::string, RealType*>::const_iterator itr = cellFields.begin();
+         itr != cellFields.end();
+         ++itr) {
+      dataArray(xml, realName(), itr->first, 1, offset, uint64_t(numCells)*sizeof(RealType));
+    }
+    xml << "      </CellData>\n"
+        << "    </Piece>\n"
+        << "  </UnstructuredGrid>\n"
+        << "  <AppendedData encoding=\"raw\">\n"
+        << "   _";
+    const std::string header = xml.str();
+    file.write(header.c_str(), header.size());
+
+    // Stream the arrays.
+    {
+      internal::BlockWriter out(file);
+      out.put(3*uint64_t(numNodes)*sizeof(RealType));
+      internal::writeNodes(mesh, 3, out);
+
+      out.put(connectivitySize*sizeof(int32_t));
+      if (Dimension == 2) {
+        for (unsigned i = 0; i != numCells; ++i) {
+          for (unsigned j = 0; j != mesh.cells[i].size(); ++j) {
+            out.put(int32_t(ringNode(mesh, mesh.cells[i][j])));
+          }
+        }
+      } else {
+        mark.assign(numNodes, -1);
+        for (unsigned i = 0; i != numCells; ++i) {
+          forEachCellNode(mesh, i, mark, [&out](const unsigned k) { out.put(int32_t(k)); });
+        }
+      }
+
+      out.put(uint64_t(numCells)*sizeof(int64_t));
+      int64_t end = 0;
+      if (Dimension == 2) {
+        for (unsigned i = 0; i != numCells; ++i) out.put(end += mesh.cells[i].size());
+      } else {
+        mark.assign(numNodes, -1);
+        for (unsigned i = 0; i != numCells; ++i) {
+          forEachCellNode(mesh, i, mark, [&end](const unsigned) { ++end; });
+          out.put(end);
+        }
+      }
+
+      out.put(uint64_t(numCells));
+      const uint8_t type = (Dimension == 2 ? 7 : 42);      // VTK_POLYGON, VTK_POLYHEDRON
+      for (unsigned i = 0; i != numCells; ++i) out.put(type);
+
+      if (Dimension == 3) {
+        out.put(faceStreamSize*sizeof(int32_t));
+        for (unsigned i = 0; i != numCells; ++i) {
+          out.put(int32_t(mesh.cells[i].size()));
+          for (unsigned j = 0; j != mesh.cells[i].size(); ++j) {
+            const int k = mesh.cells[i][j];
+            out.put(int32_t(mesh.faces[k < 0 ? ~k : k].size()));
+            forEachCellFaceNode(mesh, i, j, [&out](const unsigned n) { out.put(int32_t(n)); });
+          }
+        }
+        out.put(uint64_t(numCells)*sizeof(int64_t));
+        end = 0;
+        for (unsigned i = 0; i != numCells; ++i) out.put(end += cellFaceStreamSize(mesh, i));
+      }
+
+      for (typename std::map<std::string, RealType*>::const_iterator itr = cellFields.begin();
+           itr != cellFields.end();
+           ++itr) {
+        out.put(uint64_t(numCells)*sizeof(RealType));
+        out.write(itr->second, uint64_t(numCells)*sizeof(RealType));
+      }
+      out.flush();
+      incrementCounter("bytesWritten", header.size() + out.bytes());
+    }
+    file << "\n  </AppendedData>\n"
+         << "</VTKFile>\n";
+    if (not file)
+      error("VTKWriter: failed writing " + fileName);
+  }
+
+  //! Write the tessellation alone.
+  static void write(const TessellationType& mesh,
+                    const std::string& fileName)
+  {
+    write(mesh, std::map<std::string, RealType*>(), fileName);
+  }
+
+  //! Write this rank's part of a distributed tessellation to
+  //! filePrefix_<rank>.vtu.  Rank 0 also writes the parallel index
+  //! filePrefix.pvtu, which is the file to open.  Every rank must pass the
+  //! same field names.  Nothing here communicates, so this works however
+  //! the ranks are run.
+  static void writeParallel(const TessellationType& mesh,
+                            const std::map<std::string, RealType*>& cellFields,
+                            const std::string& filePrefix,
+                            const int rank,
+                            const int numRanks)
+  {
+    write(mesh, cellFields, internal::pieceName(filePrefix, rank, ".vtu"));
+    if (rank == 0) {
+      const std::string fileName = filePrefix + ".pvtu";
+      std::ofstream file(fileName.c_str());
+      if (not file)
+        error("VTKWriter: could not open " + fileName + " for writing");
+      file << "<?xml version=\"1.0\"?>\n"
+           << "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\"" << byteOrder()
+           << "\" header_type=\"UInt64\">\n"
+           << "  <PUnstructuredGrid GhostLevel=\"0\">\n"
+           << "    <PPoints>\n"
+           << "      <PDataArray type=\"" << realName() << "\" NumberOfComponents=\"3\"/>\n"
+           << "    </PPoints>\n"
+           << "    <PCellData>\n";
+      for (typename std::map<std::string, RealType*>::const_iterator itr = cellFields.begin();
+           itr != cellFields.end();
+           ++itr) {
+        file << "      <PDataArray type=\"" << realName() << "\" Name=\"" << itr->first << "\"/>\n";
+      }
+      file << "    </PCellData>\n";
+      for (int i = 0; i != numRanks; ++i) {
+        file << "    <Piece Source=\""
+             << internal::baseName(internal::pieceName(filePrefix, i, ".vtu")) << "\"/>\n";
+      }
+      file << "  </PUnstructuredGrid>\n"
+           << "</VTKFile>\n";
+    }
+  }
+
+  private:
+
+  static const char* byteOrder()
+  {
+    return Binary::littleEndianHost() ? "LittleEndian" : "BigEndian";
+  }
+
+  static const char* realName()
+  {
+    return sizeof(RealType) == 8 ? "Float64" : "Float32";
+  }
+
+  // Describe an appended array, and advance the offset past it.
+  static void dataArray(std::ostream& xml,
+                        const std::string& type,
+                        const std::string& name,
+                        const unsigned numComponents,
+                        uint64_t& offset,
+                        const uint64_t nbytes)
+  {
+    xml << "        <DataArray type=\"" << type << "\"";
+    if (not name.empty()) xml << " Name=\"" << name << "\"";
+    if (numComponents > 1) xml << " NumberOfComponents=\"" << numComponents << "\"";
+    xml << " format=\"appended\" offset=\"" << offset << "\"/>\n";
+    offset += sizeof(uint64_t) + nbytes;
+  }
+
+  // The dimension specific walks, which the other dimension's branches in
+  // write() never call.
+  static unsigned ringNode(const Tessellation<2, RealType>& mesh, const int k)
+  {
+    return internal::cellRingNode(mesh, k);
+  }
+  static unsigned ringNode(const Tessellation<3, RealType>&, const int)
+  {
+    POLY_ASSERT(false);
+    return 0;
+  }
+
+  template <typename Function>
+  static void forEachCellNode(const Tessellation<3, RealType>& mesh,
+                              const unsigned i, std::vector<int>& mark, Function f)
+  {
+    internal::forEachCellNode(mesh, i, mark, f);
+  }
+  template <typename Function>
+  static void forEachCellNode(const Tessellation<2, RealType>&,
+                              const unsigned, std::vector<int>&, Function)
+  {
+    POLY_ASSERT(false);
+  }
+
+  template <typename Function>
+  static void forEachCellFaceNode(const Tessellation<3, RealType>& mesh,
+                                  const unsigned i, const unsigned j, Function f)
+  {
+    internal::forEachCellFaceNode(mesh, i, j, f);
+  }
+  template <typename Function>
+  static void forEachCellFaceNode(const Tessellation<2, RealType>&,
+                                  const unsigned, const unsigned, Function)
+  {
+    POLY_ASSERT(false);
+  }
+
+  static uint64_t cellFaceStreamSize(const Tessellation<3, RealType>& mesh, const unsigned i)
+  {
+    return internal::cellFaceStreamSize(mesh, i);
+  }
+  static uint64_t cellFaceStreamSize(const Tessellation<2, RealType>&, const unsigned)
+  {
+    POLY_ASSERT(false);
+    return 0;
+  }
+};
+
+}
+
+#endif
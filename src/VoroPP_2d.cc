@@ -6,11 +6,13 @@
 #include <algorithm>
 #include <map>
 #include <limits>
+#include <cmath>
 #include <stdint.h>
 
 #include "polytope.hh"
-#include "polytope_internal.hh" // Pulls in POLY_ASSERT and VoroPP_2d.hh.
-#include "convexHull_2d.hh"
+#include "polytope_internal.hh" // Pulls in POLY_ASSERT.
+#include "timingUtilities.hh"
+#include "VoroPP_2d.hh"
 #include "container_2d.hh"
 
 namespace polytope {
@@ -45,8 +47,8 @@ updateMeshVertices(vector<Point2<UintType> >& vertices,
     ipt = vertices[i];
     ix0 = ipt.x > 0 ? ipt.x - 1 : ipt.x;
     iy0 = ipt.y > 0 ? ipt.y - 1 : ipt.y;
-    ix1 = ipt.x + 1;
-    iy1 = ipt.y + 1;
+    ix1 = ipt.x + 2;
+    iy1 = ipt.y + 2;
     newVertex = true;
     iy = iy0;
     while (newVertex and iy != iy1) {
@@ -73,6 +75,51 @@ updateMeshVertices(vector<Point2<UintType> >& vertices,
   return result;
 }
 
+//------------------------------------------------------------------------------
+// The periodic analogue of updateMeshVertices: the vertex hashes have already
+// been wrapped into the box [0, boxlen), and the fuzzy search for an existing
+// vertex wraps around the box as well.
+//------------------------------------------------------------------------------
+template<typename RealType, typename UintType>
+map<unsigned, unsigned>
+updatePeriodicMeshVertices(vector<Point2<UintType> >& vertices,
+                           map<Point2<UintType>, unsigned>& vertexHash2ID,
+                           Tessellation<2, RealType>& mesh,
+                           const RealType& xmin,
+                           const RealType& ymin,
+                           const RealType& fconv,
+                           const UintType* boxlen) {
+  const unsigned n = vertices.size();
+  bool newVertex;
+  unsigned i, j;
+  int ix, iy;
+  Point2<UintType> ipt, ipt1;
+  map<unsigned, unsigned> result;
+  for (i = 0; i != n; ++i) {
+    ipt = vertices[i];
+    newVertex = true;
+    for (iy = -1; newVertex and iy != 2; ++iy) {
+      for (ix = -1; newVertex and ix != 2; ++ix) {
+        ipt1 = Point2<UintType>((ipt.x + ix + boxlen[0]) % boxlen[0],
+                                (ipt.y + iy + boxlen[1]) % boxlen[1]);
+        newVertex = (vertexHash2ID.find(ipt1) == vertexHash2ID.end());
+      }
+    }
+    if (newVertex) {
+      j = vertexHash2ID.size();
+      vertexHash2ID[ipt] = j;
+      mesh.nodes.push_back(ipt.realx(xmin, fconv));
+      mesh.nodes.push_back(ipt.realy(ymin, fconv));
+      POLY_ASSERT(mesh.nodes.size()/2 == j + 1);
+      result[i] = j;
+    } else {
+      result[i] = vertexHash2ID[ipt1];
+    }
+  }
+  POLY_ASSERT(result.size() == vertices.size());
+  return result;
+}
+
 //------------------------------------------------------------------------------
 // Helper method to update our face info.
 //------------------------------------------------------------------------------
@@ -134,6 +181,12 @@ hashFace(const unsigned i, const unsigned j) {
   return (i < j ? make_pair(i, j) : make_pair(j, i));
 }
 
+//------------------------------------------------------------------------------
+// The number of generators per Voro++ block we aim for when sizing the block
+// grid automatically.
+//------------------------------------------------------------------------------
+const double particlesPerBlock = 5.6;
+
 } // end anonymous namespace
 
 //------------------------------------------------------------------------------
@@ -173,11 +226,12 @@ tessellate(const vector<RealType>& points,
   typedef typename polytope::DimensionTraits<2, RealType>::CoordHash CoordHash;
   typedef typename polytope::DimensionTraits<2, RealType>::IntPoint VertexHash;
 
+  ScopedTimer totalTimer("tessellate");
   const unsigned ncells = points.size()/2;
   const RealType xmin = low[0], ymin = low[1];
   const RealType xmax = high[0], ymax = high[1];
   const RealType scale = max(xmax - xmin, ymax - ymin);
-  const RealType dx = this->degeneracy();
+  const RealType dx = max(RealType(this->degeneracy()), RealType(1.0/double(1 << 30)));   // Keep the quantized box within a CoordHash.
   const RealType fconv = dx*scale;
 
   // Pre-conditions.
@@ -197,10 +251,6 @@ tessellate(const vector<RealType>& points,
   POLY_ASSERT(scale > 0.0);
 
   unsigned i, j, k, nv, icell;
-  double xc, yc;
-  vector<CoordHash> vertices;
-  vector<VertexHash > hullVertices;
-  PLC<2, CoordHash> hull;
 
   // Size the output arrays.
   mesh.cells.resize(ncells);
@@ -217,81 +267,249 @@ tessellate(const vector<RealType>& points,
   }
   POLY_ASSERT(generators.size() == 2*ncells);
 
+  // Size the Voro++ block grid.  Any direction not fixed at construction is
+  // chosen from the generator count and the box aspect ratio so that blocks
+  // hold about particlesPerBlock generators apiece.
+  const double lx = (xmax - xmin)/scale, ly = (ymax - ymin)/scale;
+  const double ilscale = sqrt(max(1U, ncells)/(particlesPerBlock*lx*ly));
+  const int nx = (mNx > 0 ? mNx : max(1, int(lx*ilscale + 1.0)));
+  const int ny = (mNy > 0 ? mNy : max(1, int(ly*ilscale + 1.0)));
+
+  ScopedTimer timer("voronoiCells");
+
   // Build the Voro++ container, and add the generators.
-  container_2d con(0.0, 1.0,
-                   0.0, 1.0,
-                   mNx, mNy,
+  container_2d con(0.0, lx,
+                   0.0, ly,
+                   nx, ny,
                    false, false, 8);
   for (i = 0; i != ncells; ++i) con.put(i, generators[2*i], generators[2*i + 1]);
   POLY_ASSERT(con.total_particles() == ncells);
 
-  // Dummy low coordinates in integer space for the convex hull.
-  CoordHash ilow[2] = {0U, 0U};
+  // Compute the Voro++ cells concurrently.  Every cell is independent, so each
+  // thread carries its own voro_compute_2d search state and cell and works
+  // through a share of the container blocks; the container itself is only
+  // read.  The hashed cell vertices are stashed per generator so the merge
+  // below is independent of the thread count and schedule.
+  vector<vector<VertexHash> > cellVertices(ncells);
+  const int nblocks = con.nxy;
+#pragma omp parallel
+  {
+    voro_compute_2d<container_2d> vc(con, nx, ny);
+    voronoicell_neighbor_2d cell;                  // Use cells with neighbor tracking.
+    int ij, q, ib, jb, kv;
+#pragma omp for schedule(dynamic)
+    for (ij = 0; ij < nblocks; ++ij) {
+      jb = ij/con.nx;
+      ib = ij - jb*con.nx;
+      for (q = 0; q < con.co[ij]; ++q) {
+        if (vc.compute_cell(cell, ij, q, ib, jb)) {
+          const unsigned icell = con.id[ij][q];       // The cell index.
+          POLY_ASSERT(icell < ncells);
+
+          // Read out the vertices counter-clockwise.  Voro++ stores them at
+          // twice their offset from the generator.
+          const double *pp = con.p[ij] + con.ps*q;
+          POLY_ASSERT(cell.p >= 3);
+          vector<VertexHash>& vertices = cellVertices[icell];
+          vertices.reserve(cell.p);
+          kv = 0;
+          do {
+            vertices.push_back(VertexHash(CoordHash(max(0.0, min(double(numeric_limits<CoordHash>::max() - 1), (pp[0] + 0.5*cell.pts[2*kv    ])/dx + 0.5))),
+                                          CoordHash(max(0.0, min(double(numeric_limits<CoordHash>::max() - 1), (pp[1] + 0.5*cell.pts[2*kv + 1])/dx + 0.5)))));
+            kv = cell.ed[2*kv];
+          } while (kv != 0);
+        }
+      }
+    }
+  }
+
+  timer.stop();
+  ScopedTimer mergeTimer("fillTessellation");
 
-  // Build the tessellation cell by cell.
-  voronoicell_neighbor_2d cell;                    // Use cells with neighbor tracking.
+  // Merge the cells into the mesh in generator order.
   map<FaceHash, unsigned> faceHash2ID;             // map from face hash to ID.
   map<VertexHash, unsigned> vertexHash2ID;         // map from vertex hash to ID.
-  c_loop_all_2d loop(con); // Loop over all cells.
-  if (loop.start()) {
-    do {
-      if (con.compute_cell(cell, loop)) {
-        icell = loop.pid();                   // The cell index.
-
-        // Get the cell centroid.
-        double *pp = con.p[loop.ij] + con.ps*loop.q;  // Man, this is obvious!
-        cell.centroid(xc, yc);
-        xc += pp[0];
-        yc += pp[1];
-
-        // Read out the vertices into a temporary array.
-        nv = cell.p;
-        POLY_ASSERT(nv >= 3);
-        vertices = vector<CoordHash>();
-        vertices.reserve(2*nv);
-        for (k = 0; k != nv; ++k) {
-          vertices.push_back(CoordHash(max(0.0, min(numeric_limits<CoordHash>::max() - 1.0, (xc + 0.5*cell.pts[2*k    ])/dx + 0.5))));
-          vertices.push_back(CoordHash(max(0.0, min(numeric_limits<CoordHash>::max() - 1.0, (yc + 0.5*cell.pts[2*k + 1])/dx + 0.5))));
-        }
+  for (icell = 0; icell != ncells; ++icell) {
+    vector<VertexHash>& vertices = cellVertices[icell];
+    if (vertices.empty()) continue;
+    nv = vertices.size();
+
+    // Add any new vertices from this cell to the global set, and update the vertexMap
+    // to point to the global (mesh) node IDs.
+    map<unsigned, unsigned> vertexMap = updateMeshVertices(vertices, vertexHash2ID, mesh, xmin, ymin, fconv);
+    vector<VertexHash>().swap(vertices);
+
+    // Build the faces by walking the cell vertices counter-clockwise,
+    // skipping any edges Voro++ left degenerate.
+    for (k = 0; k != nv; ++k) {
+      i = vertexMap[k];
+      j = vertexMap[(k + 1) % nv];
+      POLY_ASSERT(i < mesh.nodes.size()/2);
+      POLY_ASSERT(j < mesh.nodes.size()/2);
+      if (i != j) insertFaceInfo(hashFace(i, j), icell, i, j, faceHash2ID, mesh);
+    }
+  }
+  incrementCounter("cells", mesh.cells.size());
+}
 
-        // Sort the vertices counter-clockwise.
-        hull = convexHull_2d(vertices, ilow, CoordHash(1));
-//         if (!(hull.facets.size() == nv)) {
-//           cerr << "Input vertices: " << endl;
-//           for (unsigned k = 0; k != nv; ++k) cerr << "    " << k << " (" << vertices[2*k] << " " << vertices[2*k + 1] << ")" << endl;
-//           cerr << "Hull ordering: ";
-//           for (unsigned k = 0; k != hull.facets.size(); ++k) cerr << " " << hull.facets[k][0];
-//           cerr << endl;
-//         }
-        POLY_ASSERT(hull.facets.size() <= nv);            // There may be some degenerate vertices, but the hull method reduces to the unique set.
-        nv = hull.facets.size();
-        hullVertices = vector<VertexHash >();
-        hullVertices.reserve(nv);
-        for (k = 0; k != nv; ++k) {
-          i = hull.facets[k][0];
-          hullVertices.push_back(VertexHash(vertices[2*i], vertices[2*i + 1]));
-        }
+//------------------------------------------------------------------------------
+// Compute the tessellation in a periodic box.
+//------------------------------------------------------------------------------
+template<typename RealType>
+void
+VoroPP_2d<RealType>::
+tessellatePeriodic(const vector<RealType>& points,
+                   RealType* low,
+                   RealType* high,
+                   Tessellation<2, RealType>& mesh) const {
+
+  typedef pair<unsigned, unsigned> FaceHash;
+  typedef typename polytope::DimensionTraits<2, RealType>::CoordHash CoordHash;
+  typedef typename polytope::DimensionTraits<2, RealType>::IntPoint VertexHash;
+
+  ScopedTimer totalTimer("tessellate");
+  const unsigned ncells = points.size()/2;
+  const RealType xmin = low[0], ymin = low[1];
+  const RealType xmax = high[0], ymax = high[1];
+  const RealType scale = max(xmax - xmin, ymax - ymin);
+
+  // Pre-conditions.
+  POLY_ASSERT(xmin < xmax);
+  POLY_ASSERT(ymin < ymax);
+  POLY_ASSERT(points.size() % 2 == 0);
+  POLY_ASSERT(ncells > 0);
+  POLY_ASSERT(mesh.nodes.size() == 0);
+  POLY_ASSERT(mesh.cells.size() == 0);
+  POLY_ASSERT(mesh.faces.size() == 0);
+  POLY_ASSERT(mesh.faceCells.size() == 0);
 
-        // Add any new vertices from this cell to the global set, and update the vertexMap
-        // to point to the global (mesh) node IDs.
-        map<unsigned, unsigned> vertexMap = updateMeshVertices(hullVertices, vertexHash2ID, mesh, xmin, ymin, fconv);
-//         cerr << "Cell vertex mapping: " << endl;
-//         for (unsigned k = 0; k != nv; ++k) {
-//           cerr << "  --> " << hullVertices[k] << " " << vertexMap[k] << endl;
-//         }
-
-        // Build the faces by walking the cell vertices counter-clockwise.
-        for (k = 0; k != nv; ++k) {
-          i = vertexMap[k];
-          j = vertexMap[(k + 1) % nv];
-          POLY_ASSERT(i < mesh.nodes.size()/2);
-          POLY_ASSERT(j < mesh.nodes.size()/2);
-          POLY_ASSERT(i != j);
-          insertFaceInfo(hashFace(i, j), icell, i, j, faceHash2ID, mesh);
+  // The normalized box, and its length in quantized coordinates.  We cap the
+  // resolution so the quantized box always fits in a CoordHash.
+  const double lbox[2] = {(xmax - xmin)/scale, (ymax - ymin)/scale};
+  const double dx = max(double(this->degeneracy()), 1.0/double(1 << 30));
+  const RealType fconv = dx*scale;
+  const CoordHash ibox[2] = {max(CoordHash(1), CoordHash(lbox[0]/dx + 0.5)),
+                             max(CoordHash(1), CoordHash(lbox[1]/dx + 0.5))};
+
+  // Map the generators into the normalized box, wrapping any strays.
+  vector<double> generators(2*ncells);
+  unsigned i, j, k, nv, icell;
+  for (i = 0; i != ncells; ++i) {
+    for (j = 0; j != 2; ++j) {
+      double xi = (points[2*i + j] - low[j])/scale;
+      xi -= floor(xi/lbox[j])*lbox[j];
+      generators[2*i + j] = min(xi, lbox[j]);
+    }
+  }
+
+  // Size the Voro++ block grid as in the bounded case.
+  const double ilscale = sqrt(ncells/(particlesPerBlock*lbox[0]*lbox[1]));
+  const int nx = (mNx > 0 ? mNx : max(1, int(lbox[0]*ilscale + 1.0)));
+  const int ny = (mNy > 0 ? mNy : max(1, int(lbox[1]*ilscale + 1.0)));
+
+  ScopedTimer timer("voronoiCells");
+
+  // Build the periodic Voro++ container, and add the generators.
+  container_2d con(0.0, lbox[0],
+                   0.0, lbox[1],
+                   nx, ny,
+                   true, true, 8);
+  for (i = 0; i != ncells; ++i) con.put(i, generators[2*i], generators[2*i + 1]);
+  POLY_ASSERT(con.total_particles() == ncells);
+
+  // Compute the cells concurrently as in the bounded case.  We walk each cell
+  // counter-clockwise, wrapping the vertices into the box before hashing, and
+  // record for each edge the lattice shift taking the neighbor generator to
+  // the image that actually shares the edge.  That image is the reflection of
+  // this cell's generator through the edge.
+  vector<vector<VertexHash> > cellVertices(ncells);
+  vector<vector<int> > cellEdgeShifts(ncells);
+  const int nblocks = con.nxy;
+#pragma omp parallel
+  {
+    voro_compute_2d<container_2d> vc(con, 2*nx + 1, 2*ny + 1);
+    voronoicell_neighbor_2d cell;
+    int ij, q, ib, jb, kv, lv, jn;
+    double xa[2], xb[2], tx, ty, tmag, dist;
+#pragma omp for schedule(dynamic)
+    for (ij = 0; ij < nblocks; ++ij) {
+      jb = ij/con.nx;
+      ib = ij - jb*con.nx;
+      for (q = 0; q < con.co[ij]; ++q) {
+        if (vc.compute_cell(cell, ij, q, ib, jb)) {
+          const unsigned icell = con.id[ij][q];
+          POLY_ASSERT(icell < ncells);
+          const double *pp = con.p[ij] + con.ps*q;
+          vector<VertexHash>& vertices = cellVertices[icell];
+          vector<int>& shifts = cellEdgeShifts[icell];
+          vertices.reserve(cell.p);
+          shifts.reserve(2*cell.p);
+          kv = 0;
+          do {
+            lv = cell.ed[2*kv];
+            POLY_ASSERT(cell.ne[kv] >= 0 and cell.ne[kv] < ncells);
+            for (jn = 0; jn != 2; ++jn) {
+              xa[jn] = pp[jn] + 0.5*cell.pts[2*kv + jn];
+              xb[jn] = pp[jn] + 0.5*cell.pts[2*lv + jn];
+            }
+            CoordHash iv2[2];
+            for (jn = 0; jn != 2; ++jn) {
+              iv2[jn] = CoordHash(floor(xa[jn]/dx + 0.5)) % ibox[jn];
+              if (iv2[jn] < 0) iv2[jn] += ibox[jn];
+            }
+            vertices.push_back(VertexHash(iv2[0], iv2[1]));
+
+            // Reflect our generator through the edge kv->lv.
+            tx = xb[0] - xa[0];
+            ty = xb[1] - xa[1];
+            tmag = max(1.0e-300, tx*tx + ty*ty);
+            dist = ((xa[0] - pp[0])*ty - (xa[1] - pp[1])*tx)/tmag;
+            shifts.push_back(int(floor((pp[0] + 2.0*dist*ty - generators[2*cell.ne[kv]    ])/lbox[0] + 0.5)));
+            shifts.push_back(int(floor((pp[1] - 2.0*dist*tx - generators[2*cell.ne[kv] + 1])/lbox[1] + 0.5)));
+            kv = lv;
+          } while (kv != 0);
+          POLY_ASSERT(vertices.size() >= 3);
         }
       }
-    } while (loop.inc());
+    }
+  }
+
+  timer.stop();
+  ScopedTimer mergeTimer("fillTessellation");
+
+  // Merge the cells into the mesh in generator order.  The first cell to see
+  // an edge owns it, so its shift defines the face's periodic shift.
+  mesh.cells.resize(ncells);
+  map<FaceHash, unsigned> faceHash2ID;
+  map<VertexHash, unsigned> vertexHash2ID;
+  for (icell = 0; icell != ncells; ++icell) {
+    vector<VertexHash>& cellVerts = cellVertices[icell];
+    POLY_ASSERT(!cellVerts.empty());
+    nv = cellVerts.size();
+    map<unsigned, unsigned> vertexMap = updatePeriodicMeshVertices(cellVerts, vertexHash2ID, mesh, xmin, ymin, fconv, ibox);
+    for (k = 0; k != nv; ++k) {
+      i = vertexMap[k];
+      j = vertexMap[(k + 1) % nv];
+      if (i == j) continue;          // Degenerate edge.
+      const unsigned nfaces0 = mesh.faces.size();
+      insertFaceInfo(hashFace(i, j), icell, i, j, faceHash2ID, mesh);
+      const int* shift = &cellEdgeShifts[icell][2*k];
+      if (mesh.faces.size() > nfaces0 and (shift[0] != 0 or shift[1] != 0)) {
+        mesh.periodicFaces.push_back(nfaces0);
+        mesh.periodicFaceShifts.insert(mesh.periodicFaceShifts.end(), shift, shift + 2);
+      }
+    }
+    vector<VertexHash>().swap(cellVerts);
+    vector<int>().swap(cellEdgeShifts[icell]);
+  }
+
+  // Every face of a periodic tessellation is shared by two cells.
+  POLY_BEGIN_CONTRACT_SCOPE;
+  {
+    for (i = 0; i != mesh.faceCells.size(); ++i) POLY_ASSERT(mesh.faceCells[i].size() == 2);
   }
+  POLY_END_CONTRACT_SCOPE;
+  incrementCounter("cells", mesh.cells.size());
 }
 
 //------------------------------------------------------------------------------
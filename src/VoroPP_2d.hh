@@ -7,6 +7,8 @@
 #ifndef __Polytope_VoroPP_2d__
 #define __Polytope_VoroPP_2d__
 
+#ifdef HAVE_VOROPP
+
 #include <vector>
 #include <cmath>
 
@@ -20,16 +22,27 @@ class VoroPP_2d: public Tessellator<2, RealType> {
   //--------------------------- Public Interface ---------------------------//
 public:
 
+  typedef typename Tessellator<2, RealType>::QuantizedTessellation QuantizedTessellation;
+
   //! Constructor.
   //! The parameters (nx, ny) are used internally to Voro++ in order to make
   //! the selection of generators that can influence any particular generator
   //! more efficient.  The results of the tessellation should be independent of
-  //! of these choices -- they only affect computational expense.
+  //! of these choices -- they only affect computational expense.  A value of
+  //! zero (the default) sizes that direction automatically from the number of
+  //! generators and the shape of the box, aiming for a fixed number of
+  //! generators per box.
+  //! When polytope is built with OpenMP the cells are computed concurrently,
+  //! with threads sharing out the boxes.
   //! \param nx The number of boxes to carve the volume into in the x direction.
   //! \param ny The number of boxes to carve the volume into in the y direction.
-  //! \param degeneracy The tolerance for merging nodes in a cell.
-  VoroPP_2d(const unsigned nx = 20,
-            const unsigned ny = 20,
+  //! \param degeneracy The tolerance for merging nodes in a cell, relative
+  //!                   to the largest side of the box.  The box and periodic
+  //!                   tessellations hash the nodes on a grid of this spacing
+  //!                   that has to fit in a CoordHash, so anything below
+  //!                   2^-30 (about 9.3e-10) is treated as 2^-30.
+  VoroPP_2d(const unsigned nx = 0,
+            const unsigned ny = 0,
             const RealType degeneracy = RealType(1.0e-12));
   ~VoroPP_2d();
 
@@ -50,13 +63,29 @@ public:
                           Tessellation<2, RealType>& mesh) const;
 
 
+  //! Generate a Voronoi tessellation in a box periodic in both directions,
+  //! using a periodic Voro++ container rather than ghost generators.
+  virtual void tessellatePeriodic(const std::vector<RealType>& points,
+                                  RealType* low,
+                                  RealType* high,
+                                  Tessellation<2, RealType>& mesh) const;
+
+  //! Voro++ only builds bounded and periodic box tessellations, so there is
+  //! no quantized (unbounded) tessellation to offer.
+  virtual void tessellateQuantized(QuantizedTessellation& qmesh) const {
+    error(this->name() + " only supports box and periodic box tessellations");
+  }
+
+  // This Tessellator handles periodic boxes.
+  bool handlesPeriodicBoxes() const { return true; }
+
   // This Tessellator does not handle PLCs... yet.
   bool handlesPLCs() const { return false; }
 
   // The Tessellator's name
   std::string name() const { return "VoroTessellator2d"; }
 
-  // Access our attributes.
+  // Access our attributes (zero means the box count is chosen automatically).
   unsigned nx() const { return mNx; }
   unsigned ny() const { return mNy; }
 
@@ -78,3 +107,4 @@ private:
 }
 
 #endif
+#endif
@@ -3,6 +3,7 @@
 //----------------------------------------------------------------------------//
 #include <stdint.h>
 #include <cstdlib>
+#include <cmath>
 #include <iostream>
 #include <iterator>
 #include <algorithm>
@@ -10,7 +11,9 @@
 #include <set>
 
 #include "polytope.hh"
-#include "polytope_internal.hh" // Pulls in POLY_ASSERT and VoroPP_3d.hh.
+#include "polytope_internal.hh" // Pulls in POLY_ASSERT.
+#include "timingUtilities.hh"
+#include "VoroPP_3d.hh"
 #include "Point.hh"
 #include "container.hh"
 
@@ -48,9 +51,9 @@ updateMeshVertices(vector<Point3<UintType> >& vertices,
     ix0 = ipt.x > 0 ? ipt.x - 1 : ipt.x;
     iy0 = ipt.y > 0 ? ipt.y - 1 : ipt.y;
     iz0 = ipt.z > 0 ? ipt.z - 1 : ipt.z;
-    ix1 = ipt.x + 1;
-    iy1 = ipt.y + 1;
-    iz1 = ipt.z + 1;
+    ix1 = ipt.x + 2;
+    iy1 = ipt.y + 2;
+    iz1 = ipt.z + 2;
     newVertex = true;
     iz = iz0;
     while (newVertex and iz != iz1) {
@@ -82,6 +85,89 @@ updateMeshVertices(vector<Point3<UintType> >& vertices,
   return result;
 }
 
+//------------------------------------------------------------------------------
+// The periodic analogue of updateMeshVertices: the vertex hashes have already
+// been wrapped into the box [0, boxlen), and the fuzzy search for an existing
+// vertex wraps around the box as well.
+//------------------------------------------------------------------------------
+template<typename RealType, typename UintType>
+map<unsigned, unsigned>
+updatePeriodicMeshVertices(vector<Point3<UintType> >& vertices,
+                           map<Point3<UintType>, unsigned>& vertexHash2ID,
+                           Tessellation<3, RealType>& mesh,
+                           const RealType& xmin,
+                           const RealType& ymin,
+                           const RealType& zmin,
+                           const RealType& fconv,
+                           const UintType* boxlen) {
+  const unsigned n = vertices.size();
+  bool newVertex;
+  unsigned i, j;
+  int ix, iy, iz;
+  Point3<UintType> ipt, ipt1;
+  map<unsigned, unsigned> result;
+  for (i = 0; i != n; ++i) {
+    ipt = vertices[i];
+    newVertex = true;
+    for (iz = -1; newVertex and iz != 2; ++iz) {
+      for (iy = -1; newVertex and iy != 2; ++iy) {
+        for (ix = -1; newVertex and ix != 2; ++ix) {
+          ipt1 = Point3<UintType>((ipt.x + ix + boxlen[0]) % boxlen[0],
+                                  (ipt.y + iy + boxlen[1]) % boxlen[1],
+                                  (ipt.z + iz + boxlen[2]) % boxlen[2]);
+          newVertex = (vertexHash2ID.find(ipt1) == vertexHash2ID.end());
+        }
+      }
+    }
+    if (newVertex) {
+      j = vertexHash2ID.size();
+      vertexHash2ID[ipt] = j;
+      mesh.nodes.push_back(ipt.realx(xmin, fconv));
+      mesh.nodes.push_back(ipt.realy(ymin, fconv));
+      mesh.nodes.push_back(ipt.realz(zmin, fconv));
+      POLY_ASSERT(mesh.nodes.size()/3 == j + 1);
+      result[i] = j;
+    } else {
+      result[i] = vertexHash2ID[ipt1];
+    }
+  }
+  POLY_ASSERT(result.size() == vertices.size());
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// The quantized analogue of updateMeshVertices: the vertices are already in
+// the quantized coordinates of a QuantizedTessellation, and we collect the
+// unique ones as its nodes.
+//------------------------------------------------------------------------------
+template<typename IntType>
+vector<int>
+updateQuantizedVertices(const vector<Point3<IntType> >& vertices,
+                        map<Point3<IntType>, int>& vertexHash2ID,
+                        vector<Point3<IntType> >& nodes) {
+  const unsigned n = vertices.size();
+  vector<int> result(n);
+  for (unsigned i = 0; i != n; ++i) {
+    const Point3<IntType>& ipt = vertices[i];
+    typename map<Point3<IntType>, int>::const_iterator itr = vertexHash2ID.end();
+    for (int iz = -1; itr == vertexHash2ID.end() and iz != 2; ++iz) {
+      for (int iy = -1; itr == vertexHash2ID.end() and iy != 2; ++iy) {
+        for (int ix = -1; itr == vertexHash2ID.end() and ix != 2; ++ix) {
+          itr = vertexHash2ID.find(Point3<IntType>(ipt.x + ix, ipt.y + iy, ipt.z + iz));
+        }
+      }
+    }
+    if (itr == vertexHash2ID.end()) {
+      result[i] = nodes.size();
+      vertexHash2ID[ipt] = result[i];
+      nodes.push_back(ipt);
+    } else {
+      result[i] = itr->second;
+    }
+  }
+  return result;
+}
+
 //------------------------------------------------------------------------------
 // Helper method to update our face info.
 //------------------------------------------------------------------------------
@@ -124,6 +210,13 @@ insertFaceInfo(const set<unsigned>& fhashi,
   }
 }
 
+//------------------------------------------------------------------------------
+// The number of generators per Voro++ block we aim for when sizing the block
+// grid automatically.  This is the value Voro++ itself uses when guessing an
+// optimal grid.
+//------------------------------------------------------------------------------
+const double particlesPerBlock = 5.6;
+
 //------------------------------------------------------------------------------
 // Define our own local random number generator wrapping the standard srand &
 // rand methods.
@@ -172,11 +265,12 @@ tessellate(const vector<RealType>& points,
   typedef set<unsigned> FaceHash;
   typedef typename polytope::DimensionTraits<3, RealType>::IntPoint VertexHash;
 
+  ScopedTimer totalTimer("tessellate");
   const unsigned ncells = points.size()/3;
   const RealType xmin = low[0], ymin = low[1], zmin = low[2];
   const RealType xmax = high[0], ymax = high[1], zmax = high[2];
   const RealType scale = max(xmax - xmin, max(ymax - ymin, zmax - zmin));
-  const RealType dx = this->degeneracy();
+  const RealType dx = max(RealType(this->degeneracy()), RealType(1.0/double(1 << 30)));   // Keep the quantized box within a CoordHash.
   const RealType fconv = dx*scale;
   const RealType randomfuzz = 0.0; // 2.0*dx;
 
@@ -196,8 +290,7 @@ tessellate(const vector<RealType>& points,
   POLY_ASSERT(mesh.faces.size() == 0);
   POLY_ASSERT(mesh.faceCells.size() == 0);
 
-  unsigned i, j, k, iv, iface, nf, nvf, icell;
-  double xc, yc, zc;
+  unsigned i, j, k, iv, nf, nvf, icell;
 
   // Size the output arrays.
   mesh.cells.resize(ncells);
@@ -216,98 +309,463 @@ tessellate(const vector<RealType>& points,
   }
   POLY_ASSERT(generators.size() == 3*ncells);
 
+  // Size the Voro++ block grid.  Any direction not fixed at construction is
+  // chosen from the generator count and the box aspect ratio so that blocks
+  // hold about particlesPerBlock generators apiece.
+  const double lx = (xmax - xmin)/scale, ly = (ymax - ymin)/scale, lz = (zmax - zmin)/scale;
+  const double ilscale = pow(max(1U, ncells)/(particlesPerBlock*lx*ly*lz), 1.0/3.0);
+  const int nx = (mNx > 0 ? mNx : max(1, int(lx*ilscale + 1.0)));
+  const int ny = (mNy > 0 ? mNy : max(1, int(ly*ilscale + 1.0)));
+  const int nz = (mNz > 0 ? mNz : max(1, int(lz*ilscale + 1.0)));
+
+  ScopedTimer timer("voronoiCells");
+
   // Build the Voro++ container, and add the generators.
-  container con(0.0, 1.0,
-                0.0, 1.0,
-                0.0, 1.0,
-                mNx, mNy, mNz,
+  container con(0.0, lx,
+                0.0, ly,
+                0.0, lz,
+                nx, ny, nz,
                 false, false, false, 8);
   for (i = 0; i != ncells; ++i) con.put(i, 
-                                        max(0.0, min(1.0, generators[3*i]     + (random01() - 0.5)*randomfuzz)),
-                                        max(0.0, min(1.0, generators[3*i + 1] + (random01() - 0.5)*randomfuzz)),
-                                        max(0.0, min(1.0, generators[3*i + 2] + (random01() - 0.5)*randomfuzz)));
+                                        max(0.0, min(lx, generators[3*i]     + (random01() - 0.5)*randomfuzz)),
+                                        max(0.0, min(ly, generators[3*i + 1] + (random01() - 0.5)*randomfuzz)),
+                                        max(0.0, min(lz, generators[3*i + 2] + (random01() - 0.5)*randomfuzz)));
   POLY_ASSERT(con.total_particles() == ncells);
 
-  // Build the tessellation cell by cell.
-  voronoicell cell;                                // The Voro++ cell (without neighbor tracking).
+  // Compute the Voro++ cells concurrently.  Every cell is independent, so each
+  // thread carries its own voro_compute search state and voronoicell and works
+  // through a share of the container blocks; the container itself is only
+  // read.  The hashed vertices and face-vertex lists are stashed per generator
+  // so the merge below is independent of the thread count and schedule.
+  vector<vector<VertexHash> > cellVertices(ncells);
+  vector<vector<int> > cellFaceVertexIndices(ncells);
+  const int nblocks = con.nxyz;
+#pragma omp parallel
+  {
+    voro_compute<container> vc(con, nx, ny, nz);
+    voronoicell cell;                              // The Voro++ cell (without neighbor tracking).
+    int ijk, q, ib, jb, kb, k;
+#pragma omp for schedule(dynamic)
+    for (ijk = 0; ijk < nblocks; ++ijk) {
+      kb = ijk/con.nxy;
+      jb = (ijk - kb*con.nxy)/con.nx;
+      ib = ijk - kb*con.nxy - jb*con.nx;
+      for (q = 0; q < con.co[ijk]; ++q) {
+        if (vc.compute_cell(cell, ijk, q, ib, jb, kb)) {
+          const unsigned icell = con.id[ijk][q];      // The cell index.
+          POLY_ASSERT(icell < ncells);
+
+          // Read out the vertices and face vertex indices.  Voro++ stores
+          // the vertices at twice their offset from the generator.
+          const double *pp = con.p[ijk] + con.ps*q;
+          vector<VertexHash>& vertices = cellVertices[icell];
+          vertices.reserve(cell.p);
+          for (k = 0; k != cell.p; ++k) vertices.push_back(VertexHash(RealType(pp[0] + 0.5*cell.pts[3*k]),
+                                                                      RealType(pp[1] + 0.5*cell.pts[3*k + 1]),
+                                                                      RealType(pp[2] + 0.5*cell.pts[3*k + 2]),
+                                                                      dx));
+          POLY_ASSERT(vertices.size() >= 4);
+          cell.face_vertices(cellFaceVertexIndices[icell]);
+        }
+      }
+    }
+  }
+
+  timer.stop();
+  ScopedTimer mergeTimer("fillTessellation");
+
+  // Merge the cells into the mesh in generator order.
   map<FaceHash, unsigned> faceHash2ID;             // map from face hash to mesh ID.
   map<VertexHash, unsigned> vertexHash2ID;         // map from vertex hash to mesh ID.
-  c_loop_all loop(con); // Loop over all cells.
-  if (loop.start()) {
-    do {
-      if (con.compute_cell(cell, loop)) {
-        icell = loop.pid();                   // The cell index.
-
-        // Get the cell centroid.
-        double *pp = con.p[loop.ijk] + con.ps*loop.q;   // Man, this is obvious!
-        cell.centroid(xc, yc, zc);
-        xc += pp[0];
-        yc += pp[1];
-        zc += pp[2];
-
-        // Read out the vertices into a temporary array.
-        vector<VertexHash > vertices;
-        for (k = 0; k != cell.p; ++k) vertices.push_back(VertexHash(RealType(xc + 0.5*cell.pts[3*k]),
-								    RealType(yc + 0.5*cell.pts[3*k + 1]),
-								    RealType(zc + 0.5*cell.pts[3*k + 2]),
-								    dx));
-        POLY_ASSERT(vertices.size() >= 4);
-
-        // Add any new vertices from this cell to the global set, and update the vertexMap
-        // to point to the global (mesh) node IDs.
-        map<unsigned, unsigned> vertexMap = updateMeshVertices(vertices, vertexHash2ID, mesh, xmin, ymin, zmin, fconv);
-
-        // // Blago!
-        // std::cout << "Mesh vertices for cell " << icell << " : ";
-        // std::copy(vertices.begin(), vertices.end(), ostream_iterator<VertexHash >(std::cout, " "));
-        // cout << endl;
-        // std::cout << "                           ";
-        // for (k = 0; k != vertices.size(); ++k) std::cout << "(" 
-        //                                                  << vertices[k].realx(xmin, fconv) << " "
-        //                                                  << vertices[k].realy(ymin, fconv) << " "
-        //                                                  << vertices[k].realz(zmin, fconv) << ") ";
-        // cout << endl;
-        // std::cout << "                           ";
-        // for (k = 0; k != vertices.size(); ++k) std::cout << vertexMap[k] << " ";
-        // cout << endl;
-        // POLY_ASSERT(vertices.size() == 8);
-        // // Blago!
-
-        // Read the face vertex indices to a temporary array as well.
-        vector<int> voroFaceVertexIndices;
-        cell.face_vertices(voroFaceVertexIndices);
-
-        // Walk the faces.
-        nf = cell.number_of_faces();
-        POLY_ASSERT(nf >= 4);
-        k = 0;
-        for (iface = 0; iface != nf; ++iface) {
-          POLY_ASSERT(k < voroFaceVertexIndices.size());
-          FaceHash fhashi;
-          vector<unsigned> faceNodeIDs;
-
-          // Read the vertices for this face.  We assume they are listed in the
-          // proper counter-clockwise order (viewed from outside)!
-          nvf = voroFaceVertexIndices[k++];
-          POLY_ASSERT(nvf >= 3);
-          for (iv = 0; iv != nvf; ++iv) {
-            POLY_ASSERT(k < voroFaceVertexIndices.size());
-            POLY_ASSERT(vertexMap.find(voroFaceVertexIndices[k]) != vertexMap.end());
-            j = vertexMap[voroFaceVertexIndices[k++]];
-
-            // Is this vertex new to the face?
-            if (fhashi.find(j) == fhashi.end()) {
-              fhashi.insert(j);
-              faceNodeIDs.push_back(j);
+  for (icell = 0; icell != ncells; ++icell) {
+    vector<VertexHash>& vertices = cellVertices[icell];
+    if (vertices.empty()) continue;
+
+    // Add any new vertices from this cell to the global set, and update the vertexMap
+    // to point to the global (mesh) node IDs.
+    map<unsigned, unsigned> vertexMap = updateMeshVertices(vertices, vertexHash2ID, mesh, xmin, ymin, zmin, fconv);
+
+    // Walk the faces.
+    const vector<int>& voroFaceVertexIndices = cellFaceVertexIndices[icell];
+    k = 0;
+    nf = 0;
+    while (k < voroFaceVertexIndices.size()) {
+      FaceHash fhashi;
+      vector<unsigned> faceNodeIDs;
+
+      // Read the vertices for this face.  We assume they are listed in the
+      // proper counter-clockwise order (viewed from outside)!
+      nvf = voroFaceVertexIndices[k++];
+      POLY_ASSERT(nvf >= 3);
+      for (iv = 0; iv != nvf; ++iv) {
+        POLY_ASSERT(k < voroFaceVertexIndices.size());
+        POLY_ASSERT(vertexMap.find(voroFaceVertexIndices[k]) != vertexMap.end());
+        j = vertexMap[voroFaceVertexIndices[k++]];
+
+        // Is this vertex new to the face?
+        if (fhashi.find(j) == fhashi.end()) {
+          fhashi.insert(j);
+          faceNodeIDs.push_back(j);
+        }
+      }
+
+      // Add this face to the cell, unless Voro++ left it degenerate.
+      if (faceNodeIDs.size() >= 3) {
+        insertFaceInfo(fhashi, icell, faceNodeIDs, faceHash2ID, mesh);
+        ++nf;
+      }
+    }
+    POLY_ASSERT(nf >= 4);
+
+    // Release the per-cell scratch as we go.
+    vector<VertexHash>().swap(vertices);
+    vector<int>().swap(cellFaceVertexIndices[icell]);
+  }
+  incrementCounter("cells", mesh.cells.size());
+}
+
+//------------------------------------------------------------------------------
+// Compute the tessellation in a periodic box.
+//------------------------------------------------------------------------------
+template<typename RealType>
+void
+VoroPP_3d<RealType>::
+tessellatePeriodic(const vector<RealType>& points,
+                   RealType* low,
+                   RealType* high,
+                   Tessellation<3, RealType>& mesh) const {
+
+  typedef set<unsigned> FaceHash;
+  typedef typename polytope::DimensionTraits<3, RealType>::CoordHash CoordHash;
+  typedef typename polytope::DimensionTraits<3, RealType>::IntPoint VertexHash;
+
+  ScopedTimer totalTimer("tessellate");
+  const unsigned ncells = points.size()/3;
+  const RealType xmin = low[0], ymin = low[1], zmin = low[2];
+  const RealType xmax = high[0], ymax = high[1], zmax = high[2];
+  const RealType scale = max(xmax - xmin, max(ymax - ymin, zmax - zmin));
+
+  // Pre-conditions.
+  POLY_ASSERT(xmin < xmax);
+  POLY_ASSERT(ymin < ymax);
+  POLY_ASSERT(zmin < zmax);
+  POLY_ASSERT(points.size() % 3 == 0);
+  POLY_ASSERT(ncells > 0);
+  POLY_ASSERT(mesh.nodes.size() == 0);
+  POLY_ASSERT(mesh.cells.size() == 0);
+  POLY_ASSERT(mesh.faces.size() == 0);
+  POLY_ASSERT(mesh.faceCells.size() == 0);
+
+  // The normalized box, and its length in quantized coordinates.  We cap the
+  // resolution so the quantized box always fits in a CoordHash.
+  const double lbox[3] = {(xmax - xmin)/scale, (ymax - ymin)/scale, (zmax - zmin)/scale};
+  const double dx = max(double(this->degeneracy()), 1.0/double(1 << 30));
+  const RealType fconv = dx*scale;
+  const CoordHash ibox[3] = {max(CoordHash(1), CoordHash(lbox[0]/dx + 0.5)),
+                             max(CoordHash(1), CoordHash(lbox[1]/dx + 0.5)),
+                             max(CoordHash(1), CoordHash(lbox[2]/dx + 0.5))};
+
+  // Map the generators into the normalized box, wrapping any strays.
+  vector<double> generators(3*ncells);
+  unsigned i, j, k, iv, kf, nf, nvf, icell;
+  for (i = 0; i != ncells; ++i) {
+    for (j = 0; j != 3; ++j) {
+      double xi = (points[3*i + j] - low[j])/scale;
+      xi -= floor(xi/lbox[j])*lbox[j];
+      generators[3*i + j] = min(xi, lbox[j]);
+    }
+  }
+
+  // Size the Voro++ block grid as in the bounded case.
+  const double ilscale = pow(ncells/(particlesPerBlock*lbox[0]*lbox[1]*lbox[2]), 1.0/3.0);
+  const int nx = (mNx > 0 ? mNx : max(1, int(lbox[0]*ilscale + 1.0)));
+  const int ny = (mNy > 0 ? mNy : max(1, int(lbox[1]*ilscale + 1.0)));
+  const int nz = (mNz > 0 ? mNz : max(1, int(lbox[2]*ilscale + 1.0)));
+
+  ScopedTimer timer("voronoiCells");
+
+  // Build the periodic Voro++ container, and add the generators.
+  container con(0.0, lbox[0],
+                0.0, lbox[1],
+                0.0, lbox[2],
+                nx, ny, nz,
+                true, true, true, 8);
+  for (i = 0; i != ncells; ++i) con.put(i, generators[3*i], generators[3*i + 1], generators[3*i + 2]);
+  POLY_ASSERT(con.total_particles() == ncells);
+
+  // Compute the cells concurrently as in the bounded case, now tracking the
+  // neighbor across each face.  Vertices are wrapped into the box before
+  // hashing, and for each face we record the lattice shift taking the
+  // neighbor generator to the image that actually shares the face.  That image
+  // is the reflection of this cell's generator through the face plane.
+  vector<vector<VertexHash> > cellVertices(ncells);
+  vector<vector<int> > cellFaceVertexIndices(ncells), cellFaceShifts(ncells);
+  const int nblocks = con.nxyz;
+#pragma omp parallel
+  {
+    voro_compute<container> vc(con, 2*nx + 1, 2*ny + 1, 2*nz + 1);
+    voronoicell_neighbor cell;
+    vector<int> neighbors;
+    vector<double> normals;
+    int ijk, q, ib, jb, kb, kk, kf, jf, jn;
+    double xv[3], dist;
+#pragma omp for schedule(dynamic)
+    for (ijk = 0; ijk < nblocks; ++ijk) {
+      kb = ijk/con.nxy;
+      jb = (ijk - kb*con.nxy)/con.nx;
+      ib = ijk - kb*con.nxy - jb*con.nx;
+      for (q = 0; q < con.co[ijk]; ++q) {
+        if (vc.compute_cell(cell, ijk, q, ib, jb, kb)) {
+          const unsigned icell = con.id[ijk][q];
+          POLY_ASSERT(icell < ncells);
+          const double *pp = con.p[ijk] + con.ps*q;
+
+          // Wrap and hash the vertices.
+          vector<VertexHash>& vertices = cellVertices[icell];
+          vertices.reserve(cell.p);
+          for (kk = 0; kk != cell.p; ++kk) {
+            CoordHash iv3[3];
+            for (jn = 0; jn != 3; ++jn) {
+              iv3[jn] = CoordHash(floor((pp[jn] + 0.5*cell.pts[3*kk + jn])/dx + 0.5)) % ibox[jn];
+              if (iv3[jn] < 0) iv3[jn] += ibox[jn];
+            }
+            vertices.push_back(VertexHash(iv3[0], iv3[1], iv3[2]));
+          }
+          POLY_ASSERT(vertices.size() >= 4);
+          cell.face_vertices(cellFaceVertexIndices[icell]);
+
+          // The periodic shift to each neighbor image.
+          cell.neighbors(neighbors);
+          cell.normals(normals);
+          vector<int>& shifts = cellFaceShifts[icell];
+          shifts.reserve(3*neighbors.size());
+          kk = 0;
+          for (kf = 0; kf != neighbors.size(); ++kf) {
+            POLY_ASSERT(neighbors[kf] >= 0 and neighbors[kf] < ncells);
+            jf = cellFaceVertexIndices[icell][kk + 1];
+            dist = 0.0;
+            for (jn = 0; jn != 3; ++jn) dist += 0.5*cell.pts[3*jf + jn]*normals[3*kf + jn];
+            for (jn = 0; jn != 3; ++jn) {
+              xv[jn] = pp[jn] + 2.0*dist*normals[3*kf + jn];
+              shifts.push_back(int(floor((xv[jn] - generators[3*neighbors[kf] + jn])/lbox[jn] + 0.5)));
             }
+            kk += cellFaceVertexIndices[icell][kk] + 1;
           }
-          POLY_ASSERT(faceNodeIDs.size() >= 3);
+        }
+      }
+    }
+  }
 
-          // Add this face to the cell.
-          insertFaceInfo(fhashi, icell, faceNodeIDs, faceHash2ID, mesh);
+  timer.stop();
+  ScopedTimer mergeTimer("fillTessellation");
+
+  // Merge the cells into the mesh in generator order.  The first cell to see
+  // a face owns it, so its shifts define the face's periodic shift.
+  mesh.cells.resize(ncells);
+  map<FaceHash, unsigned> faceHash2ID;
+  map<VertexHash, unsigned> vertexHash2ID;
+  for (icell = 0; icell != ncells; ++icell) {
+    vector<VertexHash>& vertices = cellVertices[icell];
+    POLY_ASSERT(!vertices.empty());
+    map<unsigned, unsigned> vertexMap = updatePeriodicMeshVertices(vertices, vertexHash2ID, mesh, xmin, ymin, zmin, fconv, ibox);
+
+    const vector<int>& voroFaceVertexIndices = cellFaceVertexIndices[icell];
+    k = 0;
+    kf = 0;
+    nf = 0;
+    while (k < voroFaceVertexIndices.size()) {
+      FaceHash fhashi;
+      vector<unsigned> faceNodeIDs;
+      nvf = voroFaceVertexIndices[k++];
+      POLY_ASSERT(nvf >= 3);
+      for (iv = 0; iv != nvf; ++iv) {
+        POLY_ASSERT(k < voroFaceVertexIndices.size());
+        j = vertexMap[voroFaceVertexIndices[k++]];
+        if (fhashi.find(j) == fhashi.end()) {
+          fhashi.insert(j);
+          faceNodeIDs.push_back(j);
         }
       }
-    } while (loop.inc());
+      const int* shift = &cellFaceShifts[icell][3*kf++];
+      if (faceNodeIDs.size() < 3) continue;      // Degenerate face.
+      const unsigned nfaces0 = mesh.faces.size();
+      insertFaceInfo(fhashi, icell, faceNodeIDs, faceHash2ID, mesh);
+      if (mesh.faces.size() > nfaces0 and
+          (shift[0] != 0 or shift[1] != 0 or shift[2] != 0)) {
+        mesh.periodicFaces.push_back(nfaces0);
+        mesh.periodicFaceShifts.insert(mesh.periodicFaceShifts.end(), shift, shift + 3);
+      }
+      ++nf;
+    }
+    POLY_ASSERT(nf >= 4);
+    vector<VertexHash>().swap(vertices);
+    vector<int>().swap(cellFaceVertexIndices[icell]);
+    vector<int>().swap(cellFaceShifts[icell]);
+  }
+
+  // Every face of a periodic tessellation is shared by two cells.
+  POLY_BEGIN_CONTRACT_SCOPE;
+  {
+    for (i = 0; i != mesh.faceCells.size(); ++i) POLY_ASSERT(mesh.faceCells[i].size() == 2);
+  }
+  POLY_END_CONTRACT_SCOPE;
+  incrementCounter("cells", mesh.cells.size());
+}
+
+//------------------------------------------------------------------------------
+// Compute the quantized tessellation.
+//------------------------------------------------------------------------------
+template<typename RealType>
+void
+VoroPP_3d<RealType>::
+tessellateQuantized(QuantizedTessellation& qmesh) const {
+
+  typedef set<unsigned> FaceHash;
+  typedef typename QuantizedTessellation::IntPoint IntPoint;
+  typedef pair<int, int> EdgeHash;
+
+  const unsigned ncells = qmesh.generators.size();
+  POLY_ASSERT(ncells > 0);
+  POLY_ASSERT(qmesh.nodes.empty() and qmesh.edges.empty() and qmesh.faces.empty());
+
+  // The quantized box is the bounding box of the PLC (or the generators)
+  // grown by twice its largest extent on every side.  We put the walls of the
+  // Voro++ container a quarter of that extent outside the inner box, so every
+  // cell reaches well past the boundary it will be clipped to.
+  const double extent = (qmesh.length > 0.0 ? qmesh.length/5.0 : 1.0);
+  double low[3], high[3];
+  unsigned i, j, k, iv, nf, nvf;
+  for (j = 0; j != 3; ++j) {
+    low[j] = qmesh.xmin[j] + 2.0*extent;
+    high[j] = qmesh.xmax[j] - 2.0*extent;
+  }
+  vector<double> generators(3*ncells);
+  for (i = 0; i != ncells; ++i) {
+    RealType gen[3];
+    qmesh.dequantize(&qmesh.generators[i].x, gen);
+    for (j = 0; j != 3; ++j) {
+      generators[3*i + j] = gen[j];
+      low[j] = min(low[j], generators[3*i + j]);
+      high[j] = max(high[j], generators[3*i + j]);
+    }
+  }
+  for (j = 0; j != 3; ++j) {
+    low[j] = max(double(qmesh.xmin[j]), low[j] - 0.25*extent);
+    high[j] = min(double(qmesh.xmax[j]), high[j] + 0.25*extent);
+  }
+
+  // Scale to a unit box, as in the bounded case.
+  const double scale = max(high[0] - low[0], max(high[1] - low[1], high[2] - low[2]));
+  const double lbox[3] = {(high[0] - low[0])/scale, (high[1] - low[1])/scale, (high[2] - low[2])/scale};
+  for (i = 0; i != ncells; ++i) {
+    for (j = 0; j != 3; ++j) {
+      generators[3*i + j] = max(0.0, min(lbox[j], (generators[3*i + j] - low[j])/scale));
+    }
+  }
+  const double ilscale = pow(ncells/(particlesPerBlock*lbox[0]*lbox[1]*lbox[2]), 1.0/3.0);
+  const int nx = (mNx > 0 ? mNx : max(1, int(lbox[0]*ilscale + 1.0)));
+  const int ny = (mNy > 0 ? mNy : max(1, int(lbox[1]*ilscale + 1.0)));
+  const int nz = (mNz > 0 ? mNz : max(1, int(lbox[2]*ilscale + 1.0)));
+
+  ScopedTimer timer("voronoiCells");
+
+  container con(0.0, lbox[0],
+                0.0, lbox[1],
+                0.0, lbox[2],
+                nx, ny, nz,
+                false, false, false, 8);
+  for (i = 0; i != ncells; ++i) con.put(i, generators[3*i], generators[3*i + 1], generators[3*i + 2]);
+  POLY_ASSERT(con.total_particles() == ncells);
+
+  // Compute the cells concurrently as in the bounded case, quantizing the
+  // vertices as we go.
+  vector<vector<IntPoint> > cellVertices(ncells);
+  vector<vector<int> > cellFaceVertexIndices(ncells);
+  const int nblocks = con.nxyz;
+#pragma omp parallel
+  {
+    voro_compute<container> vc(con, nx, ny, nz);
+    voronoicell cell;
+    int ijk, q, ib, jb, kb, kk, jn;
+    RealType xv[3];
+#pragma omp for schedule(dynamic)
+    for (ijk = 0; ijk < nblocks; ++ijk) {
+      kb = ijk/con.nxy;
+      jb = (ijk - kb*con.nxy)/con.nx;
+      ib = ijk - kb*con.nxy - jb*con.nx;
+      for (q = 0; q < con.co[ijk]; ++q) {
+        if (vc.compute_cell(cell, ijk, q, ib, jb, kb)) {
+          const unsigned icell = con.id[ijk][q];
+          POLY_ASSERT(icell < ncells);
+          const double *pp = con.p[ijk] + con.ps*q;
+          vector<IntPoint>& vertices = cellVertices[icell];
+          vertices.resize(cell.p);
+          for (kk = 0; kk != cell.p; ++kk) {
+            for (jn = 0; jn != 3; ++jn) xv[jn] = low[jn] + scale*(pp[jn] + 0.5*cell.pts[3*kk + jn]);
+            qmesh.quantize(xv, &vertices[kk].x);
+          }
+          POLY_ASSERT(vertices.size() >= 4);
+          cell.face_vertices(cellFaceVertexIndices[icell]);
+        }
+      }
+    }
+  }
+
+  timer.stop();
+  ScopedTimer mergeTimer("fillQuantizedTessellation");
+
+  // Merge the cells in generator order.  The faces on the container walls
+  // belong to a single cell, like those against the guard generators.
+  map<IntPoint, int> vertexHash2ID;
+  map<EdgeHash, int> edgeHash2ID;
+  map<FaceHash, int> faceHash2ID;
+  qmesh.cellFaces.resize(ncells);
+  for (i = 0; i != ncells; ++i) {
+    vector<IntPoint>& vertices = cellVertices[i];
+    POLY_ASSERT(!vertices.empty());
+    const vector<int> vertexMap = updateQuantizedVertices(vertices, vertexHash2ID, qmesh.nodes);
+    const vector<int>& voroFaceVertexIndices = cellFaceVertexIndices[i];
+    k = 0;
+    nf = 0;
+    while (k < voroFaceVertexIndices.size()) {
+      FaceHash fhashi;
+      vector<int> faceNodeIDs;
+      nvf = voroFaceVertexIndices[k++];
+      POLY_ASSERT(nvf >= 3);
+      for (iv = 0; iv != nvf; ++iv) {
+        POLY_ASSERT(k < voroFaceVertexIndices.size());
+        j = vertexMap[voroFaceVertexIndices[k++]];
+        if (fhashi.insert(j).second) faceNodeIDs.push_back(j);
+      }
+      if (faceNodeIDs.size() < 3) continue;      // Degenerate face.
+      ++nf;
+
+      // Voro++ goes around the face clockwise seen from outside the cell.
+      reverse(faceNodeIDs.begin(), faceNodeIDs.end());
+
+      // Is this a new face?
+      const map<FaceHash, int>::const_iterator faceItr = faceHash2ID.find(fhashi);
+      if (faceItr != faceHash2ID.end()) {
+        qmesh.cellFaces[i].push_back(~faceItr->second);
+        continue;
+      }
+      const int iface = qmesh.faces.size();
+      faceHash2ID[fhashi] = iface;
+      qmesh.faces.push_back(vector<int>());
+      const unsigned n = faceNodeIDs.size();
+      for (iv = 0; iv != n; ++iv) {
+        const int j0 = faceNodeIDs[iv], j1 = faceNodeIDs[(iv + 1) % n];
+        const EdgeHash edge = internal::hashEdge(j0, j1);
+        const int old_size = edgeHash2ID.size();
+        const int e = internal::addKeyToMap(edge, edgeHash2ID);
+        if (e == old_size) qmesh.edges.push_back(edge);
+        qmesh.faces[iface].push_back(edge.first == j0 ? e : ~e);
+      }
+      qmesh.cellFaces[i].push_back(iface);
+    }
+    POLY_ASSERT(nf >= 4);
+    vector<IntPoint>().swap(vertices);
+    vector<int>().swap(cellFaceVertexIndices[i]);
   }
 }
 
@@ -7,6 +7,8 @@
 #ifndef __Polytope_VoroPP_3d__
 #define __Polytope_VoroPP_3d__
 
+#ifdef HAVE_VOROPP
+
 #include <vector>
 #include <cmath>
 
@@ -20,17 +22,28 @@ class VoroPP_3d: public Tessellator<3, RealType> {
   //--------------------------- Public Interface ---------------------------//
 public:
 
+  typedef typename Tessellator<3, RealType>::QuantizedTessellation QuantizedTessellation;
+
   //! Constructor.
   //! The parameters (nx, ny) are used internally to Voro++ in order to make
   //! the selection of generators that can influence any particular generator
   //! more efficient.  The results of the tessellation should be independent of
-  //! of these choices -- they only affect computational expense.
+  //! of these choices -- they only affect computational expense.  A value of
+  //! zero (the default) sizes that direction automatically from the number of
+  //! generators and the shape of the box, aiming for a fixed number of
+  //! generators per box.
+  //! When polytope is built with OpenMP the cells are computed concurrently,
+  //! with threads sharing out the boxes.
   //! \param nx The number of boxes to carve the volume into in the x direction.
   //! \param ny The number of boxes to carve the volume into in the y direction.
-  //! \param degeneracy The tolerance for merging nodes in a cell.
-  VoroPP_3d(const unsigned nx = 20,
-            const unsigned ny = 20,
-            const unsigned nz = 20,
+  //! \param degeneracy The tolerance for merging nodes in a cell, relative
+  //!                   to the largest side of the box.  The box and periodic
+  //!                   tessellations hash the nodes on a grid of this spacing
+  //!                   that has to fit in a CoordHash, so anything below
+  //!                   2^-30 (about 9.3e-10) is treated as 2^-30.
+  VoroPP_3d(const unsigned nx = 0,
+            const unsigned ny = 0,
+            const unsigned nz = 0,
             const RealType degeneracy = 1.0e-12);
   ~VoroPP_3d();
 
@@ -50,14 +63,32 @@ public:
                           RealType* high,
                           Tessellation<3, RealType>& mesh) const;
 
+  // The unbounded and PLC versions come from the base class.
+  using Tessellator<3, RealType>::tessellate;
+
+  //! Generate a Voronoi tessellation in a box periodic in every direction,
+  //! using Voro++'s periodic container rather than ghost generators.
+  virtual void tessellatePeriodic(const std::vector<RealType>& points,
+                                  RealType* low,
+                                  RealType* high,
+                                  Tessellation<3, RealType>& mesh) const;
 
-  // This Tessellator does not handle PLCs... yet.
-  bool handlesPLCs() const { return false; }
+  //! Compute the quantized tessellation, from which the unbounded and PLC
+  //! tessellations are built.  Voro++ needs a box, so rather than the guard
+  //! generators the cells are closed by the walls of a box a quarter of the
+  //! size of the PLC (or the generators) beyond it on every side.
+  virtual void tessellateQuantized(QuantizedTessellation& qmesh) const;
+
+  // This Tessellator handles periodic boxes.
+  bool handlesPeriodicBoxes() const { return true; }
+
+  // This Tessellator handles PLCs, by clipping the quantized tessellation.
+  bool handlesPLCs() const { return true; }
 
   // The Tessellator's name
   std::string name() const { return "VoroTessellator3d"; }
 
-  // Access our attributes.
+  // Access our attributes (zero means the box count is chosen automatically).
   unsigned nx() const { return mNx; }
   unsigned ny() const { return mNy; }
   unsigned nz() const { return mNz; }
@@ -80,3 +111,4 @@ private:
 }
 
 #endif
+#endif
@@ -0,0 +1,202 @@
+#ifndef POLYTOPE_XDMF_WRITER_HH
+#define POLYTOPE_XDMF_WRITER_HH
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <stdint.h>
+
+#include "Tessellation.hh"
+#include "BinaryUtils.hh"
+#include "polytope_write_utilities.hh"
+#include "timingUtilities.hh"
+
+namespace polytope
+{
+
+//! \class XDMFWriter
+//! This class provides a static interface for writing tessellations in the
+//! XDMF format: a small XML file (.xmf) describing the mesh, and a raw
+//! binary file (.bin) holding the arrays it points into.  The cells are
+//! written as a Mixed topology of polygons (2D) or polyhedra (3D), which
+//! ParaView and VisIt both read.  The binary data is streamed from the
+//! tessellation in large blocks and needs no third-party libraries.
+template <int Dimension, typename RealType>
+class XDMFWriter
+{
+  public:
+
+  typedef Tessellation<Dimension, RealType> TessellationType;
+
+  //! Write the tessellation and a set of cell-centered fields, each with a
+  //! value per cell, to filePrefix.xmf and filePrefix.bin.
+  static void write(const TessellationType& mesh,
+                    const std::map<std::string, RealType*>& cellFields,
+                    const std::string& filePrefix)
+  {
+    ScopedTimer timer("writeXDMF");
+    const std::string xmfName = filePrefix + ".xmf", binName = filePrefix + ".bin";
+    const unsigned numNodes = mesh.nodes.size()/Dimension;
+    const unsigned numCells = mesh.cells.size();
+
+    // Size up the topology.  A polygon is [3, number of nodes, nodes...],
+    // and a polyhedron [16, number of faces, then for each face its number
+    // of nodes and the nodes].
+    uint64_t topologySize = 0;
+    for (unsigned i = 0; i != numCells; ++i) topologySize += cellStreamSize(mesh, i);
+
+    // Stream the binary data.
+    uint64_t nbytes;
+    {
+      std::ofstream file;
+      internal::openOutputFile(file, binName, "XDMFWriter");
+      internal::BlockWriter out(file);
+      internal::writeNodes(mesh, Dimension, out);
+      for (unsigned i = 0; i != numCells; ++i) {
+        if (Dimension == 2) {
+          out.put(int32_t(3));
+          out.put(int32_t(mesh.cells[i].size()));
+        } else {
+          out.put(int32_t(16));
+        }
+        writeCell(mesh, i, out);
+      }
+      for (typename std::map<std::string, RealType*>::const_iterator itr = cellFields.begin();
+           itr != cellFields.end();
+           ++itr) {
+        out.write(itr->second, uint64_t(numCells)*sizeof(RealType));
+      }
+      out.flush();
+      nbytes = out.bytes();
+      if (not file)
+        error("XDMFWriter: failed writing " + binName);
+    }
+
+    // Describe it.
+    std::ofstream file(xmfName.c_str());
+    if (not file)
+      error("XDMFWriter: could not open " + xmfName + " for writing");
+    const std::string binFile = internal::baseName(binName);
+    uint64_t seek = 0;
+    file << "<?xml version=\"1.0\" ?>\n"
+         << "<Xdmf Version=\"3.0\" xmlns:xi=\"http://www.w3.org/2001/XInclude\">\n"
+         << "  <Domain>\n"
+         << "    <Grid Name=\"" << internal::baseName(filePrefix) << "\" GridType=\"Uniform\">\n"
+         << "      <Geometry GeometryType=\"" << (Dimension == 2 ? "XY" : "XYZ") << "\">\n";
+    dataItem(file, binFile, "Float", sizeof(RealType), seek, numNodes, Dimension);
+    file << "      </Geometry>\n"
+         << "      <Topology TopologyType=\"Mixed\" NumberOfElements=\"" << numCells << "\">\n";
+    dataItem(file, binFile, "Int", 4, seek, topologySize, 1);
+    file << "      </Topology>\n";
+    for (typename std::map<std::string, RealType*>::const_iterator itr = cellFields.begin();
+         itr != cellFields.end();
+         ++itr) {
+      file << "      <Attribute Name=\"" << itr->first
+           << "\" AttributeType=\"Scalar\" Center=\"Cell\">\n";
+      dataItem(file, binFile, "Float", sizeof(RealType), seek, numCells, 1);
+      file << "      </Attribute>\n";
+    }
+    file << "    </Grid>\n"
+         << "  </Domain>\n"
+         << "</Xdmf>\n";
+    POLY_ASSERT(seek == nbytes);
+    incrementCounter("bytesWritten", uint64_t(file.tellp()) + nbytes);
+  }
+
+  //! Write the tessellation alone.
+  static void write(const TessellationType& mesh,
+                    const std::string& filePrefix)
+  {
+    write(mesh, std::map<std::string, RealType*>(), filePrefix);
+  }
+
+  //! Write this rank's part of a distributed tessellation to
+  //! filePrefix_<rank>.xmf and .bin.  Rank 0 also writes filePrefix.xmf,
+  //! which gathers the pieces into one spatial collection and is the file
+  //! to open.  Nothing here communicates, so this works however the ranks
+  //! are run.
+  static void writeParallel(const TessellationType& mesh,
+                            const std::map<std::string, RealType*>& cellFields,
+                            const std::string& filePrefix,
+                            const int rank,
+                            const int numRanks)
+  {
+    write(mesh, cellFields, internal::pieceName(filePrefix, rank, ""));
+    if (rank == 0) {
+      const std::string fileName = filePrefix + ".xmf";
+      std::ofstream file(fileName.c_str());
+      if (not file)
+        error("XDMFWriter: could not open " + fileName + " for writing");
+      file << "<?xml version=\"1.0\" ?>\n"
+           << "<Xdmf Version=\"3.0\" xmlns:xi=\"http://www.w3.org/2001/XInclude\">\n"
+           << "  <Domain>\n"
+           << "    <Grid Name=\"" << internal::baseName(filePrefix)
+           << "\" GridType=\"Collection\" CollectionType=\"Spatial\">\n";
+      for (int i = 0; i != numRanks; ++i) {
+        file << "      <xi:include href=\""
+             << internal::baseName(internal::pieceName(filePrefix, i, ".xmf"))
+             << "\" xpointer=\"xpointer(//Xdmf/Domain/Grid)\"/>\n";
+      }
+      file << "    </Grid>\n"
+           << "  </Domain>\n"
+           << "</Xdmf>\n";
+    }
+  }
+
+  private:
+
+  // Describe an array in the binary file, and advance the seek offset past
+  // it.
+  static void dataItem(std::ostream& xml,
+                       const std::string& binFile,
+                       const std::string& numberType,
+                       const unsigned precision,
+                       uint64_t& seek,
+                       const uint64_t n,
+                       const unsigned numComponents)
+  {
+    xml << "        <DataItem Dimensions=\"" << n;
+    if (numComponents > 1) xml << " " << numComponents;
+    xml << "\" NumberType=\"" << numberType << "\" Precision=\"" << precision
+        << "\" Format=\"Binary\" Endian=\"" << (Binary::littleEndianHost() ? "Little" : "Big")
+        << "\" Seek=\"" << seek << "\">" << binFile << "</DataItem>\n";
+    seek += n*numComponents*precision;
+  }
+
+  // The topology entries of a cell, including its type.
+  static uint64_t cellStreamSize(const Tessellation<2, RealType>& mesh, const unsigned i)
+  {
+    return 2 + mesh.cells[i].size();
+  }
+  static uint64_t cellStreamSize(const Tessellation<3, RealType>& mesh, const unsigned i)
+  {
+    return 1 + internal::cellFaceStreamSize(mesh, i);
+  }
+
+  // The topology entries of a cell following its type (and, for polygons,
+  // number of nodes).
+  static void writeCell(const Tessellation<2, RealType>& mesh,
+                        const unsigned i,
+                        internal::BlockWriter& out)
+  {
+    for (unsigned j = 0; j != mesh.cells[i].size(); ++j) {
+      out.put(int32_t(internal::cellRingNode(mesh, mesh.cells[i][j])));
+    }
+  }
+  static void writeCell(const Tessellation<3, RealType>& mesh,
+                        const unsigned i,
+                        internal::BlockWriter& out)
+  {
+    out.put(int32_t(mesh.cells[i].size()));
+    for (unsigned j = 0; j != mesh.cells[i].size(); ++j) {
+      const int k = mesh.cells[i][j];
+      out.put(int32_t(mesh.faces[k < 0 ? ~k : k].size()));
+      internal::forEachCellFaceNode(mesh, i, j, [&out](const unsigned n) { out.put(int32_t(n)); });
+    }
+  }
+};
+
+}
+
+#endif
@@ -26,19 +26,20 @@ inline
 std::string
 reduceToMaxString(const std::string& x,
                   const unsigned rank,
-                  const unsigned numDomains) {
+                  const unsigned numDomains,
+                  const MPI_Comm comm) {
   unsigned badRank = polytope::allReduce((x.size() == 0 ? numDomains : rank),
                                          MPI_MIN,
-                                         MPI_COMM_WORLD);
+                                         comm);
   if (badRank == numDomains) {
     return x;
   } else {
     unsigned size = x.size();
-    MPI_Bcast(&size, 1, MPI_UNSIGNED, badRank, MPI_COMM_WORLD);
+    MPI_Bcast(&size, 1, MPI_UNSIGNED, badRank, comm);
     POLY_ASSERT(size > 0);
     std::string result = x;
     result.resize(size, '0');
-    MPI_Bcast(&result[0], size, MPI_CHAR, badRank, MPI_COMM_WORLD);
+    MPI_Bcast(&result[0], size, MPI_CHAR, badRank, comm);
     return result;
   }
 }
@@ -54,7 +55,8 @@ checkConsistentCommInfo(const std::string& label,
                         const unsigned numDomains,
                         const std::vector<typename polytope::DimensionTraits<Dimension, RealType>::IntPoint>& hashes,
                         const std::vector<unsigned>& neighborDomains,
-                        const std::vector<std::vector<unsigned> >& sharedIDs) {
+                        const std::vector<std::vector<unsigned> >& sharedIDs,
+                        const MPI_Comm comm) {
 
   typedef typename polytope::DimensionTraits<Dimension, RealType>::IntPoint Point;
 
@@ -65,7 +67,7 @@ checkConsistentCommInfo(const std::string& label,
 
     // Tell everyone how many domains we're checking.
     unsigned numChecks = neighborDomains.size();
-    MPI_Bcast(&numChecks, 1, MPI_UNSIGNED, sendProc, MPI_COMM_WORLD);
+    MPI_Bcast(&numChecks, 1, MPI_UNSIGNED, sendProc, comm);
 
     // For each neighbor to be checked:
     for (unsigned k = 0; k != numChecks; ++k) {
@@ -73,7 +75,7 @@ checkConsistentCommInfo(const std::string& label,
       // ID of the neighbor domain to be checked.
       unsigned recvProc;
       if (rank == sendProc) recvProc = neighborDomains[k];
-      MPI_Bcast(&recvProc, 1, MPI_UNSIGNED, sendProc, MPI_COMM_WORLD);
+      MPI_Bcast(&recvProc, 1, MPI_UNSIGNED, sendProc, comm);
 
       // Send the hashes the send proc thinks it shares with the receive.
       unsigned bufSize;
@@ -86,10 +88,10 @@ checkConsistentCommInfo(const std::string& label,
         }
         bufSize = buffer.size();
       }
-      MPI_Bcast(&bufSize, 1, MPI_UNSIGNED, sendProc, MPI_COMM_WORLD);
+      MPI_Bcast(&bufSize, 1, MPI_UNSIGNED, sendProc, comm);
       std::vector<Point> recvHashes;
       buffer.resize(bufSize);
-      MPI_Bcast(&buffer.front(), bufSize, MPI_CHAR, sendProc, MPI_COMM_WORLD);
+      MPI_Bcast(&buffer.front(), bufSize, MPI_CHAR, sendProc, comm);
       std::vector<char>::const_iterator itr = buffer.begin();
       unsigned nother;
       polytope::deserialize(nother, itr, buffer.end());
@@ -131,7 +133,7 @@ checkConsistentCommInfo(const std::string& label,
     if (result != "") std::cout << result << std::endl;
 
     // Globally reduce the message so far.
-    result = reduceToMaxString(result, rank, numDomains);
+    result = reduceToMaxString(result, rank, numDomains, comm);
     if (result != "") return label + " : " + result;
   }
   
@@ -151,7 +153,8 @@ checkAllSharedElementsFound(const std::string& label,
                             const std::vector<typename polytope::DimensionTraits<Dimension, RealType>::IntPoint>& hashes,
                             const std::vector<unsigned>& neighborDomains,
                             const std::vector<std::vector<unsigned> >& sharedIDs,
-                            const bool doNotAllowEmptySets) {
+                            const bool doNotAllowEmptySets,
+                            const MPI_Comm comm) {
 
   typedef typename polytope::DimensionTraits<Dimension, RealType>::IntPoint Point;
 
@@ -172,10 +175,10 @@ checkAllSharedElementsFound(const std::string& label,
 
     // Broadcast the send processors full set of hashes to everyone.
     unsigned bufSize = localBuffer.size();
-    MPI_Bcast(&bufSize, 1, MPI_UNSIGNED, sendProc, MPI_COMM_WORLD);
+    MPI_Bcast(&bufSize, 1, MPI_UNSIGNED, sendProc, comm);
     std::vector<char> buffer = localBuffer;
     buffer.resize(bufSize);
-    MPI_Bcast(&buffer.front(), bufSize, MPI_CHAR, sendProc, MPI_COMM_WORLD);
+    MPI_Bcast(&buffer.front(), bufSize, MPI_CHAR, sendProc, comm);
     std::vector<Point> otherHashes;
     std::vector<char>::const_iterator bufItr = buffer.begin();
     polytope::deserialize(otherHashes, bufItr, buffer.end());
@@ -249,7 +252,7 @@ checkAllSharedElementsFound(const std::string& label,
     }
 
     // Globally reduce the message so far.
-    result = reduceToMaxString(result, rank, numDomains);
+    result = reduceToMaxString(result, rank, numDomains, comm);
     if (result != "") return label + " : " + result;
   }
 
@@ -262,46 +265,51 @@ checkAllSharedElementsFound(const std::string& label,
 namespace polytope {
 
 //------------------------------------------------------------------------------
-//! \fn string checkDistributedTessellation(const Tessellation& mesh)
+//! \fn string checkDistributedTessellation(const Tessellation& mesh, MPI_Comm comm)
 //! \brief Checks the parallel data structures in a tessellation for consistency.
 //! \param mesh The tessellation we're checking.
+//! \param comm The communicator the tessellation is distributed over.
 //------------------------------------------------------------------------------
 template<int Dimension, typename RealType>
 inline
 std::string
-checkDistributedTessellation(const Tessellation<Dimension, RealType>& mesh) {
+checkDistributedTessellation(const Tessellation<Dimension, RealType>& mesh,
+                             const MPI_Comm comm = MPI_COMM_WORLD) {
 
   typedef DimensionTraits<Dimension, RealType> Traits;
   typedef typename Traits::IntPoint Point;
 
   // Parallel configuration.
   int rank, numDomains;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &numDomains);
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &numDomains);
 
   // Prepare our result optimistically.
   std::string result = "";
 
   // Compute the bounding box for normalizing our coordinates.
   RealType xmin[Dimension], xmax[Dimension];
-  geometry::computeBoundingBox<Dimension, RealType>(mesh.nodes, true, xmin, xmax);
+  {
+    CommunicatorScope commScope(comm);
+    geometry::computeBoundingBox<Dimension, RealType>(mesh.nodes, true, xmin, xmax);
+  }
   const RealType dxhash = Traits::maxLength(xmin, xmax)/(KeyTraits::maxKey1d - KeyTraits::minKey1d);
 
   // First check that all processors agree about who is talking to whom.
   for (unsigned sendProc = 0; sendProc != numDomains; ++sendProc) {
     unsigned numNeighbors = mesh.neighborDomains.size();
     std::vector<unsigned> checkNeighbors = mesh.neighborDomains;
-    MPI_Bcast(&numNeighbors, 1, MPI_UNSIGNED, sendProc, MPI_COMM_WORLD);
+    MPI_Bcast(&numNeighbors, 1, MPI_UNSIGNED, sendProc, comm);
     if (numNeighbors > 0) {
       checkNeighbors.resize(numNeighbors);
-      MPI_Bcast(&checkNeighbors.front(), numNeighbors, MPI_UNSIGNED, sendProc, MPI_COMM_WORLD);
+      MPI_Bcast(&checkNeighbors.front(), numNeighbors, MPI_UNSIGNED, sendProc, comm);
       if (not (std::binary_search(checkNeighbors.begin(), checkNeighbors.end(), rank) == 
                std::binary_search(mesh.neighborDomains.begin(), mesh.neighborDomains.end(), sendProc))) {
         result = "Processors don't agree about who is talking to whom!";
       }
     }
   }
-  result = reduceToMaxString(result, rank, numDomains);
+  result = reduceToMaxString(result, rank, numDomains, comm);
 
   // Hash the mesh node positions.
   std::vector<Point> nodeHashes;
@@ -310,8 +318,8 @@ checkDistributedTessellation(const Tessellation<Dimension, RealType>& mesh) {
   for (unsigned i = 0; i != numNodes; ++i) nodeHashes.push_back(Traits::constructPoint(&mesh.nodes[Dimension*i], xmin, dxhash, i));
 
   // Check the communicated nodes.
-  if (result == "") result = checkConsistentCommInfo<Dimension, RealType>("Node", rank, numDomains, nodeHashes, mesh.neighborDomains, mesh.sharedNodes);
-  if (result == "") result = checkAllSharedElementsFound<Dimension, RealType>("Node", rank, numDomains, nodeHashes, mesh.neighborDomains, mesh.sharedNodes, true);
+  if (result == "") result = checkConsistentCommInfo<Dimension, RealType>("Node", rank, numDomains, nodeHashes, mesh.neighborDomains, mesh.sharedNodes, comm);
+  if (result == "") result = checkAllSharedElementsFound<Dimension, RealType>("Node", rank, numDomains, nodeHashes, mesh.neighborDomains, mesh.sharedNodes, true, comm);
 
   // Something weird about hashing the faces, so I'm suspending those checks for now.
 
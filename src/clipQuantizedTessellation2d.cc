@@ -7,11 +7,18 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <stdint.h>
 
 #include "clipQuantizedTessellation.hh"
 #include "RegisterBoostPolygonTypes.hh"
 #include "removeElements.hh"
 #include "IntPointMap.hh"
+#include "BoxGrid.hh"
+#include "timingUtilities.hh"
 
 using namespace std;
 namespace bp = boost::polygon;
@@ -46,6 +53,205 @@ removeCollinearPoints(bp::polygon_data<IntType>& poly) {
   poly.set(points.begin(), points.end());
 }
 
+//------------------------------------------------------------------------------
+// The integer bounding box of a polygon.
+//------------------------------------------------------------------------------
+template<typename IntType>
+typename internal::BoxGrid<2, IntType>::Box
+polygonBox(const bp::polygon_data<IntType>& poly) {
+  typename internal::BoxGrid<2, IntType>::Box result;
+  for (typename bp::polygon_data<IntType>::iterator_type itr = poly.begin(); itr != poly.end(); ++itr) {
+    const IntType p[2] = {itr->x(), itr->y()};
+    result.expand(p);
+  }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// The pool of orphaned cell fragments.  Each new fragment is merged with any
+// orphans it touches (and those with any they touch in turn), so the pool
+// holds connected orphans which never touch each other.  Only polygons whose
+// boxes meet can union to one, so those are the only unions we try.
+//------------------------------------------------------------------------------
+template<typename IntType>
+class OrphanPool {
+public:
+  typedef bp::polygon_data<IntType> Polygon;
+  typedef std::vector<Polygon> PolygonSet;
+  typedef typename internal::BoxGrid<2, IntType>::Box Box;
+
+  explicit OrphanPool(const int64_t binSize):
+    mOrphans(),
+    mAlive(),
+    mGrid(binSize) {}
+
+  void add(const Polygon& fragment) {
+    Polygon merged = fragment;
+    Box box = polygonBox(merged);
+    unsigned target = std::numeric_limits<unsigned>::max();
+    std::set<unsigned> tried;
+    std::vector<unsigned> candidates;
+    bool grew = true;
+    while (grew) {
+      grew = false;
+      mGrid.query(box, candidates);
+      for (unsigned i = 0; i != candidates.size(); ++i) {
+        const unsigned k = candidates[i];
+        if (not mAlive[k] or not tried.insert(k).second) continue;
+        PolygonSet set1, set2, trialunion;
+        set1 += merged;
+        set2 += mOrphans[k];
+        bp::assign(trialunion, set1 | set2);
+        if (trialunion.size() == 1) {
+          // These can be unioned, so absorb the existing orphan.
+          merged = trialunion[0];
+          removeCollinearPoints(merged);
+          mAlive[k] = false;
+          target = std::min(target, k);
+          box = polygonBox(merged);
+          grew = true;
+        }
+      }
+    }
+
+    // The result takes the place of the first orphan it absorbed, or
+    // starts a new one.
+    if (target == std::numeric_limits<unsigned>::max()) {
+      target = mOrphans.size();
+      mOrphans.push_back(merged);
+      mAlive.push_back(true);
+    } else {
+      mOrphans[target] = merged;
+      mAlive[target] = true;
+    }
+    mGrid.insert(target, box);
+  }
+
+  // The surviving orphans, in the order they were first created.
+  PolygonSet orphans() const {
+    PolygonSet result;
+    for (unsigned k = 0; k != mOrphans.size(); ++k) {
+      if (mAlive[k]) result.push_back(mOrphans[k]);
+    }
+    return result;
+  }
+
+private:
+  std::vector<Polygon> mOrphans;
+  std::vector<bool> mAlive;
+  internal::BoxGrid<2, IntType> mGrid;
+};
+
+//------------------------------------------------------------------------------
+// Check if two polygons share any boundary, which means one has a vertex on
+// the boundary of the other.
+//------------------------------------------------------------------------------
+template<typename IntType>
+bool
+polygonsTouch(const bp::polygon_data<IntType>& a,
+              const bp::polygon_data<IntType>& b) {
+  typedef bp::polygon_data<IntType> Polygon;
+  for (typename Polygon::iterator_type itr = a.begin(); itr != a.end(); ++itr) {
+    if (bp::contains(b, *itr, true)) return true;
+  }
+  for (typename Polygon::iterator_type itr = b.begin(); itr != b.end(); ++itr) {
+    if (bp::contains(a, *itr, true)) return true;
+  }
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Find the cells sharing any boundary with an orphan.  A cell which only meets
+// the middle of a long orphan edge has no node in common with it, so we check
+// the geometry of every cell whose box meets the orphan's.
+//------------------------------------------------------------------------------
+template<typename IntType>
+void
+orphanNeighbors(const bp::polygon_data<IntType>& orphan,
+                const internal::BoxGrid<2, IntType>& cellGrid,
+                const std::vector<bp::polygon_data<IntType> >& cellPolygons,
+                std::vector<unsigned>& neighbors) {
+  std::vector<unsigned> candidates;
+  cellGrid.query(polygonBox(orphan), candidates);
+  neighbors.clear();
+  for (unsigned k = 0; k != candidates.size(); ++k) {
+    if (polygonsTouch(orphan, cellPolygons[candidates[k]])) neighbors.push_back(candidates[k]);
+  }
+  POLY_ASSERT(neighbors.size() > 0);
+}
+
+//------------------------------------------------------------------------------
+// Re-tessellate an orphan together with its neighboring cells, returning the
+// new geometry of each neighbor.  Only the neighbors change, so orphans with
+// no neighbors in common can be adopted at the same time.
+//------------------------------------------------------------------------------
+template<typename IntType, typename RealType>
+void
+adoptOrphan(const bp::polygon_data<IntType>& orphan,
+            const std::vector<unsigned>& neighbors,
+            const std::vector<bp::polygon_data<IntType> >& cellPolygons,
+            const QuantizedTessellation2d<IntType, RealType>& qmesh,
+            const Tessellator<2, RealType>& tessellator,
+            std::vector<bp::polygon_data<IntType> >& newCells) {
+  typedef bp::polygon_data<IntType> Polygon;
+  typedef typename bp::polygon_traits<Polygon>::point_type Point;
+  typedef std::vector<Polygon> PolygonSet;
+  typedef typename QuantizedTessellation2d<IntType, RealType>::IntPoint IntPoint;
+
+  // Find the overall boundary of the orphan unioned with all the neighbors in one boolean
+  // operation, and accumulate the local generator positions.
+  vector<IntPoint> localgenerators;
+  bp::polygon_set_data<IntType> localSet;
+  localSet.insert(orphan);
+  for (unsigned i = 0; i != neighbors.size(); ++i) {
+    localSet.insert(cellPolygons[neighbors[i]]);
+    localgenerators.push_back(qmesh.generators[neighbors[i]]);
+    localgenerators.back().index = i;
+  }
+  PolygonSet localBoundary;
+  localSet.get(localBoundary);
+  POLY_ASSERT(localBoundary.size() == 1);
+
+  // Construct the tessellation of the neighbor generators.  Tessellators
+  // which can't run concurrently take turns.
+  QuantizedTessellation2d<IntType, RealType> localqmesh(localgenerators, qmesh);
+  if (tessellator.threadSafe()) {
+    tessellator.tessellateQuantized(localqmesh);
+  } else {
+#pragma omp critical(polytopeAdoptOrphanTessellate)
+    tessellator.tessellateQuantized(localqmesh);
+  }
+
+  // Clip each new cell geometry against the local boundary to obtain the final cell geometries.
+  newCells.resize(neighbors.size());
+  IntPoint p;
+  for (unsigned i = 0; i != localgenerators.size(); ++i) {
+    Polygon cell;
+    const unsigned nverts = localqmesh.cellEdges[i].size();
+    std::vector<Point> cellPoints(nverts);
+    for (unsigned j = 0; j != nverts; ++j) {
+      int k = localqmesh.cellEdges[i][j];
+      if (k < 0) {
+        k = ~k;
+        p = localqmesh.nodes[localqmesh.edges[k].second];
+      } else {
+        p = localqmesh.nodes[localqmesh.edges[k].first];
+      }
+      cellPoints[j] = bp::construct<Point>(p.x, p.y);
+    }
+    bp::set_points(cell, cellPoints.begin(), cellPoints.end());
+
+    // Clip the cell against the boundary.
+    PolygonSet cellSet;
+    cellSet += cell;
+    cellSet &= localBoundary;
+    POLY_ASSERT2(cellSet.size() == 1, cellSet.size());  // Hopefully no more new orphans!
+
+    removeCollinearPoints(cellSet[0]); // Get rid of any collinear points the intersection operation may have left behind.
+    newCells[i] = cellSet[0];
+  }
+}
+
 }
 
 //------------------------------------------------------------------------------
@@ -126,12 +332,20 @@ void clipQuantizedTessellation(QuantizedTessellation2d<IntType, RealType>& qmesh
   internal::IntPointMap<2, IntType> node2id(2);
   typedef std::map<std::pair<int, int>, int> EdgeIDMap;
   EdgeIDMap edge2id;
-  std::vector<std::set<int> > newNodeCells;
   std::vector<Polygon> cellPolygons;
   
-  // We also prepare to keep track of the orphans for each cell.
-  typedef PolygonSet Orphanage;
-  Orphanage orphans;
+  // We also prepare to keep track of the orphans for each cell, binned on a
+  // grid about the size of the cells.
+  int64_t xmin = std::numeric_limits<int64_t>::max(), xmax = std::numeric_limits<int64_t>::min();
+  int64_t ymin = xmin, ymax = xmax;
+  for (unsigned i = 0; i != numBoundaryPoints; ++i) {
+    xmin = std::min(xmin, int64_t(boundaryPoints[i].x()));
+    xmax = std::max(xmax, int64_t(boundaryPoints[i].x()));
+    ymin = std::min(ymin, int64_t(boundaryPoints[i].y()));
+    ymax = std::max(ymax, int64_t(boundaryPoints[i].y()));
+  }
+  const int64_t binSize = int64_t(std::max(xmax - xmin, ymax - ymin)/std::sqrt(double(std::max(1U, ncells))));
+  OrphanPool<IntType> orphanPool(binSize);
 
   // Now walk each cell and clip it with the boundary.
   for (unsigned i = 0; i != ncells; ++i) {
@@ -156,6 +370,9 @@ void clipQuantizedTessellation(QuantizedTessellation2d<IntType, RealType>& qmesh
     PolygonSet cellSet;
     cellSet += cell;
     cellSet &= boundarySet;
+    // The clip can only take area away, so the cell crossed the boundary if
+    // it lost some.
+    if (timersEnabled() and bp::area(cellSet) != bp::area(cell)) incrementCounter("cellsClipped");
 
     // Check if we generated more than one polygon.  If so, some are orphans.
     Point gen = bp::construct<Point>(qmesh.generators[i].x, qmesh.generators[i].y);
@@ -167,30 +384,9 @@ void clipQuantizedTessellation(QuantizedTessellation2d<IntType, RealType>& qmesh
       while (polygonIndex < cellSet.size() and not bp::contains(cellSet[polygonIndex], gen)) ++polygonIndex;
       POLY_ASSERT(polygonIndex < cellSet.size());
 
-      // For each new orphan check if it can be unioned with an existing orphan.  Otherwise add it to the orphan set.
-      unsigned k;
-      PolygonSet trialunion;
-      typename QuantizedTessellation2d<IntType, RealType>::RealPoint rp;
-      IntType pp[2] = {gen.x(), gen.y()};
-      qmesh.dequantize(pp, &rp.x);
+      // Each new orphan is unioned with any existing orphans it touches, or else added to the orphanage.
       for (unsigned ipoly = 0; ipoly != cellSet.size(); ++ipoly) {
-        if (ipoly != polygonIndex) {
-          for (k = 0; k != orphans.size(); ++k) {
-            PolygonSet set1, set2, trialunion;
-            set1 += cellSet[ipoly];
-            set2 += orphans[k];
-            bp::assign(trialunion, set1 | set2);
-            if (trialunion.size() == 1) {
-              // Looks like these orphans can be unioned.  Replace the exising orphan with the union.
-              orphans[k] = trialunion[0];
-              removeCollinearPoints(orphans[k]);
-              break;
-            }
-          }
-
-          // If we didn't find another orphan to union with, add this one to the orphanage.
-          if (k == orphans.size()) orphans += cellSet[ipoly];
-        }
+        if (ipoly != polygonIndex) orphanPool.add(cellSet[ipoly]);
       }
     }
 
@@ -210,21 +406,13 @@ void clipQuantizedTessellation(QuantizedTessellation2d<IntType, RealType>& qmesh
       p.x = v0.x();
       p.y = v0.y();
       const int j0 = node2id.index(p);
-      if (j0 == newNodes.size()) {
-        newNodes.push_back(p);
-        newNodeCells.push_back(std::set<int>());
-      }
-      newNodeCells[j0].insert(i);
+      if (j0 == newNodes.size()) newNodes.push_back(p);
 
       // Insert vertex 1.
       p.x = v1.x();
       p.y = v1.y();
       const int j1 = node2id.index(p);
-      if (j1 == newNodes.size()) {
-        newNodes.push_back(p);
-        newNodeCells.push_back(std::set<int>());
-      }
-      newNodeCells[j1].insert(i);
+      if (j1 == newNodes.size()) newNodes.push_back(p);
     
       // Now insert the edge if non-degenerate.
       if (j0 != j1) {
@@ -247,129 +435,110 @@ void clipQuantizedTessellation(QuantizedTessellation2d<IntType, RealType>& qmesh
   }
   POLY_ASSERT(cellPolygons.size() == ncells);
 
-  // Now deal with any orphans.
-  for (typename Orphanage::iterator orphanItr = orphans.begin();
-       orphanItr != orphans.end();
-       ++orphanItr) {
-    const Polygon& orphan = *orphanItr;
-
-    // Start the local boundary with just the orphan.
-    PolygonSet localBoundary;
-    localBoundary += orphan;
-
-    // Walk the edges of this orphan and find the neighboring cells.
-    // We use those neigbors to augment the local boundary by union.
-    std::set<unsigned> neighbors;
-    for (typename Polygon::iterator_type pItr = orphan.begin();
-         pItr != orphan.end() - 1;
-         ++pItr) {
-
-      // Check the generators touching this node.
-      const IntPoint p0(pItr->x(), pItr->y());
-      if (node2id.have(p0)) {
-        const int nodeID = node2id.index(p0);
-        POLY_ASSERT(nodeID < newNodeCells.size());
-        neighbors.insert(newNodeCells[nodeID].begin(), newNodeCells[nodeID].end());
-      }
+  // Now deal with any orphans.  Adopting an orphan only changes the cells neighboring it, so
+  // orphans with no neighbors in common are independent.  We adopt the orphans in rounds,
+  // greedily coloring them in order: each orphan claims its neighbors for the round, and joins
+  // the round unless an earlier orphan (adopted this round or waiting) already claimed one of
+  // them.  So every orphan is still adopted after the earlier orphans it conflicts with, just as
+  // if we went through them one at a time, and the result does not depend on the number of
+  // threads.  The orphans of a round are adopted concurrently and written back in order.
+  ScopedTimer orphanTimer("adoptOrphans");
+  const PolygonSet orphans = orphanPool.orphans();
+  const int norphans = orphans.size();
+  incrementCounter("orphansAdopted", norphans);
+  internal::BoxGrid<2, IntType> cellGrid(binSize);
+  if (norphans > 0) {
+    for (unsigned i = 0; i != ncells; ++i) cellGrid.insert(i, polygonBox(cellPolygons[i]));
+  }
+  std::vector<std::vector<unsigned> > neighbors(norphans);
+  std::vector<PolygonSet> adoptedCells(norphans);
+  std::vector<int> cellRound(ncells, -1);
+  std::vector<unsigned> pending(norphans), round, deferred;
+  for (int k = 0; k != norphans; ++k) pending[k] = k;
+  for (int iround = 0; not pending.empty(); ++iround) {
+
+    // Find the current neighbors of the orphans still waiting.
+#pragma omp parallel for schedule(dynamic)
+    for (int k = 0; k < int(pending.size()); ++k) {
+      orphanNeighbors(orphans[pending[k]], cellGrid, cellPolygons, neighbors[pending[k]]);
     }
-    POLY_ASSERT(neighbors.size() > 0);
-
-    // Find the overall boundary of the orphan unioned with all the neighbors, and accumulate the
-    // local generator positions.
-    vector<IntPoint> localgenerators;
-    std::set<unsigned>::const_iterator gitr = neighbors.begin();
-    for (unsigned i = 0; i != neighbors.size(); ++i, ++gitr) {
-      const unsigned igen = *gitr;
-      PolygonSet oldcell;
-      oldcell += cellPolygons[igen];
-      bp::assign(localBoundary, localBoundary | oldcell);
-      localgenerators.push_back(qmesh.generators[igen]);
-      localgenerators.back().index = i;
+
+    // Pick this round's orphans.
+    round.clear();
+    deferred.clear();
+    for (unsigned k = 0; k != pending.size(); ++k) {
+      const std::vector<unsigned>& nbrs = neighbors[pending[k]];
+      bool available = true;
+      for (unsigned i = 0; i != nbrs.size(); ++i) {
+        if (cellRound[nbrs[i]] == iround) available = false;
+        cellRound[nbrs[i]] = iround;
+      }
+      if (available) {
+        round.push_back(pending[k]);
+      } else {
+        deferred.push_back(pending[k]);
+      }
     }
-    POLY_ASSERT(localBoundary.size() == 1);
+    POLY_ASSERT(not round.empty());
 
-    // Construct the tessellation of the neighbor generators.
-    QuantizedTessellation2d<IntType, RealType> localqmesh(localgenerators, qmesh);
-    tessellator.tessellateQuantized(localqmesh);
+    // Re-tessellate each orphan's neighborhood.
+#pragma omp parallel for schedule(dynamic)
+    for (int k = 0; k < int(round.size()); ++k) {
+      const unsigned iorphan = round[k];
+      adoptOrphan(orphans[iorphan], neighbors[iorphan], cellPolygons, qmesh, tessellator, adoptedCells[iorphan]);
+    }
 
-    // Clip each new cell geometry against the local boundary to obtain the final cell geometries.
-    gitr = neighbors.begin();
-    for (unsigned i = 0; i != localgenerators.size(); ++i, ++gitr) {
-      const unsigned igen = *gitr; // localgenerators[i].index;
-      Polygon cell;
-      unsigned nverts = localqmesh.cellEdges[i].size();
-      std::vector<Point> cellPoints(nverts);
-      for (unsigned j = 0; j != nverts; ++j) {
-        int k = localqmesh.cellEdges[i][j];
-        if (k < 0) {
-          k = ~k;
-          p = localqmesh.nodes[localqmesh.edges[k].second];
-        } else {
-          p = localqmesh.nodes[localqmesh.edges[k].first];
-        }
-        typename QuantizedTessellation2d<IntType, RealType>::RealPoint rp;
-        qmesh.dequantize(&p.x, &rp.x);
-        cellPoints[j] = bp::construct<Point>(p.x, p.y);
-      }
-      bp::set_points(cell, cellPoints.begin(), cellPoints.end());
-
-      // Clip the cell against the boundary.
-      PolygonSet cellSet;
-      cellSet += cell;
-      cellSet &= localBoundary;
-      POLY_ASSERT2(cellSet.size() == 1, cellSet.size());  // Hopefully no more new orphans!
-
-      removeCollinearPoints(cellSet[0]); // Get rid of any collinear points the intersection operation may have left behind.
-
-      // Read out the new cell geometry.
-      cellPolygons[igen] = cellSet[0];
-      newCellEdges[igen].clear();
-      nverts = cellSet[0].size();
-      for (unsigned j = 0; j != nverts; ++j) {
-        const Point& v0 = *(cellSet[0].begin() + j);
-        const Point& v1 = *(cellSet[0].begin() + ((j + 1) % nverts));
+    // Read out the new cell geometries.
+    for (unsigned k = 0; k != round.size(); ++k) {
+      const unsigned iorphan = round[k];
+      for (unsigned i = 0; i != neighbors[iorphan].size(); ++i) {
+        const unsigned igen = neighbors[iorphan][i];
+        const Polygon& cell = adoptedCells[iorphan][i];
+        cellPolygons[igen] = cell;
+        cellGrid.insert(igen, polygonBox(cell));
+        newCellEdges[igen].clear();
+        const unsigned nverts = cell.size();
+        for (unsigned j = 0; j != nverts; ++j) {
+          const Point& v0 = *(cell.begin() + j);
+          const Point& v1 = *(cell.begin() + ((j + 1) % nverts));
    
-        // Insert vertex 0.
-        p.x = v0.x();
-        p.y = v0.y();
-        const int j0 = node2id.index(p);
-        if (j0 == newNodes.size()) {
-          newNodes.push_back(p);
-          newNodeCells.push_back(std::set<int>());
-        }
-        newNodeCells[j0].insert(igen);
-
-        // Insert vertex 1.
-        p.x = v1.x();
-        p.y = v1.y();
-        const int j1 = node2id.index(p);
-        if (j1 == newNodes.size()) {
-          newNodes.push_back(p);
-          newNodeCells.push_back(std::set<int>());
-        }
-        newNodeCells[j1].insert(igen);
+          // Insert vertex 0.
+          p.x = v0.x();
+          p.y = v0.y();
+          const int j0 = node2id.index(p);
+          if (j0 == newNodes.size()) newNodes.push_back(p);
+
+          // Insert vertex 1.
+          p.x = v1.x();
+          p.y = v1.y();
+          const int j1 = node2id.index(p);
+          if (j1 == newNodes.size()) newNodes.push_back(p);
     
-        // Now insert the edge if non-degenerate.
-        if (j0 != j1) {
-          const std::pair<int, int> edge = internal::hashEdge(j0, j1);
-          POLY_ASSERT((edge.first == j0 and edge.second == j1) or
-                      (edge.first == j1 and edge.second == j0));
-          const int old_size = edge2id.size();
-          const int e1 = internal::addKeyToMap(edge, edge2id);
-          if (e1 == old_size) {
-            POLY_ASSERT(e1 == newEdges.size());
-            newEdges.push_back(edge);
-          }
-          if (edge.first == j0) {
-            newCellEdges[igen].push_back(e1);
-          } else {
-            newCellEdges[igen].push_back(~e1);
+          // Now insert the edge if non-degenerate.
+          if (j0 != j1) {
+            const std::pair<int, int> edge = internal::hashEdge(j0, j1);
+            POLY_ASSERT((edge.first == j0 and edge.second == j1) or
+                        (edge.first == j1 and edge.second == j0));
+            const int old_size = edge2id.size();
+            const int e1 = internal::addKeyToMap(edge, edge2id);
+            if (e1 == old_size) {
+              POLY_ASSERT(e1 == newEdges.size());
+              newEdges.push_back(edge);
+            }
+            if (edge.first == j0) {
+              newCellEdges[igen].push_back(e1);
+            } else {
+              newCellEdges[igen].push_back(~e1);
+            }
           }
         }
       }
+      PolygonSet().swap(adoptedCells[iorphan]);
     }
+    pending.swap(deferred);
   }
   POLY_ASSERT(newCellEdges.size() == ncells);
+  orphanTimer.stop();
 
   // If we dealt with any orphans, there may be unused edges and nodes we should clear out before
   // copying the final topology.
@@ -507,5 +676,11 @@ clipQuantizedTessellation<int, double>(QuantizedTessellation2d<int, double>& qme
                                        const std::vector<double>& PLCpoints,
                                        const PLC<2, double>& geometry,
                                        const Tessellator<2, double>& tessellator);
+template
+void
+clipQuantizedTessellation<int, float>(QuantizedTessellation2d<int, float>& qmesh,
+                                      const std::vector<float>& PLCpoints,
+                                      const PLC<2, float>& geometry,
+                                      const Tessellator<2, float>& tessellator);
 
 }
@@ -1,20 +1,1338 @@
 //------------------------------------------------------------------------------
 // 3D implementation of clipQuantizedTessellation.
 //
-// This method relies upon the Boost.Polygon library for geometric operations.
+// The usual boundaries are convex (boxes and the like), and since the Voronoi
+// cells are convex too we clip each cell by the facet planes of the boundary
+// directly in the quantized coordinates.  Neighboring cells compute the points
+// where a shared edge crosses a plane identically, so the clipped mesh stays
+// conformal.
+//
+// Non-convex boundaries split each cell into convex pieces by the planes of
+// the boundary facets which actually meet it, keep the pieces inside the
+// boundary, and merge the fragments of each face back together.  The point
+// where a plane crosses an edge is named by the plane and the two faces
+// meeting at the edge, so cells cut by different sets of planes still agree
+// on the nodes they share.  As in 2D, a cell the boundary cuts into several
+// pieces keeps the one holding its generator, and the rest are orphans,
+// adopted by the neighboring cell with the nearest generator.
 //------------------------------------------------------------------------------
 
+#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <cmath>
+#include <stdint.h>
+
 #include "clipQuantizedTessellation.hh"
 #include "polytope_internal.hh"
+#include "BoxGrid.hh"
+#include "timingUtilities.hh"
 
 namespace polytope {
 
+namespace {
+
+// A cell as a set of node loops, each counterclockwise viewed from outside
+// the cell.
+typedef std::vector<std::vector<int> > FaceLoops;
+
+//------------------------------------------------------------------------------
+// Hash functors for the keys we look up.
+//------------------------------------------------------------------------------
+inline
+size_t
+hashInts(const size_t seed, const int64_t value) {
+  return seed ^ (std::hash<int64_t>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+template<typename IntType>
+struct IntPointHash {
+  size_t operator()(const Point3<IntType>& p) const {
+    return hashInts(hashInts(hashInts(0, p.x), p.y), p.z);
+  }
+};
+
+struct EdgeHash {
+  size_t operator()(const std::pair<int, int>& edge) const {
+    return hashInts(hashInts(0, edge.first), edge.second);
+  }
+};
+
+struct LoopHash {
+  size_t operator()(const std::vector<int>& loop) const {
+    size_t result = loop.size();
+    for (unsigned k = 0; k != loop.size(); ++k) result = hashInts(result, loop[k]);
+    return result;
+  }
+};
+
+typedef std::unordered_map<std::vector<int>, unsigned, LoopHash> FaceKeyMap;
+
+//------------------------------------------------------------------------------
+// The key of a face loop: its nodes starting from the least, heading towards
+// the lesser of its neighbors, so both cells sharing a face get the same key.
+// Returns 1 if the loop runs that way, and -1 if it runs the other.
+//------------------------------------------------------------------------------
+int
+faceKey(const std::vector<int>& loop, std::vector<int>& key) {
+  const int n = loop.size();
+  const int i0 = std::min_element(loop.begin(), loop.end()) - loop.begin();
+  const int sense = (loop[(i0 + 1) % n] < loop[(i0 + n - 1) % n] ? 1 : -1);
+  key.resize(n);
+  for (int k = 0; k != n; ++k) key[k] = loop[(i0 + n + sense*k) % n];
+  return sense;
+}
+
+//------------------------------------------------------------------------------
+// Map quantized points exactly to unique node ids.
+//------------------------------------------------------------------------------
+template<typename IntType>
+struct NodeTable {
+  typedef Point3<IntType> IntPoint;
+  std::vector<IntPoint> nodes;
+  std::unordered_map<IntPoint, int, IntPointHash<IntType> > ids;
+
+  // The initial nodes keep their ids, even if some coincide.
+  explicit NodeTable(const std::vector<IntPoint>& initialNodes):
+    nodes(initialNodes),
+    ids() {
+    for (unsigned i = 0; i != nodes.size(); ++i) ids.insert(std::make_pair(nodes[i], int(i)));
+  }
+
+  int index(const IntPoint& p) {
+    const typename std::unordered_map<IntPoint, int, IntPointHash<IntType> >::const_iterator itr = ids.find(p);
+    if (itr != ids.end()) return itr->second;
+    const int result = nodes.size();
+    ids[p] = result;
+    nodes.push_back(p);
+    return result;
+  }
+};
+
+//------------------------------------------------------------------------------
+// The nodes where planes cross the edges of cells, named by the plane and the
+// line the edge lies on.  The first cell to cross a line computes the node,
+// and every other cell crossing the same line reuses it, however its edges
+// along the line were cut.
+//------------------------------------------------------------------------------
+struct TagTriple {
+  int tags[3];
+  TagTriple(const int a, const int b, const int c) {
+    tags[0] = a;
+    tags[1] = b;
+    tags[2] = c;
+    std::sort(tags, tags + 3);
+  }
+  bool operator==(const TagTriple& rhs) const {
+    return tags[0] == rhs.tags[0] and tags[1] == rhs.tags[1] and tags[2] == rhs.tags[2];
+  }
+};
+
+struct TagTripleHash {
+  size_t operator()(const TagTriple& key) const {
+    return hashInts(hashInts(hashInts(0, key.tags[0]), key.tags[1]), key.tags[2]);
+  }
+};
+
+struct CrossingNodes {
+  const std::vector<std::vector<int> >& faces;
+  std::unordered_map<TagTriple, int, TagTripleHash> nodes;
+
+  // The original faces, as loops of edges.
+  explicit CrossingNodes(const std::vector<std::vector<int> >& originalFaces):
+    faces(originalFaces),
+    nodes() {}
+
+  // The key for the plane tagged planeTag crossing the line between faces
+  // tagged a and b.  Two original faces meet along an original edge, which
+  // the other cells around it see between other faces, so we name that line
+  // by the edge instead.
+  TagTriple key(const int a, const int b, const int planeTag) const {
+    const int n = faces.size();
+    if (a < n and b < n) {
+      for (unsigned i = 0; i != faces[a].size(); ++i) {
+        const int e = internal::positiveID(faces[a][i]);
+        for (unsigned j = 0; j != faces[b].size(); ++j) {
+          if (internal::positiveID(faces[b][j]) == e) return TagTriple(~e, ~e, planeTag);
+        }
+      }
+    }
+    return TagTriple(a, b, planeTag);
+  }
+};
+
+//------------------------------------------------------------------------------
+// A plane n.x = d in quantized coordinates, with n a unit vector.
+//------------------------------------------------------------------------------
+struct ClipPlane {
+  double normal[3], d;
+
+  template<typename IntType>
+  double distance(const Point3<IntType>& p) const {
+    return normal[0]*double(p.x) + normal[1]*double(p.y) + normal[2]*double(p.z) - d;
+  }
+
+  void flip() {
+    normal[0] = -normal[0];
+    normal[1] = -normal[1];
+    normal[2] = -normal[2];
+    d = -d;
+  }
+};
+
+//------------------------------------------------------------------------------
+// The plane of a PLC facet, by Newell's method.  Returns false for a
+// degenerate facet.
+//------------------------------------------------------------------------------
+template<typename IntType>
+bool
+facetPlane(const std::vector<int>& facet,
+           const std::vector<Point3<IntType> >& points,
+           ClipPlane& plane) {
+  const unsigned n = facet.size();
+  if (n < 3) return false;
+  const Point3<IntType>& p0 = points[facet[0]];
+  double normal[3] = {0.0, 0.0, 0.0}, centroid[3] = {0.0, 0.0, 0.0};
+  for (unsigned k = 0; k != n; ++k) {
+    const Point3<IntType>& pa = points[facet[k]];
+    const Point3<IntType>& pb = points[facet[(k + 1) % n]];
+    const double a[3] = {double(pa.x) - p0.x, double(pa.y) - p0.y, double(pa.z) - p0.z};
+    const double b[3] = {double(pb.x) - p0.x, double(pb.y) - p0.y, double(pb.z) - p0.z};
+    normal[0] += (a[1] - b[1])*(a[2] + b[2]);
+    normal[1] += (a[2] - b[2])*(a[0] + b[0]);
+    normal[2] += (a[0] - b[0])*(a[1] + b[1]);
+    centroid[0] += a[0];
+    centroid[1] += a[1];
+    centroid[2] += a[2];
+  }
+  const double nmag = std::sqrt(normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2]);
+  if (nmag == 0.0) return false;
+  for (unsigned k = 0; k != 3; ++k) plane.normal[k] = normal[k]/nmag;
+  plane.d = (plane.normal[0]*(p0.x + centroid[0]/n) +
+             plane.normal[1]*(p0.y + centroid[1]/n) +
+             plane.normal[2]*(p0.z + centroid[2]/n));
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// The point where the segment (a, b) crosses the plane, rounded to the
+// quantized grid.  We always interpolate from the lesser end point, so both
+// cells sharing an edge get the same node.
+//------------------------------------------------------------------------------
+template<typename IntType>
+int
+intersectPlane(const int a, const int b,
+               const ClipPlane& plane,
+               NodeTable<IntType>& table) {
+  Point3<IntType> pa = table.nodes[a], pb = table.nodes[b];
+  if (pb < pa) std::swap(pa, pb);
+  const double sa = plane.distance(pa), sb = plane.distance(pb);
+  POLY_ASSERT(sa*sb < 0.0);
+  const double t = sa/(sa - sb);
+  const Point3<IntType> p(IntType(std::floor(pa.x + t*(double(pb.x) - pa.x) + 0.5)),
+                          IntType(std::floor(pa.y + t*(double(pb.y) - pa.y) + 0.5)),
+                          IntType(std::floor(pa.z + t*(double(pb.z) - pa.z) + 0.5)));
+  return table.index(p);
+}
+
+//------------------------------------------------------------------------------
+// Clip a convex cell to the inside of a plane.  Nodes within tol of the
+// plane are taken to be on it.  The part of each face inside is kept
+// (Sutherland-Hodgman), and the hole left in the surface is closed with a
+// new face in the plane, tagged with capTag.  Given crossings, the node where
+// an edge crosses the plane is looked up by the tags of the faces meeting at
+// the edge and capTag, which then has to identify the plane.  Returns false
+// if nothing of the cell is left.
+//------------------------------------------------------------------------------
+template<typename IntType>
+bool
+clipCell(FaceLoops& cell,
+         std::vector<int>& tags,
+         const int capTag,
+         const ClipPlane& plane,
+         const double tol,
+         NodeTable<IntType>& table,
+         CrossingNodes* crossings = 0) {
+  typedef std::unordered_map<std::pair<int, int>, int, EdgeHash> EdgeMap;
+
+  // Classify the nodes: -1 inside, 0 on the plane, 1 outside.
+  std::unordered_map<int, int> side;
+  bool anyInside = false, anyOutside = false;
+  for (unsigned i = 0; i != cell.size(); ++i) {
+    for (unsigned j = 0; j != cell[i].size(); ++j) {
+      const int k = cell[i][j];
+      if (side.find(k) == side.end()) {
+        const double s = plane.distance(table.nodes[k]);
+        side[k] = (s > tol ? 1 : s < -tol ? -1 : 0);
+        anyInside |= (s < -tol);
+        anyOutside |= (s > tol);
+      }
+    }
+  }
+  if (not anyOutside) return true;
+  if (not anyInside) {
+    cell.clear();
+    tags.clear();
+    return false;
+  }
+
+  // The tag of the face on each side of each edge.
+  EdgeMap edgeTags;
+  if (crossings != 0) {
+    for (unsigned i = 0; i != cell.size(); ++i) {
+      const unsigned n = cell[i].size();
+      for (unsigned j = 0; j != n; ++j) edgeTags[std::make_pair(cell[i][j], cell[i][(j + 1) % n])] = tags[i];
+    }
+  }
+
+  // Clip each face, collecting the edges of the survivors lying in the plane.
+  // Each is reversed, since it bounds the new face from the other side.
+  FaceLoops result;
+  std::vector<int> resultTags;
+  EdgeMap capEdges;
+  bool coplanarFace = false;
+  for (unsigned i = 0; i != cell.size(); ++i) {
+    const std::vector<int>& loop = cell[i];
+    const unsigned n = loop.size();
+    std::vector<int> clipped;
+    for (unsigned j = 0; j != n; ++j) {
+      const int a = loop[j], b = loop[(j + 1) % n];
+      const int sa = side[a], sb = side[b];
+      if (sa <= 0) clipped.push_back(a);
+      if (sa*sb < 0) {
+        int c = -1;
+        const EdgeMap::const_iterator twin = (crossings != 0 ? edgeTags.find(std::make_pair(b, a)) : edgeTags.end());
+        if (twin != edgeTags.end()) {
+          const TagTriple key = crossings->key(tags[i], twin->second, capTag);
+          const std::unordered_map<TagTriple, int, TagTripleHash>::const_iterator itr = crossings->nodes.find(key);
+          if (itr != crossings->nodes.end()) {
+            c = itr->second;
+          } else {
+            c = intersectPlane(a, b, plane, table);
+            crossings->nodes[key] = c;
+          }
+        } else {
+          c = intersectPlane(a, b, plane, table);
+        }
+        side[c] = 0;
+        clipped.push_back(c);
+      }
+    }
+
+    // Rounding may have merged neighboring nodes.
+    std::vector<int>::iterator last = std::unique(clipped.begin(), clipped.end());
+    clipped.erase(last, clipped.end());
+    while (clipped.size() > 1 and clipped.front() == clipped.back()) clipped.pop_back();
+    if (clipped.size() < 3) continue;
+
+    // Note the edges in the plane.
+    const unsigned m = clipped.size();
+    unsigned numOn = 0;
+    for (unsigned j = 0; j != m; ++j) {
+      const int a = clipped[j], b = clipped[(j + 1) % m];
+      if (side[a] == 0) ++numOn;
+      if (side[a] == 0 and side[b] == 0) {
+        const EdgeMap::iterator itr = capEdges.find(std::make_pair(a, b));
+        if (itr != capEdges.end()) {
+          capEdges.erase(itr);
+        } else {
+          capEdges[std::make_pair(b, a)] = 1;
+        }
+      }
+    }
+    coplanarFace |= (numOn == m);
+    result.push_back(clipped);
+    resultTags.push_back(tags[i]);
+  }
+
+  // Chain what's left of the plane edges into the new face, unless a face in
+  // the plane already closes the cell.
+  if (not coplanarFace) {
+    std::map<int, int> next;
+    for (EdgeMap::const_iterator itr = capEdges.begin(); itr != capEdges.end(); ++itr) {
+      POLY_ASSERT(next.find(itr->first.first) == next.end());
+      next[itr->first.first] = itr->first.second;
+    }
+    while (not next.empty()) {
+      std::vector<int> cap;
+      int k = next.begin()->first;
+      while (next.find(k) != next.end()) {
+        cap.push_back(k);
+        const int knext = next[k];
+        next.erase(k);
+        k = knext;
+      }
+      POLY_ASSERT(k == cap.front());
+      if (cap.size() >= 3) {
+        result.push_back(cap);
+        resultTags.push_back(capTag);
+      }
+    }
+  }
+  POLY_ASSERT(result.size() >= 4);
+  cell.swap(result);
+  tags.swap(resultTags);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Which side of a plane a convex cell is on: -1 inside, 1 outside, or 0 if
+// the plane cuts it.
+//------------------------------------------------------------------------------
+template<typename IntType>
+int
+cellSide(const FaceLoops& cell,
+         const ClipPlane& plane,
+         const double tol,
+         const NodeTable<IntType>& table) {
+  bool anyInside = false, anyOutside = false;
+  for (unsigned i = 0; i != cell.size(); ++i) {
+    for (unsigned j = 0; j != cell[i].size(); ++j) {
+      const double s = plane.distance(table.nodes[cell[i][j]]);
+      anyInside |= (s < -tol);
+      anyOutside |= (s > tol);
+    }
+  }
+  return (anyInside and anyOutside ? 0 :
+          anyOutside ? 1 :
+          -1);
+}
+
+//------------------------------------------------------------------------------
+// The winding number of a closed surface about a point: the sum of the solid
+// angles of its facets (fanned into triangles) seen from the point, over 4 pi.
+//------------------------------------------------------------------------------
+template<typename IntType>
+double
+windingNumber(const std::vector<std::vector<int> >& facets,
+              const std::vector<Point3<IntType> >& points,
+              const double* p) {
+  double result = 0.0;
+  for (unsigned i = 0; i != facets.size(); ++i) {
+    const std::vector<int>& facet = facets[i];
+    if (facet.size() < 3) continue;
+    const Point3<IntType>& p0 = points[facet[0]];
+    const double a[3] = {p0.x - p[0], p0.y - p[1], p0.z - p[2]};
+    const double la = std::sqrt(a[0]*a[0] + a[1]*a[1] + a[2]*a[2]);
+    for (unsigned k = 1; k + 1 < facet.size(); ++k) {
+      const Point3<IntType>& p1 = points[facet[k]];
+      const Point3<IntType>& p2 = points[facet[k + 1]];
+      const double b[3] = {p1.x - p[0], p1.y - p[1], p1.z - p[2]};
+      const double c[3] = {p2.x - p[0], p2.y - p[1], p2.z - p[2]};
+      const double lb = std::sqrt(b[0]*b[0] + b[1]*b[1] + b[2]*b[2]);
+      const double lc = std::sqrt(c[0]*c[0] + c[1]*c[1] + c[2]*c[2]);
+      const double triple = (a[0]*(b[1]*c[2] - b[2]*c[1]) +
+                             a[1]*(b[2]*c[0] - b[0]*c[2]) +
+                             a[2]*(b[0]*c[1] - b[1]*c[0]));
+      const double ab = a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+      const double ac = a[0]*c[0] + a[1]*c[1] + a[2]*c[2];
+      const double bc = b[0]*c[0] + b[1]*c[1] + b[2]*c[2];
+      result += 2.0*std::atan2(triple, la*lb*lc + ab*lc + ac*lb + bc*la);
+    }
+  }
+  return result/(4.0*M_PI);
+}
+
+//------------------------------------------------------------------------------
+// The area weighted normal of a loop (Newell's method), about its first node.
+//------------------------------------------------------------------------------
+template<typename IntType>
+void
+newellNormal(const std::vector<int>& loop,
+             const std::vector<Point3<IntType> >& nodes,
+             double* normal) {
+  const unsigned n = loop.size();
+  const Point3<IntType>& p0 = nodes[loop[0]];
+  normal[0] = normal[1] = normal[2] = 0.0;
+  for (unsigned k = 0; k != n; ++k) {
+    const Point3<IntType>& pa = nodes[loop[k]];
+    const Point3<IntType>& pb = nodes[loop[(k + 1) % n]];
+    const double a[3] = {double(pa.x) - p0.x, double(pa.y) - p0.y, double(pa.z) - p0.z};
+    const double b[3] = {double(pb.x) - p0.x, double(pb.y) - p0.y, double(pb.z) - p0.z};
+    normal[0] += (a[1] - b[1])*(a[2] + b[2]);
+    normal[1] += (a[2] - b[2])*(a[0] + b[0]);
+    normal[2] += (a[0] - b[0])*(a[1] + b[1]);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Merge some coplanar faces of a cell by cancelling the edges they share,
+// giving one loop for each connected patch.  Returns false if what's left
+// doesn't chain into simple loops, or if a patch has a hole in it, which a
+// single loop can't describe.
+//------------------------------------------------------------------------------
+template<typename IntType>
+bool
+mergeFaces(const FaceLoops& cell,
+           const std::vector<unsigned>& faces,
+           const std::vector<Point3<IntType> >& nodes,
+           FaceLoops& result) {
+  typedef std::unordered_map<std::pair<int, int>, unsigned, EdgeHash> EdgeMap;
+  EdgeMap edgeIndex;
+  std::vector<std::pair<int, int> > edges;
+  std::vector<bool> alive;
+  double normal[3] = {0.0, 0.0, 0.0}, ni[3];
+  for (unsigned i = 0; i != faces.size(); ++i) {
+    const std::vector<int>& loop = cell[faces[i]];
+    const unsigned n = loop.size();
+    newellNormal(loop, nodes, ni);
+    for (unsigned j = 0; j != 3; ++j) normal[j] += ni[j];
+    for (unsigned k = 0; k != n; ++k) {
+      const int a = loop[k], b = loop[(k + 1) % n];
+      const EdgeMap::iterator itr = edgeIndex.find(std::make_pair(b, a));
+      if (itr != edgeIndex.end()) {
+        alive[itr->second] = false;
+        edgeIndex.erase(itr);
+      } else {
+        if (edgeIndex.find(std::make_pair(a, b)) != edgeIndex.end()) return false;
+        edgeIndex[std::make_pair(a, b)] = edges.size();
+        edges.push_back(std::make_pair(a, b));
+        alive.push_back(true);
+      }
+    }
+  }
+  std::unordered_map<int, int> next;
+  for (unsigned k = 0; k != edges.size(); ++k) {
+    if (not alive[k]) continue;
+    if (next.find(edges[k].first) != next.end()) return false;
+    next[edges[k].first] = edges[k].second;
+  }
+  if (next.empty()) return false;
+  FaceLoops loops;
+  for (unsigned k = 0; k != edges.size(); ++k) {
+    if (not alive[k] or next.find(edges[k].first) == next.end()) continue;
+    std::vector<int> loop;
+    int j = edges[k].first;
+    do {
+      loop.push_back(j);
+      const std::unordered_map<int, int>::iterator itr = next.find(j);
+      j = itr->second;
+      next.erase(itr);
+    } while (next.find(j) != next.end());
+    if (j != loop.front() or loop.size() < 3) return false;
+    newellNormal(loop, nodes, ni);
+    if (ni[0]*normal[0] + ni[1]*normal[1] + ni[2]*normal[2] <= 0.0) return false;
+    loops.push_back(loop);
+  }
+  result.insert(result.end(), loops.begin(), loops.end());
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Merge the faces of a cell with the same tag -- the fragments of each
+// original face and each facet plane -- and the same cell across them.
+// Fragments which don't merge cleanly are kept as they are.
+//------------------------------------------------------------------------------
+template<typename IntType>
+void
+mergeFragments(FaceLoops& cell,
+               std::vector<int>& tags,
+               const std::vector<int>& neighbors,
+               const std::vector<Point3<IntType> >& nodes) {
+  std::unordered_map<std::pair<int, int>, unsigned, EdgeHash> key2group;
+  std::vector<std::vector<unsigned> > groups;
+  for (unsigned j = 0; j != cell.size(); ++j) {
+    const std::pair<std::unordered_map<std::pair<int, int>, unsigned, EdgeHash>::iterator, bool> itr =
+      key2group.insert(std::make_pair(std::make_pair(tags[j], neighbors[j]), unsigned(groups.size())));
+    if (itr.second) groups.push_back(std::vector<unsigned>());
+    groups[itr.first->second].push_back(j);
+  }
+  FaceLoops merged;
+  std::vector<int> mergedTags;
+  for (unsigned i = 0; i != groups.size(); ++i) {
+    const std::vector<unsigned>& group = groups[i];
+    const unsigned n0 = merged.size();
+    if (group.size() == 1 or not mergeFaces(cell, group, nodes, merged)) {
+      merged.resize(n0);
+      for (unsigned k = 0; k != group.size(); ++k) merged.push_back(cell[group[k]]);
+    }
+    mergedTags.resize(merged.size(), tags[group[0]]);
+  }
+  cell.swap(merged);
+  tags.swap(mergedTags);
+}
+
+//------------------------------------------------------------------------------
+// Cutting and merging leaves nodes in the middle of straight edges, which
+// only ever connect to the two ends.  We remove those past firstNode.
+//------------------------------------------------------------------------------
+template<typename IntType>
+void
+removeStraightNodes(std::vector<FaceLoops>& cells,
+                    const std::vector<Point3<IntType> >& nodes,
+                    const unsigned firstNode,
+                    const double tol) {
+  typedef Point3<IntType> IntPoint;
+
+  // Up to three neighbors of each node is all we need to know.
+  std::vector<std::vector<int> > nodeNeighbors(nodes.size());
+  for (unsigned i = 0; i != cells.size(); ++i) {
+    for (unsigned j = 0; j != cells[i].size(); ++j) {
+      const std::vector<int>& loop = cells[i][j];
+      const unsigned n = loop.size();
+      for (unsigned k = 0; k != n; ++k) {
+        const int a = loop[k], b = loop[(k + 1) % n];
+        if (a >= int(firstNode) and nodeNeighbors[a].size() < 3 and
+            std::find(nodeNeighbors[a].begin(), nodeNeighbors[a].end(), b) == nodeNeighbors[a].end()) nodeNeighbors[a].push_back(b);
+        if (b >= int(firstNode) and nodeNeighbors[b].size() < 3 and
+            std::find(nodeNeighbors[b].begin(), nodeNeighbors[b].end(), a) == nodeNeighbors[b].end()) nodeNeighbors[b].push_back(a);
+      }
+    }
+  }
+  std::vector<bool> removeNode(nodes.size(), false);
+  bool anyRemoved = false;
+  for (unsigned k = firstNode; k < nodes.size(); ++k) {
+    if (nodeNeighbors[k].size() == 2) {
+      const IntPoint& p = nodes[k];
+      const IntPoint& a = nodes[nodeNeighbors[k][0]];
+      const IntPoint& b = nodes[nodeNeighbors[k][1]];
+      const double ab[3] = {double(b.x) - a.x, double(b.y) - a.y, double(b.z) - a.z};
+      const double ap[3] = {double(p.x) - a.x, double(p.y) - a.y, double(p.z) - a.z};
+      const double cross[3] = {ab[1]*ap[2] - ab[2]*ap[1],
+                               ab[2]*ap[0] - ab[0]*ap[2],
+                               ab[0]*ap[1] - ab[1]*ap[0]};
+      const double cmag2 = cross[0]*cross[0] + cross[1]*cross[1] + cross[2]*cross[2];
+      const double abmag2 = ab[0]*ab[0] + ab[1]*ab[1] + ab[2]*ab[2];
+      removeNode[k] = (cmag2 <= tol*tol*abmag2);
+      anyRemoved |= removeNode[k];
+    }
+  }
+  if (not anyRemoved) return;
+  for (unsigned i = 0; i != cells.size(); ++i) {
+    for (unsigned j = 0; j != cells[i].size(); ++j) {
+      std::vector<int>& loop = cells[i][j];
+      std::vector<int> newLoop;
+      for (unsigned k = 0; k != loop.size(); ++k) {
+        if (not removeNode[loop[k]]) newLoop.push_back(loop[k]);
+      }
+      POLY_ASSERT(newLoop.size() >= 3);
+      loop.swap(newLoop);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// A cell cut by a plane that its neighbor across a face was not cut by keeps
+// the crossing nodes on their shared edges, so the neighbor sees an edge where
+// the cell has a chain of nodes.  We put those nodes into every edge they lie
+// on, walking from one end to the other through the nodes connected to it.
+//------------------------------------------------------------------------------
+template<typename IntType>
+void
+splitTJunctions(std::vector<FaceLoops>& cells,
+                const std::vector<Point3<IntType> >& nodes,
+                const double tol) {
+  std::vector<std::vector<int> > nodeNeighbors(nodes.size());
+  for (unsigned i = 0; i != cells.size(); ++i) {
+    for (unsigned j = 0; j != cells[i].size(); ++j) {
+      const std::vector<int>& loop = cells[i][j];
+      const unsigned n = loop.size();
+      for (unsigned k = 0; k != n; ++k) {
+        const int a = loop[k], b = loop[(k + 1) % n];
+        if (std::find(nodeNeighbors[a].begin(), nodeNeighbors[a].end(), b) == nodeNeighbors[a].end()) {
+          nodeNeighbors[a].push_back(b);
+          nodeNeighbors[b].push_back(a);
+        }
+      }
+    }
+  }
+  for (unsigned i = 0; i != cells.size(); ++i) {
+    for (unsigned j = 0; j != cells[i].size(); ++j) {
+      std::vector<int>& loop = cells[i][j];
+      const unsigned n = loop.size();
+      std::vector<int> newLoop;
+      for (unsigned k = 0; k != n; ++k) {
+        const int a = loop[k], b = loop[(k + 1) % n];
+        newLoop.push_back(a);
+        const double ab[3] = {double(nodes[b].x) - nodes[a].x,
+                              double(nodes[b].y) - nodes[a].y,
+                              double(nodes[b].z) - nodes[a].z};
+        const double abmag2 = ab[0]*ab[0] + ab[1]*ab[1] + ab[2]*ab[2];
+        int current = a;
+        double tcurrent = 0.0;
+        while (true) {
+          int next = -1;
+          double tnext = 1.0;
+          for (unsigned m = 0; m != nodeNeighbors[current].size(); ++m) {
+            const int x = nodeNeighbors[current][m];
+            if (x == b) continue;
+            const double ax[3] = {double(nodes[x].x) - nodes[a].x,
+                                  double(nodes[x].y) - nodes[a].y,
+                                  double(nodes[x].z) - nodes[a].z};
+            const double t = (ax[0]*ab[0] + ax[1]*ab[1] + ax[2]*ab[2])/abmag2;
+            if (t <= tcurrent or t >= tnext) continue;
+            const double cross[3] = {ab[1]*ax[2] - ab[2]*ax[1],
+                                     ab[2]*ax[0] - ab[0]*ax[2],
+                                     ab[0]*ax[1] - ab[1]*ax[0]};
+            if (cross[0]*cross[0] + cross[1]*cross[1] + cross[2]*cross[2] <= tol*tol*abmag2) {
+              next = x;
+              tnext = t;
+            }
+          }
+          if (next == -1) break;
+          newLoop.push_back(next);
+          current = next;
+          tcurrent = tnext;
+        }
+      }
+      loop.swap(newLoop);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Is the point q in the polygon (by crossing number)?
+//------------------------------------------------------------------------------
+bool
+pointInPolygon(const std::vector<std::pair<double, double> >& poly,
+               const std::pair<double, double>& q) {
+  const unsigned n = poly.size();
+  bool result = false;
+  for (unsigned i = 0, j = n - 1; i != n; j = i++) {
+    const std::pair<double, double>& a = poly[i];
+    const std::pair<double, double>& b = poly[j];
+    if ((a.second > q.second) != (b.second > q.second) and
+        q.first < a.first + (q.second - a.second)*(b.first - a.first)/(b.second - a.second)) result = not result;
+  }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// Does a face loop hold the point p, seen along normal?
+//------------------------------------------------------------------------------
+template<typename IntType>
+bool
+loopContains(const std::vector<int>& loop,
+             const std::vector<Point3<IntType> >& nodes,
+             const double* normal,
+             const double* p) {
+  unsigned iaxis = 0;
+  for (unsigned j = 1; j != 3; ++j) {
+    if (std::abs(normal[j]) > std::abs(normal[iaxis])) iaxis = j;
+  }
+  const unsigned iu = (iaxis + 1) % 3, iv = (iaxis + 2) % 3;
+  std::vector<std::pair<double, double> > poly(loop.size());
+  for (unsigned k = 0; k != loop.size(); ++k) poly[k] = std::make_pair(double(nodes[loop[k]][iu]), double(nodes[loop[k]][iv]));
+  return pointInPolygon(poly, std::make_pair(p[iu], p[iv]));
+}
+
+//------------------------------------------------------------------------------
+// The distance between the point q and the segment (a, b).
+//------------------------------------------------------------------------------
+double
+pointSegmentDistance(const std::pair<double, double>& q,
+                     const std::pair<double, double>& a,
+                     const std::pair<double, double>& b) {
+  const double dx = b.first - a.first, dy = b.second - a.second;
+  const double len2 = dx*dx + dy*dy;
+  const double t = (len2 > 0.0 ?
+                    std::max(0.0, std::min(1.0, ((q.first - a.first)*dx + (q.second - a.second)*dy)/len2)) :
+                    0.0);
+  const double ex = a.first + t*dx - q.first, ey = a.second + t*dy - q.second;
+  return std::sqrt(ex*ex + ey*ey);
+}
+
+//------------------------------------------------------------------------------
+// Do the segments (a, b) and (c, d) come within eps of each other?
+//------------------------------------------------------------------------------
+bool
+segmentsMeet(const std::pair<double, double>& a,
+             const std::pair<double, double>& b,
+             const std::pair<double, double>& c,
+             const std::pair<double, double>& d,
+             const double eps) {
+  const double d1 = (b.first - a.first)*(c.second - a.second) - (b.second - a.second)*(c.first - a.first);
+  const double d2 = (b.first - a.first)*(d.second - a.second) - (b.second - a.second)*(d.first - a.first);
+  const double d3 = (d.first - c.first)*(a.second - c.second) - (d.second - c.second)*(a.first - c.first);
+  const double d4 = (d.first - c.first)*(b.second - c.second) - (d.second - c.second)*(b.first - c.first);
+  if (d1*d2 < 0.0 and d3*d4 < 0.0) return true;
+  return (pointSegmentDistance(a, c, d) <= eps or
+          pointSegmentDistance(b, c, d) <= eps or
+          pointSegmentDistance(c, a, b) <= eps or
+          pointSegmentDistance(d, a, b) <= eps);
+}
+
+//------------------------------------------------------------------------------
+// Does a boundary facet meet a convex cell its plane crosses?  We project the
+// section of the cell by the plane and the facet onto the coordinate plane
+// most nearly parallel to the facet, and check whether the convex hull of the
+// section meets the facet polygon.  Touching within eps counts as meeting.
+//------------------------------------------------------------------------------
+template<typename IntType>
+bool
+facetMeetsCell(const std::vector<int>& facet,
+               const std::vector<Point3<IntType> >& points,
+               const FaceLoops& cell,
+               const ClipPlane& plane,
+               const double tol,
+               const NodeTable<IntType>& table) {
+  typedef std::pair<double, double> Point2;
+  const double eps = 2.0*tol;
+  unsigned iaxis = 0;
+  for (unsigned j = 1; j != 3; ++j) {
+    if (std::abs(plane.normal[j]) > std::abs(plane.normal[iaxis])) iaxis = j;
+  }
+  const unsigned iu = (iaxis + 1) % 3, iv = (iaxis + 2) % 3;
+
+  // The section of the cell.
+  std::vector<Point2> section;
+  for (unsigned i = 0; i != cell.size(); ++i) {
+    const unsigned n = cell[i].size();
+    for (unsigned k = 0; k != n; ++k) {
+      const Point3<IntType>& pa = table.nodes[cell[i][k]];
+      const Point3<IntType>& pb = table.nodes[cell[i][(k + 1) % n]];
+      const double sa = plane.distance(pa), sb = plane.distance(pb);
+      if (std::abs(sa) <= tol) section.push_back(Point2(pa[iu], pa[iv]));
+      if ((sa < -tol and sb > tol) or (sa > tol and sb < -tol)) {
+        const double t = sa/(sa - sb);
+        section.push_back(Point2(pa[iu] + t*(double(pb[iu]) - pa[iu]),
+                                 pa[iv] + t*(double(pb[iv]) - pa[iv])));
+      }
+    }
+  }
+  if (section.empty()) return false;
+
+  // Its convex hull, counterclockwise (Andrew's monotone chain).
+  std::sort(section.begin(), section.end());
+  section.erase(std::unique(section.begin(), section.end()), section.end());
+  std::vector<Point2> hull;
+  if (section.size() < 3) {
+    hull = section;
+  } else {
+    hull.resize(2*section.size());
+    unsigned k = 0;
+    for (unsigned i = 0; i != section.size(); ++i) {
+      while (k >= 2 and ((hull[k-1].first - hull[k-2].first)*(section[i].second - hull[k-2].second) -
+                         (hull[k-1].second - hull[k-2].second)*(section[i].first - hull[k-2].first)) <= 0.0) --k;
+      hull[k++] = section[i];
+    }
+    for (int i = int(section.size()) - 2, t = k + 1; i >= 0; --i) {
+      while (k >= unsigned(t) and ((hull[k-1].first - hull[k-2].first)*(section[i].second - hull[k-2].second) -
+                                   (hull[k-1].second - hull[k-2].second)*(section[i].first - hull[k-2].first)) <= 0.0) --k;
+      hull[k++] = section[i];
+    }
+    hull.resize(k - 1);
+  }
+
+  // The facet.
+  const unsigned nf = facet.size();
+  std::vector<Point2> poly(nf);
+  for (unsigned k = 0; k != nf; ++k) poly[k] = Point2(points[facet[k]][iu], points[facet[k]][iv]);
+
+  // A facet vertex in the hull?
+  const unsigned nh = hull.size();
+  if (nh >= 3) {
+    for (unsigned k = 0; k != nf; ++k) {
+      bool inside = true;
+      for (unsigned i = 0; inside and i != nh; ++i) {
+        const Point2& a = hull[i];
+        const Point2& b = hull[(i + 1) % nh];
+        const double len = std::sqrt((b.first - a.first)*(b.first - a.first) + (b.second - a.second)*(b.second - a.second));
+        inside = ((b.first - a.first)*(poly[k].second - a.second) -
+                  (b.second - a.second)*(poly[k].first - a.first)) >= -eps*len;
+      }
+      if (inside) return true;
+    }
+  }
+
+  // A hull vertex in the facet?
+  for (unsigned i = 0; i != nh; ++i) {
+    if (pointInPolygon(poly, hull[i])) return true;
+  }
+
+  // Do their edges meet?
+  for (unsigned i = 0; i != nh; ++i) {
+    for (unsigned k = 0; k != nf; ++k) {
+      if (segmentsMeet(hull[i], hull[(i + 1) % nh], poly[k], poly[(k + 1) % nf], eps)) return true;
+    }
+  }
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Union-find with path halving.
+//------------------------------------------------------------------------------
+unsigned
+findRoot(std::vector<unsigned>& parent, unsigned i) {
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+void
+unite(std::vector<unsigned>& parent, const unsigned i, const unsigned j) {
+  const unsigned ri = findRoot(parent, i), rj = findRoot(parent, j);
+  if (ri < rj) {
+    parent[rj] = ri;
+  } else {
+    parent[ri] = rj;
+  }
+}
+
+}
+
+//------------------------------------------------------------------------------
+// clipQuantizedTessellation
+//------------------------------------------------------------------------------
 template<typename IntType, typename RealType>
 void clipQuantizedTessellation(QuantizedTessellation3d<IntType, RealType>& qmesh,
                                const std::vector<RealType>& PLCpoints,
                                const PLC<3, RealType>& geometry,
                                const Tessellator<3, RealType>& tessellator) {
-  POLY_ASSERT2(false, "Implement me!");
+  typedef typename QuantizedTessellation3d<IntType, RealType>::IntPoint IntPoint;
+
+  // How far from a plane (in quanta) a node may be and still be on it.  This
+  // covers rounding the points where edges cross the plane.
+  const double tol = 1.0;
+
+  // Quantize the boundary.
+  const unsigned numBoundaryPoints = PLCpoints.size()/3;
+  POLY_ASSERT(numBoundaryPoints >= 4);
+  std::vector<IntPoint> boundaryPoints(numBoundaryPoints);
+  double center[3] = {0.0, 0.0, 0.0};
+  for (unsigned i = 0; i != numBoundaryPoints; ++i) {
+    qmesh.quantize(&PLCpoints[3*i], &boundaryPoints[i].x);
+    center[0] += double(boundaryPoints[i].x)/numBoundaryPoints;
+    center[1] += double(boundaryPoints[i].y)/numBoundaryPoints;
+    center[2] += double(boundaryPoints[i].z)/numBoundaryPoints;
+  }
+  const IntPoint centerPoint = IntPoint(IntType(center[0]), IntType(center[1]), IntType(center[2]));
+
+  // The facet planes, facing out of the boundary if it's convex.  The
+  // boundary is convex if no boundary point is outside any facet plane.
+  std::vector<ClipPlane> planes;
+  bool convex = geometry.holes.empty();
+  for (unsigned i = 0; convex and i != geometry.facets.size(); ++i) {
+    ClipPlane plane;
+    if (facetPlane(geometry.facets[i], boundaryPoints, plane)) {
+      if (plane.distance(centerPoint) > 0.0) plane.flip();
+      convex = plane.distance(centerPoint) < -tol;
+      for (unsigned j = 0; convex and j != numBoundaryPoints; ++j) {
+        convex = plane.distance(boundaryPoints[j]) <= 4.0*tol;
+      }
+      planes.push_back(plane);
+    }
+  }
+
+  // Read the cells out as node loops.
+  const unsigned ncells = qmesh.cellFaces.size();
+  NodeTable<IntType> table(qmesh.nodes);
+  std::vector<FaceLoops> cells(ncells);
+  for (unsigned i = 0; i != ncells; ++i) {
+    const unsigned nfaces = qmesh.cellFaces[i].size();
+    cells[i].resize(nfaces);
+    for (unsigned j = 0; j != nfaces; ++j) {
+      const int f = qmesh.cellFaces[i][j];
+      const std::vector<int>& face = qmesh.faces[f < 0 ? ~f : f];
+      std::vector<int>& loop = cells[i][j];
+      for (unsigned k = 0; k != face.size(); ++k) {
+        const int e = face[k];
+        loop.push_back(e < 0 ? qmesh.edges[~e].second : qmesh.edges[e].first);
+      }
+      if (f < 0) std::reverse(loop.begin(), loop.end());
+    }
+  }
+
+  if (convex) {
+
+    // Clip every cell by every plane.
+    for (unsigned i = 0; i != ncells; ++i) {
+      const unsigned nfaces0 = cells[i].size();
+      std::vector<int> tags(nfaces0, 0);
+      for (unsigned j = 0; j != planes.size(); ++j) {
+        const bool inside = clipCell(cells[i], tags, 0, planes[j], tol, table);
+        POLY_CONTRACT_VAR(inside);
+        POLY_ASSERT2(inside, "Cell " << i << " is outside the boundary");
+      }
+      if (cells[i].size() != nfaces0) incrementCounter("cellsClipped");
+    }
+
+  } else {
+
+    // Every facet, boundary and holes alike.  Coplanar facets (like the
+    // pieces of a face of a box with a notch in it) share one plane.  The
+    // faces each plane makes are tagged with the number of original faces
+    // plus its index, and the fragments of an original face with its index.
+    std::vector<const std::vector<int>*> facets;
+    for (unsigned i = 0; i != geometry.facets.size(); ++i) facets.push_back(&geometry.facets[i]);
+    for (unsigned ihole = 0; ihole != geometry.holes.size(); ++ihole) {
+      for (unsigned i = 0; i != geometry.holes[ihole].size(); ++i) facets.push_back(&geometry.holes[ihole][i]);
+    }
+    const unsigned nfacets = facets.size();
+    planes.clear();
+    std::vector<int> facetPlaneIDs(nfacets, -1);
+    for (unsigned i = 0; i != nfacets; ++i) {
+      ClipPlane plane;
+      if (not facetPlane(*facets[i], boundaryPoints, plane)) continue;
+      unsigned j = 0;
+      bool coplanar = false;
+      while (not coplanar and j != planes.size()) {
+        coplanar = true;
+        for (unsigned k = 0; coplanar and k != facets[i]->size(); ++k) {
+          coplanar = std::abs(planes[j].distance(boundaryPoints[(*facets[i])[k]])) <= tol;
+        }
+        if (not coplanar) ++j;
+      }
+      if (not coplanar) planes.push_back(plane);
+      facetPlaneIDs[i] = j;
+    }
+    const int nfaces = qmesh.faces.size();
+
+    // Bin the facets on a grid about the size of the cells.
+    typedef typename internal::BoxGrid<3, IntType>::Box Box;
+    int64_t extent = 0;
+    std::vector<Box> facetBoxes(nfacets);
+    for (unsigned i = 0; i != nfacets; ++i) {
+      for (unsigned k = 0; k != facets[i]->size(); ++k) facetBoxes[i].expand(boundaryPoints[(*facets[i])[k]]);
+    }
+    {
+      Box box;
+      for (unsigned i = 0; i != numBoundaryPoints; ++i) box.expand(boundaryPoints[i]);
+      for (unsigned j = 0; j != 3; ++j) extent = std::max(extent, box.high[j] - box.low[j]);
+    }
+    internal::BoxGrid<3, IntType> facetGrid(int64_t(extent/std::cbrt(double(std::max(1U, ncells)))));
+    for (unsigned i = 0; i != nfacets; ++i) facetGrid.insert(i, facetBoxes[i]);
+
+    // Split each cell into convex pieces by the planes of the facets meeting
+    // it, and keep the pieces inside the boundary.  Kept pieces sharing a face
+    // make up a connected part of the cell: the cell keeps the part holding
+    // its generator, and the others are orphans, which we append after the
+    // cells for now.
+    std::vector<std::vector<int> > cellTags(ncells);
+    std::vector<unsigned> orphanOwners;
+    CrossingNodes crossings(qmesh.faces);
+    std::vector<unsigned> candidates;
+    std::vector<int> key;
+    for (unsigned i = 0; i != ncells; ++i) {
+      const unsigned nfaces0 = cells[i].size();
+      cellTags[i].resize(nfaces0);
+      for (unsigned j = 0; j != nfaces0; ++j) cellTags[i][j] = internal::positiveID(qmesh.cellFaces[i][j]);
+
+      // The planes of the facets meeting this cell.
+      Box box;
+      for (unsigned j = 0; j != nfaces0; ++j) {
+        for (unsigned k = 0; k != cells[i][j].size(); ++k) box.expand(table.nodes[cells[i][j][k]]);
+      }
+      box.grow(int64_t(std::ceil(2.0*tol)));
+      facetGrid.query(box, candidates);
+      std::set<int> cuts;
+      for (unsigned k = 0; k != candidates.size(); ++k) {
+        const int iplane = facetPlaneIDs[candidates[k]];
+        if (iplane < 0 or cuts.find(iplane) != cuts.end()) continue;
+        if (cellSide(cells[i], planes[iplane], tol, table) == 0 and
+            facetMeetsCell(*facets[candidates[k]], boundaryPoints, cells[i], planes[iplane], tol, table)) cuts.insert(iplane);
+      }
+      if (cuts.empty()) continue;
+
+      // Split the pieces by each plane crossing them.
+      std::vector<FaceLoops> pieces(1, cells[i]);
+      std::vector<std::vector<int> > pieceTags(1, cellTags[i]);
+      for (std::set<int>::const_iterator itr = cuts.begin(); itr != cuts.end(); ++itr) {
+        const ClipPlane& plane = planes[*itr];
+        ClipPlane flipped = plane;
+        flipped.flip();
+        const unsigned npieces = pieces.size();
+        for (unsigned k = 0; k != npieces; ++k) {
+          if (cellSide(pieces[k], plane, tol, table) != 0) continue;
+          pieces.push_back(pieces[k]);
+          pieceTags.push_back(pieceTags[k]);
+          clipCell(pieces[k], pieceTags[k], nfaces + *itr, plane, tol, table, &crossings);
+          clipCell(pieces.back(), pieceTags.back(), nfaces + *itr, flipped, tol, table, &crossings);
+        }
+      }
+
+      // Classify the pieces by the winding numbers of the boundary and holes
+      // about their centroids.
+      std::vector<unsigned> kept;
+      for (unsigned k = 0; k != pieces.size(); ++k) {
+        double centroid[3] = {0.0, 0.0, 0.0};
+        unsigned n = 0;
+        for (unsigned j = 0; j != pieces[k].size(); ++j) {
+          for (unsigned m = 0; m != pieces[k][j].size(); ++m) {
+            const IntPoint& p = table.nodes[pieces[k][j][m]];
+            centroid[0] += p.x;
+            centroid[1] += p.y;
+            centroid[2] += p.z;
+            ++n;
+          }
+        }
+        centroid[0] /= n;
+        centroid[1] /= n;
+        centroid[2] /= n;
+        bool inside = std::abs(windingNumber(geometry.facets, boundaryPoints, centroid)) > 0.5;
+        for (unsigned ihole = 0; inside and ihole != geometry.holes.size(); ++ihole) {
+          inside = std::abs(windingNumber(geometry.holes[ihole], boundaryPoints, centroid)) < 0.5;
+        }
+        if (inside) kept.push_back(k);
+      }
+      POLY_ASSERT2(not kept.empty(), "Cell " << i << " is outside the boundary");
+      const unsigned nkept = kept.size();
+
+      // Faces two kept pieces share are interior, and join the pieces.
+      std::vector<unsigned> parent(nkept);
+      for (unsigned k = 0; k != nkept; ++k) parent[k] = k;
+      std::vector<std::vector<bool> > interior(nkept);
+      std::vector<std::pair<unsigned, unsigned> > keptFaces;
+      FaceKeyMap keyOwners;
+      for (unsigned k = 0; k != nkept; ++k) {
+        const FaceLoops& piece = pieces[kept[k]];
+        interior[k].resize(piece.size(), false);
+        for (unsigned j = 0; j != piece.size(); ++j) {
+          faceKey(piece[j], key);
+          const std::pair<FaceKeyMap::iterator, bool> itr = keyOwners.insert(std::make_pair(key, unsigned(keptFaces.size())));
+          if (itr.second) {
+            keptFaces.push_back(std::make_pair(k, j));
+          } else {
+            const std::pair<unsigned, unsigned>& twin = keptFaces[itr.first->second];
+            interior[k][j] = true;
+            interior[twin.first][twin.second] = true;
+            unite(parent, k, twin.first);
+          }
+        }
+      }
+
+      // The part holding the generator is the one with the piece it's
+      // deepest inside.
+      const IntPoint& gen = qmesh.generators[i];
+      unsigned imain = 0;
+      double minDistance = std::numeric_limits<double>::max();
+      for (unsigned k = 0; k != nkept; ++k) {
+        double maxDistance = -std::numeric_limits<double>::max();
+        const FaceLoops& piece = pieces[kept[k]];
+        for (unsigned j = 0; j != piece.size(); ++j) {
+          ClipPlane plane;
+          if (facetPlane(piece[j], table.nodes, plane)) maxDistance = std::max(maxDistance, plane.distance(gen));
+        }
+        if (maxDistance < minDistance) {
+          minDistance = maxDistance;
+          imain = k;
+        }
+      }
+      const unsigned mainRoot = findRoot(parent, imain);
+
+      // Collect the faces of each part.
+      std::map<unsigned, unsigned> root2part;
+      root2part[mainRoot] = i;
+      cells[i].clear();
+      cellTags[i].clear();
+      for (unsigned k = 0; k != nkept; ++k) {
+        const unsigned root = findRoot(parent, k);
+        if (root2part.find(root) == root2part.end()) {
+          root2part[root] = cells.size();
+          cells.push_back(FaceLoops());
+          cellTags.push_back(std::vector<int>());
+          orphanOwners.push_back(i);
+        }
+        const unsigned ipart = root2part[root];
+        for (unsigned j = 0; j != pieces[kept[k]].size(); ++j) {
+          if (not interior[k][j]) {
+            cells[ipart].push_back(pieces[kept[k]][j]);
+            cellTags[ipart].push_back(pieceTags[kept[k]][j]);
+          }
+        }
+      }
+      if (nkept != pieces.size() or root2part.size() > 1) incrementCounter("cellsClipped");
+    }
+    const unsigned norphans = orphanOwners.size();
+    const unsigned nparts = ncells + norphans;
+
+    // The two cells on either side of each original face.
+    std::vector<std::pair<int, int> > faceCells(nfaces, std::make_pair(-1, -1));
+    for (unsigned i = 0; i != ncells; ++i) {
+      for (unsigned j = 0; j != qmesh.cellFaces[i].size(); ++j) {
+        const int f = qmesh.cellFaces[i][j];
+        if (f >= 0) {
+          faceCells[f].first = i;
+        } else {
+          faceCells[~f].second = i;
+        }
+      }
+    }
+
+    // Find the part across each fragment of an original face: the part of the
+    // cell on the other side with a fragment of the face holding its center.
+    // The two cells may have cut the face differently, so we can't match the
+    // fragments themselves.
+    std::unordered_map<int, std::vector<std::pair<unsigned, unsigned> > > fragments;
+    for (unsigned ipart = 0; ipart != nparts; ++ipart) {
+      for (unsigned j = 0; j != cells[ipart].size(); ++j) {
+        if (cellTags[ipart][j] < nfaces) fragments[cellTags[ipart][j]].push_back(std::make_pair(ipart, j));
+      }
+    }
+    std::vector<std::vector<int> > across(nparts);
+    for (unsigned ipart = 0; ipart != nparts; ++ipart) {
+      const int icell = (ipart < ncells ? ipart : orphanOwners[ipart - ncells]);
+      across[ipart].resize(cells[ipart].size(), -1);
+      for (unsigned j = 0; j != cells[ipart].size(); ++j) {
+        const int f = cellTags[ipart][j];
+        if (f >= nfaces) continue;
+        const int other = (faceCells[f].first == icell ? faceCells[f].second : faceCells[f].first);
+        if (other < 0) continue;
+        std::vector<std::pair<unsigned, unsigned> > candidates;
+        const std::vector<std::pair<unsigned, unsigned> >& frags = fragments[f];
+        for (unsigned k = 0; k != frags.size(); ++k) {
+          const unsigned kpart = frags[k].first;
+          if (int(kpart < ncells ? kpart : orphanOwners[kpart - ncells]) == other) candidates.push_back(frags[k]);
+        }
+        if (candidates.size() == 1) {
+          across[ipart][j] = candidates[0].first;
+        } else if (candidates.size() > 1) {
+          const std::vector<int>& loop = cells[ipart][j];
+          double normal[3], center[3] = {0.0, 0.0, 0.0};
+          newellNormal(loop, table.nodes, normal);
+          for (unsigned k = 0; k != loop.size(); ++k) {
+            for (unsigned m = 0; m != 3; ++m) center[m] += double(table.nodes[loop[k]][m])/loop.size();
+          }
+          for (unsigned k = 0; across[ipart][j] < 0 and k != candidates.size(); ++k) {
+            if (loopContains(cells[candidates[k].first][candidates[k].second], table.nodes, normal, center)) {
+              across[ipart][j] = candidates[k].first;
+            }
+          }
+        }
+      }
+    }
+
+    // Adopt the orphans.  Orphans sharing faces go together, to the cell
+    // sharing a face with them whose generator is nearest their centroid.
+    // Unlike 2D we don't re-tessellate the neighborhood: that would cut
+    // faces the neighbors share with cells beyond it.
+    std::vector<unsigned> owner(nparts);
+    for (unsigned ipart = 0; ipart != nparts; ++ipart) owner[ipart] = (ipart < ncells ? ipart : orphanOwners[ipart - ncells]);
+    if (norphans > 0) {
+      ScopedTimer orphanTimer("adoptOrphans");
+      std::vector<unsigned> parent(norphans);
+      for (unsigned k = 0; k != norphans; ++k) parent[k] = k;
+      for (unsigned k = 0; k != norphans; ++k) {
+        for (unsigned j = 0; j != across[ncells + k].size(); ++j) {
+          if (across[ncells + k][j] >= int(ncells)) unite(parent, k, across[ncells + k][j] - ncells);
+        }
+      }
+      std::map<unsigned, std::vector<unsigned> > groups;
+      for (unsigned k = 0; k != norphans; ++k) groups[findRoot(parent, k)].push_back(ncells + k);
+      incrementCounter("orphansAdopted", groups.size());
+      for (std::map<unsigned, std::vector<unsigned> >::const_iterator itr = groups.begin(); itr != groups.end(); ++itr) {
+        const std::vector<unsigned>& group = itr->second;
+
+        // The centroid of the orphans, and the cells they touch.
+        double centroid[3] = {0.0, 0.0, 0.0};
+        unsigned n = 0;
+        std::set<unsigned> neighbors;
+        for (unsigned k = 0; k != group.size(); ++k) {
+          const FaceLoops& orphan = cells[group[k]];
+          for (unsigned j = 0; j != orphan.size(); ++j) {
+            for (unsigned m = 0; m != orphan[j].size(); ++m) {
+              const IntPoint& p = table.nodes[orphan[j][m]];
+              centroid[0] += p.x;
+              centroid[1] += p.y;
+              centroid[2] += p.z;
+              ++n;
+            }
+            if (across[group[k]][j] >= 0 and across[group[k]][j] < int(ncells)) neighbors.insert(across[group[k]][j]);
+          }
+        }
+        centroid[0] /= n;
+        centroid[1] /= n;
+        centroid[2] /= n;
+
+        // An orphan touching no cell stays with the cell it came from.
+        unsigned adopter = owner[group[0]];
+        double minDistance = std::numeric_limits<double>::max();
+        for (std::set<unsigned>::const_iterator nitr = neighbors.begin(); nitr != neighbors.end(); ++nitr) {
+          const IntPoint& g = qmesh.generators[*nitr];
+          const double dx = g.x - centroid[0], dy = g.y - centroid[1], dz = g.z - centroid[2];
+          const double distance = dx*dx + dy*dy + dz*dz;
+          if (distance < minDistance) {
+            minDistance = distance;
+            adopter = *nitr;
+          }
+        }
+        for (unsigned k = 0; k != group.size(); ++k) owner[group[k]] = adopter;
+      }
+    }
+
+    // Gather each cell's parts.  Faces between parts of the same cell go, and
+    // the rest we merge by tag and the cell across them, so both cells sharing
+    // a face merge the same fragments.
+    std::vector<std::vector<int> > cellNeighbors(ncells);
+    for (unsigned ipart = 0; ipart != nparts; ++ipart) {
+      const unsigned i = owner[ipart];
+      FaceLoops loops;
+      std::vector<int> tags;
+      for (unsigned j = 0; j != cells[ipart].size(); ++j) {
+        const int other = (across[ipart][j] < 0 ? -1 : int(owner[across[ipart][j]]));
+        if (other == int(i)) continue;
+        loops.push_back(cells[ipart][j]);
+        tags.push_back(cellTags[ipart][j]);
+        cellNeighbors[i].push_back(other);
+      }
+      if (ipart == i) {
+        cells[i].swap(loops);
+        cellTags[i].swap(tags);
+      } else {
+        cells[i].insert(cells[i].end(), loops.begin(), loops.end());
+        cellTags[i].insert(cellTags[i].end(), tags.begin(), tags.end());
+      }
+    }
+    cells.resize(ncells);
+    cellTags.resize(ncells);
+    for (unsigned i = 0; i != ncells; ++i) mergeFragments(cells[i], cellTags[i], cellNeighbors[i], table.nodes);
+    removeStraightNodes(cells, table.nodes, qmesh.nodes.size(), tol);
+    splitTJunctions(cells, table.nodes, tol);
+  }
+
+  // Rebuild the mesh from the node loops.  A face is shared by two cells,
+  // traversed in opposite directions: the first cell to reach it gets it
+  // positively.
+  std::vector<int> old2new(table.nodes.size(), -1);
+  std::vector<IntPoint> newNodes;
+  std::vector<std::pair<int, int> > newEdges;
+  std::vector<std::vector<int> > newFaces;
+  std::vector<std::vector<int> > newCellFaces(ncells);
+  std::unordered_map<std::pair<int, int>, int, EdgeHash> edge2id;
+  FaceKeyMap face2id;
+  std::vector<int> key;
+  for (unsigned i = 0; i != ncells; ++i) {
+    for (unsigned j = 0; j != cells[i].size(); ++j) {
+      std::vector<int>& loop = cells[i][j];
+      const unsigned n = loop.size();
+      POLY_ASSERT(n >= 3);
+      for (unsigned k = 0; k != n; ++k) {
+        if (old2new[loop[k]] == -1) {
+          old2new[loop[k]] = newNodes.size();
+          newNodes.push_back(table.nodes[loop[k]]);
+        }
+        loop[k] = old2new[loop[k]];
+      }
+      faceKey(loop, key);
+      const std::pair<FaceKeyMap::iterator, bool> fitr = face2id.insert(std::make_pair(key, unsigned(newFaces.size())));
+      if (fitr.second) {
+        const int f = newFaces.size();
+        newFaces.push_back(std::vector<int>());
+        for (unsigned k = 0; k != n; ++k) {
+          const int j0 = loop[k], j1 = loop[(k + 1) % n];
+          const std::pair<int, int> edge = internal::hashEdge(j0, j1);
+          const std::pair<std::unordered_map<std::pair<int, int>, int, EdgeHash>::iterator, bool> eitr =
+            edge2id.insert(std::make_pair(edge, int(newEdges.size())));
+          if (eitr.second) newEdges.push_back(edge);
+          const int e = eitr.first->second;
+          newFaces[f].push_back(edge.first == j0 ? e : ~e);
+        }
+        newCellFaces[i].push_back(f);
+      } else {
+        newCellFaces[i].push_back(~int(fitr.first->second));
+      }
+    }
+  }
+  qmesh.nodes = newNodes;
+  qmesh.edges = newEdges;
+  qmesh.faces = newFaces;
+  qmesh.cellFaces = newCellFaces;
 }
 
 //------------------------------------------------------------------------------
@@ -26,4 +1344,10 @@ clipQuantizedTessellation<int, double>(QuantizedTessellation3d<int, double>& qme
                                        const std::vector<double>& PLCpoints,
                                        const PLC<3, double>& geometry,
                                        const Tessellator<3, double>& tessellator);
+template
+void
+clipQuantizedTessellation<int, float>(QuantizedTessellation3d<int, float>& qmesh,
+                                      const std::vector<float>& PLCpoints,
+                                      const PLC<3, float>& geometry,
+                                      const Tessellator<3, float>& tessellator);
 }
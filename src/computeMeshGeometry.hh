@@ -0,0 +1,241 @@
+//------------------------------------------------------------------------------
+// computeMeshGeometry
+//
+// Compute the geometry of every cell and face of a tessellation at once:
+//   cellVolumes   : the signed area (2D) or volume (3D) of each cell,
+//   cellCentroids : Dimension*ncells area/volume weighted cell centroids,
+//   faceAreas     : the length (2D) or area (3D) of each face,
+//   faceNormals   : Dimension*nfaces unit normals, pointing out of the cell
+//                   that references the face with a positive index,
+//   faceCentroids : Dimension*nfaces area weighted face centroids.
+//
+// This does the same work as calling computeCellCentroidAndSignedArea or
+// computeCellCentroidAndSignedVolume on every cell, but each face is visited
+// once and its contribution shared by the two cells on either side of it.
+// Both passes are threaded with OpenMP.
+//
+// A non-planar 3D face is treated as the fan of triangles joining its edges
+// to the average of its vertices, just as computeCellCentroidAndSignedVolume
+// does, so the two agree to roundoff.  The face area is then the magnitude of
+// the summed triangle area vectors, so area*normal is the exact integral of
+// the normal over the face.
+//------------------------------------------------------------------------------
+#ifndef __polytope_computeMeshGeometry__
+#define __polytope_computeMeshGeometry__
+
+#include <vector>
+#include <cmath>
+
+#include "Tessellation.hh"
+#include "polytope_internal.hh"
+
+namespace polytope {
+
+namespace internal {
+
+//------------------------------------------------------------------------------
+// Per face moments in 2D.  A face is the segment n0->n1; its area vector
+// (dy, -dx) points out of a counterclockwise cell.  The "center" is where the
+// cell pass measures each face from, here just the midpoint.  The 2D face
+// needs no higher moments, so extra is unused.
+//------------------------------------------------------------------------------
+template<typename RealType>
+inline
+void
+computeFaceMoments(const Tessellation<2, RealType>& mesh,
+                   const unsigned fi,
+                   RealType* center,
+                   RealType* areaVector,
+                   RealType* fcent,
+                   RealType* /*extra*/) {
+  POLY_ASSERT(mesh.faces[fi].size() == 2);
+  const RealType* p0 = &mesh.nodes[2*mesh.faces[fi][0]];
+  const RealType* p1 = &mesh.nodes[2*mesh.faces[fi][1]];
+  center[0] = 0.5*(p0[0] + p1[0]);
+  center[1] = 0.5*(p0[1] + p1[1]);
+  areaVector[0] =   p1[1] - p0[1];
+  areaVector[1] = -(p1[0] - p0[0]);
+  fcent[0] = center[0];
+  fcent[1] = center[1];
+}
+
+//------------------------------------------------------------------------------
+// Per face moments in 3D.  The face is the fan of triangles (c, p_i, p_i+1)
+// about its vertex average c.  We accumulate the vector area A = sum A_t, and
+// the matrix B = sum (q_i + q_i+1) A_t^T (stored row major in extra), with
+// q_i = p_i - c.  Together these give the volume and first moment of the
+// tets joining the face to any apex without revisiting the face nodes.
+//------------------------------------------------------------------------------
+template<typename RealType>
+inline
+void
+computeFaceMoments(const Tessellation<3, RealType>& mesh,
+                   const unsigned fi,
+                   RealType* center,
+                   RealType* areaVector,
+                   RealType* fcent,
+                   RealType* extra) {
+  const std::vector<unsigned>& faceNodes = mesh.faces[fi];
+  const unsigned nn = faceNodes.size();
+  POLY_ASSERT(nn >= 3);
+  unsigned i, j, k;
+  for (j = 0; j != 3; ++j) center[j] = 0.0;
+  for (i = 0; i != nn; ++i) {
+    const RealType* p = &mesh.nodes[3*faceNodes[i]];
+    for (j = 0; j != 3; ++j) center[j] += p[j];
+  }
+  for (j = 0; j != 3; ++j) center[j] /= nn;
+
+  RealType q0[3], q1[3], qsum[3], At[3];
+  for (j = 0; j != 3; ++j) areaVector[j] = 0.0;
+  for (k = 0; k != 9; ++k) extra[k] = 0.0;
+  const RealType* p = &mesh.nodes[3*faceNodes[nn - 1]];
+  for (j = 0; j != 3; ++j) q1[j] = p[j] - center[j];
+  for (i = 0; i != nn; ++i) {
+    p = &mesh.nodes[3*faceNodes[i]];
+    for (j = 0; j != 3; ++j) {
+      q0[j] = q1[j];
+      q1[j] = p[j] - center[j];
+      qsum[j] = q0[j] + q1[j];
+    }
+    At[0] = 0.5*(q0[1]*q1[2] - q0[2]*q1[1]);
+    At[1] = 0.5*(q0[2]*q1[0] - q0[0]*q1[2]);
+    At[2] = 0.5*(q0[0]*q1[1] - q0[1]*q1[0]);
+    for (j = 0; j != 3; ++j) {
+      areaVector[j] += At[j];
+      for (k = 0; k != 3; ++k) extra[3*j + k] += qsum[j]*At[k];
+    }
+  }
+
+  // The area weighted centroid of the fan, weighting each triangle by its
+  // area projected on the face normal so the weights sum to |A|.  Since
+  // sum (q_i + q_i+1) (A_t.A) = B A, this comes straight out of B.
+  const RealType A2 = areaVector[0]*areaVector[0] + areaVector[1]*areaVector[1] + areaVector[2]*areaVector[2];
+  for (j = 0; j != 3; ++j) {
+    fcent[j] = center[j];
+    if (A2 > 0.0) fcent[j] += (extra[3*j]*areaVector[0] +
+                               extra[3*j + 1]*areaVector[1] +
+                               extra[3*j + 2]*areaVector[2])/(3.0*A2);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Twice the area (2D) or six times the volume (3D) of the triangle/tet fan
+// joining a face to the apex, and the corresponding first moment about the
+// apex.  r is the face center less the apex, and the mesh argument only
+// picks the dimension.
+//------------------------------------------------------------------------------
+template<typename RealType>
+inline
+void
+addFaceToCell(const Tessellation<2, RealType>&,
+              const RealType* r,
+              const RealType* areaVector,
+              const RealType* /*extra*/,
+              const RealType sign,
+              RealType& vol,
+              RealType* moment) {
+  const RealType w = sign*(r[0]*areaVector[0] + r[1]*areaVector[1]);
+  vol += w;
+  moment[0] += w*r[0]*(2.0/3.0);
+  moment[1] += w*r[1]*(2.0/3.0);
+}
+
+template<typename RealType>
+inline
+void
+addFaceToCell(const Tessellation<3, RealType>&,
+              const RealType* r,
+              const RealType* areaVector,
+              const RealType* extra,
+              const RealType sign,
+              RealType& vol,
+              RealType* moment) {
+  const RealType w = sign*(r[0]*areaVector[0] + r[1]*areaVector[1] + r[2]*areaVector[2]);
+  vol += 2.0*w;
+  for (unsigned j = 0; j != 3; ++j) {
+    moment[j] += 1.5*w*r[j] + 0.5*sign*(extra[3*j]*r[0] + extra[3*j + 1]*r[1] + extra[3*j + 2]*r[2]);
+  }
+}
+
+}
+
+//------------------------------------------------------------------------------
+// Compute the geometry of all cells and faces of mesh.
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+void
+computeMeshGeometry(const Tessellation<Dimension, RealType>& mesh,
+                    std::vector<RealType>& cellVolumes,
+                    std::vector<RealType>& cellCentroids,
+                    std::vector<RealType>& faceAreas,
+                    std::vector<RealType>& faceNormals,
+                    std::vector<RealType>& faceCentroids) {
+  const int numCells = mesh.cells.size();
+  const int numFaces = mesh.faces.size();
+  const unsigned nextra = (Dimension == 2 ? 1 : 9);
+  cellVolumes.resize(numCells);
+  cellCentroids.resize(Dimension*numCells);
+  faceAreas.resize(numFaces);
+  faceNormals.resize(Dimension*numFaces);
+  faceCentroids.resize(Dimension*numFaces);
+
+  // Face pass: everything the cells need from their faces, stored face major
+  // so the cell pass just gathers it.
+  std::vector<RealType> centers(Dimension*numFaces), areaVectors(Dimension*numFaces), extra(nextra*numFaces);
+#pragma omp parallel for schedule(static)
+  for (int fi = 0; fi < numFaces; ++fi) {
+    RealType* A = &areaVectors[Dimension*fi];
+    internal::computeFaceMoments(mesh, fi, &centers[Dimension*fi], A,
+                                 &faceCentroids[Dimension*fi], &extra[nextra*fi]);
+    RealType A2 = 0.0;
+    for (unsigned j = 0; j != Dimension; ++j) A2 += A[j]*A[j];
+    const RealType area = std::sqrt(A2);
+    faceAreas[fi] = area;
+    for (unsigned j = 0; j != Dimension; ++j) faceNormals[Dimension*fi + j] = (area > 0.0 ? A[j]/area : RealType(0));
+  }
+
+  // Cell pass.  Each cell is built from the triangles/tets joining its faces
+  // to an apex at the average of its face centers.  The result is the same
+  // for any apex, but one inside the cell keeps the roundoff small.
+#pragma omp parallel for schedule(static)
+  for (int ci = 0; ci < numCells; ++ci) {
+    const std::vector<int>& cellFaces = mesh.cells[ci];
+    const unsigned nf = cellFaces.size();
+    POLY_ASSERT(nf > 0);
+    unsigned j, k;
+    RealType apex[Dimension], r[Dimension], moment[Dimension], vol = 0.0;
+    for (j = 0; j != Dimension; ++j) apex[j] = moment[j] = 0.0;
+    for (k = 0; k != nf; ++k) {
+      const RealType* c = &centers[Dimension*internal::positiveID(cellFaces[k])];
+      for (j = 0; j != Dimension; ++j) apex[j] += c[j];
+    }
+    for (j = 0; j != Dimension; ++j) apex[j] /= nf;
+    for (k = 0; k != nf; ++k) {
+      const unsigned fi = internal::positiveID(cellFaces[k]);
+      POLY_ASSERT(fi < unsigned(numFaces));
+      for (j = 0; j != Dimension; ++j) r[j] = centers[Dimension*fi + j] - apex[j];
+      internal::addFaceToCell(mesh, r, &areaVectors[Dimension*fi], &extra[nextra*fi],
+                              RealType(cellFaces[k] < 0 ? -1 : 1), vol, moment);
+    }
+    POLY_ASSERT(vol != 0.0);
+    for (j = 0; j != Dimension; ++j) cellCentroids[Dimension*ci + j] = apex[j] + moment[j]/vol;
+    cellVolumes[ci] = vol/(Dimension == 2 ? 2 : 6);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Same thing for callers who only want the cells.
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+void
+computeMeshGeometry(const Tessellation<Dimension, RealType>& mesh,
+                    std::vector<RealType>& cellVolumes,
+                    std::vector<RealType>& cellCentroids) {
+  std::vector<RealType> faceAreas, faceNormals, faceCentroids;
+  computeMeshGeometry(mesh, cellVolumes, cellCentroids, faceAreas, faceNormals, faceCentroids);
+}
+
+}
+
+#endif
@@ -1,6 +1,8 @@
 //----------------------------------------------------------------------------//
 // 2D implementation of the convex hull algorithm.
 // Based on an example at http://www.algorithmist.com/index.php/Monotone_Chain_Convex_Hull.cpp
+// The quantized points are radix sorted, so building the hull is linear in
+// the number of points.
 //----------------------------------------------------------------------------//
 #ifndef __polytope_convexHull_2d__
 #define __polytope_convexHull_2d__
@@ -8,38 +10,19 @@
 #include <iostream>
 #include <iterator>
 #include <algorithm>
-#include <set>
+#include <vector>
 #include <stdint.h>
 
 #include "PLC.hh"
 #include "polytope_internal.hh"
 #include "polytope_geometric_utilities.hh"
 #include "Point.hh"
+#include "polytope_thread_utilities.hh"
 
 namespace polytope {
 
 namespace { // We hide internal functions in an anonymous namespace.
 
-//------------------------------------------------------------------------------
-// A fuzzy comparison operator for our quantized Point2 type.
-//------------------------------------------------------------------------------
-template<typename UintType>
-struct FuzzyPoint2LessThan {
-  UintType fuzz;
-  FuzzyPoint2LessThan(const UintType ifuzz = 1): fuzz(ifuzz) {}
-  bool operator()(const Point2<UintType>& p1, const Point2<UintType>& p2) {
-    return (p1.x + fuzz < p2.x        ? true :
-            p1.x        > p2.x + fuzz ? false :
-            p1.y + fuzz < p2.y        ? true :
-            p1.y        > p2.y + fuzz ? false :
-            false);
-  }
-  bool operator()(const std::pair<Point2<UintType>, unsigned>& p1,
-                  const std::pair<Point2<UintType>, unsigned>& p2) {
-    return operator()(p1.first, p2.first);
-  }
-};
-
 //------------------------------------------------------------------------------
 // sign of the Z coordinate of cross product : (p2 - p1)x(p3 - p1).
 //------------------------------------------------------------------------------
@@ -65,6 +48,163 @@ struct ComparePairByFirstElement {
   }
 };
 
+//------------------------------------------------------------------------------
+// A quantized point: the (x, y) hash packed into a single unsigned key which
+// sorts the same as the lexicographic (x, y) ordering, plus the index of the
+// input point it came from.
+//------------------------------------------------------------------------------
+template<typename CoordHash>
+struct HullPoint {
+  uint64_t key;
+  unsigned index;
+  HullPoint(): key(0), index(0) {}
+  HullPoint(const CoordHash x, const CoordHash y, const unsigned i):
+    key((uint64_t(uint32_t(x) ^ 0x80000000U) << 32) | uint64_t(uint32_t(y) ^ 0x80000000U)),
+    index(i) {}
+  Point2<CoordHash> point() const {
+    return Point2<CoordHash>(CoordHash(int32_t(uint32_t(key >> 32) ^ 0x80000000U)),
+                             CoordHash(int32_t(uint32_t(key & 0xFFFFFFFFU) ^ 0x80000000U)));
+  }
+  bool operator<(const HullPoint& rhs) const {
+    return key < rhs.key or (key == rhs.key and index < rhs.index);
+  }
+};
+
+//------------------------------------------------------------------------------
+// Stable LSD radix sort of HullPoints by key, 16 bits per pass.  Passes where
+// every key has the same digit are skipped, which is the common case for the
+// high bits of each coordinate.  Small sets aren't worth clearing the digit
+// counts for, so they go to std::sort; the points come in index order, so
+// ordering ties by index gives the same result.
+//------------------------------------------------------------------------------
+template<typename CoordHash>
+void
+radixSortHullPoints(std::vector<HullPoint<CoordHash> >& points) {
+  const unsigned n = points.size();
+  if (n < 256) {
+    std::sort(points.begin(), points.end());
+    return;
+  }
+  std::vector<HullPoint<CoordHash> > buffer(n);
+  std::vector<unsigned> counts(65536);
+  for (unsigned shift = 0; shift != 64; shift += 16) {
+    std::fill(counts.begin(), counts.end(), 0U);
+    for (unsigned i = 0; i != n; ++i) ++counts[(points[i].key >> shift) & 0xFFFFU];
+    if (n == 0 or counts[(points[0].key >> shift) & 0xFFFFU] == n) continue;
+    unsigned sum = 0;
+    for (unsigned d = 0; d != 65536; ++d) {
+      const unsigned c = counts[d];
+      counts[d] = sum;
+      sum += c;
+    }
+    for (unsigned i = 0; i != n; ++i) buffer[counts[(points[i].key >> shift) & 0xFFFFU]++] = points[i];
+    points.swap(buffer);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Sort the quantized points and reduce them to a unique set.  Points whose
+// hashes are within one of a point already accepted (in input index order) in
+// both x and y are treated as duplicates; the lowest input index wins.
+//------------------------------------------------------------------------------
+template<typename CoordHash>
+void
+sortUniqueHullPoints(std::vector<HullPoint<CoordHash> >& points,
+                     const bool radix) {
+  if (radix) {
+    radixSortHullPoints(points);     // Stable, so the lowest index leads each run.
+  } else {
+    std::sort(points.begin(), points.end());
+  }
+
+  // Exact duplicates first.
+  unsigned j = 0;
+  for (unsigned i = 0; i != points.size(); ++i) {
+    if (j == 0 or points[i].key != points[j - 1].key) points[j++] = points[i];
+  }
+  points.resize(j);
+  const unsigned nunique = points.size();
+  if (nunique < 2) return;
+
+  // Now accept points in input order, rejecting any that fall within one of
+  // a point already accepted.  The neighbors in the same column are adjacent
+  // in the sorted order.  For the neighboring columns we record where the
+  // candidates start, walking each pair of adjacent columns together.
+  std::vector<Point2<CoordHash> > ps(nunique);
+  unsigned maxIndex = 0;
+  for (unsigned i = 0; i != nunique; ++i) {
+    ps[i] = points[i].point();
+    maxIndex = std::max(maxIndex, points[i].index);
+  }
+  std::vector<unsigned> prevStart(nunique, nunique), nextStart(nunique, nunique);
+  unsigned c0 = 0, p0 = 0, p1 = 0, i, q;
+  while (c0 != nunique) {
+    unsigned c1 = c0 + 1;
+    while (c1 != nunique and ps[c1].x == ps[c0].x) ++c1;
+    if (p1 > p0 and long(ps[p0].x) + 1 == long(ps[c0].x)) {
+      for (i = c0, q = p0; i != c1; ++i) {
+        while (q != p1 and long(ps[q].y) + 1 < long(ps[i].y)) ++q;
+        prevStart[i] = q;
+      }
+      for (i = p0, q = c0; i != p1; ++i) {
+        while (q != c1 and long(ps[q].y) + 1 < long(ps[i].y)) ++q;
+        nextStart[i] = q;
+      }
+    }
+    p0 = c0;
+    p1 = c1;
+    c0 = c1;
+  }
+  std::vector<unsigned> byIndex(maxIndex + 1, nunique);
+  for (i = 0; i != nunique; ++i) byIndex[points[i].index] = i;
+  std::vector<char> accepted(nunique, 0);
+  for (unsigned m = 0; m != byIndex.size(); ++m) {
+    i = byIndex[m];
+    if (i == nunique) continue;
+    bool near = ((i > 0 and accepted[i - 1] and ps[i - 1].x == ps[i].x and long(ps[i - 1].y) + 1 == long(ps[i].y)) or
+                 (i + 1 < nunique and accepted[i + 1] and ps[i + 1].x == ps[i].x and long(ps[i].y) + 1 == long(ps[i + 1].y)));
+    for (q = prevStart[i]; not near and q < nunique and long(ps[q].x) + 1 == long(ps[i].x) and long(ps[q].y) <= long(ps[i].y) + 1; ++q) near = accepted[q];
+    for (q = nextStart[i]; not near and q < nunique and long(ps[q].x) == long(ps[i].x) + 1 and long(ps[q].y) <= long(ps[i].y) + 1; ++q) near = accepted[q];
+    accepted[i] = not near;
+  }
+  j = 0;
+  for (i = 0; i != nunique; ++i) {
+    if (accepted[i]) points[j++] = points[i];
+  }
+  points.resize(j);
+}
+
+//------------------------------------------------------------------------------
+// Andrew's monotone chain over sorted, unique points.  Returns the positions
+// (in points) of the hull vertices counterclockwise, with the first repeated
+// at the end.
+//------------------------------------------------------------------------------
+template<typename CoordHash>
+std::vector<int>
+monotoneChain(const std::vector<HullPoint<CoordHash> >& points) {
+  const int nunique = points.size();
+  std::vector<Point2<CoordHash> > ps(nunique);
+  for (int i = 0; i != nunique; ++i) ps[i] = points[i].point();
+  std::vector<int> result(2*nunique);
+  int i, k, t;
+
+  // Build the lower hull.
+  for (i = 0, k = 0; i < nunique; i++) {
+    while (k >= 2 and
+           zcross_sign(ps[result[k - 2]], ps[result[k - 1]], ps[i]) <= 0) k--;
+    result[k++] = i;
+  }
+
+  // Build the upper hull.
+  for (i = nunique - 2, t = k + 1; i >= 0; i--) {
+    while (k >= t and
+           zcross_sign(ps[result[k - 2]], ps[result[k - 1]], ps[i]) <= 0) k--;
+    result[k++] = i;
+  }
+  result.resize(k);
+  return result;
+}
+
 } // end anonymous namespace
 
 //------------------------------------------------------------------------------
@@ -84,7 +224,6 @@ convexHull_2d(const std::vector<RealType>& points,
               const RealType* low,
               const RealType& dx) {
   typedef KeyTraits::Key CoordHash;
-  typedef Point2<CoordHash> PointHash;
   // typedef polytope::DimensionTraits<2, RealType>::CoordHash CoordHash;
   // typedef polytope::DimensionTraits<2, RealType>::IntPoint PointHash;
 
@@ -92,7 +231,7 @@ convexHull_2d(const std::vector<RealType>& points,
   POLY_ASSERT(points.size() % 2 == 0);
   const unsigned n = points.size() / 2;
   PLC<2, RealType> plc;
-  int i, j, k, t;
+  int i, j, k;
   
   // If there's only one or two points, we're done: that's the whole hull
   if (n == 1 or n == 2) {
@@ -128,62 +267,69 @@ convexHull_2d(const std::vector<RealType>& points,
     ++i;
   }
   
-  // Hash the input points and sort them by x coordinate, remembering their original indices
-  // in the input set.  We also ensure that only unique (using a fuzzy comparison) points
-  // are inserted here, since duplicates mess up the hull calculation.
+  // Hash the input points, remembering their original indices in the input
+  // set, and sort them lexicographically.  We also ensure that only one point
+  // per hash position is kept, since duplicates mess up the hull calculation.
+  // Large inputs are split between threads: each builds the hull of its share,
+  // and the final hull is built from the union of those hull vertices.
+  typedef HullPoint<CoordHash> HullPointType;
   const RealType& xmin = low[0];
   const RealType& ymin = low[1];
-  std::set<std::pair<PointHash, unsigned>, FuzzyPoint2LessThan<CoordHash> > uniquePoints;
-  for (i = 0; i != n; ++i) {
-    uniquePoints.insert(std::make_pair(PointHash(CoordHash((points[2*i]     - xmin)/dx + 0.5),
-                                                 CoordHash((points[2*i + 1] - ymin)/dx + 0.5)),
-                                       i));
+  std::vector<HullPointType> sortedPoints;
+  const int nthreads = (n >= 65536 ? internal::maxThreads() : 1);
+  if (nthreads == 1) {
+    sortedPoints.resize(n);
+    for (i = 0; i != n; ++i) {
+      sortedPoints[i] = HullPointType(CoordHash((points[2*i]     - xmin)/dx + 0.5),
+                                      CoordHash((points[2*i + 1] - ymin)/dx + 0.5),
+                                      i);
+    }
+    sortUniqueHullPoints(sortedPoints, true);
+  } else {
+    std::vector<std::vector<HullPointType> > threadHulls(nthreads);
+#pragma omp parallel num_threads(nthreads)
+    {
+      const int ithread = internal::threadIndex(), nt = internal::numThreads();
+      const int i0 = (long(n)*ithread)/nt, i1 = (long(n)*(ithread + 1))/nt;
+      std::vector<HullPointType> local(i1 - i0);
+      for (int ii = i0; ii < i1; ++ii) {
+        local[ii - i0] = HullPointType(CoordHash((points[2*ii]     - xmin)/dx + 0.5),
+                                       CoordHash((points[2*ii + 1] - ymin)/dx + 0.5),
+                                       ii);
+      }
+      sortUniqueHullPoints(local, true);
+      if (local.size() < 3) {
+        threadHulls[ithread].swap(local);
+      } else {
+        // Every vertex of the full hull is a vertex of the hull of its share.
+        const std::vector<int> chain = monotoneChain(local);
+        for (unsigned m = 0; m + 1 < chain.size(); ++m) threadHulls[ithread].push_back(local[chain[m]]);
+      }
+    }
+    for (int ithread = 0; ithread != nthreads; ++ithread) {
+      std::copy(threadHulls[ithread].begin(), threadHulls[ithread].end(), std::back_inserter(sortedPoints));
+    }
+    sortUniqueHullPoints(sortedPoints, false);
   }
-  std::vector<std::pair<PointHash, unsigned> > sortedPoints(uniquePoints.begin(), uniquePoints.end());
-  std::sort(sortedPoints.begin(), sortedPoints.end());
 
   // If the points are collinear, we can save a lot of work
   if (collinear) {
     plc.facets.resize(1, std::vector<int>(2));
-    plc.facets[0][0] = sortedPoints.front().second;
-    plc.facets[0][1] = sortedPoints.back().second;
+    plc.facets[0][0] = sortedPoints.front().index;
+    plc.facets[0][1] = sortedPoints.back().index;
   }
   else {
-    // Prepare the result.
-    const unsigned nunique = sortedPoints.size();
-    std::vector<int> result(2*nunique);
-    
-    // Build the lower hull.
-    for (i = 0, k = 0; i < nunique; i++) {
-      while (k >= 2 and
-             zcross_sign(sortedPoints[result[k - 2]].first, sortedPoints[result[k - 1]].first, sortedPoints[i].first) <= 0) k--;
-      result[k++] = i;
-    }
-    
-    // Build the upper hull.
-    for (i = nunique - 2, t = k + 1; i >= 0; i--) {
-      while (k >= t and
-             zcross_sign(sortedPoints[result[k - 2]].first, sortedPoints[result[k - 1]].first, sortedPoints[i].first) <= 0) k--;
-      result[k++] = i;
-    }
-    // if (!(k >= 4)) {
-    //   std::cerr << "Blago!  " << n << " " << nunique << " " << k << std::endl;
-    //   std::cerr << "Unique:" << std::endl;
-    //   for (unsigned i = 0; i != nunique; ++i) std::cerr << "  --> " << sortedPoints[i].first << std::endl;
-    //   std::cerr << "Input:" << std::endl;
-    //   for (unsigned i = 0; i != n; ++i) std::cerr << "  --> " << points[2*i] << " " << points[2*i+1] << std::endl;
-    // }
+    const std::vector<int> result = monotoneChain(sortedPoints);
+    k = result.size();
     POLY_ASSERT(k >= 4);
     POLY_ASSERT(result.front() == result.back());
     
     // Translate our sorted information to a PLC based on the input point ordering and we're done.
+    plc.facets.resize(k - 1, std::vector<int>(2));
     for (i = 0; i != k - 1; ++i) {
-      j = (i + 1) % k;
-      plc.facets.push_back(std::vector<int>());
-      plc.facets.back().push_back(sortedPoints[result[i]].second);
-      plc.facets.back().push_back(sortedPoints[result[j]].second);
+      plc.facets[i][0] = sortedPoints[result[i]].index;
+      plc.facets[i][1] = sortedPoints[result[i + 1]].index;
     }
-    POLY_ASSERT(plc.facets.size() == k - 1);
   }
   return plc;
 }
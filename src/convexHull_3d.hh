@@ -1,7 +1,9 @@
 //----------------------------------------------------------------------------//
 // 3D implementation of the convex hull algorithm.
-// My own (possibly loose) interpretation of the incremental hull algorithm
-// in 3D (JMO).
+// Quickhull (Barber, Dobkin, & Huhdanpaa 1996): each facet of the growing hull
+// keeps a conflict list of the points outside it, so adding a point only
+// touches the facets it can see and the points they owned.  Orientation
+// tests use the exact predicates in predicates.cc.
 //----------------------------------------------------------------------------//
 #ifndef __polytope_convexHull_3d__
 #define __polytope_convexHull_3d__
@@ -17,6 +19,12 @@
 #include "polytope_geometric_utilities.hh"
 #include "Point.hh"
 
+// Shewchuk's adaptive exact predicates (predicates.cc).
+// orient3d(a, b, c, d) is negative when d lies above the plane of (a, b, c),
+// with (a, b, c) counterclockwise viewed from above.
+extern double exactinit();
+extern double orient3d(double* pa, double* pb, double* pc, double* pd);
+
 namespace polytope {
 
 namespace {
@@ -101,180 +109,221 @@ struct CompareAbsPlaneDistance {
   }
 };
 
-// //------------------------------------------------------------------------------
-// // Borrow the Point3 type as a tuple to create 3 node facets hashes.
-// //------------------------------------------------------------------------------
-// Point3<unsigned>
-// hashFacet(const unsigned i, const unsigned j, const unsigned k) {
-//   typedef Point3<unsigned> Tuple3;
-//   POLY_ASSERT(i != j and i != k and j != k);
-//   if (i < j and i < k) {
-//     if (j < k) {
-//       return Tuple3(i, j, k);
-//     } else {
-//       return Tuple3(i, k, j);
-//     }
-//   } else if (j < i and j < k) {
-//     if (i < k) {
-//       return Tuple3(j, i, k);
-//     } else {
-//       return Tuple3(j, k, i);
-//     }
-//   } else {
-//     if (i < j) {
-//       return Tuple3(k, i, j);
-//     } else {
-//       return Tuple3(k, j, i);
-//     }
-//   }
-// }
-
 //------------------------------------------------------------------------------
-// Hold one of our triangular facets.
+// Hold one of our triangular facets.  The vertices (inode, jnode, knode) are
+// counterclockwise viewed from outside the hull, and neighbors[0,1,2] are the
+// facets across the edges (inode, jnode), (jnode, knode), and (knode, inode).
+// The conflict list holds the points outside this facet which have not yet
+// been added to the hull, and furthest is the one highest above it.
 //------------------------------------------------------------------------------
-template<typename RealType>
-struct TriangleFacet {
-  typedef Point3<RealType> PointType;
-  typedef Point3<unsigned> HashType;
-
-  unsigned inode, jnode, knode;          // Indices of the vertices of the triangle.
-  PointType normal;                      // Normal to the surface.
-
-  TriangleFacet(): inode(0), jnode(0), knode(0), normal() {}
-  TriangleFacet(const unsigned i, 
-                const unsigned j,
-                const unsigned k,
-                const std::vector<PointType>& points): inode(i), 
-                                                       jnode(j),
-                                                       knode(k),
-                                                       normal() {
-    this->computeNormal(points);
+struct QuickhullFacet {
+  unsigned inode, jnode, knode;
+  int neighbors[3];
+  std::vector<unsigned> outside;
+  int furthest;
+  double height;
+  bool alive;
+
+  QuickhullFacet(): inode(0), jnode(0), knode(0), outside(), furthest(-1), height(0.0), alive(false) {
+    neighbors[0] = neighbors[1] = neighbors[2] = -1;
   }
-
-  void computeNormal(const std::vector<PointType>& points) {
-    const PointType ij = points[jnode] - points[inode];
-    const PointType ik = points[knode] - points[inode];
-    geometry::cross<3, RealType>(&ij.x, &ik.x, &normal.x);
-    geometry::unitVector<3, RealType>(&normal.x);
+  QuickhullFacet(const unsigned i, const unsigned j, const unsigned k):
+    inode(i), jnode(j), knode(k), outside(), furthest(-1), height(0.0), alive(true) {
+    neighbors[0] = neighbors[1] = neighbors[2] = -1;
   }
 
-  int compare(const PointType& point, 
-              const std::vector<PointType>& points) const { 
-    const PointType ip = point - points[inode];
-    const RealType test = geometry::dot<3, RealType>(&ip.x, &normal.x);
-    return (std::abs(test) < 1.0e-8 ? 0 :
-            test < 0 ? -1 :
-            1);
+  // The start and end vertices of edge e.
+  unsigned edgeStart(const unsigned e) const { return e == 0 ? inode : e == 1 ? jnode : knode; }
+  unsigned edgeEnd(const unsigned e) const { return e == 0 ? jnode : e == 1 ? knode : inode; }
+
+  // Exact test for the given point: positive if above (visible), zero if coplanar.
+  double altitude(const std::vector<double>& coords, const unsigned ip) const {
+    return -orient3d(const_cast<double*>(&coords[3*inode]),
+                     const_cast<double*>(&coords[3*jnode]),
+                     const_cast<double*>(&coords[3*knode]),
+                     const_cast<double*>(&coords[3*ip]));
   }
 
-  void flip() { std::swap(inode, jnode); normal *= -1; }
-  // bool operator==(const TriangleFacet& rhs) const { return hashFacet(inode, jnode, knode) == hashFacet(rhs.inode, rhs.jnode, rhs.knode); }
-  // bool operator<(const TriangleFacet& rhs) const { return hashFacet(inode, jnode, knode) < hashFacet(rhs.inode, rhs.jnode, rhs.knode); }
+  // Add a point to the conflict list if it is above this facet.
+  bool claim(const std::vector<double>& coords, const unsigned ip) {
+    const double h = this->altitude(coords, ip);
+    if (h <= 0.0) return false;
+    outside.push_back(ip);
+    if (h > height) {
+      height = h;
+      furthest = ip;
+    }
+    return true;
+  }
 
   // output operator
-  friend std::ostream& operator<<(std::ostream& os, const TriangleFacet& facet) {
-    os << "TriangleFacet(" << facet.inode << " " << facet.jnode << " " << facet.knode 
-       << "), normal = " << facet.normal;
+  friend std::ostream& operator<<(std::ostream& os, const QuickhullFacet& facet) {
+    os << "QuickhullFacet(" << facet.inode << " " << facet.jnode << " " << facet.knode
+       << "), neighbors = (" << facet.neighbors[0] << " " << facet.neighbors[1] << " " << facet.neighbors[2]
+       << "), " << facet.outside.size() << " outside points";
     return os;
   }
 };
 
 //------------------------------------------------------------------------------
-// Reduce the given set of point indices to those exterior to the facets.
+// Find which edge of a facet runs from a to b, or -1 if none does.
 //------------------------------------------------------------------------------
-template<typename RealType>
-void 
-exteriorPoints(std::vector<unsigned>& indices,
-               const std::vector<TriangleFacet<RealType> >& facets, 
-               const std::vector<Point3<RealType> >& points) {
-  typedef std::vector<TriangleFacet<RealType> > FacetSet;
-
-  std::vector<unsigned> remainingPoints;
-  for (std::vector<unsigned>::const_iterator iitr = indices.begin();
-       iitr != indices.end();
-       ++iitr) {
-    typename FacetSet::const_iterator fitr = facets.begin();
-    while (fitr != facets.end() and fitr->compare(points[*iitr], points) != 1) ++fitr;
-    if (fitr != facets.end()) remainingPoints.push_back(*iitr);
+inline
+int
+findEdge(const QuickhullFacet& facet, const unsigned a, const unsigned b) {
+  for (unsigned e = 0; e != 3; ++e) {
+    if (facet.edgeStart(e) == a and facet.edgeEnd(e) == b) return e;
   }
-  indices = remainingPoints;
+  return -1;
 }
 
 //------------------------------------------------------------------------------
-// Reduce the given set of point indices to those exterior to the facets.
+// Quickhull with conflict lists.  Builds the triangulated hull of the given
+// (3*n) coordinates starting from the tetrahedron (i, j, k, apex),
+// with (i, j, k) oriented so apex is below it.  Returns the triangles
+// counterclockwise viewed from outside.
 //------------------------------------------------------------------------------
-template<typename RealType>
-unsigned highestPoint(std::vector<unsigned>& indices,
-                      const std::vector<TriangleFacet<RealType> >& facets, 
-                      const std::vector<Point3<RealType> >& points) {
-  typedef std::vector<TriangleFacet<RealType> > FacetSet;
-  int result = -1;
-  RealType maxAltitude = 0.0;
-  for (typename std::vector<unsigned>::const_iterator itr = indices.begin();
-       itr != indices.end();
-       ++itr) {
-    for (typename FacetSet::const_iterator fitr = facets.begin();
-         fitr != facets.end();
-         ++fitr) {
-      const RealType altitude = pointPlaneDistance(points[*itr], points[fitr->inode], fitr->normal);
-      if (altitude > maxAltitude) {
-        maxAltitude = altitude;
-        result = *itr;
+inline
+std::vector<QuickhullFacet>
+quickhull(const std::vector<double>& coords,
+          const unsigned i,
+          const unsigned j,
+          const unsigned k,
+          const unsigned apex) {
+  typedef std::vector<QuickhullFacet> FacetSet;
+  static const double eps = exactinit();
+  POLY_CONTRACT_VAR(eps);
+
+  const unsigned n = coords.size()/3;
+  POLY_ASSERT(QuickhullFacet(i, j, k).altitude(coords, apex) < 0.0);
+
+  // The starting tetrahedron, and its adjacency.
+  FacetSet facets;
+  facets.push_back(QuickhullFacet(i, j, k));
+  facets.push_back(QuickhullFacet(j, i, apex));
+  facets.push_back(QuickhullFacet(i, k, apex));
+  facets.push_back(QuickhullFacet(k, j, apex));
+  for (unsigned f = 0; f != 4; ++f) {
+    for (unsigned e = 0; e != 3; ++e) {
+      for (unsigned g = 0; g != 4; ++g) {
+        if (g != f and findEdge(facets[g], facets[f].edgeEnd(e), facets[f].edgeStart(e)) >= 0) facets[f].neighbors[e] = g;
       }
+      POLY_ASSERT(facets[f].neighbors[e] >= 0);
     }
   }
-  POLY_ASSERT(result >= 0);
-  return unsigned(result);
-}
-
-//------------------------------------------------------------------------------
-// Cull out the facets visible from the given point (points[apex]).
-// Also computes the remaining horizon edges.
-//------------------------------------------------------------------------------
-template<typename RealType>
-void cullVisibleFacets(std::vector<std::pair<int, int> >& horizonEdges,
-                       std::vector<TriangleFacet<RealType> >& facets, 
-                       const std::vector<Point3<RealType> >& points,
-                       const unsigned apex) {
-
-  typedef std::pair<int, int> EdgeHash;
-  typedef std::vector<TriangleFacet<RealType> > FacetSet;
-
-  FacetSet newFacets;
-  internal::CounterMap<EdgeHash> edgeCount;
-
-  // Walk the facets.
-  for (typename FacetSet::const_iterator fitr = facets.begin();
-       fitr != facets.end();
-       ++fitr) {
-
-    // Is this facet visible from the apex point?
-    if (fitr->compare(points[apex], points) == 1) {
 
-      // Yep, it needs to be removed.  Increment the use count for each
-      // of it's edges.
-      ++edgeCount[internal::hashEdge(fitr->inode, fitr->jnode)];
-      ++edgeCount[internal::hashEdge(fitr->jnode, fitr->knode)];
-      ++edgeCount[internal::hashEdge(fitr->knode, fitr->inode)];
-
-    } else {
+  // Hand each point to the first facet it is outside of.
+  for (unsigned ip = 0; ip != n; ++ip) {
+    if (ip != i and ip != j and ip != k and ip != apex) {
+      unsigned f = 0;
+      while (f != 4 and not facets[f].claim(coords, ip)) ++f;
+    }
+  }
+  std::vector<unsigned> pending;
+  for (unsigned f = 0; f != 4; ++f) {
+    if (not facets[f].outside.empty()) pending.push_back(f);
+  }
 
-      // Nope, copy it to the new set.
-      newFacets.push_back(*fitr);
+  // Work arrays, reused from pass to pass.
+  std::vector<unsigned> visible, freeFacets, newFacets, orphans;
+  std::vector<std::pair<unsigned, unsigned> > horizon;   // (visible facet, edge)
+  std::vector<int> visited(facets.size(), -1), coneFacet(n, -1);
+  int pass = 0;
+
+  // Keep adding the furthest point of some facet until no conflicts remain.
+  while (not pending.empty()) {
+    const unsigned f0 = pending.back();
+    pending.pop_back();
+    if (not facets[f0].alive or facets[f0].outside.empty()) continue;
+    const unsigned ip = facets[f0].furthest;
+
+    // Walk out from f0 to find the facets visible from the new point, and the
+    // horizon edges between them and the rest of the hull.
+    ++pass;
+    visible.clear();
+    horizon.clear();
+    visible.push_back(f0);
+    visited[f0] = pass;
+    for (unsigned v = 0; v != visible.size(); ++v) {
+      const unsigned f = visible[v];
+      for (unsigned e = 0; e != 3; ++e) {
+        const unsigned g = facets[f].neighbors[e];
+        if (visited[g] == pass) continue;
+        if (facets[g].altitude(coords, ip) > 0.0) {
+          visited[g] = pass;
+          visible.push_back(g);
+        } else {
+          horizon.push_back(std::make_pair(f, e));
+        }
+      }
+    }
+    POLY_ASSERT(horizon.size() >= 3);
+
+    // Gather up the points left homeless by the visible facets.
+    orphans.clear();
+    for (unsigned v = 0; v != visible.size(); ++v) {
+      QuickhullFacet& facet = facets[visible[v]];
+      for (unsigned m = 0; m != facet.outside.size(); ++m) {
+        if (facet.outside[m] != ip) orphans.push_back(facet.outside[m]);
+      }
+      std::vector<unsigned>().swap(facet.outside);
+      facet.alive = false;
+    }
 
+    // Build the cone of new facets from the horizon to the new point.  Each
+    // new facet (a, b, ip) takes over the horizon edge from a to b, and
+    // neighbors the new facet starting at b and the one ending at a.
+    newFacets.clear();
+    for (unsigned h = 0; h != horizon.size(); ++h) {
+      const QuickhullFacet& old = facets[horizon[h].first];
+      const unsigned e = horizon[h].second;
+      const unsigned a = old.edgeStart(e), b = old.edgeEnd(e);
+      const unsigned g = old.neighbors[e];
+      unsigned f;
+      if (freeFacets.empty()) {
+        f = facets.size();
+        facets.push_back(QuickhullFacet(a, b, ip));
+        visited.push_back(-1);
+      } else {
+        f = freeFacets.back();
+        freeFacets.pop_back();
+        facets[f] = QuickhullFacet(a, b, ip);
+      }
+      facets[f].neighbors[0] = g;
+      const int eg = findEdge(facets[g], b, a);
+      POLY_ASSERT(eg >= 0);
+      facets[g].neighbors[eg] = f;
+      newFacets.push_back(f);
+    }
+    for (unsigned h = 0; h != newFacets.size(); ++h) coneFacet[facets[newFacets[h]].inode] = newFacets[h];
+    for (unsigned h = 0; h != newFacets.size(); ++h) {
+      QuickhullFacet& facet = facets[newFacets[h]];
+      const int next = coneFacet[facet.jnode];
+      POLY_ASSERT(next >= 0 and facets[next].inode == facet.jnode);
+      facet.neighbors[1] = next;
+      facets[next].neighbors[2] = newFacets[h];
+    }
+    for (unsigned h = 0; h != newFacets.size(); ++h) coneFacet[facets[newFacets[h]].inode] = -1;
+    for (unsigned v = 0; v != visible.size(); ++v) freeFacets.push_back(visible[v]);
+
+    // Points which are outside one of the new facets go in its conflict list,
+    // and the rest are now inside the hull.
+    for (unsigned m = 0; m != orphans.size(); ++m) {
+      unsigned h = 0;
+      while (h != newFacets.size() and not facets[newFacets[h]].claim(coords, orphans[m])) ++h;
+    }
+    for (unsigned h = 0; h != newFacets.size(); ++h) {
+      if (not facets[newFacets[h]].outside.empty()) pending.push_back(newFacets[h]);
     }
   }
-  facets = newFacets;
-
-  // The horizon edges are the ones with a single use count.  All others should
-  // have been hit twice.
-  horizonEdges = std::vector<EdgeHash>();
-  for (internal::CounterMap<EdgeHash>::const_iterator eitr = edgeCount.begin();
-       eitr != edgeCount.end();
-       ++eitr) {
-    POLY_ASSERT(eitr->second == 1 or eitr->second == 2);
-    if (eitr->second == 1) horizonEdges.push_back(eitr->first);
+
+  // Return the surviving facets.
+  FacetSet result;
+  for (unsigned f = 0; f != facets.size(); ++f) {
+    if (facets[f].alive) result.push_back(facets[f]);
   }
+  POLY_ASSERT(result.size() >= 4);
+  return result;
 }
 
 } // anonymous namespace
@@ -289,8 +338,6 @@ convexHull_3d(const std::vector<RealType>& points,
               const RealType& dx) {
 
   typedef Point3<RealType> PointType;
-  typedef std::vector<TriangleFacet<RealType> > FacetSet;
-  typedef std::pair<int, int> EdgeHash;
 
   // Pre-conditions.
   POLY_ASSERT(points.size() % 3 == 0);
@@ -330,103 +377,60 @@ convexHull_3d(const std::vector<RealType>& points,
                  boxy2 = geometry::dot<3, RealType>(&boxy.x, &boxy.x),
                  boxz2 = geometry::dot<3, RealType>(&boxz.x, &boxz.x);
   POLY_ASSERT(boxx2 > 0.0 and boxy2 > 0.0 and boxz2 > 0.0);
-  TriangleFacet<RealType> startingFacet;
+  unsigned inode, jnode;
   if (boxx2 >= std::max(boxy2, boxz2)) {
-    startingFacet.inode = ixmin;
-    startingFacet.jnode = ixmax;
+    inode = ixmin;
+    jnode = ixmax;
   } else if (boxy2 >= boxz2) {
-    startingFacet.inode = iymin;
-    startingFacet.jnode = iymax;
+    inode = iymin;
+    jnode = iymax;
   } else {
     POLY_ASSERT(boxz2 >= std::max(boxx2, boxy2));
-    startingFacet.inode = izmin;
-    startingFacet.jnode = izmax;
+    inode = izmin;
+    jnode = izmax;
   }
 
   // Select a third point as the most distant from the line defined by the two we just picked.
   // This one should also be on the hull.
-  PointType lineDirection = ps[startingFacet.jnode] - ps[startingFacet.inode];
+  PointType lineDirection = ps[jnode] - ps[inode];
   geometry::unitVector<3, RealType>(&lineDirection.x);
-  startingFacet.knode = std::max_element(ps.begin(), ps.end(), CompareLineDistance<RealType>(ps[startingFacet.inode], lineDirection))->index;
-  startingFacet.computeNormal(ps);
+  const unsigned knode = std::max_element(ps.begin(), ps.end(), CompareLineDistance<RealType>(ps[inode], lineDirection))->index;
 
   // We have the triangular base, so pick the furthest point from this base as the apex of our
   // starting tetrahedron.  This point should also be on the hull.
-  const unsigned apex = std::max_element(ps.begin(), ps.end(), CompareAbsPlaneDistance<RealType>(ps[startingFacet.inode], startingFacet.normal))->index;
-
-  // If the apex point is below our starting facet, flip the facet.
-  if (startingFacet.compare(ps[apex], ps) == 1) startingFacet.flip();
-
-  // Intialize our starting tetrahedron.
-  FacetSet workingFacets;
-  workingFacets.push_back(startingFacet);
-  workingFacets.push_back(TriangleFacet<RealType>(startingFacet.jnode, startingFacet.inode, apex, ps));
-  workingFacets.push_back(TriangleFacet<RealType>(startingFacet.inode, startingFacet.knode, apex ,ps));
-  workingFacets.push_back(TriangleFacet<RealType>(startingFacet.knode, startingFacet.jnode, apex, ps));
-  // std::cerr << "Starting facets: " << std::endl
-  //           << "    " << workingFacets[0] << std::endl
-  //           << "    " << workingFacets[1] << std::endl
-  //           << "    " << workingFacets[2] << std::endl
-  //           << "    " << workingFacets[3] << std::endl;
-
-  // Find the set of points exterior to our starting tetrahedron.
-  std::vector<unsigned> remainingPoints(ps.size());
-  for (unsigned i = 0; i != ps.size(); ++i) remainingPoints[i] = i;
-  exteriorPoints(remainingPoints, workingFacets, ps);
-
-  // Iterate until all points are interior to the facets.
-  while (!remainingPoints.empty()) {
-
-    // Find the remaining point furthest from the hull.
-    const unsigned apex = highestPoint(remainingPoints, workingFacets, ps);
-
-    // Remove the visible facets from apex, and compute the horizon edges.
-    std::vector<EdgeHash> horizonEdges;
-    cullVisibleFacets(horizonEdges, workingFacets, ps, apex);
-    POLY_ASSERT(horizonEdges.size() >= 3);
-
-    // Build the new facets from the apex point and horizon edges.
-    // const PointType testPoint = (ps[workingFacets[0].inode] + ps[workingFacets[0].jnode] + ps[workingFacets[0].knode])/3.0;
-    PointType testPoint;
-    for (typename std::vector<EdgeHash>::const_iterator eitr = horizonEdges.begin();
-         eitr != horizonEdges.end();
-         ++eitr) {
-      testPoint += ps[eitr->first];
-      testPoint += ps[eitr->second];
-    }
-    testPoint /= 2*horizonEdges.size();
-    for (typename std::vector<EdgeHash>::const_iterator eitr = horizonEdges.begin();
-         eitr != horizonEdges.end();
-         ++eitr) {
-      workingFacets.push_back(TriangleFacet<RealType>(eitr->first, eitr->second, apex, ps));
-      if (workingFacets.back().compare(testPoint, ps) == 1) workingFacets.back().flip();
-    }
+  PointType normal;
+  {
+    const PointType ij = ps[jnode] - ps[inode];
+    const PointType ik = ps[knode] - ps[inode];
+    geometry::cross<3, RealType>(&ij.x, &ik.x, &normal.x);
+    geometry::unitVector<3, RealType>(&normal.x);
+  }
+  const unsigned apex = std::max_element(ps.begin(), ps.end(), CompareAbsPlaneDistance<RealType>(ps[inode], normal))->index;
+
+  // The exact predicates work on doubles.
+  std::vector<double> coords(upoints.begin(), upoints.end());
+
+  // If the apex point is above our starting facet, flip the facet.
+  const double baseTest = orient3d(&coords[3*inode], &coords[3*jnode], &coords[3*knode], &coords[3*apex]);
+  POLY_ASSERT2(baseTest != 0.0, "convexHull_3d: input points are coplanar.");
+  if (baseTest < 0.0) std::swap(inode, jnode);
+
+  // Build the hull.
+  const std::vector<QuickhullFacet> facets = quickhull(coords, inode, jnode, knode, apex);
 
-    // Reduce to the new set of exterior points.
-    const unsigned oldsize = remainingPoints.size();
-    POLY_CONTRACT_VAR(oldsize);
-    exteriorPoints(remainingPoints, workingFacets, ps);
-    POLY_ASSERT(remainingPoints.size() < oldsize);
-
-    // std::cerr << "New pass at facets: " << std::endl;
-    // for (unsigned i = 0; i != workingFacets.size(); ++i) {
-    //   std::cerr << " --> " << workingFacets[i] << std::endl;
-    // }
-    // std::cerr << "Remaining points : ";
-    // std::copy(remainingPoints.begin(), remainingPoints.end(), std::ostream_iterator<unsigned>(std::cerr, " "));
-    // std::cerr << std::endl;
-    // std::cerr << "  --> " << remainingPoints.size() << std::endl;
+  // Map the unique points back to the first corresponding input point.
+  std::vector<int> inputIndex(nunique, -1);
+  for (unsigned i = 0; i != pointMap.size(); ++i) {
+    if (inputIndex[pointMap[i]] == -1) inputIndex[pointMap[i]] = i;
   }
 
   // Read out the data to the PLC and we're done.
   PLC<3, RealType> plc;
-  for (typename FacetSet::iterator facetItr = workingFacets.begin();
-       facetItr != workingFacets.end();
-       ++facetItr) {
-    plc.facets.push_back(std::vector<int>());
-    plc.facets.back().push_back(pointMap[facetItr->inode]);
-    plc.facets.back().push_back(pointMap[facetItr->jnode]);
-    plc.facets.back().push_back(pointMap[facetItr->knode]);
+  plc.facets.resize(facets.size(), std::vector<int>(3));
+  for (unsigned f = 0; f != facets.size(); ++f) {
+    plc.facets[f][0] = inputIndex[facets[f].inode];
+    plc.facets[f][1] = inputIndex[facets[f].jnode];
+    plc.facets[f][2] = inputIndex[facets[f].knode];
   }
   return plc;
 }
@@ -69,7 +69,7 @@ int compare(const RealType& ox, const RealType& oy, const RealType& oz,
 //------------------------------------------------------------------------------
 template<typename RealType>
 int compare(const RealType& ox, const RealType& oy, const RealType& oz, 
-            const RealType& nx, const RealType& ny, const RealType& nz, 
+            const double& nx, const double& ny, const double& nz, 
             const std::vector<RealType>& points) {
   POLY_ASSERT(points.size() % 3 == 0);
   POLY_ASSERT(points.size() > 1);
@@ -8,15 +8,22 @@
 // 2.  cellMask : an array of length mesh.cells.size of either 0 or 1:
 //     0 => delete cell
 //     1 => keep cell
+//
+// The old to new index maps are dense arrays built by prefix sums over the
+// element masks, and the surviving elements are renumbered in parallel and
+// then compacted in place, so the cost is linear in the mesh size.  This
+// matters since the DistributedTessellator uses it to strip the (typically
+// many) ghost cells from every distributed tessellation.
 //----------------------------------------------------------------------------//
 #ifndef __polytope_deleteCells__
 #define __polytope_deleteCells__
 #include <iostream>
 #include <iterator>
 #include <algorithm>
-#include <map>
+#include <vector>
 
 #include "polytope.hh"
+#include "polytope_thread_utilities.hh"
 
 namespace polytope {
 
@@ -26,132 +33,116 @@ deleteCells(Tessellation<Dimension, RealType>& mesh,
             const std::vector<unsigned>& cellMask) {
 
   // Pre-conditions.
-  const unsigned ncells0 = mesh.cells.size();
-  const unsigned nfaces0 = mesh.faces.size();
-  const unsigned nnodes0 = mesh.nodes.size()/Dimension;
-  POLY_ASSERT(cellMask.size() == ncells0);
+  const int ncells0 = mesh.cells.size();
+  const int nfaces0 = mesh.faces.size();
+  const int nnodes0 = mesh.nodes.size()/Dimension;
+  POLY_ASSERT(cellMask.size() == unsigned(ncells0));
   POLY_ASSERT(ncells0 == 0 or *max_element(cellMask.begin(), cellMask.end()) == 1);
+  POLY_ASSERT(mesh.faceCells.size() == unsigned(nfaces0));
 
-  // Create masks for the nodes and faces.
-  std::vector<int> nodeMask(nnodes0, 0), faceMask(nfaces0, 0);
-  for (unsigned icell = 0; icell != ncells0; ++icell) {
-    if (cellMask[icell] == 1) {
-      for (std::vector<int>::const_iterator faceItr = mesh.cells[icell].begin();
-           faceItr != mesh.cells[icell].end();
-           ++faceItr) {
-        const unsigned iface = (*faceItr >= 0 ? *faceItr : ~(*faceItr));
-        POLY_ASSERT(iface < mesh.faces.size());
-        faceMask[iface] = 1;
-        for (std::vector<unsigned>::const_iterator nodeItr = mesh.faces[iface].begin();
-             nodeItr != mesh.faces[iface].end();
-             ++nodeItr) {
-          const unsigned inode = *nodeItr;
-          POLY_ASSERT(inode < mesh.nodes.size()/Dimension);
-          nodeMask[inode] = 1;
-        }
+  // Create masks for the faces and nodes.  A face survives if either of its
+  // cells does, and a node if any surviving face uses it.
+  std::vector<unsigned> faceMask(nfaces0, 0), nodeMask(nnodes0, 0);
+#pragma omp parallel for schedule(static)
+  for (int iface = 0; iface < nfaces0; ++iface) {
+    const std::vector<int>& fcells = mesh.faceCells[iface];
+    POLY_ASSERT(fcells.size() == 1 or fcells.size() == 2);
+    for (unsigned k = 0; k != fcells.size(); ++k) {
+      POLY_ASSERT(internal::positiveID(fcells[k]) < ncells0);
+      if (cellMask[internal::positiveID(fcells[k])] == 1) faceMask[iface] = 1;
+    }
+    if (faceMask[iface] == 1) {
+      for (unsigned k = 0; k != mesh.faces[iface].size(); ++k) {
+        const unsigned inode = mesh.faces[iface][k];
+        POLY_ASSERT(inode < unsigned(nnodes0));
+#pragma omp atomic write
+        nodeMask[inode] = 1;
       }
     }
   }
 
-  // Determine the new cell, face, and node numberings.
-  unsigned nnodes1 = 0, nfaces1 = 0, ncells1 = 0;
-  std::map<unsigned, unsigned> old2new_nodes, old2new_faces, old2new_cells;
-  {
-    for (unsigned i = 0; i != nnodes0; ++i) {
-      if (nodeMask[i] == 1) old2new_nodes[i] = nnodes1++;
-    }
-    for (unsigned i = 0; i != nfaces0; ++i) {
-      if (faceMask[i] == 1) old2new_faces[i] = nfaces1++;
-    }
-    for (unsigned i = 0; i != ncells0; ++i) {
-      if (cellMask[i] == 1) old2new_cells[i] = ncells1++;
-    }
-  }
+  // Determine the new cell, face, and node numberings.  old2new[i] is only
+  // meaningful where the corresponding mask is set.
+  std::vector<unsigned> old2new_cells(cellMask), old2new_faces(faceMask), old2new_nodes(nodeMask);
+  const unsigned ncells1 = internal::exclusiveScan(old2new_cells);
+  const unsigned nfaces1 = internal::exclusiveScan(old2new_faces);
+  const unsigned nnodes1 = internal::exclusiveScan(old2new_nodes);
 
-  // Reconstruct the nodes.
-  {
-    std::vector<RealType> newNodes;
-    newNodes.reserve(nnodes1);
-    for (unsigned i = 0; i != nnodes0; ++i) {
-      if (nodeMask[i] == 1) {
-        std::copy(&mesh.nodes[Dimension*i], &mesh.nodes[Dimension*(i + 1)], back_inserter(newNodes));
+  // Renumber the surviving faces and cells where they sit.
+#pragma omp parallel for schedule(static)
+  for (int iface = 0; iface < nfaces0; ++iface) {
+    if (faceMask[iface] == 1) {
+      std::vector<unsigned>& nodes = mesh.faces[iface];
+      for (unsigned k = 0; k != nodes.size(); ++k) {
+        POLY_ASSERT(nodeMask[nodes[k]] == 1);
+        nodes[k] = old2new_nodes[nodes[k]];
       }
+      std::vector<int>& fcells = mesh.faceCells[iface];
+      unsigned nkeep = 0;
+      for (unsigned k = 0; k != fcells.size(); ++k) {
+        const int icell = internal::positiveID(fcells[k]);
+        if (cellMask[icell] == 1) {
+          const int newCell = old2new_cells[icell];
+          fcells[nkeep++] = (fcells[k] < 0 ? ~newCell : newCell);
+        }
+      }
+      fcells.resize(nkeep);
+      POLY_ASSERT(fcells.size() == 1 or fcells.size() == 2);
     }
-    mesh.nodes = newNodes;
   }
-
-  // Reconstruct the faces.
-  {
-    std::vector<std::vector<unsigned> > newFaces;
-    std::vector<std::vector<int> > newFaceCells;
-    newFaces.reserve(nfaces1);
-    newFaceCells.reserve(nfaces1);
-    for (unsigned i = 0; i != nfaces0; ++i) {
-      if (faceMask[i] == 1) {
-        newFaces.push_back(mesh.faces[i]);
-        for (std::vector<unsigned>::iterator itr = newFaces.back().begin();
-             itr != newFaces.back().end();
-             ++itr) {
-          POLY_ASSERT(old2new_nodes.find(*itr) != old2new_nodes.end());
-          *itr = old2new_nodes[*itr];
-        }
-        POLY_ASSERT(mesh.faceCells[i].size() == 1 or
-               mesh.faceCells[i].size() == 2);
-        newFaceCells.push_back(std::vector<int>());
-        unsigned fc = (mesh.faceCells[i][0] < 0 ? ~mesh.faceCells[i][0] : mesh.faceCells[i][0]);
-        if (cellMask[fc] == 1) newFaceCells.back().push_back(mesh.faceCells[i][0] < 0 ?
-                                                             ~old2new_cells[fc] :
-                                                             old2new_cells[fc]);
-        if (mesh.faceCells[i].size() == 2) {
-          fc = (mesh.faceCells[i][1] < 0 ? ~mesh.faceCells[i][1] : mesh.faceCells[i][1]);
-          if (cellMask[fc] == 1) newFaceCells.back().push_back(mesh.faceCells[i][1] < 0 ?
-                                                               ~old2new_cells[fc] :
-                                                               old2new_cells[fc]);
-        }
-        POLY_ASSERT(newFaceCells.back().size() == 1 or
-               newFaceCells.back().size() == 2);
+#pragma omp parallel for schedule(static)
+  for (int icell = 0; icell < ncells0; ++icell) {
+    if (cellMask[icell] == 1) {
+      std::vector<int>& faces = mesh.cells[icell];
+      for (unsigned k = 0; k != faces.size(); ++k) {
+        const int iface = internal::positiveID(faces[k]);
+        POLY_ASSERT(faceMask[iface] == 1);
+        const int newFace = old2new_faces[iface];
+        faces[k] = (faces[k] < 0 ? ~newFace : newFace);
       }
     }
-    mesh.faces = newFaces;
-    mesh.faceCells = newFaceCells;
   }
 
-  // Reconstruct the cells.
-  {
-    std::vector<std::vector<int> > newCells;
-    newCells.reserve(ncells1);
-    for (unsigned i = 0; i != ncells0; ++i) {
-      if (cellMask[i] == 1) {
-        newCells.push_back(mesh.cells[i]);
-        for (std::vector<int>::iterator itr = newCells.back().begin();
-             itr != newCells.back().end();
-             ++itr) {
-          const int iface = (*itr >= 0 ? *itr : ~(*itr));
-          POLY_ASSERT(old2new_faces.find(iface) != old2new_faces.end());
-          *itr = (*itr >= 0 ? old2new_faces[iface] : ~old2new_faces[iface]);
-        }
-      }
+  // Compact everything in place.  Elements only ever move down, and moving
+  // the face and cell vectors just swaps their buffers.
+  for (int i = 0; i < nnodes0; ++i) {
+    if (nodeMask[i] == 1 and old2new_nodes[i] != unsigned(i)) {
+      std::copy(&mesh.nodes[Dimension*i], &mesh.nodes[Dimension*i] + Dimension,
+                &mesh.nodes[Dimension*old2new_nodes[i]]);
+    }
+  }
+  mesh.nodes.resize(Dimension*nnodes1);
+  for (int i = 0; i < nfaces0; ++i) {
+    if (faceMask[i] == 1 and old2new_faces[i] != unsigned(i)) {
+      mesh.faces[old2new_faces[i]].swap(mesh.faces[i]);
+      mesh.faceCells[old2new_faces[i]].swap(mesh.faceCells[i]);
+    }
+  }
+  mesh.faces.resize(nfaces1);
+  mesh.faceCells.resize(nfaces1);
+  for (int i = 0; i < ncells0; ++i) {
+    if (cellMask[i] == 1 and old2new_cells[i] != unsigned(i)) {
+      mesh.cells[old2new_cells[i]].swap(mesh.cells[i]);
     }
-    mesh.cells = newCells;
   }
+  mesh.cells.resize(ncells1);
 
   // Update the shared nodes and faces.
   const unsigned numNeighbors = mesh.sharedNodes.size();
   POLY_ASSERT(mesh.sharedFaces.size() == numNeighbors);
   for (unsigned idomain = 0; idomain != numNeighbors; ++idomain) {
-    std::vector<unsigned> newNodes, newFaces;
-    for (std::vector<unsigned>::iterator itr = mesh.sharedNodes[idomain].begin();
-         itr != mesh.sharedNodes[idomain].end();
-         ++itr) {
-      if (nodeMask[*itr] == 1) newNodes.push_back(old2new_nodes[*itr]);
+    std::vector<unsigned>& sharedNodes = mesh.sharedNodes[idomain];
+    std::vector<unsigned>& sharedFaces = mesh.sharedFaces[idomain];
+    unsigned n = 0;
+    for (unsigned k = 0; k != sharedNodes.size(); ++k) {
+      if (nodeMask[sharedNodes[k]] == 1) sharedNodes[n++] = old2new_nodes[sharedNodes[k]];
     }
-    for (std::vector<unsigned>::iterator itr = mesh.sharedFaces[idomain].begin();
-         itr != mesh.sharedFaces[idomain].end();
-         ++itr) {
-      if (faceMask[*itr] == 1) newFaces.push_back(old2new_faces[*itr]);
+    sharedNodes.resize(n);
+    n = 0;
+    for (unsigned k = 0; k != sharedFaces.size(); ++k) {
+      if (faceMask[sharedFaces[k]] == 1) sharedFaces[n++] = old2new_faces[sharedFaces[k]];
     }
-    mesh.sharedNodes[idomain] = newNodes;
-    mesh.sharedFaces[idomain] = newFaces;
+    sharedFaces.resize(n);
   }
 
   // If there was a convex hull in the mesh, it's probably no longer valid.
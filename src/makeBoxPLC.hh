@@ -4,6 +4,9 @@
 #ifndef __polytope_makeBoxPLC__
 #define __polytope_makeBoxPLC__
 
+#include <vector>
+#include <algorithm>
+
 #include "ReducedPLC.hh"
 
 namespace polytope {
@@ -35,7 +38,24 @@ template<typename RealType>
 void
 makeBoxPLC(ReducedPLC<3, RealType>& result,
            const RealType* low, const RealType* high) {
-  POLY_ASSERT2(false, "Implement me!");
+  // The corners are numbered by bits: 1 for high x, 2 for high y, and 4 for
+  // high z.  Each facet is counterclockwise viewed from outside the box.
+  result.points.resize(24);
+  for (unsigned i = 0; i != 8; ++i) {
+    result.points[3*i  ] = (i & 1) ? high[0] : low[0];
+    result.points[3*i+1] = (i & 2) ? high[1] : low[1];
+    result.points[3*i+2] = (i & 4) ? high[2] : low[2];
+  }
+  const int facets[6][4] = {{0, 4, 6, 2},    // -x
+                            {1, 3, 7, 5},    // +x
+                            {0, 1, 5, 4},    // -y
+                            {2, 6, 7, 3},    // +y
+                            {0, 2, 3, 1},    // -z
+                            {4, 5, 7, 6}};   // +z
+  result.facets.resize(6, std::vector<int>(4));
+  for (unsigned i = 0; i != 6; ++i) {
+    std::copy(facets[i], facets[i] + 4, result.facets[i].begin());
+  }
 }
 
 }
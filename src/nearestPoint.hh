@@ -9,6 +9,8 @@
 //------------------------------------------------------------------------------
 #include <vector>
 #include <limits>
+#include <algorithm>
+#include <cmath>
 
 #include "PLC.hh"
 #include "polytope_internal.hh"
@@ -55,6 +57,88 @@ struct ClosestPointOnFacetsFunctor<2, RealType> {
   }
 };
 
+// 3-D specialization.  The facets are planar polygons, not necessarily convex.
+template<typename RealType>
+struct ClosestPointOnFacetsFunctor<3, RealType> {
+  static RealType impl(const RealType* point,
+                       const unsigned numVertices,
+                       const RealType* vertices,
+                       const std::vector<std::vector<int> >& facets,
+                       RealType* result) {
+    unsigned i, j, k;
+    RealType dist, minDist = std::numeric_limits<RealType>::max();
+    RealType candidate[3], edgeCandidate[3];
+    const unsigned numFacets = facets.size();
+    for (unsigned ifacet = 0; ifacet != numFacets; ++ifacet) {
+      const std::vector<int>& facet = facets[ifacet];
+      const unsigned n = facet.size();
+      POLY_ASSERT(n >= 3);
+
+      // The facet normal (Newell's method) and its largest component.
+      RealType normal[3] = {0.0, 0.0, 0.0};
+      for (k = 0; k != n; ++k) {
+        i = facet[k];
+        j = facet[(k + 1) % n];
+        POLY_ASSERT(i >= 0 and i < numVertices);
+        POLY_ASSERT(j >= 0 and j < numVertices);
+        const RealType* a = &vertices[3*i];
+        const RealType* b = &vertices[3*j];
+        normal[0] += (a[1] - b[1])*(a[2] + b[2]);
+        normal[1] += (a[2] - b[2])*(a[0] + b[0]);
+        normal[2] += (a[0] - b[0])*(a[1] + b[1]);
+      }
+      const RealType nmag = sqrt(geometry::dot<3, RealType>(normal, normal));
+      bool inside = false;
+      if (nmag > 0.0) {
+        for (k = 0; k != 3; ++k) normal[k] /= nmag;
+
+        // Project onto the facet plane, and test whether the projection lies
+        // within the facet in the coordinate plane the facet is most nearly
+        // parallel to.
+        const RealType* v0 = &vertices[3*facet[0]];
+        const RealType pv0[3] = {point[0] - v0[0], point[1] - v0[1], point[2] - v0[2]};
+        const RealType h = geometry::dot<3, RealType>(pv0, normal);
+        for (k = 0; k != 3; ++k) candidate[k] = point[k] - h*normal[k];
+        const unsigned iz = ((std::abs(normal[0]) > std::abs(normal[1]) and 
+                              std::abs(normal[0]) > std::abs(normal[2])) ? 0 :
+                             std::abs(normal[1]) > std::abs(normal[2]) ? 1 : 2);
+        const unsigned ix = (iz + 1) % 3, iy = (iz + 2) % 3;
+        for (k = 0; k != n; ++k) {
+          const RealType* a = &vertices[3*facet[k]];
+          const RealType* b = &vertices[3*facet[(k + 1) % n]];
+          if ((a[iy] > candidate[iy]) != (b[iy] > candidate[iy]) and
+              candidate[ix] < a[ix] + (b[ix] - a[ix])*(candidate[iy] - a[iy])/(b[iy] - a[iy])) {
+            inside = not inside;
+          }
+        }
+      }
+
+      // Otherwise the closest point is on one of the facet edges.
+      if (not inside) {
+        RealType edgeDist = std::numeric_limits<RealType>::max();
+        for (k = 0; k != n; ++k) {
+          i = facet[k];
+          j = facet[(k + 1) % n];
+          geometry::closestPointOnSegment3D(point, &vertices[3*i], &vertices[3*j], edgeCandidate);
+          dist = geometry::distance<3, RealType>(point, edgeCandidate);
+          if (dist < edgeDist) {
+            edgeDist = dist;
+            std::copy(edgeCandidate, edgeCandidate + 3, candidate);
+          }
+        }
+      }
+      dist = geometry::distance<3, RealType>(point, candidate);
+      if (dist < minDist) {
+        minDist = dist;
+        result[0] = candidate[0];
+        result[1] = candidate[1];
+        result[2] = candidate[2];
+      }
+    }
+    return minDist;
+  }
+};
+
 // Functional interface.
 template<int Dimension, typename RealType> 
 RealType closestPointOnFacets(const RealType* point,
@@ -62,7 +146,7 @@ RealType closestPointOnFacets(const RealType* point,
                               const RealType* vertices,
                               const std::vector<std::vector<int> >& facets,
                               RealType* result) {
-  return ClosestPointOnFacetsFunctor<2, RealType>::impl(point, numVertices, vertices, facets, result);
+  return ClosestPointOnFacetsFunctor<Dimension, RealType>::impl(point, numVertices, vertices, facets, result);
 }
 
 }
@@ -82,7 +166,7 @@ nearestPoint(const RealType* point,
   RealType minDist = closestPointOnFacets<Dimension, RealType>(point, numVertices, vertices, plc.facets, result);
 
   // Check each of the holes.
-  RealType dist, candidate[2];
+  RealType dist, candidate[Dimension];
   for (unsigned ihole = 0; ihole != plc.holes.size(); ++ihole) {
     dist = closestPointOnFacets<Dimension, RealType>(point, numVertices, vertices, plc.holes[ihole], candidate);
     if (dist < minDist) {
@@ -61,7 +61,7 @@ template<int Dimension, typename RealType> struct Hasher;
 template<typename RealType> struct Hasher<2, RealType> {
 
   // typedef typename DimensionTraits<Dimension, RealType>::CoordHash CoordHash;
-  typedef KeyTraits::Key CoordHash;
+  typedef uint64_t CoordHash;
 
   static unsigned  num1dbits()                { return 31U; }
   //static unsigned  num1dbits()                { return 30U; }
@@ -172,7 +172,7 @@ template<typename RealType> struct Hasher<2, RealType> {
 template<typename RealType> struct Hasher<3, RealType> {
 
   // typedef DimensionTraits<3, RealType>::CoordHash CoordHash;
-  typedef KeyTraits::Key CoordHash;
+  typedef uint64_t CoordHash;
 
   static unsigned  num1dbits()                { return 21U; }
   static CoordHash coordMax()                 { return (1ULL << num1dbits()) - 1ULL; }
@@ -514,13 +514,41 @@ closestPointOnSegment2D(const RealType* point,
     shat[0] /= seglength;
     shat[1] /= seglength;
     const RealType s1p[2] = {point[0] - s1[0], point[1] - s1[1]};
-    const RealType ptest = std::max(0.0, std::min(seglength, geometry::dot<2, RealType>(s1p, shat)));
+    const RealType ptest = std::max(RealType(0), std::min(seglength, geometry::dot<2, RealType>(s1p, shat)));
     result[0] = s1[0] + ptest*shat[0];
     result[1] = s1[1] + ptest*shat[1];
   }
 }
 
 
+//------------------------------------------------------------------------------
+// Find the closest point on a line segment (3D).
+//------------------------------------------------------------------------------
+template<typename RealType> 
+void
+closestPointOnSegment3D(const RealType* point, 
+                        const RealType* s1,
+                        const RealType* s2,
+                        RealType* result) {
+  RealType shat[3] = {s2[0] - s1[0], s2[1] - s1[1], s2[2] - s1[2]};
+  const RealType seglength = sqrt(shat[0]*shat[0] + shat[1]*shat[1] + shat[2]*shat[2]);
+  if (seglength < 1.0e-10) {
+    result[0] = 0.5*(s1[0] + s2[0]);
+    result[1] = 0.5*(s1[1] + s2[1]);
+    result[2] = 0.5*(s1[2] + s2[2]);
+  } else {
+    shat[0] /= seglength;
+    shat[1] /= seglength;
+    shat[2] /= seglength;
+    const RealType s1p[3] = {point[0] - s1[0], point[1] - s1[1], point[2] - s1[2]};
+    const RealType ptest = std::max(RealType(0), std::min(seglength, geometry::dot<3, RealType>(s1p, shat)));
+    result[0] = s1[0] + ptest*shat[0];
+    result[1] = s1[1] + ptest*shat[1];
+    result[2] = s1[2] + ptest*shat[2];
+  }
+}
+
+
 //------------------------------------------------------------------------------
 // Determine if the point lies inside unclosed polygon determined by vertices
 //------------------------------------------------------------------------------
@@ -598,7 +626,8 @@ pointOnPolygon(const RealType* point,
 // }
 
 //------------------------------------------------------------------------------
-// Find the global bounding box for a set of coordinates.
+// Find the global bounding box for a set of coordinates.  With globalReduce
+// the box is reduced over defaultCommunicator().
 //------------------------------------------------------------------------------
 template<int Dimension, typename RealType>
 inline
@@ -623,8 +652,8 @@ computeBoundingBox(const RealType* pos,
 #ifdef HAVE_MPI
    if (globalReduce) {
      for (unsigned j = 0; j != Dimension; ++j) {
-       xmin[j] = allReduce(xmin[j], MPI_MIN, MPI_COMM_WORLD);
-       xmax[j] = allReduce(xmax[j], MPI_MAX, MPI_COMM_WORLD);
+       xmin[j] = allReduce(xmin[j], MPI_MIN, defaultCommunicator());
+       xmax[j] = allReduce(xmax[j], MPI_MAX, defaultCommunicator());
      }
    }
 #endif
@@ -673,8 +702,8 @@ expandBoundingBox(const RealType* pos,
 #ifdef HAVE_MPI
   if (globalReduce) {
     for (unsigned j = 0; j != Dimension; ++j) {
-      xmin[j] = allReduce(xmin[j], MPI_MIN, MPI_COMM_WORLD);
-      xmax[j] = allReduce(xmax[j], MPI_MAX, MPI_COMM_WORLD);
+      xmin[j] = allReduce(xmin[j], MPI_MIN, defaultCommunicator());
+      xmax[j] = allReduce(xmax[j], MPI_MAX, defaultCommunicator());
     }
   }
 #endif
@@ -1358,7 +1387,7 @@ uniquePoints(const std::vector<RealType>& points,
   POLY_ASSERT(points.size() % Dimension == 0);
   typedef geometry::Hasher<Dimension, RealType> HasherType;
   // typedef DimensionTraits<Dimension, RealType>::CoordHash CoordHash;
-  typedef KeyTraits::Key CoordHash;
+  typedef uint64_t CoordHash;
 
   // // Compute the bounding box.
   // RealType xmin[Dimension], xmax[Dimension];
@@ -1428,7 +1457,7 @@ struct CellToReducedPLCFunctor<3, RealType> {
   static ReducedPLC<3, RealType> impl(const Tessellation<3, RealType>& mesh, 
                                       const unsigned icell) {
     POLY_ASSERT(icell < mesh.cells.size());
-    ReducedPLC<3, double> result;
+    ReducedPLC<3, RealType> result;
     std::map<int, int> old2new;
     for (unsigned i = 0; i != mesh.cells[icell].size(); ++i) {
       result.facets.push_back(std::vector<int>());
@@ -1548,7 +1577,7 @@ aboveBelow(const RealType& l1x, const RealType& l1y,
 template<typename RealType>
 int 
 aboveBelow(const RealType& ox, const RealType& oy, const RealType& oz, 
-           const RealType& nx,    const RealType& ny, const RealType& nz, 
+           const double& nx,   const double& ny,   const double& nz, 
            const std::vector<RealType>& points) {
   POLY_ASSERT(points.size() % 3 == 0);
   POLY_ASSERT(points.size() > 1);
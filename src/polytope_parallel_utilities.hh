@@ -11,6 +11,7 @@
 #include "mpi.h"
 
 #include "KeyTraits.hh"
+#include "polytope_internal.hh"
 
 namespace polytope {
 
@@ -46,6 +47,64 @@ allReduce(const Value& value,
   return result;
 }
 
+//------------------------------------------------------------------------------
+// The communicator used by the collectives buried in code that isn't handed
+// one explicitly, such as the global bounding box reductions the serial
+// tessellators make.  This is MPI_COMM_WORLD unless a CommunicatorScope is
+// in effect: the DistributedTessellator opens one on its own communicator
+// for the length of each tessellation.
+//------------------------------------------------------------------------------
+inline
+MPI_Comm&
+defaultCommunicatorRef() {
+  static MPI_Comm comm = MPI_COMM_WORLD;
+  return comm;
+}
+
+inline
+MPI_Comm
+defaultCommunicator() {
+  return defaultCommunicatorRef();
+}
+
+class CommunicatorScope {
+public:
+  explicit CommunicatorScope(const MPI_Comm comm):
+    mPrevious(defaultCommunicatorRef()) {
+    defaultCommunicatorRef() = comm;
+  }
+  ~CommunicatorScope() {
+    defaultCommunicatorRef() = mPrevious;
+  }
+private:
+  MPI_Comm mPrevious;
+  CommunicatorScope(const CommunicatorScope&);
+  CommunicatorScope& operator=(const CommunicatorScope&);
+};
+
+//------------------------------------------------------------------------------
+// Split comm into numProblems disjoint communicators of consecutive ranks,
+// as evenly sized as possible, so independent problems can be tessellated
+// at the same time: build a DistributedTessellator on the communicator
+// returned to each rank.  problem is set to the index of the problem this
+// rank works on.  numProblems must not exceed the size of comm, and the
+// caller frees the result with MPI_Comm_free.
+//------------------------------------------------------------------------------
+inline
+MPI_Comm
+splitCommunicator(const MPI_Comm comm,
+                  const unsigned numProblems,
+                  unsigned& problem) {
+  int rank, numProcs;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &numProcs);
+  POLY_ASSERT(numProblems > 0 and numProblems <= unsigned(numProcs));
+  problem = (unsigned long)(rank)*numProblems/numProcs;
+  MPI_Comm result;
+  MPI_Comm_split(comm, problem, rank, &result);
+  return result;
+}
+
 }
 
 #endif
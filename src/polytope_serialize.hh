@@ -9,6 +9,8 @@
 #include <vector>
 #include <iterator>
 #include <algorithm>
+#include <cstring>
+#include <type_traits>
 #include <stdint.h>
 
 #include "polytope_internal.hh"
@@ -17,6 +19,53 @@
 
 namespace polytope {
 
+//------------------------------------------------------------------------------
+// Types whose values serialize as their raw bytes.  Vectors of these are
+// copied to and from the buffer in bulk rather than an element at a time.
+// Specialize this for any plain struct whose Serializer just writes its
+// bytes.
+//------------------------------------------------------------------------------
+template<typename T>
+struct SerializeBitwise {
+  static const bool value = std::is_arithmetic<T>::value;
+};
+
+// std::vector<bool> packs its bits, so there are no bools to copy in bulk.
+template<>
+struct SerializeBitwise<bool> {
+  static const bool value = false;
+};
+
+//------------------------------------------------------------------------------
+// Raw byte copies to and from a buffer.
+//------------------------------------------------------------------------------
+// Make room for n more bytes, keeping the geometric growth of the buffer so
+// repeated calls don't reallocate every time.
+inline
+void
+reserveBytes(std::vector<char>& buffer, const size_t n) {
+  const size_t needed = buffer.size() + n;
+  if (needed > buffer.capacity()) buffer.reserve(std::max(needed, 2*buffer.capacity()));
+}
+
+inline
+void
+appendBytes(const void* data, const size_t n, std::vector<char>& buffer) {
+  const char* p = static_cast<const char*>(data);
+  buffer.insert(buffer.end(), p, p + n);
+}
+
+inline
+void
+extractBytes(void* data,
+             const size_t n,
+             std::vector<char>::const_iterator& bufItr,
+             const std::vector<char>::const_iterator& endItr) {
+  POLY_ASSERT(size_t(endItr - bufItr) >= n);
+  if (n > 0) std::memcpy(data, &(*bufItr), n);
+  bufItr += n;
+}
+
 //------------------------------------------------------------------------------
 // Serialize.  Due to limitations on partial specialization for functions, we 
 // define a Functor object to handle specializing for each data type.
@@ -27,19 +76,54 @@ struct Serializer {
 
   static void serializeImpl(const T& val, 
                             std::vector<char>& buffer) {
-    const unsigned n = sizeof(T);
-    const char* data = reinterpret_cast<const char*>(&val);
-    std::copy(data, data + n, std::back_inserter(buffer));
+    appendBytes(&val, sizeof(T), buffer);
   }
 
   static void deserializeImpl(T& val, 
                               std::vector<char>::const_iterator& bufItr, 
                               const std::vector<char>::const_iterator& endItr) {
-    const unsigned n = sizeof(T);
-    char* data = reinterpret_cast<char*>(&val);
-    POLY_ASSERT(bufItr + n <= endItr);
-    std::copy(bufItr, bufItr + n, data);
-    bufItr += n;
+    extractBytes(&val, sizeof(T), bufItr, endItr);
+  }
+};
+
+// The elements of a vector, a copy apiece or in bulk.  Deserializing
+// appends to the vector.
+template<typename T, bool bitwise = SerializeBitwise<T>::value>
+struct ElementSerializer {
+
+  static void serializeImpl(const T* val,
+                            const unsigned n,
+                            std::vector<char>& buffer) {
+    for (unsigned i = 0; i != n; ++i) Serializer<T>::serializeImpl(val[i], buffer);
+  }
+
+  static void deserializeImpl(std::vector<T>& val,
+                              const unsigned n,
+                              std::vector<char>::const_iterator& bufItr,
+                              const std::vector<char>::const_iterator& endItr) {
+    const unsigned n0 = val.size();
+    val.resize(n0 + n);
+    for (unsigned i = 0; i != n; ++i) Serializer<T>::deserializeImpl(val[n0 + i], bufItr, endItr);
+  }
+};
+
+template<typename T>
+struct ElementSerializer<T, true> {
+
+  static void serializeImpl(const T* val,
+                            const unsigned n,
+                            std::vector<char>& buffer) {
+    if (n > 0) appendBytes(val, n*sizeof(T), buffer);
+  }
+
+  static void deserializeImpl(std::vector<T>& val,
+                              const unsigned n,
+                              std::vector<char>::const_iterator& bufItr,
+                              const std::vector<char>::const_iterator& endItr) {
+    const unsigned n0 = val.size();
+    POLY_ASSERT(size_t(endItr - bufItr) >= n*sizeof(T));
+    val.resize(n0 + n);
+    if (n > 0) extractBytes(&val[n0], n*sizeof(T), bufItr, endItr);
   }
 };
 
@@ -50,29 +134,85 @@ struct Serializer<std::vector<T> > {
   static void serializeImpl(const std::vector<T>& val, 
                             std::vector<char>& buffer) {
     const unsigned n = val.size();
+    if (SerializeBitwise<T>::value) reserveBytes(buffer, sizeof(unsigned) + n*sizeof(T));
     Serializer<unsigned>::serializeImpl(n, buffer);
-    for (unsigned i = 0; i != n; ++i) Serializer<T>::serializeImpl(val[i], buffer);
+    ElementSerializer<T>::serializeImpl(n > 0 ? &val[0] : 0, n, buffer);
   }
 
   static void deserializeImpl(std::vector<T>& val, 
                               std::vector<char>::const_iterator& bufItr, 
                               const std::vector<char>::const_iterator& endItr) {
+    unsigned n;
+    Serializer<unsigned>::deserializeImpl(n, bufItr, endItr);
+    ElementSerializer<T>::deserializeImpl(val, n, bufItr, endItr);
+  }
+};
+
+// std::vector<bool>, which can't hand out references to its elements.
+template<>
+struct Serializer<std::vector<bool> > {
+
+  static void serializeImpl(const std::vector<bool>& val, 
+                            std::vector<char>& buffer) {
+    const unsigned n = val.size();
+    Serializer<unsigned>::serializeImpl(n, buffer);
+    for (unsigned i = 0; i != n; ++i) Serializer<bool>::serializeImpl(val[i], buffer);
+  }
+
+  static void deserializeImpl(std::vector<bool>& val, 
+                              std::vector<char>::const_iterator& bufItr, 
+                              const std::vector<char>::const_iterator& endItr) {
+    unsigned n;
+    Serializer<unsigned>::deserializeImpl(n, bufItr, endItr);
+    for (unsigned i = 0; i != n; ++i) {
+      bool element;
+      Serializer<bool>::deserializeImpl(element, bufItr, endItr);
+      val.push_back(element);
+    }
+  }
+};
+
+// std::vector<std::vector> of known type, an inner vector at a time.
+template<typename T, bool bitwise = SerializeBitwise<T>::value>
+struct NestedVectorSerializer {
+
+  static void serializeImpl(const std::vector<std::vector<T> >& val, 
+                            std::vector<char>& buffer) {
+    const unsigned n = val.size();
+    Serializer<unsigned>::serializeImpl(n, buffer);
+    for (unsigned i = 0; i != n; ++i) Serializer<std::vector<T> >::serializeImpl(val[i], buffer);
+  }
+
+  static void deserializeImpl(std::vector<std::vector<T> >& val, 
+                              std::vector<char>::const_iterator& bufItr, 
+                              const std::vector<char>::const_iterator& endItr) {
     unsigned n, n0 = val.size();
     Serializer<unsigned>::deserializeImpl(n, bufItr, endItr);
     val.resize(n0 + n);
-    for (unsigned i = 0; i != n; ++i) Serializer<T>::deserializeImpl(val[n0 + i], bufItr, endItr);
+    for (unsigned i = 0; i != n; ++i) Serializer<std::vector<T> >::deserializeImpl(val[n0 + i], bufItr, endItr);
   }
 };
 
-// std::vector<std::vector> of known type.
+// When the elements serialize bitwise the inner lengths go first as one
+// array, followed by all the elements.
 template<typename T>
-struct Serializer<std::vector<std::vector<T> > > {
+struct NestedVectorSerializer<T, true> {
 
   static void serializeImpl(const std::vector<std::vector<T> >& val, 
                             std::vector<char>& buffer) {
-    unsigned n = val.size();
+    const unsigned n = val.size();
+    std::vector<unsigned> sizes(n);
+    size_t nelements = 0;
+    for (unsigned i = 0; i != n; ++i) {
+      sizes[i] = val[i].size();
+      nelements += sizes[i];
+    }
+    reserveBytes(buffer, (n + 1)*sizeof(unsigned) + nelements*sizeof(T));
     Serializer<unsigned>::serializeImpl(n, buffer);
-    for (unsigned i = 0; i != n; ++i) Serializer<std::vector<T> >::serializeImpl(val[i], buffer);
+    ElementSerializer<unsigned>::serializeImpl(n > 0 ? &sizes[0] : 0, n, buffer);
+    for (unsigned i = 0; i != n; ++i) {
+      ElementSerializer<T>::serializeImpl(sizes[i] > 0 ? &val[i][0] : 0, sizes[i], buffer);
+    }
   }
 
   static void deserializeImpl(std::vector<std::vector<T> >& val, 
@@ -81,7 +221,26 @@ struct Serializer<std::vector<std::vector<T> > > {
     unsigned n, n0 = val.size();
     Serializer<unsigned>::deserializeImpl(n, bufItr, endItr);
     val.resize(n0 + n);
-    for (unsigned i = 0; i != n; ++i) Serializer<std::vector<T> >::deserializeImpl(val[n0 + i], bufItr, endItr);
+    std::vector<unsigned> sizes;
+    ElementSerializer<unsigned>::deserializeImpl(sizes, n, bufItr, endItr);
+    for (unsigned i = 0; i != n; ++i) {
+      ElementSerializer<T>::deserializeImpl(val[n0 + i], sizes[i], bufItr, endItr);
+    }
+  }
+};
+
+template<typename T>
+struct Serializer<std::vector<std::vector<T> > > {
+
+  static void serializeImpl(const std::vector<std::vector<T> >& val, 
+                            std::vector<char>& buffer) {
+    NestedVectorSerializer<T>::serializeImpl(val, buffer);
+  }
+
+  static void deserializeImpl(std::vector<std::vector<T> >& val, 
+                              std::vector<char>::const_iterator& bufItr, 
+                              const std::vector<char>::const_iterator& endItr) {
+    NestedVectorSerializer<T>::deserializeImpl(val, bufItr, endItr);
   }
 };
 
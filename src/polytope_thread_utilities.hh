@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+// polytope_thread_utilities
+//
+// Thin wrappers around the OpenMP runtime, so the threaded algorithms read the
+// same whether or not polytope is built with OpenMP.  Without OpenMP the
+// "#pragma omp" directives are ignored and these report a single thread.
+//------------------------------------------------------------------------------
+#ifndef __polytope_thread_utilities__
+#define __polytope_thread_utilities__
+
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace polytope {
+namespace internal {
+
+//------------------------------------------------------------------------------
+// The number of threads a parallel region started here would get.
+//------------------------------------------------------------------------------
+inline
+int
+maxThreads() {
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Set the number of threads later parallel regions get.  A no-op without
+// OpenMP.
+//------------------------------------------------------------------------------
+inline
+void
+setMaxThreads(const int n) {
+#ifdef _OPENMP
+  omp_set_num_threads(n);
+#endif
+}
+
+//------------------------------------------------------------------------------
+// The number of threads in the current parallel region.
+//------------------------------------------------------------------------------
+inline
+int
+numThreads() {
+#ifdef _OPENMP
+  return omp_get_num_threads();
+#else
+  return 1;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// The index of the calling thread in the current parallel region.
+//------------------------------------------------------------------------------
+inline
+int
+threadIndex() {
+#ifdef _OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// In place exclusive prefix sum: replace each x[i] by the sum of the entries
+// before it, and return the sum of them all.  Applied to a 0/1 mask this
+// gives each kept element its index after compaction.  Each thread scans a
+// contiguous block, so the result is the same for any number of threads.
+//------------------------------------------------------------------------------
+template<typename IntType>
+IntType
+exclusiveScan(std::vector<IntType>& x) {
+  const int n = x.size();
+  const int nthreads = maxThreads();
+  std::vector<IntType> offsets(nthreads + 1, IntType(0));
+#pragma omp parallel num_threads(nthreads)
+  {
+    const int ithread = threadIndex(), nt = numThreads();
+    const int begin = int((long(n)*ithread)/nt), end = int((long(n)*(ithread + 1))/nt);
+    IntType sum = 0;
+    for (int i = begin; i < end; ++i) sum += x[i];
+    offsets[ithread + 1] = sum;
+#pragma omp barrier
+#pragma omp single
+    for (int k = 0; k < nthreads; ++k) offsets[k + 1] += offsets[k];
+    sum = offsets[ithread];
+    for (int i = begin; i < end; ++i) {
+      const IntType xi = x[i];
+      x[i] = sum;
+      sum += xi;
+    }
+  }
+  return offsets.back();
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,200 @@
+//------------------------------------------------------------------------------
+// polytope_write_utilities
+//
+// The pieces shared by the VTK and XDMF writers: a buffered binary output
+// stream, and the walks over a Tessellation producing the polygon node
+// rings (2D) and polyhedron face streams (3D) both formats describe cells
+// with.  The walks come in a counting pass, so a writer can lay out its file
+// before streaming anything, and a streaming pass.
+//------------------------------------------------------------------------------
+#ifndef __polytope_write_utilities__
+#define __polytope_write_utilities__
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+
+#include "Tessellation.hh"
+#include "timingUtilities.hh"
+
+namespace polytope {
+namespace internal {
+
+//------------------------------------------------------------------------------
+// Binary output in large blocks.  Values are appended to a buffer which is
+// handed to the file whenever it fills, and big arrays go straight through.
+//------------------------------------------------------------------------------
+class BlockWriter {
+public:
+  BlockWriter(std::ofstream& file, const unsigned blockSize = 1U << 22):
+    mFile(file),
+    mBuffer(),
+    mBytes(0) {
+    mBuffer.reserve(blockSize);
+  }
+  ~BlockWriter() { flush(); }
+
+  void write(const void* data, const uint64_t nbytes) {
+    if (mBuffer.size() + nbytes > mBuffer.capacity()) {
+      flush();
+      if (nbytes >= mBuffer.capacity()) {
+        mFile.write(static_cast<const char*>(data), nbytes);
+        mBytes += nbytes;
+        return;
+      }
+    }
+    const char* p = static_cast<const char*>(data);
+    mBuffer.insert(mBuffer.end(), p, p + nbytes);
+  }
+
+  template<typename T>
+  void put(const T value) {
+    this->write(&value, sizeof(T));
+  }
+
+  template<typename T>
+  void put(const std::vector<T>& values) {
+    if (not values.empty()) this->write(&values[0], values.size()*sizeof(T));
+  }
+
+  void flush() {
+    if (not mBuffer.empty()) {
+      mFile.write(&mBuffer[0], mBuffer.size());
+      mBytes += mBuffer.size();
+      mBuffer.clear();
+    }
+  }
+
+  // The bytes handed to the file so far.
+  uint64_t bytes() const { return mBytes; }
+
+private:
+  std::ofstream& mFile;
+  std::vector<char> mBuffer;
+  uint64_t mBytes;
+};
+
+//------------------------------------------------------------------------------
+// Open a file for binary output, or fail with the writer's name.
+//------------------------------------------------------------------------------
+inline
+void
+openOutputFile(std::ofstream& file, const std::string& fileName, const std::string& writer) {
+  file.open(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (not file) error(writer + ": could not open " + fileName + " for writing");
+}
+
+//------------------------------------------------------------------------------
+// The name of the piece of a file written by one rank.
+//------------------------------------------------------------------------------
+inline
+std::string
+pieceName(const std::string& prefix, const int rank, const std::string& extension) {
+  std::stringstream ss;
+  ss << prefix << "_" << rank << extension;
+  return ss.str();
+}
+
+// The file name without any directories.
+inline
+std::string
+baseName(const std::string& fileName) {
+  const std::string::size_type i = fileName.find_last_of('/');
+  return i == std::string::npos ? fileName : fileName.substr(i + 1);
+}
+
+//------------------------------------------------------------------------------
+// The node of a 2D cell's face k as we go counterclockwise around it.
+//------------------------------------------------------------------------------
+template<typename RealType>
+unsigned
+cellRingNode(const Tessellation<2, RealType>& mesh, const int k) {
+  return k >= 0 ? mesh.faces[k][0] : mesh.faces[~k][1];
+}
+
+//------------------------------------------------------------------------------
+// Call f(node) for each distinct node of 3D cell i, in the order of first
+// appearance.  mark must have an entry per node, none of them equal to i.
+//------------------------------------------------------------------------------
+template<typename RealType, typename Function>
+void
+forEachCellNode(const Tessellation<3, RealType>& mesh,
+                const unsigned i,
+                std::vector<int>& mark,
+                Function f) {
+  for (unsigned j = 0; j != mesh.cells[i].size(); ++j) {
+    const int k = mesh.cells[i][j];
+    const std::vector<unsigned>& face = mesh.faces[k < 0 ? ~k : k];
+    for (unsigned m = 0; m != face.size(); ++m) {
+      if (mark[face[m]] != int(i)) {
+        mark[face[m]] = i;
+        f(face[m]);
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Call f(node) for the nodes of face j of 3D cell i, counterclockwise viewed
+// from outside the cell.
+//------------------------------------------------------------------------------
+template<typename RealType, typename Function>
+void
+forEachCellFaceNode(const Tessellation<3, RealType>& mesh,
+                    const unsigned i,
+                    const unsigned j,
+                    Function f) {
+  const int k = mesh.cells[i][j];
+  if (k >= 0) {
+    const std::vector<unsigned>& face = mesh.faces[k];
+    for (unsigned m = 0; m != face.size(); ++m) f(face[m]);
+  } else {
+    const std::vector<unsigned>& face = mesh.faces[~k];
+    for (unsigned m = face.size(); m != 0; --m) f(face[m - 1]);
+  }
+}
+
+//------------------------------------------------------------------------------
+// The number of entries in the 3D polyhedron face stream of cell i: the
+// number of faces, then for each face its number of nodes and the nodes.
+//------------------------------------------------------------------------------
+template<typename RealType>
+uint64_t
+cellFaceStreamSize(const Tessellation<3, RealType>& mesh, const unsigned i) {
+  uint64_t result = 1 + mesh.cells[i].size();
+  for (unsigned j = 0; j != mesh.cells[i].size(); ++j) {
+    const int k = mesh.cells[i][j];
+    result += mesh.faces[k < 0 ? ~k : k].size();
+  }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// Write the node positions with Dimension components, or padded out to three
+// with zeros.
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+void
+writeNodes(const Tessellation<Dimension, RealType>& mesh,
+           const unsigned numComponents,
+           BlockWriter& out) {
+  if (numComponents == Dimension) {
+    out.put(mesh.nodes);
+  } else {
+    const unsigned n = mesh.nodes.size()/Dimension;
+    RealType p[3] = {0, 0, 0};
+    for (unsigned i = 0; i != n; ++i) {
+      std::copy(&mesh.nodes[Dimension*i], &mesh.nodes[Dimension*i] + Dimension, p);
+      out.write(p, numComponents*sizeof(RealType));
+    }
+  }
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,344 @@
+//----------------------------------------------------------------------------//
+// repartitionGenerators
+//
+// Redistribute the generators spread over the ranks of a communicator so each
+// rank holds a contiguous piece of a space filling curve (Morton or Hilbert)
+// through them, carrying about the same estimated tessellation cost.  This is
+// an optional step before DistributedTessellator::tessellate for when the
+// caller's own distribution is lopsided: clustered points, say, or one rank
+// holding most of the boundary cells, which stalls every other rank at the
+// collective steps.
+//
+// The splitting keys come from a weighted parallel sample sort.  Each rank
+// sorts its keys, contributes samples evenly spaced in its cumulative cost,
+// and every rank picks the same splitters from the gathered samples, so the
+// balance is good to about the cost of one sample interval.
+//
+// We assume MPI is available here, so don't include this header unless that
+// is so!
+//----------------------------------------------------------------------------//
+#ifndef __Polytope_repartitionGenerators__
+#define __Polytope_repartitionGenerators__
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <iostream>
+#include <limits>
+#include <cmath>
+#include <stdint.h>
+
+#include "mpi.h"
+
+#include "polytope.hh"
+#include "polytope_internal.hh"
+#include "polytope_geometric_utilities.hh"
+#include "polytope_parallel_utilities.hh"
+#include "spatialOrderIndices.hh"
+#include "timingUtilities.hh"
+
+namespace polytope {
+
+//------------------------------------------------------------------------------
+// How the generators (and their estimated cost) were spread over the ranks
+// before and after repartitioning.  The imbalance is the largest rank's cost
+// over the mean, so 1 is perfect.
+//------------------------------------------------------------------------------
+struct RepartitionStatistics {
+  unsigned localCount, minCountBefore, maxCountBefore, minCountAfter, maxCountAfter;
+  double localCost, maxCostBefore, maxCostAfter, meanCost;
+
+  double imbalanceBefore() const { return (meanCost > 0.0 ? maxCostBefore/meanCost : 1.0); }
+  double imbalanceAfter() const { return (meanCost > 0.0 ? maxCostAfter/meanCost : 1.0); }
+};
+
+inline
+std::ostream&
+operator<<(std::ostream& os, const RepartitionStatistics& stats) {
+  os << "generators per rank " << stats.minCountBefore << "-" << stats.maxCountBefore
+     << " -> " << stats.minCountAfter << "-" << stats.maxCountAfter
+     << ", cost imbalance " << stats.imbalanceBefore() << " -> " << stats.imbalanceAfter();
+  return os;
+}
+
+namespace internal {
+
+//------------------------------------------------------------------------------
+// A generator in transit between ranks.
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+struct RepartitionItem {
+  uint64_t key;
+  double cost;
+  unsigned rank, index;
+  RealType x[Dimension];
+
+  bool operator<(const RepartitionItem& rhs) const {
+    return (key < rhs.key or
+            (key == rhs.key and (rank < rhs.rank or
+                                 (rank == rhs.rank and index < rhs.index))));
+  }
+};
+
+//------------------------------------------------------------------------------
+// A key sampled from a rank's sorted generators, and the cost of the
+// generators since the previous sample.
+//------------------------------------------------------------------------------
+struct RepartitionSample {
+  uint64_t key;
+  double cost;
+  bool operator<(const RepartitionSample& rhs) const { return key < rhs.key; }
+};
+
+//------------------------------------------------------------------------------
+// Exchange variable numbers of trivially copyable values with every rank.
+// send is grouped by destination, with sendCounts values for each.
+//------------------------------------------------------------------------------
+template<typename Value>
+inline
+void
+exchangeAllToAll(const std::vector<Value>& send,
+                 const std::vector<int>& sendCounts,
+                 std::vector<Value>& recv,
+                 const MPI_Comm comm) {
+  const unsigned numProcs = sendCounts.size();
+  std::vector<int> recvCounts(numProcs);
+  MPI_Alltoall(const_cast<int*>(&sendCounts[0]), 1, MPI_INT, &recvCounts[0], 1, MPI_INT, comm);
+  std::vector<int> sendBytes(numProcs), sendOffsets(numProcs), recvBytes(numProcs), recvOffsets(numProcs);
+  int sendTotal = 0, recvTotal = 0;
+  for (unsigned i = 0; i != numProcs; ++i) {
+    sendBytes[i] = sendCounts[i]*sizeof(Value);
+    recvBytes[i] = recvCounts[i]*sizeof(Value);
+    sendOffsets[i] = sendTotal;
+    recvOffsets[i] = recvTotal;
+    sendTotal += sendBytes[i];
+    recvTotal += recvBytes[i];
+  }
+  POLY_ASSERT(sendTotal == int(send.size()*sizeof(Value)));
+  recv.resize(recvTotal/sizeof(Value));
+  MPI_Alltoallv(send.empty() ? 0 : const_cast<Value*>(&send[0]), &sendBytes[0], &sendOffsets[0], MPI_BYTE,
+                recv.empty() ? 0 : &recv[0], &recvBytes[0], &recvOffsets[0], MPI_BYTE,
+                comm);
+}
+
+//------------------------------------------------------------------------------
+// The bounding box of all the generators on comm.
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+inline
+void
+globalGeneratorBox(const std::vector<RealType>& points,
+                   RealType* xmin,
+                   RealType* xmax,
+                   const MPI_Comm comm) {
+  CommunicatorScope commScope(comm);
+  geometry::computeBoundingBox<Dimension, RealType>(points.empty() ? 0 : &points[0], points.size(), true, xmin, xmax);
+}
+
+}
+
+//------------------------------------------------------------------------------
+// A rough estimate of what each generator's cell costs to build.  Every cell
+// costs 1, and the cells of generators within one mean generator spacing of
+// the global bounding box count double, since they are the ones clipped
+// against the boundary.
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+std::vector<double>
+estimateGeneratorCosts(const std::vector<RealType>& points,
+                       const MPI_Comm comm = MPI_COMM_WORLD) {
+  POLY_ASSERT(points.size() % Dimension == 0);
+  const unsigned n = points.size()/Dimension;
+  RealType xmin[Dimension], xmax[Dimension];
+  internal::globalGeneratorBox<Dimension, RealType>(points, xmin, xmax, comm);
+  const unsigned numGlobal = allReduce(n, MPI_SUM, comm);
+  double volume = 1.0;
+  for (unsigned j = 0; j != Dimension; ++j) volume *= double(xmax[j] - xmin[j]);
+  const double spacing = (numGlobal > 0 ? std::pow(volume/numGlobal, 1.0/Dimension) : 0.0);
+  std::vector<double> result(n, 1.0);
+  for (unsigned i = 0; i != n; ++i) {
+    for (unsigned j = 0; j != Dimension; ++j) {
+      const double xj = points[Dimension*i + j];
+      if (xj - xmin[j] < spacing or xmax[j] - xj < spacing) {
+        result[i] = 2.0;
+        break;
+      }
+    }
+  }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// Repartition the (Dimension*n) generator coordinates in points over comm
+// along the requested space filling curve, balancing the given per-generator
+// costs (or estimateGeneratorCosts if costs is empty).  On return points
+// holds this rank's new generators in curve order, and origin[i] is the
+// (rank, index) the ith of them came from, so the cells of the subsequent
+// tessellation can be mapped back; see returnToOrigin.
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+RepartitionStatistics
+repartitionGenerators(std::vector<RealType>& points,
+                      const std::vector<double>& costs,
+                      std::vector<std::pair<unsigned, unsigned> >& origin,
+                      const SpatialSort method = HilbertSort,
+                      const MPI_Comm comm = MPI_COMM_WORLD) {
+  typedef internal::RepartitionItem<Dimension, RealType> Item;
+  typedef internal::RepartitionSample Sample;
+  POLY_ASSERT(points.size() % Dimension == 0);
+  POLY_ASSERT(method != NoSpatialSort);
+  ScopedTimer timer("repartitionGenerators");
+
+  int rank, numProcs;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &numProcs);
+  const unsigned n = points.size()/Dimension;
+  const std::vector<double> estimatedCosts = (costs.empty() ?
+                                              estimateGeneratorCosts<Dimension, RealType>(points, comm) :
+                                              std::vector<double>());
+  const std::vector<double>& cost = (costs.empty() ? estimatedCosts : costs);
+  POLY_ASSERT(cost.size() == n);
+
+  // Key our generators on a lattice covering everyone's, and sort them.
+  RealType xmin[Dimension], xmax[Dimension];
+  internal::globalGeneratorBox<Dimension, RealType>(points, xmin, xmax, comm);
+  const double scale = internal::spatialKeyScale<Dimension, RealType>(xmin, xmax);
+  std::vector<Item> items(n);
+  double localCost = 0.0;
+  for (unsigned i = 0; i != n; ++i) {
+    items[i].key = internal::spatialKey<Dimension, RealType>(&points[Dimension*i], xmin, scale, method);
+    items[i].cost = cost[i];
+    items[i].rank = rank;
+    items[i].index = i;
+    std::copy(&points[Dimension*i], &points[Dimension*i] + Dimension, items[i].x);
+    localCost += cost[i];
+  }
+  std::sort(items.begin(), items.end());
+
+  // Sample our keys evenly in cumulative cost.  More samples per rank make
+  // the balance finer at the price of a bigger all-gather; we need several
+  // per rank in case one rank starts out with nearly everything.
+  const unsigned numSamples = std::min(n, std::min(4096U, std::max(256U, 16U*numProcs)));
+  std::vector<Sample> samples;
+  samples.reserve(numSamples);
+  {
+    double cumulative = 0.0, previous = 0.0;
+    unsigned k = 1;
+    for (unsigned i = 0; i != n; ++i) {
+      cumulative += items[i].cost;
+      if (i + 1 == n or (k <= numSamples and cumulative >= localCost*k/numSamples)) {
+        Sample sample = {items[i].key, cumulative - previous};
+        samples.push_back(sample);
+        previous = cumulative;
+        while (k <= numSamples and cumulative >= localCost*k/numSamples) ++k;
+      }
+    }
+  }
+
+  // Gather everyone's samples, and choose the splitters so each rank gets
+  // an equal share of the total cost: rank r takes the keys in
+  // (splitters[r-1], splitters[r]].
+  std::vector<Sample> allSamples;
+  {
+    int localBytes = samples.size()*sizeof(Sample);
+    std::vector<int> bytes(numProcs), offsets(numProcs);
+    MPI_Allgather(&localBytes, 1, MPI_INT, &bytes[0], 1, MPI_INT, comm);
+    int total = 0;
+    for (int i = 0; i != numProcs; ++i) {
+      offsets[i] = total;
+      total += bytes[i];
+    }
+    allSamples.resize(total/sizeof(Sample));
+    MPI_Allgatherv(samples.empty() ? 0 : &samples[0], localBytes, MPI_BYTE,
+                   allSamples.empty() ? 0 : &allSamples[0], &bytes[0], &offsets[0], MPI_BYTE,
+                   comm);
+  }
+  std::sort(allSamples.begin(), allSamples.end());
+  double totalCost = 0.0;
+  for (unsigned i = 0; i != allSamples.size(); ++i) totalCost += allSamples[i].cost;
+  std::vector<uint64_t> splitters(numProcs - 1, std::numeric_limits<uint64_t>::max());
+  {
+    double cumulative = 0.0;
+    unsigned r = 0;
+    for (unsigned i = 0; i != allSamples.size() and r != splitters.size(); ++i) {
+      cumulative += allSamples[i].cost;
+      while (r != splitters.size() and cumulative >= totalCost*(r + 1)/numProcs) splitters[r++] = allSamples[i].key;
+    }
+  }
+
+  // Send each generator to the rank owning its key.  Our items are sorted,
+  // so they are already grouped by destination.
+  std::vector<int> sendCounts(numProcs, 0);
+  for (unsigned i = 0; i != n; ++i) {
+    ++sendCounts[std::lower_bound(splitters.begin(), splitters.end(), items[i].key) - splitters.begin()];
+  }
+  std::vector<Item> received;
+  internal::exchangeAllToAll(items, sendCounts, received, comm);
+  std::sort(received.begin(), received.end());
+
+  // Unpack our new generators.
+  const unsigned nnew = received.size();
+  points.resize(Dimension*nnew);
+  origin.resize(nnew);
+  double newCost = 0.0;
+  for (unsigned i = 0; i != nnew; ++i) {
+    std::copy(received[i].x, received[i].x + Dimension, &points[Dimension*i]);
+    origin[i] = std::make_pair(received[i].rank, received[i].index);
+    newCost += received[i].cost;
+  }
+  incrementCounter("generatorsMoved", n - sendCounts[rank]);
+
+  // How did we do?
+  RepartitionStatistics result;
+  result.localCount = nnew;
+  result.localCost = newCost;
+  result.minCountBefore = allReduce(n, MPI_MIN, comm);
+  result.maxCountBefore = allReduce(n, MPI_MAX, comm);
+  result.minCountAfter = allReduce(nnew, MPI_MIN, comm);
+  result.maxCountAfter = allReduce(nnew, MPI_MAX, comm);
+  result.maxCostBefore = allReduce(localCost, MPI_MAX, comm);
+  result.maxCostAfter = allReduce(newCost, MPI_MAX, comm);
+  result.meanCost = allReduce(newCost, MPI_SUM, comm)/numProcs;
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// Send values computed for the repartitioned generators (one per generator,
+// e.g., cell volumes) back to where the generators came from, given the
+// origin from repartitionGenerators.  On return result[i] is the value for
+// this rank's ith generator before repartitioning.  Value must be trivially
+// copyable.
+//------------------------------------------------------------------------------
+template<typename Value>
+void
+returnToOrigin(const std::vector<Value>& values,
+               const std::vector<std::pair<unsigned, unsigned> >& origin,
+               std::vector<Value>& result,
+               const MPI_Comm comm = MPI_COMM_WORLD) {
+  POLY_ASSERT(values.size() == origin.size());
+  int numProcs;
+  MPI_Comm_size(comm, &numProcs);
+  const unsigned n = values.size();
+
+  // Group the values by their origin rank.
+  std::vector<int> sendCounts(numProcs, 0), offsets(numProcs, 0);
+  for (unsigned i = 0; i != n; ++i) {
+    POLY_ASSERT(origin[i].first < unsigned(numProcs));
+    ++sendCounts[origin[i].first];
+  }
+  for (int i = 1; i != numProcs; ++i) offsets[i] = offsets[i - 1] + sendCounts[i - 1];
+  std::vector<std::pair<unsigned, Value> > send(n), received;
+  for (unsigned i = 0; i != n; ++i) send[offsets[origin[i].first]++] = std::make_pair(origin[i].second, values[i]);
+  internal::exchangeAllToAll(send, sendCounts, received, comm);
+
+  // Every one of our original generators comes back exactly once.
+  result.resize(received.size());
+  for (unsigned i = 0; i != received.size(); ++i) {
+    POLY_ASSERT(received[i].first < result.size());
+    result[received[i].first] = received[i].second;
+  }
+}
+
+}
+
+#endif
@@ -135,7 +135,71 @@ void snapToBoundary(Tessellation<3, RealType>& mesh,
                     const vector<RealType>& points,
                     const PLC<3, RealType>& geometry,
                     const RealType degeneracy) {
-  POLY_ASSERT2(false, "Implement me!");
+
+  typedef Point3<RealType> RealPoint;
+
+  // Find the bounding box, and our tolerance for points being on the boundary.
+  RealPoint xmin, xmax;
+  RealType length;
+  geometry::computeBoundingBox<3, RealType>(&points[0], points.size(), true, &xmin.x, &xmax.x);
+  length = std::max(xmax.x - xmin.x, std::max(xmax.y - xmin.y, xmax.z - xmin.z));
+  const RealType tol = 4.0*degeneracy*length;
+
+  // Copy the boundary nodes to a std::set.
+  std::set<unsigned> boundaryNodes(mesh.boundaryNodes.begin(), mesh.boundaryNodes.end());
+
+  // Snap the nearest boundary node to each PLC point.  Unlike 2D, a PLC point
+  // need not be a mesh node: points in the interior of a flat region of the
+  // boundary (say a triangulated facet) are not corners of any cell.
+  for (unsigned ipoint = 0; ipoint < points.size()/3; ++ipoint) {
+    const RealPoint rp = RealPoint(points[3*ipoint], points[3*ipoint+1], points[3*ipoint+2]);
+    RealType dist = std::numeric_limits<RealType>::max();
+    unsigned inode;
+    for (set<unsigned>::iterator nodeItr = boundaryNodes.begin();
+         nodeItr != boundaryNodes.end();
+         ++nodeItr) {
+      const RealType dnew = geometry::distance<3, RealType>(&mesh.nodes[3*(*nodeItr)], &rp.x);
+      if (dnew < dist) {
+        inode = *nodeItr;
+        dist = dnew;
+      }
+    }
+    if (dist < tol) {
+      mesh.nodes[3*inode  ] = rp.x;
+      mesh.nodes[3*inode+1] = rp.y;
+      mesh.nodes[3*inode+2] = rp.z;
+      boundaryNodes.erase(inode);
+    }
+  }
+
+  // Snap all remaining boundary nodes to the nearest point on the boundary
+  for (set<unsigned>::iterator nodeItr = boundaryNodes.begin();
+       nodeItr != boundaryNodes.end();
+       ++nodeItr) {
+    RealPoint result;
+    RealType dist = nearestPoint(&mesh.nodes[3*(*nodeItr)],
+                                 points.size()/3,
+                                 &points[0],
+                                 geometry,
+                                 &result.x);
+    if (dist >= tol) {
+      cerr << "Possible internal boundary node "
+           << (*nodeItr) << " at ("
+           << mesh.nodes[3*(*nodeItr)  ] << ","
+           << mesh.nodes[3*(*nodeItr)+1] << ","
+           << mesh.nodes[3*(*nodeItr)+2] << ")";
+#ifndef NDEBUG
+      cerr << " wants to move distance " << dist << " to "
+           << "(" << result.x << "," << result.y << "," << result.z << ")";
+#endif
+      cerr << endl;
+    } else {
+      mesh.nodes[3*(*nodeItr)  ] = result.x;
+      mesh.nodes[3*(*nodeItr)+1] = result.y;
+      mesh.nodes[3*(*nodeItr)+2] = result.z;
+    }
+    POLY_ASSERT(dist < tol);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -149,5 +213,13 @@ template void snapToBoundary<double>(Tessellation<3, double>& mesh,
                                      const vector<double>& points,
                                      const PLC<3, double>& geometry,
                                      const double degeneracy);
+template void snapToBoundary<float>(Tessellation<2, float>& mesh,
+                                    const vector<float>& points,
+                                    const PLC<2, float>& geometry,
+                                    const float degeneracy);
+template void snapToBoundary<float>(Tessellation<3, float>& mesh,
+                                    const vector<float>& points,
+                                    const PLC<3, float>& geometry,
+                                    const float degeneracy);
 
 }
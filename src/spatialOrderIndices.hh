@@ -0,0 +1,218 @@
+//-----------------------------------------------------------------------------//
+// spatialOrderIndices
+//
+// Compute an ordering of a set of points along a space filling curve (Morton
+// or Hilbert), so that points which are close in the ordering are also close
+// in space.  Tessellators use this to hand generators to the underlying
+// Delaunay algorithms in a cache friendly order.
+//
+// The Hilbert keys use the transposed-axes algorithm described in
+// Skilling (2004), AIP Conference Proceedings, 707, 381-387.
+//----------------------------------------------------------------------------//
+#ifndef __Polytope_spatialOrderIndices__
+#define __Polytope_spatialOrderIndices__
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <stdint.h>
+
+#include "polytope_internal.hh"
+#include "polytope_geometric_utilities.hh"
+#include "Tessellation.hh"
+
+namespace polytope {
+
+//------------------------------------------------------------------------------
+// The orderings we know how to impose on a set of generators.
+//------------------------------------------------------------------------------
+enum SpatialSort {
+  NoSpatialSort = 0,
+  MortonSort = 1,
+  HilbertSort = 2
+};
+
+namespace internal {
+
+//------------------------------------------------------------------------------
+// The number of bits per dimension we quantize coordinates to, chosen so the
+// full key fits in 64 bits.
+//------------------------------------------------------------------------------
+template<int Dimension> struct SpatialKeyBits;
+template<> struct SpatialKeyBits<2> { static const unsigned value = 31U; };
+template<> struct SpatialKeyBits<3> { static const unsigned value = 21U; };
+
+//------------------------------------------------------------------------------
+// Interleave the bits of the quantized coordinates, most significant first.
+//------------------------------------------------------------------------------
+template<int Dimension>
+inline
+uint64_t
+interleaveBits(const uint32_t* X) {
+  const unsigned nbits = SpatialKeyBits<Dimension>::value;
+  uint64_t result = 0;
+  for (int b = nbits - 1; b >= 0; --b) {
+    for (unsigned j = 0; j != Dimension; ++j) {
+      result = (result << 1) | ((X[j] >> b) & 1U);
+    }
+  }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// Morton (Z-order) key.
+//------------------------------------------------------------------------------
+template<int Dimension>
+inline
+uint64_t
+mortonKey(const uint32_t* X) {
+  return interleaveBits<Dimension>(X);
+}
+
+//------------------------------------------------------------------------------
+// Hilbert key: convert the coordinates to the transposed Hilbert index in
+// place, then interleave.
+//------------------------------------------------------------------------------
+template<int Dimension>
+inline
+uint64_t
+hilbertKey(const uint32_t* Xin) {
+  const unsigned nbits = SpatialKeyBits<Dimension>::value;
+  uint32_t X[Dimension];
+  std::copy(Xin, Xin + Dimension, X);
+  const uint32_t M = 1U << (nbits - 1);
+  uint32_t P, Q, t;
+  unsigned i;
+
+  // Inverse undo.
+  for (Q = M; Q > 1; Q >>= 1) {
+    P = Q - 1;
+    for (i = 0; i != Dimension; ++i) {
+      if (X[i] & Q) {
+        X[0] ^= P;
+      } else {
+        t = (X[0] ^ X[i]) & P;
+        X[0] ^= t;
+        X[i] ^= t;
+      }
+    }
+  }
+
+  // Gray encode.
+  for (i = 1; i != Dimension; ++i) X[i] ^= X[i-1];
+  t = 0;
+  for (Q = M; Q > 1; Q >>= 1) {
+    if (X[Dimension-1] & Q) t ^= Q - 1;
+  }
+  for (i = 0; i != Dimension; ++i) X[i] ^= t;
+
+  return interleaveBits<Dimension>(X);
+}
+
+//------------------------------------------------------------------------------
+// The scaling from coordinates to the key lattice for points in the box
+// [xmin, xmax]: the same in every direction, so the curve is not distorted by
+// the aspect ratio of the box.
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+inline
+double
+spatialKeyScale(const RealType* xmin, const RealType* xmax) {
+  RealType box = 0;
+  for (unsigned j = 0; j != Dimension; ++j) box = std::max(box, xmax[j] - xmin[j]);
+  const uint32_t maxCoord = (1U << SpatialKeyBits<Dimension>::value) - 1U;
+  return (box > 0 ? double(maxCoord)/double(box) : 0.0);
+}
+
+//------------------------------------------------------------------------------
+// The key of the point x along the requested curve (Morton or Hilbert).
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+inline
+uint64_t
+spatialKey(const RealType* x,
+           const RealType* xmin,
+           const double scale,
+           const SpatialSort method) {
+  const uint32_t maxCoord = (1U << SpatialKeyBits<Dimension>::value) - 1U;
+  uint32_t X[Dimension];
+  for (unsigned j = 0; j != Dimension; ++j) {
+    const double xj = scale*double(x[j] - xmin[j]);
+    X[j] = std::min(maxCoord, uint32_t(std::max(0.0, xj)));
+  }
+  return (method == HilbertSort ? hilbertKey<Dimension>(X) : mortonKey<Dimension>(X));
+}
+
+}
+
+//------------------------------------------------------------------------------
+// Return the indices of the given (Dimension*n) coordinates sorted along the
+// requested space filling curve, i.e., result[i] is the index of the point
+// which comes ith along the curve.  Ties are broken by the original index, so
+// the ordering is deterministic.
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+std::vector<unsigned>
+spatialOrderIndices(const std::vector<RealType>& points,
+                    const SpatialSort method) {
+  POLY_ASSERT(points.size() % Dimension == 0);
+  const unsigned n = points.size()/Dimension;
+  std::vector<unsigned> result(n);
+  for (unsigned i = 0; i != n; ++i) result[i] = i;
+  if (method == NoSpatialSort or n < 2) return result;
+
+  // Quantize the coordinates on a uniform lattice covering the bounding box,
+  // using the same scaling in every direction so the curve is not distorted
+  // by the aspect ratio of the points.
+  RealType xmin[Dimension], xmax[Dimension];
+  geometry::computeBoundingBox<Dimension, RealType>(points, false, xmin, xmax);
+  const double scale = internal::spatialKeyScale<Dimension, RealType>(xmin, xmax);
+
+  std::vector<std::pair<uint64_t, unsigned> > keys(n);
+  for (unsigned i = 0; i != n; ++i) {
+    keys[i] = std::make_pair(internal::spatialKey<Dimension, RealType>(&points[Dimension*i], xmin, scale, method), i);
+  }
+  std::sort(keys.begin(), keys.end());
+  for (unsigned i = 0; i != n; ++i) result[i] = keys[i].second;
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// Given a tessellation of generators taken in the order returned by
+// spatialOrderIndices, renumber its cells back to the original generator
+// order.  Only the cell numbering changes: nodes and faces stay where they
+// are.  Does nothing if order is empty.
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+void
+restoreSpatialOrder(const std::vector<unsigned>& order,
+                    Tessellation<Dimension, RealType>& mesh) {
+  if (order.empty()) return;
+  const unsigned n = order.size();
+  POLY_ASSERT(mesh.cells.size() == n);
+
+  // Cells.
+  std::vector<std::vector<int> > cells(n);
+  for (unsigned i = 0; i != n; ++i) cells[order[i]].swap(mesh.cells[i]);
+  mesh.cells.swap(cells);
+
+  // Face->cell connectivity, preserving the orientation flag.
+  for (unsigned k = 0; k != mesh.faceCells.size(); ++k) {
+    for (unsigned j = 0; j != mesh.faceCells[k].size(); ++j) {
+      const int i = mesh.faceCells[k][j];
+      POLY_ASSERT(unsigned(internal::positiveID(i)) < n);
+      mesh.faceCells[k][j] = (i < 0 ? ~int(order[~i]) : int(order[i]));
+    }
+  }
+
+  // The convex hull (if any) is expressed in generator indices.
+  for (unsigned k = 0; k != mesh.convexHull.facets.size(); ++k) {
+    for (unsigned j = 0; j != mesh.convexHull.facets[k].size(); ++j) {
+      mesh.convexHull.facets[k][j] = order[mesh.convexHull.facets[k][j]];
+    }
+  }
+}
+
+}
+
+#endif
@@ -0,0 +1,145 @@
+//------------------------------------------------------------------------------
+// The process wide totals behind the instrumentation in timingUtilities.hh.
+//------------------------------------------------------------------------------
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <sstream>
+#include <iomanip>
+
+#include "timingUtilities.hh"
+
+namespace polytope {
+
+namespace {
+
+struct TimerTotal {
+  double seconds;
+  unsigned calls;
+  TimerTotal(): seconds(0.0), calls(0) {}
+};
+
+std::atomic<bool> timersOn(false);
+std::mutex timersMutex;
+std::map<std::string, TimerTotal> timerTotals;
+std::map<std::string, uint64_t> counterTotals;
+
+}
+
+//------------------------------------------------------------------------------
+void
+enableTimers(const bool enable) {
+  timersOn.store(enable);
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+bool
+timersEnabled() {
+  return timersOn.load(std::memory_order_relaxed);
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+void
+resetTimers() {
+  std::lock_guard<std::mutex> lock(timersMutex);
+  timerTotals.clear();
+  counterTotals.clear();
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+void
+addTimerSeconds(const char* name, const double seconds) {
+  if (timersEnabled()) {
+    std::lock_guard<std::mutex> lock(timersMutex);
+    TimerTotal& total = timerTotals[name];
+    total.seconds += seconds;
+    ++total.calls;
+  }
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+void
+incrementCounter(const char* name, const uint64_t n) {
+  if (timersEnabled()) {
+    std::lock_guard<std::mutex> lock(timersMutex);
+    counterTotals[name] += n;
+  }
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+double
+timerSeconds(const std::string& name) {
+  std::lock_guard<std::mutex> lock(timersMutex);
+  std::map<std::string, TimerTotal>::const_iterator itr = timerTotals.find(name);
+  return (itr == timerTotals.end() ? 0.0 : itr->second.seconds);
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+unsigned
+timerCalls(const std::string& name) {
+  std::lock_guard<std::mutex> lock(timersMutex);
+  std::map<std::string, TimerTotal>::const_iterator itr = timerTotals.find(name);
+  return (itr == timerTotals.end() ? 0 : itr->second.calls);
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+uint64_t
+counterValue(const std::string& name) {
+  std::lock_guard<std::mutex> lock(timersMutex);
+  std::map<std::string, uint64_t>::const_iterator itr = counterTotals.find(name);
+  return (itr == counterTotals.end() ? 0 : itr->second);
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+std::vector<std::string>
+timerNames() {
+  std::lock_guard<std::mutex> lock(timersMutex);
+  std::vector<std::string> result;
+  for (std::map<std::string, TimerTotal>::const_iterator itr = timerTotals.begin();
+       itr != timerTotals.end(); ++itr) result.push_back(itr->first);
+  return result;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+std::vector<std::string>
+counterNames() {
+  std::lock_guard<std::mutex> lock(timersMutex);
+  std::vector<std::string> result;
+  for (std::map<std::string, uint64_t>::const_iterator itr = counterTotals.begin();
+       itr != counterTotals.end(); ++itr) result.push_back(itr->first);
+  return result;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+std::string
+timersReport() {
+  std::lock_guard<std::mutex> lock(timersMutex);
+  std::ostringstream os;
+  os << std::left << std::setw(32) << "Timer" << std::right
+     << std::setw(10) << "calls" << std::setw(16) << "seconds" << std::endl;
+  for (std::map<std::string, TimerTotal>::const_iterator itr = timerTotals.begin();
+       itr != timerTotals.end(); ++itr) {
+    os << std::left << std::setw(32) << itr->first << std::right
+       << std::setw(10) << itr->second.calls
+       << std::setw(16) << std::scientific << std::setprecision(6) << itr->second.seconds << std::endl;
+  }
+  os << std::left << std::setw(32) << "Counter" << std::right << std::setw(26) << "value" << std::endl;
+  for (std::map<std::string, uint64_t>::const_iterator itr = counterTotals.begin();
+       itr != counterTotals.end(); ++itr) {
+    os << std::left << std::setw(32) << itr->first << std::right << std::setw(26) << itr->second << std::endl;
+  }
+  return os.str();
+}
+//------------------------------------------------------------------------------
+
+}
@@ -4,23 +4,95 @@
 // A set of inline helper methods to encapsulate how we do timing.
 //
 // JMO:  Tue Dec  9 10:31:14 PST 2008
+//
+// Also the opt-in instrumentation of the tessellation pipeline.  The stages
+// of tessellate (the Delaunay construction, the Voronoi walk, clipping,
+// fillTessellation, findBoundaryElements, snapToBoundary, the MPI exchanges,
+// ...) are wrapped in ScopedTimers, and a few counters record how much work
+// each did.  Nothing is recorded until enableTimers() is called, and when
+// disabled a timer costs one flag check.  The results accumulate across
+// calls until resetTimers(), so the usual pattern is
+//
+//   enableTimers();
+//   resetTimers();
+//   tessellator.tessellate(points, low, high, mesh);
+//   std::cout << timersReport();
+//
+// The totals are process wide and safe to update from several threads.
 //------------------------------------------------------------------------------
-#ifdef HAVE_BOOST
+#ifndef __polytope_timingUtilities__
+#define __polytope_timingUtilities__
 
-#define BOOST_DATE_TIME_POSIX_TIME_STD_CONFIG     // Enable nanosecond timings.
-#include <boost/date_time/posix_time/posix_time.hpp>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <stdint.h>
 
 namespace polytope {
 //------------------------------------------------------------------------------
 // Get the current clock time.
 //------------------------------------------------------------------------------
 struct Timing {
-  typedef boost::posix_time::ptime Time;
-  typedef boost::posix_time::time_duration duration;
-  static Time currentTime() { return boost::posix_time::microsec_clock::local_time(); }
-  static double convertToSeconds(const duration& delta) { return double(delta.total_nanoseconds())/1e9; }
+  typedef std::chrono::steady_clock::time_point Time;
+  typedef std::chrono::steady_clock::duration duration;
+  static Time currentTime() { return std::chrono::steady_clock::now(); }
+  static double convertToSeconds(const duration& delta) { return std::chrono::duration<double>(delta).count(); }
   static double difference(const Time& t1, const Time& t2) { return convertToSeconds(t2 - t1); }
 };
+
+//------------------------------------------------------------------------------
+// Turn the instrumentation on or off, and clear what has been recorded.
+//------------------------------------------------------------------------------
+void enableTimers(const bool enable = true);
+bool timersEnabled();
+void resetTimers();
+
+//------------------------------------------------------------------------------
+// Record time spent in a named stage, or add to a named counter.  These do
+// nothing unless the timers are enabled.
+//------------------------------------------------------------------------------
+void addTimerSeconds(const char* name, const double seconds);
+void incrementCounter(const char* name, const uint64_t n = 1);
+
+//------------------------------------------------------------------------------
+// Query the totals.  Unknown names read as zero.
+//------------------------------------------------------------------------------
+double timerSeconds(const std::string& name);
+unsigned timerCalls(const std::string& name);
+uint64_t counterValue(const std::string& name);
+std::vector<std::string> timerNames();
+std::vector<std::string> counterNames();
+
+// A table of every timer and counter, one per line.
+std::string timersReport();
+
+//------------------------------------------------------------------------------
+// Time the enclosing scope, or up to the call to stop().
+//------------------------------------------------------------------------------
+class ScopedTimer {
+public:
+  explicit ScopedTimer(const char* name):
+    mName(name),
+    mRunning(timersEnabled()) {
+    if (mRunning) mStart = Timing::currentTime();
+  }
+  ~ScopedTimer() { stop(); }
+  void stop() {
+    if (mRunning) {
+      addTimerSeconds(mName, Timing::difference(mStart, Timing::currentTime()));
+      mRunning = false;
+    }
+  }
+private:
+  const char* mName;
+  bool mRunning;
+  Timing::Time mStart;
+
+  // Disallowed.
+  ScopedTimer(const ScopedTimer&);
+  ScopedTimer& operator=(const ScopedTimer&);
+};
+
 }
 
 #endif
@@ -0,0 +1,140 @@
+// -----------------------------------------------------------------------
+// test_AsyncWriter
+//
+// Check AsyncWriter writes copies of the tessellations it's handed, in
+// order, holds no more than its limit of pending writes, and reports
+// failures through the completion handles.
+// -----------------------------------------------------------------------
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <stdexcept>
+#include <future>
+
+#include "polytope.hh"
+#include "AsyncWriter.hh"
+#include "BinaryReader.hh"
+#include "polytope_test_utilities.hh"
+
+#ifdef HAVE_MPI
+#include "mpi.h"
+#endif
+
+using namespace std;
+using namespace polytope;
+
+// -----------------------------------------------------------------------
+// The unit square as a single cell.
+// -----------------------------------------------------------------------
+void
+unitSquare(Tessellation<2, double>& mesh) {
+  mesh.clear();
+  const double x[8] = {0.0, 0.0, 1.0, 0.0, 1.0, 1.0, 0.0, 1.0};
+  mesh.nodes.assign(x, x + 8);
+  mesh.cells.resize(1);
+  for (unsigned i = 0; i != 4; ++i) {
+    mesh.faces.push_back(vector<unsigned>());
+    mesh.faces.back().push_back(i);
+    mesh.faces.back().push_back((i + 1) % 4);
+    mesh.faceCells.push_back(vector<int>(1, 0));
+    mesh.cells[0].push_back(i);
+    mesh.boundaryNodes.push_back(i);
+    mesh.boundaryFaces.push_back(i);
+  }
+}
+
+// -----------------------------------------------------------------------
+// main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+#ifdef HAVE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  typedef AsyncWriter<2, double> Writer;
+  Tessellation<2, double> mesh;
+  unitSquare(mesh);
+
+  // The writer works from a copy: changing the mesh once write() returns
+  // doesn't change what's written.
+  {
+    Writer writer;
+    promise<void> gate;
+    shared_future<void> open = gate.get_future().share();
+    vector<double> written;
+    Writer::Handle handle = writer.write(mesh, [&](const Tessellation<2, double>& m) {
+        open.wait();
+        written = m.nodes;
+      });
+    const vector<double> nodes0 = mesh.nodes;
+    for (unsigned i = 0; i != mesh.nodes.size(); ++i) mesh.nodes[i] += 1.0;
+    POLY_CHECK(writer.numPending() == 1);
+    gate.set_value();
+    handle.get();
+    POLY_CHECK(written == nodes0);
+    POLY_CHECK(writer.numPending() == 0);
+    unitSquare(mesh);
+  }
+
+  // Writes happen in order, and never more than maxPending at once.
+  {
+    Writer writer(2);
+    vector<int> order;
+    unsigned maxSeen = 0;
+    for (int i = 0; i != 10; ++i) {
+      writer.write(mesh, [&, i](const Tessellation<2, double>&) {
+          order.push_back(i);
+          maxSeen = max(maxSeen, writer.numPending());
+        });
+      POLY_CHECK(writer.numPending() <= 2);
+    }
+    writer.wait();
+    POLY_CHECK(order.size() == 10);
+    for (int i = 0; i != 10; ++i) POLY_CHECK(order[i] == i);
+    POLY_CHECK(maxSeen <= 2);
+  }
+
+  // Failures come back through the handle, and don't stop later writes.
+  {
+    Writer writer;
+    Writer::Handle bad = writer.write(mesh, [](const Tessellation<2, double>&) {
+        throw runtime_error("write failed");
+      });
+    bool ok = false;
+    Writer::Handle good = writer.write(mesh, [&](const Tessellation<2, double>&) { ok = true; });
+    bool threw = false;
+    try {
+      bad.get();
+    } catch (const runtime_error&) {
+      threw = true;
+    }
+    POLY_CHECK(threw);
+    good.get();
+    POLY_CHECK(ok);
+  }
+
+  // Binary files, finished by the time the writer is destroyed.
+  {
+    const string fileName = "test_AsyncWriter.ptess";
+    {
+      Writer writer;
+      writer.writeBinary(mesh, fileName);
+    }
+    Tessellation<2, double> mesh1;
+    BinaryReader<2, double>::read(mesh1, fileName);
+    POLY_CHECK(mesh1.nodes == mesh.nodes);
+    POLY_CHECK(mesh1.cells == mesh.cells);
+    POLY_CHECK(mesh1.faces == mesh.faces);
+    remove(fileName.c_str());
+  }
+
+  cout << "PASS" << endl;
+
+#ifdef HAVE_MPI
+  MPI_Finalize();
+#endif
+  return 0;
+}
@@ -0,0 +1,202 @@
+// -----------------------------------------------------------------------
+// test_BinaryIO
+//
+// Write tessellations with BinaryWriter, and check BinaryReader hands back
+// the same arrays both through its mapped views and copied into a
+// Tessellation.
+// -----------------------------------------------------------------------
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdio>
+
+#include "polytope.hh"
+#include "BinaryWriter.hh"
+#include "BinaryReader.hh"
+#include "polytope_test_utilities.hh"
+
+#ifdef HAVE_MPI
+#include "mpi.h"
+#endif
+
+using namespace std;
+using namespace polytope;
+
+// -----------------------------------------------------------------------
+// An nx x nx lattice of unit squares.
+// -----------------------------------------------------------------------
+void
+latticeMesh(const unsigned nx, Tessellation<2, double>& mesh) {
+  mesh.clear();
+  for (unsigned j = 0; j != nx + 1; ++j) {
+    for (unsigned i = 0; i != nx + 1; ++i) {
+      mesh.nodes.push_back(i);
+      mesh.nodes.push_back(j);
+    }
+  }
+  mesh.cells.resize(nx*nx);
+  // x faces, then y faces.
+  for (unsigned j = 0; j != nx; ++j) {
+    for (unsigned i = 0; i != nx + 1; ++i) {
+      const int iface = mesh.faces.size();
+      mesh.faces.push_back(vector<unsigned>());
+      mesh.faces.back().push_back(j*(nx + 1) + i);
+      mesh.faces.back().push_back((j + 1)*(nx + 1) + i);
+      mesh.faceCells.push_back(vector<int>());
+      if (i > 0) {
+        mesh.faceCells.back().push_back(j*nx + i - 1);
+        mesh.cells[j*nx + i - 1].push_back(~iface);
+      }
+      if (i < nx) {
+        mesh.faceCells.back().push_back(~int(j*nx + i));
+        mesh.cells[j*nx + i].push_back(iface);
+      }
+      if (i == 0 or i == nx) mesh.boundaryFaces.push_back(iface);
+    }
+  }
+  for (unsigned j = 0; j != nx + 1; ++j) {
+    for (unsigned i = 0; i != nx; ++i) {
+      const int iface = mesh.faces.size();
+      mesh.faces.push_back(vector<unsigned>());
+      mesh.faces.back().push_back(j*(nx + 1) + i + 1);
+      mesh.faces.back().push_back(j*(nx + 1) + i);
+      mesh.faceCells.push_back(vector<int>());
+      if (j > 0) {
+        mesh.faceCells.back().push_back(~int((j - 1)*nx + i));
+        mesh.cells[(j - 1)*nx + i].push_back(~iface);
+      }
+      if (j < nx) {
+        mesh.faceCells.back().push_back(j*nx + i);
+        mesh.cells[j*nx + i].push_back(iface);
+      }
+      if (j == 0 or j == nx) mesh.boundaryFaces.push_back(iface);
+    }
+  }
+  for (unsigned i = 0; i != (nx + 1)*(nx + 1); ++i) {
+    const unsigned ix = i % (nx + 1), iy = i/(nx + 1);
+    if (ix == 0 or ix == nx or iy == 0 or iy == nx) mesh.boundaryNodes.push_back(i);
+  }
+}
+
+// -----------------------------------------------------------------------
+// Check a reader matches the tessellation it was written from.
+// -----------------------------------------------------------------------
+template<int Dimension>
+void
+checkViews(const BinaryReader<Dimension, double>& reader,
+           const Tessellation<Dimension, double>& mesh) {
+  POLY_CHECK(reader.numNodes() == mesh.nodes.size()/Dimension);
+  POLY_CHECK(reader.numCells() == mesh.cells.size());
+  POLY_CHECK(reader.numFaces() == mesh.faces.size());
+  POLY_CHECK(vector<double>(reader.nodes().begin(), reader.nodes().end()) == mesh.nodes);
+  for (unsigned i = 0; i != mesh.cells.size(); ++i) {
+    POLY_CHECK(vector<int>(reader.cells()[i].begin(), reader.cells()[i].end()) == mesh.cells[i]);
+  }
+  for (unsigned i = 0; i != mesh.faces.size(); ++i) {
+    POLY_CHECK(vector<unsigned>(reader.faces()[i].begin(), reader.faces()[i].end()) == mesh.faces[i]);
+    POLY_CHECK(vector<int>(reader.faceCells()[i].begin(), reader.faceCells()[i].end()) == mesh.faceCells[i]);
+  }
+  POLY_CHECK(vector<unsigned>(reader.boundaryFaces().begin(), reader.boundaryFaces().end()) == mesh.boundaryFaces);
+}
+
+template<int Dimension>
+void
+checkCopy(const Tessellation<Dimension, double>& mesh0,
+          const Tessellation<Dimension, double>& mesh1) {
+  POLY_CHECK(mesh1.nodes == mesh0.nodes);
+  POLY_CHECK(mesh1.cells == mesh0.cells);
+  POLY_CHECK(mesh1.faces == mesh0.faces);
+  POLY_CHECK(mesh1.faceCells == mesh0.faceCells);
+  POLY_CHECK(mesh1.boundaryNodes == mesh0.boundaryNodes);
+  POLY_CHECK(mesh1.boundaryFaces == mesh0.boundaryFaces);
+  POLY_CHECK(mesh1.neighborDomains == mesh0.neighborDomains);
+  POLY_CHECK(mesh1.sharedNodes == mesh0.sharedNodes);
+  POLY_CHECK(mesh1.sharedFaces == mesh0.sharedFaces);
+  POLY_CHECK(mesh1.periodicFaces == mesh0.periodicFaces);
+  POLY_CHECK(mesh1.periodicFaceShifts == mesh0.periodicFaceShifts);
+}
+
+// -----------------------------------------------------------------------
+// main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+#ifdef HAVE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  const string fileName = "test_BinaryIO.ptess";
+
+  // A 2D lattice, with some parallel and periodic data made up.
+  {
+    Tessellation<2, double> mesh;
+    latticeMesh(5, mesh);
+    mesh.neighborDomains.push_back(1);
+    mesh.neighborDomains.push_back(3);
+    mesh.sharedNodes.resize(2);
+    mesh.sharedFaces.resize(2);
+    for (unsigned i = 0; i != 6; ++i) mesh.sharedNodes[0].push_back(6*i + 5);
+    for (unsigned i = 0; i != 5; ++i) mesh.sharedFaces[0].push_back(6*i + 5);
+    mesh.sharedNodes[1].push_back(35);
+    mesh.periodicFaces.push_back(0);
+    mesh.periodicFaceShifts.push_back(-1);
+    mesh.periodicFaceShifts.push_back(0);
+    BinaryWriter<2, double>::write(mesh, fileName);
+
+    BinaryReader<2, double> reader(fileName);
+    POLY_CHECK(reader.isOpen());
+    checkViews(reader, mesh);
+    POLY_CHECK(reader.sharedNodes().size() == 2);
+    POLY_CHECK(reader.sharedNodes()[1].size() == 1 and reader.sharedNodes()[1][0] == 35);
+    POLY_CHECK(reader.sharedFaces()[1].empty());
+    Tessellation<2, double> mesh1;
+    reader.read(mesh1);
+    checkCopy(mesh, mesh1);
+    reader.close();
+    POLY_CHECK(not reader.isOpen());
+  }
+
+  // An empty tessellation.
+  {
+    Tessellation<2, double> mesh, mesh1;
+    BinaryWriter<2, double>::write(mesh, fileName);
+    BinaryReader<2, double>::read(mesh1, fileName);
+    POLY_CHECK(mesh1.empty());
+  }
+
+  // A 3D unit cube.
+  {
+    Tessellation<3, double> mesh;
+    for (unsigned i = 0; i != 8; ++i) {
+      for (unsigned j = 0; j != 3; ++j) mesh.nodes.push_back(double((i >> j) & 1));
+    }
+    const unsigned faces[6][4] = {{0, 4, 6, 2}, {1, 3, 7, 5},
+                                  {0, 1, 5, 4}, {2, 6, 7, 3},
+                                  {0, 2, 3, 1}, {4, 5, 7, 6}};
+    mesh.cells.resize(1);
+    for (unsigned i = 0; i != 6; ++i) {
+      mesh.faces.push_back(vector<unsigned>(faces[i], faces[i] + 4));
+      mesh.faceCells.push_back(vector<int>(1, 0));
+      mesh.cells[0].push_back(i);
+      mesh.boundaryFaces.push_back(i);
+    }
+    for (unsigned i = 0; i != 8; ++i) mesh.boundaryNodes.push_back(i);
+    BinaryWriter<3, double>::write(mesh, fileName);
+
+    BinaryReader<3, double> reader(fileName);
+    checkViews(reader, mesh);
+    Tessellation<3, double> mesh1;
+    reader.read(mesh1);
+    checkCopy(mesh, mesh1);
+  }
+
+  remove(fileName.c_str());
+
+  cout << "PASS" << endl;
+
+#ifdef HAVE_MPI
+  MPI_Finalize();
+#endif
+  return 0;
+}
@@ -0,0 +1,171 @@
+// -----------------------------------------------------------------------
+// test_CentroidalRelaxation
+//
+// Relax random generators toward a centroidal Voronoi tessellation with
+// CentroidalRelaxation, and check it against hand rolled Lloyd iterations.
+// Triangle and Boost tessellators are tested here.
+// -----------------------------------------------------------------------
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "polytope.hh"
+#include "CentroidalRelaxation.hh"
+#include "polytope_test_utilities.hh"
+
+#ifdef HAVE_MPI
+#include "mpi.h"
+#endif
+
+using namespace std;
+using namespace polytope;
+
+namespace {
+
+//------------------------------------------------------------------------------
+// One hand rolled Lloyd iteration in a box.
+//------------------------------------------------------------------------------
+void lloyd(const Tessellator<2, double>& tessellator,
+           vector<double>& points,
+           double* low,
+           double* high) {
+  Tessellation<2, double> mesh;
+  tessellator.tessellate(points, low, high, mesh);
+  for (unsigned i = 0; i != mesh.cells.size(); ++i) {
+    double cent[2], area;
+    geometry::computeCellCentroidAndSignedArea(mesh, i, 1.0e-12, cent, area);
+    points[2*i  ] = cent[0];
+    points[2*i+1] = cent[1];
+  }
+}
+
+//------------------------------------------------------------------------------
+// The largest distance from a generator to the centroid of its cell.
+//------------------------------------------------------------------------------
+double maxCentroidDistance(const Tessellation<2, double>& mesh,
+                           const vector<double>& points) {
+  double result = 0.0;
+  for (unsigned i = 0; i != mesh.cells.size(); ++i) {
+    double cent[2], area;
+    geometry::computeCellCentroidAndSignedArea(mesh, i, 1.0e-12, cent, area);
+    result = max(result, geometry::distance<2, double>(cent, &points[2*i]));
+  }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// Relax in a box and in a PLC.
+//------------------------------------------------------------------------------
+void testTessellator(Tessellator<2, double>& tessellator) {
+  const unsigned n = 100;
+  double low[2] = {0.0, 0.0}, high[2] = {1.0, 1.0};
+  vector<double> points0;
+  for (unsigned i = 0; i != 2*n; ++i) points0.push_back(random01());
+
+  // A few iterations match doing it by hand, whatever order the generators
+  // are tessellated in.
+  {
+    vector<double> expected = points0;
+    for (unsigned k = 0; k != 4; ++k) lloyd(tessellator, expected, low, high);
+    const SpatialSort methods[2] = {NoSpatialSort, HilbertSort};
+    for (unsigned m = 0; m != 2; ++m) {
+      CentroidalRelaxation<2, double> cvt(tessellator, 4, 0.0);
+      cvt.spatialSort(methods[m]);
+      vector<double> points = points0;
+      Tessellation<2, double> mesh;
+      const unsigned niter = cvt.relax(points, low, high, mesh);
+      POLY_CHECK(niter == 5);
+      POLY_CHECK(not cvt.converged());
+      POLY_CHECK(cvt.tessellateTimes().size() == 5 and cvt.centroidTimes().size() == 5);
+      for (unsigned i = 0; i != 2*n; ++i) {
+        POLY_CHECK2(std::abs(points[i] - expected[i]) < 1.0e-10,
+                    "Generator " << i/2 << " " << points[i] << " != " << expected[i]);
+      }
+      POLY_CHECK(mesh.cells.size() == n);
+    }
+  }
+
+  // Run to convergence in the box.
+  {
+    CentroidalRelaxation<2, double> cvt(tessellator, 500, 1.0e-3);
+    vector<double> points = points0;
+    Tessellation<2, double> mesh;
+    const unsigned niter = cvt.relax(points, low, high, mesh);
+    POLY_CHECK(cvt.converged());
+    POLY_CHECK(niter == cvt.displacements().size());
+    POLY_CHECK(cvt.displacements().back() <= 1.0e-3);
+    POLY_CHECK(cvt.displacements().front() > cvt.displacements().back());
+    POLY_CHECK(maxCentroidDistance(mesh, points) <= 1.0e-3);
+    double tessellateTime = 0.0, centroidTime = 0.0;
+    for (unsigned k = 0; k != niter; ++k) {
+      tessellateTime += cvt.tessellateTimes()[k];
+      centroidTime += cvt.centroidTimes()[k];
+    }
+    cout << "   Box: converged in " << niter << " iterations, "
+         << tessellateTime << " s tessellating, " << centroidTime << " s in centroids." << endl;
+  }
+
+  // Under relaxation in a PLC.
+  if (tessellator.handlesPLCs()) {
+    const double coords[12] = {0.0, 0.0, 1.0, 0.0, 1.0, 0.5,
+                               0.5, 0.5, 0.5, 1.0, 0.0, 1.0};
+    const vector<double> PLCpoints(coords, coords + 12);
+    PLC<2, double> boundary;
+    boundary.facets.resize(6, vector<int>(2));
+    for (unsigned i = 0; i != 6; ++i) {
+      boundary.facets[i][0] = i;
+      boundary.facets[i][1] = (i + 1) % 6;
+    }
+    vector<double> points;
+    for (unsigned i = 0; i != n; ++i) {
+      if (points0[2*i] < 0.5 or points0[2*i+1] < 0.5) {
+        points.push_back(points0[2*i]);
+        points.push_back(points0[2*i+1]);
+      }
+    }
+    CentroidalRelaxation<2, double> cvt(tessellator, 500, 1.0e-3, 0.75);
+    Tessellation<2, double> mesh;
+    const unsigned niter = cvt.relax(points, PLCpoints, boundary, mesh);
+    POLY_CHECK(cvt.converged());
+    POLY_CHECK(mesh.cells.size() == points.size()/2);
+    POLY_CHECK(maxCentroidDistance(mesh, points) <= 1.0e-3);
+    cout << "   PLC: converged in " << niter << " iterations." << endl;
+  }
+}
+
+}
+
+// -----------------------------------------------------------------------
+// main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+#ifdef HAVE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+#ifdef HAVE_TRIANGLE
+  {
+    cout << "\nTriangle Tessellator:\n" << endl;
+    TriangleTessellator<double> tessellator;
+    testTessellator(tessellator);
+  }
+#endif
+
+#ifdef HAVE_BOOST_VORONOI
+  {
+    cout << "\nBoost Tessellator:\n" << endl;
+    BoostTessellator<double> tessellator;
+    testTessellator(tessellator);
+  }
+#endif
+
+  cout << "PASS" << endl;
+
+#ifdef HAVE_MPI
+  MPI_Finalize();
+#endif
+  return 0;
+}
@@ -0,0 +1,178 @@
+// -----------------------------------------------------------------------
+// test_DeleteCells
+//
+// Delete random subsets of the cells of a tessellation with deleteCells and
+// check the surviving cells are unchanged, the remaining mesh is consistent,
+// and the shared node/face lists are renumbered to match.
+// -----------------------------------------------------------------------
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "polytope.hh"
+#include "deleteCells.hh"
+#include "computeMeshGeometry.hh"
+#include "polytope_test_utilities.hh"
+
+#ifdef HAVE_MPI
+#include "mpi.h"
+#endif
+
+using namespace std;
+using namespace polytope;
+
+namespace {
+
+//------------------------------------------------------------------------------
+// Check the faces and cells refer to each other consistently, and that
+// every face and node is used.
+//------------------------------------------------------------------------------
+template<int Dimension, typename RealType>
+void checkTopology(const Tessellation<Dimension, RealType>& mesh) {
+  const unsigned nnodes = mesh.nodes.size()/Dimension;
+  POLY_CHECK(mesh.faceCells.size() == mesh.faces.size());
+  vector<unsigned> faceUses(mesh.faces.size(), 0), nodeUses(nnodes, 0);
+  for (unsigned i = 0; i != mesh.cells.size(); ++i) {
+    for (unsigned k = 0; k != mesh.cells[i].size(); ++k) {
+      const int iface = mesh.cells[i][k];
+      const unsigned fi = internal::positiveID(iface);
+      POLY_CHECK(fi < mesh.faces.size());
+      ++faceUses[fi];
+      const int expected = (iface < 0 ? ~int(i) : int(i));
+      POLY_CHECK(count(mesh.faceCells[fi].begin(), mesh.faceCells[fi].end(), expected) == 1);
+    }
+  }
+  for (unsigned fi = 0; fi != mesh.faces.size(); ++fi) {
+    POLY_CHECK(faceUses[fi] == mesh.faceCells[fi].size());
+    for (unsigned k = 0; k != mesh.faces[fi].size(); ++k) {
+      POLY_CHECK(mesh.faces[fi][k] < nnodes);
+      ++nodeUses[mesh.faces[fi][k]];
+    }
+  }
+  POLY_CHECK(count(faceUses.begin(), faceUses.end(), 0) == 0);
+  POLY_CHECK(count(nodeUses.begin(), nodeUses.end(), 0) == 0);
+}
+
+//------------------------------------------------------------------------------
+// Delete the cells where mask is 0 from a copy of mesh and check the result.
+//------------------------------------------------------------------------------
+void testMask(const Tessellation<2, double>& mesh0,
+              const vector<unsigned>& mask) {
+  Tessellation<2, double> mesh;
+  mesh.nodes = mesh0.nodes;
+  mesh.cells = mesh0.cells;
+  mesh.faces = mesh0.faces;
+  mesh.faceCells = mesh0.faceCells;
+
+  // Share every third node and face with a pretend neighbor, so we can
+  // check they are renumbered to the same positions.
+  mesh.neighborDomains.push_back(1);
+  mesh.sharedNodes.resize(1);
+  mesh.sharedFaces.resize(1);
+  for (unsigned i = 0; i < mesh.nodes.size()/2; i += 3) mesh.sharedNodes[0].push_back(i);
+  for (unsigned i = 0; i < mesh.faces.size(); i += 3) mesh.sharedFaces[0].push_back(i);
+  vector<double> sharedNodePositions, sharedFacePositions;
+  vector<double> cellVolumes0, cellCentroids0, faceAreas0, faceNormals0, faceCentroids0;
+  computeMeshGeometry(mesh0, cellVolumes0, cellCentroids0, faceAreas0, faceNormals0, faceCentroids0);
+  {
+    vector<unsigned> nodeUsed(mesh.nodes.size()/2, 0), faceUsed(mesh.faces.size(), 0);
+    for (unsigned i = 0; i != mesh.cells.size(); ++i) {
+      if (mask[i] == 0) continue;
+      for (unsigned k = 0; k != mesh.cells[i].size(); ++k) {
+        const unsigned fi = internal::positiveID(mesh.cells[i][k]);
+        faceUsed[fi] = 1;
+        nodeUsed[mesh.faces[fi][0]] = nodeUsed[mesh.faces[fi][1]] = 1;
+      }
+    }
+    for (unsigned k = 0; k != mesh.sharedNodes[0].size(); ++k) {
+      const unsigned i = mesh.sharedNodes[0][k];
+      if (nodeUsed[i] == 1) sharedNodePositions.insert(sharedNodePositions.end(), &mesh.nodes[2*i], &mesh.nodes[2*i] + 2);
+    }
+    for (unsigned k = 0; k != mesh.sharedFaces[0].size(); ++k) {
+      const unsigned i = mesh.sharedFaces[0][k];
+      if (faceUsed[i] == 1) sharedFacePositions.insert(sharedFacePositions.end(), &faceCentroids0[2*i], &faceCentroids0[2*i] + 2);
+    }
+  }
+
+  deleteCells(mesh, mask);
+  const unsigned nkeep = count(mask.begin(), mask.end(), 1U);
+  POLY_CHECK(mesh.cells.size() == nkeep);
+  checkTopology(mesh);
+
+  // The surviving cells are the same shapes, in the same order.
+  vector<double> cellVolumes, cellCentroids, faceAreas, faceNormals, faceCentroids;
+  computeMeshGeometry(mesh, cellVolumes, cellCentroids, faceAreas, faceNormals, faceCentroids);
+  unsigned j = 0;
+  for (unsigned i = 0; i != mask.size(); ++i) {
+    if (mask[i] == 1) {
+      POLY_CHECK2(std::abs(cellVolumes[j] - cellVolumes0[i]) < 1.0e-14,
+                  "Cell " << i << " -> " << j << " changed area");
+      POLY_CHECK(std::abs(cellCentroids[2*j] - cellCentroids0[2*i]) < 1.0e-14 and
+                 std::abs(cellCentroids[2*j + 1] - cellCentroids0[2*i + 1]) < 1.0e-14);
+      ++j;
+    }
+  }
+
+  // The shared elements still point at the same places.
+  vector<double> positions;
+  for (unsigned k = 0; k != mesh.sharedNodes[0].size(); ++k) {
+    const unsigned i = mesh.sharedNodes[0][k];
+    positions.insert(positions.end(), &mesh.nodes[2*i], &mesh.nodes[2*i] + 2);
+  }
+  POLY_CHECK(positions == sharedNodePositions);
+  positions.clear();
+  for (unsigned k = 0; k != mesh.sharedFaces[0].size(); ++k) {
+    const unsigned i = mesh.sharedFaces[0][k];
+    positions.insert(positions.end(), &faceCentroids[2*i], &faceCentroids[2*i] + 2);
+  }
+  POLY_CHECK(positions == sharedFacePositions);
+}
+
+}
+
+// -----------------------------------------------------------------------
+// main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+#ifdef HAVE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+#ifdef HAVE_BOOST_VORONOI
+  {
+    const unsigned n = 1000;
+    vector<double> points;
+    for (unsigned i = 0; i != 2*n; ++i) points.push_back(random01());
+    double low[2] = {0.0, 0.0}, high[2] = {1.0, 1.0};
+    BoostTessellator<double> tessellator;
+    Tessellation<2, double> mesh;
+    tessellator.tessellate(points, low, high, mesh);
+    checkTopology(mesh);
+
+    // Keep everything, a random half, a random few, and a single cell.
+    vector<unsigned> mask(n, 1);
+    cout << "Keep all" << endl;
+    testMask(mesh, mask);
+    cout << "Keep half" << endl;
+    for (unsigned i = 0; i != n; ++i) mask[i] = (random01() < 0.5 ? 1 : 0);
+    testMask(mesh, mask);
+    cout << "Keep ten percent" << endl;
+    for (unsigned i = 0; i != n; ++i) mask[i] = (random01() < 0.1 ? 1 : 0);
+    testMask(mesh, mask);
+    cout << "Keep the last cell" << endl;
+    fill(mask.begin(), mask.end(), 0);
+    mask.back() = 1;
+    testMask(mesh, mask);
+  }
+#endif
+
+  cout << "PASS" << endl;
+
+#ifdef HAVE_MPI
+  MPI_Finalize();
+#endif
+  return 0;
+}
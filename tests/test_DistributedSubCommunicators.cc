@@ -0,0 +1,97 @@
+// test_DistributedSubCommunicators
+//
+// Split the ranks into two groups with splitCommunicator, and have each group
+// tessellate its own problem at the same time: the unit square and a 2x1
+// box, with different numbers of generators.  Each group checks its mesh
+// covers its own box, and that its parallel data are consistent over its
+// own communicator.
+
+#include <algorithm>
+#include <numeric>
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+#include <sstream>
+#include <cmath>
+
+#include "polytope.hh"
+#include "polytope_test_utilities.hh"
+#include "polytope_parallel_utilities.hh"
+#include "checkDistributedTessellation.hh"
+#include "computeMeshGeometry.hh"
+
+#ifdef HAVE_MPI
+#include "mpi.h"
+#endif
+
+using namespace std;
+using namespace polytope;
+
+//------------------------------------------------------------------------------
+// Tessellate n random generators in the box [0, length]x[0, 1] over comm,
+// giving each rank a strip of the box.
+//------------------------------------------------------------------------------
+void runTest(const MPI_Comm comm,
+             const double length,
+             const unsigned n,
+             const unsigned seed) {
+
+  int rank, numProcs;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &numProcs);
+
+  // Every rank in the group draws the same generators and keeps its strip.
+  srand(seed);
+  vector<double> generators;
+  for (unsigned i = 0; i != n; ++i) {
+    const double x = length*random01(), y = random01();
+    if (min(unsigned(x/length*numProcs), unsigned(numProcs - 1)) == unsigned(rank)) {
+      generators.push_back(x);
+      generators.push_back(y);
+    }
+  }
+
+  double xmin[2] = {0.0, 0.0}, xmax[2] = {length, 1.0};
+  Tessellation<2, double> mesh;
+  DistributedTessellator<2, double> tessellator(new BoostTessellator<double>(), true, true, comm);
+  POLY_CHECK(tessellator.communicator() == comm);
+  tessellator.tessellate(generators, xmin, xmax, mesh);
+  POLY_CHECK(mesh.cells.size() == generators.size()/2);
+
+  // The group's cells account for all of its generators and its box.
+  vector<double> cellVolumes, cellCentroids, faceAreas, faceNormals, faceCentroids;
+  computeMeshGeometry(mesh, cellVolumes, cellCentroids, faceAreas, faceNormals, faceCentroids);
+  const double area = allReduce(accumulate(cellVolumes.begin(), cellVolumes.end(), 0.0), MPI_SUM, comm);
+  const unsigned numCells = allReduce(unsigned(mesh.cells.size()), MPI_SUM, comm);
+  POLY_CHECK2(numCells == n, numCells << " != " << n);
+  POLY_CHECK2(std::abs(area - length) < 1.0e-10*length, area << " != " << length);
+
+  const string parCheck = checkDistributedTessellation(mesh, comm);
+  POLY_CHECK2(parCheck == "ok", parCheck);
+}
+
+//------------------------------------------------------------------------------
+// main
+//------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+  // Initialize MPI.
+  MPI_Init(&argc, &argv);
+
+#ifdef HAVE_BOOST_VORONOI
+  {
+    unsigned problem;
+    MPI_Comm comm = splitCommunicator(MPI_COMM_WORLD, 2, problem);
+    if (problem == 0) {
+      runTest(comm, 1.0, 400, 10489591);
+    } else {
+      runTest(comm, 2.0, 700, 3857281);
+    }
+    MPI_Comm_free(&comm);
+  }
+#endif
+
+  cout << "PASS" << endl;
+  MPI_Finalize();
+  return 0;
+}
@@ -8,6 +8,8 @@
 #include <cassert>
 #include <cstdlib>
 #include <sstream>
+#include <cmath>
+#include <algorithm>
 
 #include "polytope.hh"
 #include "MeshEditor.hh"
@@ -23,6 +25,84 @@
 using namespace std;
 using namespace polytope;
 
+namespace {
+
+// -----------------------------------------------------------------------
+// Check the cells and faces of an edited 2D mesh refer to each other
+// consistently, every node is used, and the boundary lists match the faces
+// with one cell.
+// -----------------------------------------------------------------------
+void checkEditedMesh(const Tessellation<2,double>& mesh) {
+   const unsigned nnodes = mesh.nodes.size()/2;
+   POLY_CHECK(mesh.faceCells.size() == mesh.faces.size());
+   vector<unsigned> faceUses(mesh.faces.size(), 0), nodeUses(nnodes, 0);
+   for (unsigned i = 0; i != mesh.cells.size(); ++i) {
+      POLY_CHECK(!mesh.cells[i].empty());
+      for (unsigned k = 0; k != mesh.cells[i].size(); ++k) {
+         const int iface = mesh.cells[i][k];
+         const unsigned fi = internal::positiveID(iface);
+         POLY_CHECK(fi < mesh.faces.size());
+         ++faceUses[fi];
+         const int expected = (iface < 0 ? ~int(i) : int(i));
+         POLY_CHECK(count(mesh.faceCells[fi].begin(), mesh.faceCells[fi].end(), expected) == 1);
+      }
+   }
+   vector<unsigned> boundaryFaces, boundaryNodes;
+   set<unsigned> boundaryNodeSet;
+   for (unsigned fi = 0; fi != mesh.faces.size(); ++fi) {
+      POLY_CHECK(faceUses[fi] == mesh.faceCells[fi].size());
+      POLY_CHECK(mesh.faces[fi].size() == 2);
+      for (unsigned k = 0; k != 2; ++k) {
+         POLY_CHECK(mesh.faces[fi][k] < nnodes);
+         ++nodeUses[mesh.faces[fi][k]];
+         if (mesh.faceCells[fi].size() == 1) boundaryNodeSet.insert(mesh.faces[fi][k]);
+      }
+      if (mesh.faceCells[fi].size() == 1) boundaryFaces.push_back(fi);
+   }
+   boundaryNodes.assign(boundaryNodeSet.begin(), boundaryNodeSet.end());
+   POLY_CHECK(count(nodeUses.begin(), nodeUses.end(), 0) == 0);
+   POLY_CHECK(mesh.boundaryFaces == boundaryFaces);
+   POLY_CHECK(mesh.boundaryNodes == boundaryNodes);
+}
+
+// -----------------------------------------------------------------------
+// Copy a mesh, sharing every third node and face with a pretend neighbor.
+// -----------------------------------------------------------------------
+void copyMesh(const Tessellation<2,double>& mesh0, Tessellation<2,double>& mesh) {
+   mesh.nodes = mesh0.nodes;
+   mesh.cells = mesh0.cells;
+   mesh.faces = mesh0.faces;
+   mesh.faceCells = mesh0.faceCells;
+   mesh.boundaryNodes = mesh0.boundaryNodes;
+   mesh.boundaryFaces = mesh0.boundaryFaces;
+   mesh.neighborDomains.assign(1, 1);
+   mesh.sharedNodes.assign(1, vector<unsigned>());
+   mesh.sharedFaces.assign(1, vector<unsigned>());
+   for (unsigned i = 0; i < mesh.nodes.size()/2; i += 3) mesh.sharedNodes[0].push_back(i);
+   for (unsigned i = 0; i < mesh.faces.size(); i += 3) mesh.sharedFaces[0].push_back(i);
+}
+
+// -----------------------------------------------------------------------
+// The node positions, and the node positions of the faces, in a list of
+// shared nodes and faces.
+// -----------------------------------------------------------------------
+vector<double> sharedPositions(const Tessellation<2,double>& mesh) {
+   vector<double> result;
+   for (unsigned k = 0; k != mesh.sharedNodes[0].size(); ++k) {
+      const unsigned i = mesh.sharedNodes[0][k];
+      result.insert(result.end(), &mesh.nodes[2*i], &mesh.nodes[2*i] + 2);
+   }
+   for (unsigned k = 0; k != mesh.sharedFaces[0].size(); ++k) {
+      const unsigned i = mesh.sharedFaces[0][k];
+      for (unsigned j = 0; j != 2; ++j) {
+         result.insert(result.end(), &mesh.nodes[2*mesh.faces[i][j]], &mesh.nodes[2*mesh.faces[i][j]] + 2);
+      }
+   }
+   return result;
+}
+
+}
+
 
 // -----------------------------------------------------------------------
 // main
@@ -70,11 +150,148 @@ int main(int argc, char** argv)
       ++itest;
    }
 
-   // Test 2: Distributed test: edge is small on one proc, but not on the other
+   // Test 2: Clean the short edges of a random Voronoi mesh.  Collapsing
+   // edges moves no border or corner nodes off the boundary, so the cells
+   // should still tile the box.
+#ifdef HAVE_BOOST_VORONOI
+   {
+      const double edgeTol = 0.05;
+      cout << "\nTest 2: Clean short edges in a random 2D Voronoi mesh" << endl;
+      const unsigned n = 1000;
+      vector<double> points;
+      for (unsigned i = 0; i != 2*n; ++i) points.push_back(random01());
+      double low[2] = {0.0, 0.0}, high[2] = {1.0, 1.0};
+      BoostTessellator<double> tessellator;
+      Tessellation<2,double> mesh;
+      tessellator.tessellate(points, low, high, mesh);
+      const unsigned nnodes0 = mesh.nodes.size()/2, nfaces0 = mesh.faces.size();
+      MeshEditor<2,double> meshEditor(mesh);
+      meshEditor.cleanEdges(edgeTol);
+      const unsigned nnodes1 = mesh.nodes.size()/2, nfaces1 = mesh.faces.size();
+      cout << "   Nodes: " << nnodes0 << " -> " << nnodes1
+           << ", faces: " << nfaces0 << " -> " << nfaces1 << endl;
+      POLY_CHECK(mesh.cells.size() == n);
+      POLY_CHECK(nnodes1 < nnodes0 and nnodes0 - nnodes1 == nfaces0 - nfaces1);
+      double area = 0.0;
+      for (unsigned i = 0; i != n; ++i) {
+         double cent[2], cellArea;
+         geometry::computeCellCentroidAndSignedArea(mesh, i, 1.0e-12, cent, cellArea);
+         POLY_CHECK(cellArea > 0.0);
+         area += cellArea;
+      }
+      POLY_CHECK2(std::abs(area - 1.0) < 1.0e-10, "Total area " << area);
+      for (unsigned i = 0; i != nfaces1; ++i) {
+         POLY_CHECK(mesh.faces[i].size() == 2 and mesh.faces[i][0] != mesh.faces[i][1]);
+         POLY_CHECK(mesh.faces[i][0] < nnodes1 and mesh.faces[i][1] < nnodes1);
+      }
+   }
+#endif
+
+   // Test 3: Delete faces and nodes in bulk from a random Voronoi mesh.
+#ifdef HAVE_BOOST_VORONOI
+   {
+      cout << "\nTest 3: Delete faces and nodes from a random 2D Voronoi mesh" << endl;
+      const unsigned n = 1000;
+      vector<double> points;
+      for (unsigned i = 0; i != 2*n; ++i) points.push_back(random01());
+      double low[2] = {0.0, 0.0}, high[2] = {1.0, 1.0};
+      BoostTessellator<double> tessellator;
+      Tessellation<2,double> mesh0;
+      tessellator.tessellate(points, low, high, mesh0);
+      POLY_CHECK(!mesh0.boundaryFaces.empty() and !mesh0.boundaryNodes.empty());
+      const unsigned nnodes0 = mesh0.nodes.size()/2, nfaces0 = mesh0.faces.size();
+
+      // Deleting every face of a set of cells deletes those cells, and
+      // leaves their neighbors open where they touched them.
+      {
+         vector<unsigned> cellMask(n, 1), facesToDelete;
+         for (unsigned i = 0; i < n; i += 7) cellMask[i] = 0;
+         vector<unsigned> faceMask(nfaces0, 1);
+         for (unsigned i = 0; i != n; ++i) {
+            if (cellMask[i] == 0) {
+               for (unsigned k = 0; k != mesh0.cells[i].size(); ++k) faceMask[internal::positiveID(mesh0.cells[i][k])] = 0;
+            }
+         }
+         for (unsigned i = 0; i != nfaces0; ++i) if (faceMask[i] == 0) facesToDelete.push_back(i);
+         Tessellation<2,double> mesh;
+         copyMesh(mesh0, mesh);
+         vector<double> expected;
+         for (unsigned k = 0; k != mesh.sharedNodes[0].size(); ++k) {
+            const unsigned i = mesh.sharedNodes[0][k];
+            bool used = false;
+            for (unsigned fi = 0; fi != nfaces0; ++fi) {
+               if (faceMask[fi] == 1 and (mesh0.faces[fi][0] == i or mesh0.faces[fi][1] == i)) used = true;
+            }
+            if (used) expected.insert(expected.end(), &mesh0.nodes[2*i], &mesh0.nodes[2*i] + 2);
+         }
+         for (unsigned k = 0; k != mesh.sharedFaces[0].size(); ++k) {
+            const unsigned i = mesh.sharedFaces[0][k];
+            if (faceMask[i] == 0) continue;
+            for (unsigned j = 0; j != 2; ++j) {
+               expected.insert(expected.end(), &mesh0.nodes[2*mesh0.faces[i][j]], &mesh0.nodes[2*mesh0.faces[i][j]] + 2);
+            }
+         }
+         MeshEditor<2,double> meshEditor(mesh);
+         meshEditor.deleteFaces(facesToDelete);
+         cout << "   deleteFaces: faces " << nfaces0 << " -> " << mesh.faces.size()
+              << ", cells " << n << " -> " << mesh.cells.size() << endl;
+         POLY_CHECK(mesh.faces.size() == nfaces0 - facesToDelete.size());
+         POLY_CHECK(mesh.cells.size() == unsigned(count(cellMask.begin(), cellMask.end(), 1U)));
+         checkEditedMesh(mesh);
+         POLY_CHECK(sharedPositions(mesh) == expected);
+
+         // The surviving faces are the same, in the same order.
+         unsigned j = 0;
+         for (unsigned i = 0; i != nfaces0; ++i) {
+            if (faceMask[i] == 0) continue;
+            for (unsigned k = 0; k != 2; ++k) {
+               POLY_CHECK(mesh.nodes[2*mesh.faces[j][k]] == mesh0.nodes[2*mesh0.faces[i][k]] and
+                          mesh.nodes[2*mesh.faces[j][k] + 1] == mesh0.nodes[2*mesh0.faces[i][k] + 1]);
+            }
+            ++j;
+         }
+      }
+
+      // Deleting nodes deletes the faces that used them, and any cells left
+      // with no faces at all.
+      {
+         vector<unsigned> nodesToDelete, nodeMask(nnodes0, 1);
+         for (unsigned i = 0; i != nnodes0; ++i) {
+            if (random01() < 0.1) {
+               nodesToDelete.push_back(i);
+               nodeMask[i] = 0;
+            }
+         }
+         vector<unsigned> faceMask(nfaces0, 0), nodeUsed(nnodes0, 0);
+         for (unsigned i = 0; i != nfaces0; ++i) {
+            if (nodeMask[mesh0.faces[i][0]] == 1 and nodeMask[mesh0.faces[i][1]] == 1) {
+               faceMask[i] = 1;
+               nodeUsed[mesh0.faces[i][0]] = nodeUsed[mesh0.faces[i][1]] = 1;
+            }
+         }
+         Tessellation<2,double> mesh;
+         copyMesh(mesh0, mesh);
+         MeshEditor<2,double> meshEditor(mesh);
+         meshEditor.deleteNodes(nodesToDelete);
+         cout << "   deleteNodes: nodes " << nnodes0 << " -> " << mesh.nodes.size()/2
+              << ", faces " << nfaces0 << " -> " << mesh.faces.size() << endl;
+         POLY_CHECK(mesh.faces.size() == unsigned(count(faceMask.begin(), faceMask.end(), 1U)));
+         POLY_CHECK(mesh.nodes.size()/2 == unsigned(count(nodeUsed.begin(), nodeUsed.end(), 1U)));
+         checkEditedMesh(mesh);
+         vector<double> nodes;
+         for (unsigned i = 0; i != nnodes0; ++i) {
+            if (nodeUsed[i] == 1) nodes.insert(nodes.end(), &mesh0.nodes[2*i], &mesh0.nodes[2*i] + 2);
+         }
+         POLY_CHECK(mesh.nodes == nodes);
+      }
+   }
+#endif
+
+   // Test 4: Distributed test: edge is small on one proc, but not on the other
 #ifdef HAVE_MPI
    {
      const double edgeTol = 0.001;
-     cout << "\nTest 2: Edge is small on one proc, but not on the other" << endl;
+     cout << "\nTest 4: Edge is small on one proc, but not on the other" << endl;
       int rank, numProcs;
      MPI_Comm_rank(MPI_COMM_WORLD, &rank);
      MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
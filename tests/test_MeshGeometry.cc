@@ -0,0 +1,235 @@
+// -----------------------------------------------------------------------
+// test_MeshGeometry
+//
+// Compute the whole mesh cell and face geometry with computeMeshGeometry
+// and check it against the per cell kernels in
+// polytope_geometric_utilities.hh.  The 2D mesh comes from the Boost
+// tessellator, the 3D one is a jittered lattice of hexahedra with non-planar
+// faces.
+// -----------------------------------------------------------------------
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "polytope.hh"
+#include "computeMeshGeometry.hh"
+#include "polytope_test_utilities.hh"
+
+#ifdef HAVE_MPI
+#include "mpi.h"
+#endif
+
+using namespace std;
+using namespace polytope;
+
+namespace {
+
+//------------------------------------------------------------------------------
+// Build an n^3 lattice of hexahedra in the unit cube, moving the interior
+// nodes randomly by up to jitter/n in each direction.
+//------------------------------------------------------------------------------
+void hexMesh(const unsigned n,
+             const double jitter,
+             Tessellation<3, double>& mesh) {
+  const unsigned n1 = n + 1;
+  unsigned i, j, k;
+  mesh.clear();
+  for (k = 0; k != n1; ++k) {
+    for (j = 0; j != n1; ++j) {
+      for (i = 0; i != n1; ++i) {
+        const unsigned ijk[3] = {i, j, k};
+        for (unsigned d = 0; d != 3; ++d) {
+          double x = double(ijk[d])/n;
+          if (i > 0 and i < n and j > 0 and j < n and k > 0 and k < n) x += jitter*(random01() - 0.5)/n;
+          mesh.nodes.push_back(x);
+        }
+      }
+    }
+  }
+
+  // Faces normal to each axis, ordered so the normal points along +axis.
+  // The cell on the low side references the face positively.
+  mesh.cells.resize(n*n*n);
+#define NODE(i, j, k) ((i) + n1*((j) + n1*(k)))
+#define CELL(i, j, k) ((i) + n*((j) + n*(k)))
+  for (unsigned axis = 0; axis != 3; ++axis) {
+    for (k = 0; k != n1; ++k) {
+      for (j = 0; j != n1; ++j) {
+        for (i = 0; i != n1; ++i) {
+          unsigned ijk[3] = {i, j, k};
+          if (ijk[(axis + 1) % 3] == n or ijk[(axis + 2) % 3] == n) continue;
+          vector<unsigned> face;
+          if (axis == 0) {
+            face.push_back(NODE(i, j, k));     face.push_back(NODE(i, j + 1, k));
+            face.push_back(NODE(i, j + 1, k + 1)); face.push_back(NODE(i, j, k + 1));
+          } else if (axis == 1) {
+            face.push_back(NODE(i, j, k));     face.push_back(NODE(i, j, k + 1));
+            face.push_back(NODE(i + 1, j, k + 1)); face.push_back(NODE(i + 1, j, k));
+          } else {
+            face.push_back(NODE(i, j, k));     face.push_back(NODE(i + 1, j, k));
+            face.push_back(NODE(i + 1, j + 1, k)); face.push_back(NODE(i, j + 1, k));
+          }
+          const int iface = mesh.faces.size();
+          mesh.faces.push_back(face);
+          mesh.faceCells.push_back(vector<int>());
+          if (ijk[axis] > 0) {
+            --ijk[axis];
+            const unsigned icell = CELL(ijk[0], ijk[1], ijk[2]);
+            mesh.cells[icell].push_back(iface);
+            mesh.faceCells.back().push_back(icell);
+            ++ijk[axis];
+          }
+          if (ijk[axis] < n) {
+            const unsigned icell = CELL(ijk[0], ijk[1], ijk[2]);
+            mesh.cells[icell].push_back(~iface);
+            mesh.faceCells.back().push_back(~icell);
+          }
+        }
+      }
+    }
+  }
+#undef NODE
+#undef CELL
+}
+
+//------------------------------------------------------------------------------
+// Checks common to both dimensions: the volumes add up, every cell is
+// closed, and the face normals point out of the cells that own them.
+//------------------------------------------------------------------------------
+template<int Dimension>
+void checkMesh(const Tessellation<Dimension, double>& mesh,
+               const vector<double>& cellVolumes,
+               const vector<double>& cellCentroids,
+               const vector<double>& faceAreas,
+               const vector<double>& faceNormals,
+               const vector<double>& faceCentroids,
+               const double totalVolume) {
+  POLY_CHECK(cellVolumes.size() == mesh.cells.size());
+  POLY_CHECK(cellCentroids.size() == Dimension*mesh.cells.size());
+  POLY_CHECK(faceAreas.size() == mesh.faces.size());
+  POLY_CHECK(faceNormals.size() == Dimension*mesh.faces.size());
+  POLY_CHECK(faceCentroids.size() == Dimension*mesh.faces.size());
+  double sumVolume = 0.0;
+  for (unsigned i = 0; i != mesh.cells.size(); ++i) {
+    POLY_CHECK(cellVolumes[i] > 0.0);
+    sumVolume += cellVolumes[i];
+    double closure[Dimension] = {0.0};
+    for (unsigned k = 0; k != mesh.cells[i].size(); ++k) {
+      const int iface = mesh.cells[i][k];
+      const unsigned fi = internal::positiveID(iface);
+      const double sign = (iface < 0 ? -1.0 : 1.0);
+      double outward = 0.0;
+      for (unsigned j = 0; j != Dimension; ++j) {
+        closure[j] += sign*faceAreas[fi]*faceNormals[Dimension*fi + j];
+        outward += sign*faceNormals[Dimension*fi + j]*(faceCentroids[Dimension*fi + j] - cellCentroids[Dimension*i + j]);
+      }
+      POLY_CHECK2(outward > 0.0, "Face " << fi << " normal points into cell " << i);
+    }
+    for (unsigned j = 0; j != Dimension; ++j) {
+      POLY_CHECK2(std::abs(closure[j]) < 1.0e-12, "Cell " << i << " is not closed: " << closure[j]);
+    }
+  }
+  POLY_CHECK2(std::abs(sumVolume - totalVolume) < 1.0e-12*totalVolume,
+              "Total volume " << sumVolume << " != " << totalVolume);
+  for (unsigned fi = 0; fi != mesh.faces.size(); ++fi) {
+    POLY_CHECK(faceAreas[fi] > 0.0);
+    POLY_CHECK(std::abs(sqrt(geometry::dot<Dimension, double>(&faceNormals[Dimension*fi], &faceNormals[Dimension*fi])) - 1.0) < 1.0e-12);
+  }
+}
+
+//------------------------------------------------------------------------------
+// 2D: a random Boost tessellation.
+//------------------------------------------------------------------------------
+void test2d() {
+#ifdef HAVE_BOOST_VORONOI
+  cout << "2D Boost tessellation" << endl;
+  BoostTessellator<double> tessellator;
+  const unsigned n = 500;
+  vector<double> points;
+  for (unsigned i = 0; i != 2*n; ++i) points.push_back(random01());
+  double low[2] = {0.0, 0.0}, high[2] = {1.0, 1.0};
+  Tessellation<2, double> mesh;
+  tessellator.tessellate(points, low, high, mesh);
+  POLY_CHECK(mesh.cells.size() == n);
+
+  vector<double> cellVolumes, cellCentroids, faceAreas, faceNormals, faceCentroids;
+  computeMeshGeometry(mesh, cellVolumes, cellCentroids, faceAreas, faceNormals, faceCentroids);
+  checkMesh(mesh, cellVolumes, cellCentroids, faceAreas, faceNormals, faceCentroids, 1.0);
+  for (unsigned i = 0; i != n; ++i) {
+    double cent[2], area;
+    geometry::computeCellCentroidAndSignedArea(mesh, i, 1.0e-12, cent, area);
+    POLY_CHECK2(std::abs(cellVolumes[i] - area) < 1.0e-12, "Cell " << i << " area " << cellVolumes[i] << " != " << area);
+    POLY_CHECK2((geometry::distance<2, double>(cent, &cellCentroids[2*i])) < 1.0e-12,
+                "Cell " << i << " centroid mismatch");
+  }
+  for (unsigned fi = 0; fi != mesh.faces.size(); ++fi) {
+    const double* a = &mesh.nodes[2*mesh.faces[fi][0]];
+    const double* b = &mesh.nodes[2*mesh.faces[fi][1]];
+    POLY_CHECK(std::abs(faceAreas[fi] - geometry::distance<2, double>(a, b)) < 1.0e-12);
+    POLY_CHECK(std::abs(faceCentroids[2*fi] - 0.5*(a[0] + b[0])) < 1.0e-12 and
+               std::abs(faceCentroids[2*fi + 1] - 0.5*(a[1] + b[1])) < 1.0e-12);
+  }
+
+  // The cells only overload gives the same answer.
+  vector<double> cellVolumes2, cellCentroids2;
+  computeMeshGeometry(mesh, cellVolumes2, cellCentroids2);
+  POLY_CHECK(cellVolumes2 == cellVolumes and cellCentroids2 == cellCentroids);
+#endif
+}
+
+//------------------------------------------------------------------------------
+// 3D: planar and jittered hexahedral lattices.
+//------------------------------------------------------------------------------
+void test3d(const double jitter) {
+  cout << "3D hex lattice, jitter " << jitter << endl;
+  const unsigned n = 6;
+  Tessellation<3, double> mesh;
+  hexMesh(n, jitter, mesh);
+
+  vector<double> cellVolumes, cellCentroids, faceAreas, faceNormals, faceCentroids;
+  computeMeshGeometry(mesh, cellVolumes, cellCentroids, faceAreas, faceNormals, faceCentroids);
+  checkMesh(mesh, cellVolumes, cellCentroids, faceAreas, faceNormals, faceCentroids, 1.0);
+  for (unsigned i = 0; i != mesh.cells.size(); ++i) {
+    double cent[3], vol;
+    geometry::computeCellCentroidAndSignedVolume(mesh, i, cent, vol);
+    POLY_CHECK2(std::abs(cellVolumes[i] - vol) < 1.0e-14, "Cell " << i << " volume " << cellVolumes[i] << " != " << vol);
+    POLY_CHECK2((geometry::distance<3, double>(cent, &cellCentroids[3*i])) < 1.0e-12,
+                "Cell " << i << " centroid mismatch");
+  }
+  for (unsigned fi = 0; fi != mesh.faces.size(); ++fi) {
+    double fcent[3], fhat[3];
+    geometry::computeFaceCentroidAndNormal(mesh, fi, fcent, fhat);
+    if (jitter == 0.0) {
+      POLY_CHECK(std::abs(faceAreas[fi] - 1.0/(n*n)) < 1.0e-14);
+      POLY_CHECK((geometry::distance<3, double>(fcent, &faceCentroids[3*fi])) < 1.0e-14);
+      POLY_CHECK((geometry::distance<3, double>(fhat, &faceNormals[3*fi])) < 1.0e-14);
+    } else {
+      POLY_CHECK((geometry::dot<3, double>(fhat, &faceNormals[3*fi])) > 0.5);
+    }
+  }
+}
+
+}
+
+// -----------------------------------------------------------------------
+// main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+#ifdef HAVE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  test2d();
+  test3d(0.0);
+  test3d(0.5);
+
+  cout << "PASS" << endl;
+
+#ifdef HAVE_MPI
+  MPI_Finalize();
+#endif
+  return 0;
+}
@@ -0,0 +1,241 @@
+// -----------------------------------------------------------------------
+// test_MeshWriters
+//
+// Write tessellations with VTKWriter and XDMFWriter, then pull the binary
+// arrays back out of the files and check they describe the same cells and
+// fields, and that the parallel index files name every piece.
+// -----------------------------------------------------------------------
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+
+#include "polytope.hh"
+#include "VTKWriter.hh"
+#include "XDMFWriter.hh"
+#include "polytope_test_utilities.hh"
+
+#ifdef HAVE_MPI
+#include "mpi.h"
+#endif
+
+using namespace std;
+using namespace polytope;
+
+// -----------------------------------------------------------------------
+// The contents of a file.
+// -----------------------------------------------------------------------
+string
+readFile(const string& fileName) {
+  ifstream file(fileName.c_str(), ios::in | ios::binary);
+  POLY_CHECK2(file, "Could not open " << fileName);
+  stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+// -----------------------------------------------------------------------
+// Split the appended data of a .vtu file into its arrays, checking the
+// array sizes account for all of it.
+// -----------------------------------------------------------------------
+vector<string>
+appendedArrays(const string& vtu) {
+  const string start = "<AppendedData encoding=\"raw\">\n   _", stop = "\n  </AppendedData>";
+  const size_t i0 = vtu.find(start), i1 = vtu.rfind(stop);
+  POLY_CHECK(i0 != string::npos and i1 != string::npos);
+  vector<string> result;
+  size_t i = i0 + start.size();
+  while (i < i1) {
+    uint64_t nbytes;
+    memcpy(&nbytes, &vtu[i], sizeof(nbytes));
+    i += sizeof(nbytes);
+    POLY_CHECK(i + nbytes <= i1);
+    result.push_back(vtu.substr(i, nbytes));
+    i += nbytes;
+  }
+  POLY_CHECK(i == i1);
+  return result;
+}
+
+template<typename T>
+vector<T>
+asArray(const string& s) {
+  POLY_CHECK(s.size() % sizeof(T) == 0);
+  vector<T> result(s.size()/sizeof(T));
+  if (not s.empty()) memcpy(&result[0], &s[0], s.size());
+  return result;
+}
+
+bool contains(const string& s, const string& x) { return s.find(x) != string::npos; }
+
+// -----------------------------------------------------------------------
+// A 2x1 lattice of unit squares, with their shared face oriented for the
+// left cell.
+// -----------------------------------------------------------------------
+void
+twoSquares(Tessellation<2, double>& mesh) {
+  const double x[12] = {0, 0, 1, 0, 2, 0, 0, 1, 1, 1, 2, 1};
+  const unsigned faces[7][2] = {{0, 1}, {1, 4}, {4, 3}, {3, 0}, {1, 2}, {2, 5}, {5, 4}};
+  const int cells[2][4] = {{0, 1, 2, 3}, {4, 5, 6, ~1}};
+  mesh.nodes.assign(x, x + 12);
+  for (unsigned i = 0; i != 7; ++i) mesh.faces.push_back(vector<unsigned>(faces[i], faces[i] + 2));
+  for (unsigned i = 0; i != 2; ++i) mesh.cells.push_back(vector<int>(cells[i], cells[i] + 4));
+}
+
+// -----------------------------------------------------------------------
+// The unit cube, with its x=0 face stored the wrong way around for it.
+// -----------------------------------------------------------------------
+void
+unitCube(Tessellation<3, double>& mesh) {
+  for (unsigned i = 0; i != 8; ++i) {
+    for (unsigned j = 0; j != 3; ++j) mesh.nodes.push_back(double((i >> j) & 1));
+  }
+  const unsigned faces[6][4] = {{2, 6, 4, 0}, {1, 3, 7, 5},
+                                {0, 1, 5, 4}, {2, 6, 7, 3},
+                                {0, 2, 3, 1}, {4, 5, 7, 6}};
+  mesh.cells.resize(1);
+  for (unsigned i = 0; i != 6; ++i) {
+    mesh.faces.push_back(vector<unsigned>(faces[i], faces[i] + 4));
+    mesh.cells[0].push_back(i == 0 ? ~0 : int(i));
+  }
+}
+
+// -----------------------------------------------------------------------
+// main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+#ifdef HAVE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  vector<double> cellID(2);
+  cellID[0] = 10.0;
+  cellID[1] = 11.0;
+  map<string, double*> fields;
+  fields["cell_id"] = &cellID[0];
+
+  // 2D VTK: polygons, counterclockwise, with the nodes padded out to 3D.
+  {
+    Tessellation<2, double> mesh;
+    twoSquares(mesh);
+    VTKWriter<2, double>::write(mesh, fields, "test_MeshWriters.vtu");
+    const string vtu = readFile("test_MeshWriters.vtu");
+    POLY_CHECK(contains(vtu, "NumberOfPoints=\"6\" NumberOfCells=\"2\""));
+    POLY_CHECK(contains(vtu, "Name=\"cell_id\""));
+    const vector<string> arrays = appendedArrays(vtu);
+    POLY_CHECK(arrays.size() == 5);
+    const vector<double> points = asArray<double>(arrays[0]);
+    POLY_CHECK(points.size() == 18);
+    POLY_CHECK(points[12] == 1.0 and points[13] == 1.0 and points[14] == 0.0);
+    const int32_t conn[8] = {0, 1, 4, 3, 1, 2, 5, 4};
+    POLY_CHECK(asArray<int32_t>(arrays[1]) == vector<int32_t>(conn, conn + 8));
+    const vector<int64_t> offsets = asArray<int64_t>(arrays[2]);
+    POLY_CHECK(offsets.size() == 2 and offsets[0] == 4 and offsets[1] == 8);
+    POLY_CHECK(arrays[3] == string(2, char(7)));
+    POLY_CHECK(asArray<double>(arrays[4]) == cellID);
+    remove("test_MeshWriters.vtu");
+  }
+
+  // 3D VTK: a polyhedron, with its faces outward.
+  {
+    Tessellation<3, double> mesh;
+    unitCube(mesh);
+    VTKWriter<3, double>::write(mesh, "test_MeshWriters.vtu");
+    const vector<string> arrays = appendedArrays(readFile("test_MeshWriters.vtu"));
+    POLY_CHECK(arrays.size() == 6);
+    POLY_CHECK(asArray<double>(arrays[0]) == mesh.nodes);
+    vector<int32_t> conn = asArray<int32_t>(arrays[1]);
+    sort(conn.begin(), conn.end());
+    POLY_CHECK(conn.size() == 8);
+    for (int i = 0; i != 8; ++i) POLY_CHECK(conn[i] == i);
+    const int32_t conn0[4] = {0, 4, 6, 2};
+    POLY_CHECK(asArray<int64_t>(arrays[2]) == vector<int64_t>(1, 8));
+    POLY_CHECK(arrays[3] == string(1, char(42)));
+    const vector<int32_t> faces = asArray<int32_t>(arrays[4]);
+    POLY_CHECK(faces.size() == 31);
+    POLY_CHECK(faces[0] == 6 and faces[1] == 4);
+    POLY_CHECK(vector<int32_t>(faces.begin() + 2, faces.begin() + 6) == vector<int32_t>(conn0, conn0 + 4));
+    POLY_CHECK(asArray<int64_t>(arrays[5]) == vector<int64_t>(1, 31));
+    remove("test_MeshWriters.vtu");
+  }
+
+  // 2D XDMF.
+  {
+    Tessellation<2, double> mesh;
+    twoSquares(mesh);
+    XDMFWriter<2, double>::write(mesh, fields, "test_MeshWriters");
+    const string xmf = readFile("test_MeshWriters.xmf"), bin = readFile("test_MeshWriters.bin");
+    POLY_CHECK(contains(xmf, "TopologyType=\"Mixed\" NumberOfElements=\"2\""));
+    POLY_CHECK(contains(xmf, "GeometryType=\"XY\""));
+    POLY_CHECK(contains(xmf, "Name=\"cell_id\""));
+    POLY_CHECK(contains(xmf, "Dimensions=\"6 2\" NumberType=\"Float\""));
+    POLY_CHECK(contains(xmf, "Seek=\"0\""));
+    POLY_CHECK(contains(xmf, "Dimensions=\"12\" NumberType=\"Int\" Precision=\"4\""));
+    POLY_CHECK(contains(xmf, "Seek=\"96\""));
+    POLY_CHECK(contains(xmf, "Seek=\"144\""));
+    POLY_CHECK(bin.size() == 12*sizeof(double) + 12*sizeof(int32_t) + 2*sizeof(double));
+    POLY_CHECK(asArray<double>(bin.substr(0, 12*sizeof(double))) == mesh.nodes);
+    const int32_t topology[12] = {3, 4, 0, 1, 4, 3, 3, 4, 1, 2, 5, 4};
+    POLY_CHECK(asArray<int32_t>(bin.substr(12*sizeof(double), 12*sizeof(int32_t))) ==
+               vector<int32_t>(topology, topology + 12));
+    POLY_CHECK(asArray<double>(bin.substr(12*sizeof(double) + 12*sizeof(int32_t))) == cellID);
+    remove("test_MeshWriters.xmf");
+    remove("test_MeshWriters.bin");
+  }
+
+  // 3D XDMF.
+  {
+    Tessellation<3, double> mesh;
+    unitCube(mesh);
+    XDMFWriter<3, double>::write(mesh, "test_MeshWriters");
+    const string xmf = readFile("test_MeshWriters.xmf"), bin = readFile("test_MeshWriters.bin");
+    POLY_CHECK(contains(xmf, "GeometryType=\"XYZ\""));
+    POLY_CHECK(bin.size() == 24*sizeof(double) + 32*sizeof(int32_t));
+    const vector<int32_t> topology = asArray<int32_t>(bin.substr(24*sizeof(double)));
+    POLY_CHECK(topology[0] == 16 and topology[1] == 6 and topology[2] == 4);
+    POLY_CHECK(topology[3] == 0 and topology[4] == 4 and topology[5] == 6 and topology[6] == 2);
+    remove("test_MeshWriters.xmf");
+    remove("test_MeshWriters.bin");
+  }
+
+  // Per-rank pieces and their index files.
+  {
+    Tessellation<2, double> mesh;
+    twoSquares(mesh);
+    for (int rank = 0; rank != 2; ++rank) {
+      VTKWriter<2, double>::writeParallel(mesh, fields, "test_MeshWriters_p", rank, 2);
+      XDMFWriter<2, double>::writeParallel(mesh, fields, "test_MeshWriters_p", rank, 2);
+    }
+    const string pvtu = readFile("test_MeshWriters_p.pvtu"), xmf = readFile("test_MeshWriters_p.xmf");
+    POLY_CHECK(contains(pvtu, "<Piece Source=\"test_MeshWriters_p_0.vtu\"/>"));
+    POLY_CHECK(contains(pvtu, "<Piece Source=\"test_MeshWriters_p_1.vtu\"/>"));
+    POLY_CHECK(contains(pvtu, "Name=\"cell_id\""));
+    POLY_CHECK(contains(xmf, "CollectionType=\"Spatial\""));
+    POLY_CHECK(contains(xmf, "href=\"test_MeshWriters_p_0.xmf\""));
+    POLY_CHECK(contains(xmf, "href=\"test_MeshWriters_p_1.xmf\""));
+    for (int rank = 0; rank != 2; ++rank) {
+      const string piece = internal::pieceName("test_MeshWriters_p", rank, "");
+      POLY_CHECK(appendedArrays(readFile(piece + ".vtu")).size() == 5);
+      remove((piece + ".vtu").c_str());
+      remove((piece + ".xmf").c_str());
+      remove((piece + ".bin").c_str());
+    }
+    remove("test_MeshWriters_p.pvtu");
+    remove("test_MeshWriters_p.xmf");
+  }
+
+  cout << "PASS" << endl;
+
+#ifdef HAVE_MPI
+  MPI_Finalize();
+#endif
+  return 0;
+}
@@ -7,7 +7,8 @@
 //
 // This tests the "cell adoption" capability for 2D tessellators
 // which appropriates the area in the orphaned pieces to its neighboring
-// cells while maintaining the Voronoi property locally
+// cells while maintaining the Voronoi property locally, and that the
+// adopted mesh is the same however many threads adopt the orphans.
 //
 // The domain looks like this:
 //   _____  ________
@@ -28,7 +29,9 @@
 #include <sstream>
 
 #include "polytope.hh"
+#include "timingUtilities.hh"
 #include "polytope_test_utilities.hh"
+#include "polytope_thread_utilities.hh"
 
 #ifdef HAVE_MPI
 #include "mpi.h"
@@ -37,6 +40,36 @@
 using namespace std;
 using namespace polytope;
 
+// -----------------------------------------------------------------------
+// testThreads
+//
+// The orphans are adopted in rounds, each in parallel, but the adopted
+// mesh should not depend on the number of threads.  Tessellate with one
+// thread and with nthreads and check the meshes are identical.  Without
+// OpenMP both runs are serial, and this only checks they are repeatable.
+// -----------------------------------------------------------------------
+void testThreads(Tessellator<2,double>& tessellator,
+                 const std::vector<double>& points,
+                 const std::vector<double>& PLCpoints,
+                 const PLC<2,double>& boundary,
+                 const int nthreads) {
+  const int nthreads0 = internal::maxThreads();
+  Tessellation<2,double> mesh0, mesh1;
+  internal::setMaxThreads(1);
+  tessellator.tessellate(points, PLCpoints, boundary, mesh0);
+  internal::setMaxThreads(nthreads);
+#ifdef _OPENMP
+  POLY_CHECK(internal::maxThreads() == nthreads);
+#endif
+  tessellator.tessellate(points, PLCpoints, boundary, mesh1);
+  internal::setMaxThreads(nthreads0);
+  POLY_CHECK(mesh0.cells.size() == points.size()/2);
+  POLY_CHECK(mesh1.nodes == mesh0.nodes);
+  POLY_CHECK(mesh1.faces == mesh0.faces);
+  POLY_CHECK(mesh1.cells == mesh0.cells);
+  cout << mesh0.cells.size() << " cells identical on 1 and " << nthreads << " threads" << endl;
+}
+
 // -----------------------------------------------------------------------
 // test
 // -----------------------------------------------------------------------
@@ -123,6 +156,104 @@ void test(Tessellator<2,double>& tessellator,
   }
 }
 
+// -----------------------------------------------------------------------
+// testComb
+//
+// An n x n grid of Cartesian generators in a box with n-1 thin slits cut
+// down from the top, each splitting off the right side of the cells in
+// the upper rows of a column.  The pieces from a column touch each other,
+// so each slit leaves one long orphan built from many fragments.
+// -----------------------------------------------------------------------
+void testComb(Tessellator<2,double>& tessellator,
+              const int n) {
+  cout << "Comb with " << n - 1 << " slits" << endl;
+  const double width = 0.05, depth = 0.5*n + 0.1;
+  std::vector<double> PLCpoints, points;
+  PLC<2,double> boundary;
+  Tessellation<2,double> mesh;
+
+  // Walk the boundary counterclockwise, down and back up each slit on the
+  // top side.
+  PLCpoints.push_back(0.0);  PLCpoints.push_back(0.0);
+  PLCpoints.push_back(n);    PLCpoints.push_back(0.0);
+  PLCpoints.push_back(n);    PLCpoints.push_back(n);
+  for (int k = n - 1; k > 0; --k) {
+    const double x1 = k - 0.25, x0 = x1 - width;
+    PLCpoints.push_back(x1);  PLCpoints.push_back(n);
+    PLCpoints.push_back(x1);  PLCpoints.push_back(n - depth);
+    PLCpoints.push_back(x0);  PLCpoints.push_back(n - depth);
+    PLCpoints.push_back(x0);  PLCpoints.push_back(n);
+  }
+  PLCpoints.push_back(0.0);  PLCpoints.push_back(n);
+  const int nSides = PLCpoints.size()/2;
+  boundary.facets.resize(nSides, std::vector<int>(2));
+  for (int i = 0; i != nSides; ++i) {
+    boundary.facets[i][0] = i;
+    boundary.facets[i][1] = (i + 1) % nSides;
+  }
+  for (int iy = 0; iy != n; ++iy) {
+    for (int ix = 0; ix != n; ++ix) {
+      points.push_back(ix + 0.5);  points.push_back(iy + 0.5);
+    }
+  }
+
+  const bool timers = timersEnabled();
+  enableTimers();
+  resetTimers();
+  tessellator.tessellate(points, PLCpoints, boundary, mesh);
+  const uint64_t numOrphans = counterValue("orphansAdopted");
+  enableTimers(timers);
+
+  // One orphan per slit, and all the area is accounted for.
+  POLY_CHECK(mesh.cells.size() == n*n);
+  POLY_CHECK2(numOrphans == n - 1, numOrphans << " orphans");
+  const double trueArea = n*n - (n - 1)*width*depth;
+  const double tessArea = computeTessellationArea(mesh);
+  POLY_CHECK2(std::abs(trueArea - tessArea) < 1.0e-7*trueArea,
+              "Area = " << tessArea << " != " << trueArea);
+  testThreads(tessellator, points, PLCpoints, boundary, 4);
+}
+
+// -----------------------------------------------------------------------
+// testRandom
+//
+// Random generators in the domain of the OrphanedCell test, sparse enough
+// that the notches split some cells, checked for thread independence.
+// -----------------------------------------------------------------------
+void testRandom(Tessellator<2,double>& tessellator,
+                const unsigned n) {
+  cout << "Random generators: " << n << endl;
+  std::vector<double> PLCpoints, points;
+  PLC<2,double> boundary;
+  const double corners[12][2] = {{0.0, 0.0}, {1.2, 0.0}, {1.2, 1.3}, {1.3, 1.3},
+                                 {1.3, 0.0}, {3.0, 0.0}, {3.0, 3.0}, {1.3, 3.0},
+                                 {1.3, 1.7}, {1.2, 1.7}, {1.2, 3.0}, {0.0, 3.0}};
+  for (unsigned i = 0; i != 12; ++i) {
+    PLCpoints.push_back(corners[i][0]);
+    PLCpoints.push_back(corners[i][1]);
+  }
+  boundary.facets.resize(12, std::vector<int>(2));
+  for (unsigned i = 0; i != 12; ++i) {
+    boundary.facets[i][0] = i;
+    boundary.facets[i][1] = (i + 1) % 12;
+  }
+  srand(10489591);
+  while (points.size() != 2*n) {
+    const double x = 3.0*random01(), y = 3.0*random01();
+    if (not (x > 1.2 and x < 1.3 and (y < 1.3 or y > 1.7))) {
+      points.push_back(x);
+      points.push_back(y);
+    }
+  }
+  const bool timers = timersEnabled();
+  enableTimers();
+  resetTimers();
+  testThreads(tessellator, points, PLCpoints, boundary, 4);
+  const uint64_t numOrphans = counterValue("orphansAdopted");
+  enableTimers(timers);
+  POLY_CHECK2(numOrphans > 0, "No orphans to adopt");
+}
+
 // -----------------------------------------------------------------------
 // main
 // -----------------------------------------------------------------------
@@ -145,6 +276,9 @@ int main(int argc, char** argv)
     cout << "\nBoost Tessellator:\n" << endl;
     BoostTessellator<double> tessellator;
     test(tessellator, true);
+    testComb(tessellator, 8);
+    testComb(tessellator, 20);
+    testRandom(tessellator, 200);
   }
 #endif
 
@@ -0,0 +1,287 @@
+// -----------------------------------------------------------------------
+// test_QuantizedTessellation3d
+//
+// Check the 3D quantized pipeline -- fillTessellation, clipping against
+// convex and non-convex PLCs, and snapping to the boundary -- independent
+// of any 3D tessellator library.  The cells come from a test tessellator
+// giving each generator of a lattice its lattice cube.
+// -----------------------------------------------------------------------
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cmath>
+
+#include "polytope.hh"
+#include "polytope_test_utilities.hh"
+
+#ifdef HAVE_MPI
+#include "mpi.h"
+#endif
+
+using namespace std;
+using namespace polytope;
+
+namespace {
+
+//------------------------------------------------------------------------------
+// Make each generator's cell the cube of side dx about it, on the lattice
+// with a corner at low.
+//------------------------------------------------------------------------------
+class LatticeTessellator: public Tessellator<3, double> {
+public:
+  LatticeTessellator(const double* low, const double dx): mDx(dx) {
+    std::copy(low, low + 3, mLow);
+  }
+
+  void tessellateQuantized(QuantizedTessellation& qmesh) const {
+    typedef QuantizedTessellation::IntPoint IntPoint;
+    map<IntPoint, int> corner2id;
+    map<pair<int, int>, int> edge2id;
+    map<vector<int>, int> face2id;
+    const int faceCorners[6][4] = {{0, 4, 6, 2}, {1, 3, 7, 5}, {0, 1, 5, 4},
+                                   {2, 6, 7, 3}, {0, 2, 3, 1}, {4, 5, 7, 6}};
+    qmesh.cellFaces.resize(qmesh.generators.size());
+    for (unsigned i = 0; i != qmesh.generators.size(); ++i) {
+      double gen[3];
+      qmesh.dequantize(&qmesh.generators[i].x, gen);
+      int corners[8];
+      for (unsigned k = 0; k != 8; ++k) {
+        IntPoint ic(0, 0, 0), ip;
+        double p[3];
+        for (unsigned j = 0; j != 3; ++j) {
+          const int ix = int(floor((gen[j] - mLow[j])/mDx)) + ((k >> j) & 1);
+          (&ic.x)[j] = ix;
+          p[j] = mLow[j] + ix*mDx;
+        }
+        qmesh.quantize(p, &ip.x);
+        const int old_size = corner2id.size();
+        corners[k] = internal::addKeyToMap(ic, corner2id);
+        if (corners[k] == old_size) qmesh.nodes.push_back(ip);
+      }
+      for (unsigned f = 0; f != 6; ++f) {
+        vector<int> key;
+        for (unsigned k = 0; k != 4; ++k) key.push_back(corners[faceCorners[f][k]]);
+        sort(key.begin(), key.end());
+        const int old_size = face2id.size();
+        const int iface = internal::addKeyToMap(key, face2id);
+        if (iface == old_size) {
+          qmesh.faces.push_back(vector<int>());
+          for (unsigned k = 0; k != 4; ++k) {
+            const int j0 = corners[faceCorners[f][k]], j1 = corners[faceCorners[f][(k + 1) % 4]];
+            const pair<int, int> edge = internal::hashEdge(j0, j1);
+            const int old_nedges = edge2id.size();
+            const int e = internal::addKeyToMap(edge, edge2id);
+            if (e == old_nedges) qmesh.edges.push_back(edge);
+            qmesh.faces.back().push_back(edge.first == j0 ? e : ~e);
+          }
+          qmesh.cellFaces[i].push_back(iface);
+        } else {
+          qmesh.cellFaces[i].push_back(~iface);
+        }
+      }
+    }
+  }
+
+  std::string name() const { return "LatticeTessellator"; }
+  double degeneracy() const { return 8.0/std::numeric_limits<int>::max(); }
+
+private:
+  double mLow[3], mDx;
+};
+
+//------------------------------------------------------------------------------
+// The generators at the centers of the lattice cubes meeting a region.
+//------------------------------------------------------------------------------
+template<typename Inside>
+vector<double>
+latticeGenerators(const unsigned nx, const double dx, const Inside& inside) {
+  vector<double> result;
+  for (unsigned iz = 0; iz != nx; ++iz) {
+    for (unsigned iy = 0; iy != nx; ++iy) {
+      for (unsigned ix = 0; ix != nx; ++ix) {
+        const double p[3] = {(ix + 0.5)*dx, (iy + 0.5)*dx, (iz + 0.5)*dx};
+        if (inside(p, dx)) result.insert(result.end(), p, p + 3);
+      }
+    }
+  }
+  return result;
+}
+
+struct InCube {
+  bool operator()(const double* p, const double dx) const { return true; }
+};
+
+// Does the cube about p meet the unit cube with the corner x + y + z > cut
+// removed?
+struct InCutCube {
+  double cut;
+  InCutCube(const double c): cut(c) {}
+  bool operator()(const double* p, const double dx) const { return p[0] + p[1] + p[2] - 1.5*dx < cut; }
+};
+
+// Does the cube about p meet the L made by removing [xcut, 1] x [xcut, 1] x [0, 1]
+// from the unit cube?
+struct InL {
+  double xcut;
+  InL(const double x): xcut(x) {}
+  bool operator()(const double* p, const double dx) const { return p[0] - 0.5*dx < xcut or p[1] - 0.5*dx < xcut; }
+};
+
+//------------------------------------------------------------------------------
+// Check the mesh is closed and consistently oriented, and return its volume.
+//------------------------------------------------------------------------------
+double
+checkMesh(const Tessellation<3, double>& mesh, const unsigned ncells) {
+  POLY_CHECK(mesh.cells.size() == ncells);
+  POLY_CHECK(mesh.faceCells.size() == mesh.faces.size());
+  for (unsigned i = 0; i != mesh.faces.size(); ++i) {
+    POLY_CHECK(mesh.faces[i].size() >= 3);
+    POLY_CHECK(mesh.faceCells[i].size() == 1 or mesh.faceCells[i].size() == 2);
+    if (mesh.faceCells[i].size() == 2) POLY_CHECK(mesh.faceCells[i][0] >= 0 and mesh.faceCells[i][1] < 0);
+  }
+
+  // Each cell edge is traversed once in each direction by the cell faces.
+  double volume = 0.0;
+  for (unsigned i = 0; i != ncells; ++i) {
+    map<pair<unsigned, unsigned>, int> edgeCount;
+    for (unsigned j = 0; j != mesh.cells[i].size(); ++j) {
+      const int f = mesh.cells[i][j];
+      const vector<unsigned>& face = mesh.faces[f < 0 ? ~f : f];
+      const unsigned n = face.size();
+      for (unsigned k = 0; k != n; ++k) {
+        const unsigned a = face[k], b = face[(k + 1) % n];
+        ++edgeCount[f < 0 ? make_pair(b, a) : make_pair(a, b)];
+      }
+    }
+    for (map<pair<unsigned, unsigned>, int>::const_iterator itr = edgeCount.begin(); itr != edgeCount.end(); ++itr) {
+      POLY_CHECK2(itr->second == 1 and edgeCount.find(make_pair(itr->first.second, itr->first.first)) != edgeCount.end(),
+                  "Cell " << i << " is not closed at edge (" << itr->first.first << " " << itr->first.second << ")");
+    }
+    double centroid[3], vol;
+    geometry::computeCellCentroidAndSignedVolume(mesh, i, centroid, vol);
+    POLY_CHECK2(vol > 0.0, "Cell " << i << " volume " << vol);
+    volume += vol;
+  }
+  return volume;
+}
+
+}
+
+// -----------------------------------------------------------------------
+// main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+#ifdef HAVE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  const unsigned nx = 4;
+  const double dx = 1.0/nx;
+  const double low[3] = {0.0, 0.0, 0.0};
+  LatticeTessellator tessellator(low, dx);
+
+  // Unbounded: we get the cubes back.
+  {
+    const vector<double> generators = latticeGenerators(nx, dx, InCube());
+    Tessellation<3, double> mesh;
+    tessellator.tessellate(generators, mesh);
+    const double volume = checkMesh(mesh, nx*nx*nx);
+    POLY_CHECK2(std::abs(volume - 1.0) < 1.0e-8, volume);
+    POLY_CHECK(mesh.nodes.size()/3 == (nx + 1)*(nx + 1)*(nx + 1));
+  }
+
+  // The unit box: clipping changes nothing.
+  {
+    const vector<double> generators = latticeGenerators(nx, dx, InCube());
+    double xmin[3] = {0.0, 0.0, 0.0}, xmax[3] = {1.0, 1.0, 1.0};
+    Tessellation<3, double> mesh;
+    tessellator.tessellate(generators, xmin, xmax, mesh);
+    const double volume = checkMesh(mesh, nx*nx*nx);
+    POLY_CHECK2(std::abs(volume - 1.0) < 1.0e-8, volume);
+    POLY_CHECK(mesh.nodes.size()/3 == (nx + 1)*(nx + 1)*(nx + 1));
+  }
+
+  // A smaller box, cutting through the lattice cubes.
+  {
+    const vector<double> generators = latticeGenerators(nx, dx, InCube());
+    double xmin[3] = {0.1, 0.1, 0.1}, xmax[3] = {0.9, 0.9, 0.9};
+    Tessellation<3, double> mesh;
+    tessellator.tessellate(generators, xmin, xmax, mesh);
+    const double volume = checkMesh(mesh, nx*nx*nx);
+    POLY_CHECK2(std::abs(volume - 0.512) < 1.0e-8, volume);
+    for (unsigned i = 0; i != mesh.nodes.size(); ++i) {
+      POLY_CHECK(mesh.nodes[i] >= 0.1 - 1.0e-12 and mesh.nodes[i] <= 0.9 + 1.0e-12);
+    }
+  }
+
+  // The unit cube with a corner cut off by a tilted plane.
+  {
+    const double cut = 2.2;
+    const vector<double> generators = latticeGenerators(nx, dx, InCutCube(cut));
+    ReducedPLC<3, double> boundary;
+    double x[3];
+    for (unsigned i = 0; i != 8; ++i) {
+      for (unsigned j = 0; j != 3; ++j) x[j] = double((i >> j) & 1);
+      if (i != 7) boundary.points.insert(boundary.points.end(), x, x + 3);
+    }
+    const double tri[3][3] = {{1.0, 1.0, cut - 2.0}, {1.0, cut - 2.0, 1.0}, {cut - 2.0, 1.0, 1.0}};
+    for (unsigned i = 0; i != 3; ++i) boundary.points.insert(boundary.points.end(), tri[i], tri[i] + 3);
+    // Points 0-6 are the unit cube corners but (1,1,1); 7, 8, 9 cut its edges
+    // along z, y, and x.
+    const int facets[7][5] = {{0, 4, 6, 2, -1},    // -x
+                              {1, 3, 7, 8, 5},     // +x
+                              {0, 1, 5, 4, -1},    // -y
+                              {2, 6, 9, 7, 3},     // +y
+                              {0, 2, 3, 1, -1},    // -z
+                              {4, 5, 8, 9, 6},     // +z
+                              {7, 9, 8, -1, -1}};  // the cut
+    for (unsigned i = 0; i != 7; ++i) {
+      boundary.facets.push_back(vector<int>());
+      for (unsigned j = 0; j != 5 and facets[i][j] >= 0; ++j) boundary.facets.back().push_back(facets[i][j]);
+    }
+    Tessellation<3, double> mesh;
+    tessellator.tessellate(generators, boundary, mesh);
+    const double volume = checkMesh(mesh, generators.size()/3);
+    const double corner = cut - 2.0;
+    POLY_CHECK2(std::abs(volume - (1.0 - pow(1.0 - corner, 3)/6.0)) < 1.0e-8, volume);
+  }
+
+  // A non-convex L.
+  {
+    const double xcut = 0.6;
+    const vector<double> generators = latticeGenerators(nx, dx, InL(xcut));
+    ReducedPLC<3, double> boundary;
+    const double xy[6][2] = {{0.0, 0.0}, {1.0, 0.0}, {1.0, xcut}, {xcut, xcut}, {xcut, 1.0}, {0.0, 1.0}};
+    for (unsigned iz = 0; iz != 2; ++iz) {
+      for (unsigned i = 0; i != 6; ++i) {
+        boundary.points.push_back(xy[i][0]);
+        boundary.points.push_back(xy[i][1]);
+        boundary.points.push_back(double(iz));
+      }
+    }
+    boundary.facets.push_back(vector<int>());
+    boundary.facets.push_back(vector<int>());
+    for (unsigned i = 0; i != 6; ++i) {
+      boundary.facets[0].push_back(5 - i);     // bottom, looking from below
+      boundary.facets[1].push_back(6 + i);     // top
+      boundary.facets.push_back(vector<int>());
+      boundary.facets.back().push_back(i);
+      boundary.facets.back().push_back((i + 1) % 6);
+      boundary.facets.back().push_back(6 + (i + 1) % 6);
+      boundary.facets.back().push_back(6 + i);
+    }
+    Tessellation<3, double> mesh;
+    tessellator.tessellate(generators, boundary, mesh);
+    const double volume = checkMesh(mesh, generators.size()/3);
+    POLY_CHECK2(std::abs(volume - (1.0 - (1.0 - xcut)*(1.0 - xcut))) < 1.0e-6, volume);
+  }
+
+  cout << "PASS" << endl;
+
+#ifdef HAVE_MPI
+  MPI_Finalize();
+#endif
+  return 0;
+}
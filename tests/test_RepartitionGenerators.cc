@@ -0,0 +1,131 @@
+// test_RepartitionGenerators
+//
+// Start with nearly all of the generators on rank 0, repartition them along
+// the Hilbert and Morton curves, and check the ranks come out balanced, the
+// origin map is a permutation of the original generators, and the
+// repartitioned generators tessellate the box with the cells mapping back to
+// where their generators started.
+
+#include <algorithm>
+#include <numeric>
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+#include <sstream>
+#include <cmath>
+
+#include "polytope.hh"
+#include "polytope_test_utilities.hh"
+#include "repartitionGenerators.hh"
+#include "checkDistributedTessellation.hh"
+#include "computeMeshGeometry.hh"
+
+#ifdef HAVE_MPI
+#include "mpi.h"
+#endif
+
+using namespace std;
+using namespace polytope;
+
+//------------------------------------------------------------------------------
+// Each rank's share of n random generators in the unit square: rank 0 takes
+// nine in ten of them.
+//------------------------------------------------------------------------------
+vector<double> lopsidedGenerators(const unsigned n, const int rank, const int numProcs) {
+  srand(10489591);
+  vector<double> result;
+  for (unsigned i = 0; i != n; ++i) {
+    const double x = random01(), y = random01();
+    const int owner = (i % 10 != 0 or numProcs == 1) ? 0 : 1 + (i/10) % (numProcs - 1);
+    if (owner == rank) {
+      result.push_back(x);
+      result.push_back(y);
+    }
+  }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// Check the repartitioned generators are the originals rearranged.
+//------------------------------------------------------------------------------
+void checkOrigin(const vector<double>& original,
+                 const vector<double>& points,
+                 const vector<pair<unsigned, unsigned> >& origin) {
+  POLY_CHECK(origin.size() == points.size()/2);
+  vector<double> x(origin.size()), y(origin.size()), xback, yback;
+  for (unsigned i = 0; i != origin.size(); ++i) {
+    x[i] = points[2*i];
+    y[i] = points[2*i + 1];
+  }
+  returnToOrigin(x, origin, xback, MPI_COMM_WORLD);
+  returnToOrigin(y, origin, yback, MPI_COMM_WORLD);
+  POLY_CHECK(xback.size() == original.size()/2);
+  for (unsigned i = 0; i != xback.size(); ++i) {
+    POLY_CHECK(xback[i] == original[2*i] and yback[i] == original[2*i + 1]);
+  }
+}
+
+//------------------------------------------------------------------------------
+// main
+//------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+  // Initialize MPI.
+  MPI_Init(&argc, &argv);
+  int rank, numProcs;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+  const unsigned n = 4000;
+  const vector<double> original = lopsidedGenerators(n, rank, numProcs);
+
+  // Hilbert, with the estimated costs.
+  {
+    vector<double> points = original;
+    vector<pair<unsigned, unsigned> > origin;
+    const RepartitionStatistics stats = repartitionGenerators<2, double>(points, vector<double>(), origin, HilbertSort);
+    if (rank == 0) cout << "Hilbert: " << stats << endl;
+    POLY_CHECK(allReduce(stats.localCount, MPI_SUM, MPI_COMM_WORLD) == n);
+    POLY_CHECK(stats.localCount == points.size()/2);
+    POLY_CHECK(numProcs == 1 or stats.imbalanceBefore() > 2.0);
+    POLY_CHECK2(stats.imbalanceAfter() < 1.1, stats.imbalanceAfter());
+    checkOrigin(original, points, origin);
+
+#ifdef HAVE_BOOST_VORONOI
+    // Tessellate the repartitioned generators, and hand the cell volumes
+    // back to the original generators.
+    double xmin[2] = {0.0, 0.0}, xmax[2] = {1.0, 1.0};
+    DistributedTessellator<2, double> tessellator(new BoostTessellator<double>(), true, true);
+    Tessellation<2, double> mesh;
+    tessellator.tessellate(points, xmin, xmax, mesh);
+    POLY_CHECK(mesh.cells.size() == points.size()/2);
+    const string parCheck = checkDistributedTessellation(mesh);
+    POLY_CHECK2(parCheck == "ok", parCheck);
+    vector<double> cellVolumes, cellCentroids, faceAreas, faceNormals, faceCentroids, volumes;
+    computeMeshGeometry(mesh, cellVolumes, cellCentroids, faceAreas, faceNormals, faceCentroids);
+    returnToOrigin(cellVolumes, origin, volumes, MPI_COMM_WORLD);
+    POLY_CHECK(volumes.size() == original.size()/2);
+    for (unsigned i = 0; i != volumes.size(); ++i) POLY_CHECK(volumes[i] > 0.0);
+    const double area = allReduce(accumulate(volumes.begin(), volumes.end(), 0.0), MPI_SUM, MPI_COMM_WORLD);
+    POLY_CHECK2(std::abs(area - 1.0) < 1.0e-10, area);
+#endif
+  }
+
+  // Morton, with the left half of the box three times as costly.
+  {
+    vector<double> points = original, costs;
+    for (unsigned i = 0; i != original.size()/2; ++i) costs.push_back(original[2*i] < 0.5 ? 3.0 : 1.0);
+    vector<pair<unsigned, unsigned> > origin;
+    const RepartitionStatistics stats = repartitionGenerators<2, double>(points, costs, origin, MortonSort);
+    if (rank == 0) cout << "Morton: " << stats << endl;
+    POLY_CHECK2(stats.imbalanceAfter() < 1.1, stats.imbalanceAfter());
+    checkOrigin(original, points, origin);
+    double localCost = 0.0;
+    for (unsigned i = 0; i != points.size()/2; ++i) localCost += (points[2*i] < 0.5 ? 3.0 : 1.0);
+    POLY_CHECK(localCost == stats.localCost);
+    POLY_CHECK(numProcs == 1 or stats.minCountAfter < stats.maxCountAfter);
+  }
+
+  cout << "PASS" << endl;
+  MPI_Finalize();
+  return 0;
+}
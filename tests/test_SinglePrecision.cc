@@ -0,0 +1,229 @@
+// -----------------------------------------------------------------------
+// test_SinglePrecision
+//
+// Tessellate the same generators with the float and double instantiations
+// of a tessellator and check we get the same cells.  Generators are
+// quantized to integers internally, so the two should agree on the topology
+// and to single precision on the geometry.
+// Triangle and Boost tessellators are tested here, and with MPI the
+// distributed tessellator wrapping Boost.
+// -----------------------------------------------------------------------
+
+#include <iostream>
+#include <vector>
+#include <set>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+
+#include "polytope.hh"
+#include "polytope_test_utilities.hh"
+
+#ifdef HAVE_MPI
+#include "mpi.h"
+#endif
+
+using namespace std;
+using namespace polytope;
+
+namespace {
+
+//------------------------------------------------------------------------------
+// The area of each cell.
+//------------------------------------------------------------------------------
+template<typename RealType>
+vector<double> cellAreas(const Tessellation<2, RealType>& mesh) {
+  vector<double> result(mesh.cells.size());
+  for (unsigned i = 0; i != mesh.cells.size(); ++i) {
+    double area = 0.0;
+    for (unsigned k = 0; k != mesh.cells[i].size(); ++k) {
+      const int iface = mesh.cells[i][k];
+      const vector<unsigned>& nodes = mesh.faces[internal::positiveID(iface)];
+      POLY_CHECK(nodes.size() == 2);
+      const unsigned n0 = iface < 0 ? nodes[1] : nodes[0];
+      const unsigned n1 = iface < 0 ? nodes[0] : nodes[1];
+      area += 0.5*(double(mesh.nodes[2*n0])*double(mesh.nodes[2*n1+1]) -
+                   double(mesh.nodes[2*n1])*double(mesh.nodes[2*n0+1]));
+    }
+    result[i] = area;
+  }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// The sorted set of neighbors of each cell.
+//------------------------------------------------------------------------------
+template<typename RealType>
+vector<set<int> > cellNeighbors(const Tessellation<2, RealType>& mesh) {
+  vector<set<int> > result(mesh.cells.size());
+  for (unsigned i = 0; i != mesh.cells.size(); ++i) {
+    for (unsigned k = 0; k != mesh.cells[i].size(); ++k) {
+      const vector<int>& fcells = mesh.faceCells[internal::positiveID(mesh.cells[i][k])];
+      for (unsigned j = 0; j != fcells.size(); ++j) {
+        const int icell = internal::positiveID(fcells[j]);
+        if (icell != int(i)) result[i].insert(icell);
+      }
+    }
+  }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// Compare a float and double tessellation of the same generators.
+//------------------------------------------------------------------------------
+void compareMeshes(const Tessellation<2, float>& fmesh,
+                   const Tessellation<2, double>& dmesh,
+                   const double totalArea) {
+  POLY_CHECK(fmesh.cells.size() == dmesh.cells.size());
+  POLY_CHECK(fmesh.faces.size() == dmesh.faces.size());
+  POLY_CHECK(fmesh.nodes.size() == dmesh.nodes.size());
+  POLY_CHECK(cellNeighbors(fmesh) == cellNeighbors(dmesh));
+  const vector<double> fareas = cellAreas(fmesh), dareas = cellAreas(dmesh);
+  double fsum = 0.0;
+  for (unsigned i = 0; i != fareas.size(); ++i) {
+    POLY_CHECK2(std::abs(fareas[i] - dareas[i]) < 1.0e-5*totalArea,
+                "Cell " << i << " area mismatch: " << fareas[i] << " != " << dareas[i]);
+    fsum += fareas[i];
+  }
+  POLY_CHECK2(std::abs(fsum - totalArea) < 1.0e-5*totalArea,
+              "Total area " << fsum << " != " << totalArea);
+}
+
+//------------------------------------------------------------------------------
+// Tessellate random generators in a box and in a PLC with both precisions.
+//------------------------------------------------------------------------------
+template<template<typename> class TessellatorType>
+void testTessellator() {
+  TessellatorType<float> ftessellator;
+  TessellatorType<double> dtessellator;
+  cout << "   " << ftessellator.name() << endl;
+
+  // Generate the points in float so both tessellators see identical input.
+  const unsigned n = 200;
+  vector<float> fpoints;
+  for (unsigned i = 0; i != 2*n; ++i) fpoints.push_back(float(random01()));
+  const vector<double> dpoints(fpoints.begin(), fpoints.end());
+
+  // Box.
+  {
+    float flow[2] = {0.0f, 0.0f}, fhigh[2] = {1.0f, 1.0f};
+    double dlow[2] = {0.0, 0.0}, dhigh[2] = {1.0, 1.0};
+    Tessellation<2, float> fmesh;
+    Tessellation<2, double> dmesh;
+    ftessellator.tessellate(fpoints, flow, fhigh, fmesh);
+    dtessellator.tessellate(dpoints, dlow, dhigh, dmesh);
+    POLY_CHECK(fmesh.cells.size() == n);
+    compareMeshes(fmesh, dmesh, 1.0);
+  }
+
+  // An L-shaped PLC.
+  {
+    const float coords[12] = {0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.5f,
+                              0.5f, 0.5f, 0.5f, 1.0f, 0.0f, 1.0f};
+    const vector<float> fPLCpoints(coords, coords + 12);
+    const vector<double> dPLCpoints(coords, coords + 12);
+    PLC<2, float> fboundary;
+    PLC<2, double> dboundary;
+    fboundary.facets.resize(6, vector<int>(2));
+    for (unsigned i = 0; i != 6; ++i) {
+      fboundary.facets[i][0] = i;
+      fboundary.facets[i][1] = (i + 1) % 6;
+    }
+    dboundary.facets = fboundary.facets;
+
+    // Keep the generators inside the boundary.
+    vector<float> finside;
+    for (unsigned i = 0; i != n; ++i) {
+      if (fpoints[2*i] < 0.5f or fpoints[2*i+1] < 0.5f) {
+        finside.push_back(fpoints[2*i]);
+        finside.push_back(fpoints[2*i+1]);
+      }
+    }
+    const vector<double> dinside(finside.begin(), finside.end());
+    Tessellation<2, float> fmesh;
+    Tessellation<2, double> dmesh;
+    ftessellator.tessellate(finside, fPLCpoints, fboundary, fmesh);
+    dtessellator.tessellate(dinside, dPLCpoints, dboundary, dmesh);
+    POLY_CHECK(fmesh.cells.size() == finside.size()/2);
+    compareMeshes(fmesh, dmesh, 0.75);
+  }
+}
+
+#ifdef HAVE_MPI
+//------------------------------------------------------------------------------
+// The same for the distributed tessellator, each rank taking a strip of the
+// unit box.
+//------------------------------------------------------------------------------
+template<template<typename> class TessellatorType>
+void testDistributed() {
+  int rank, numProcs;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+  DistributedTessellator<2, float> ftessellator(new TessellatorType<float>(), true, true);
+  DistributedTessellator<2, double> dtessellator(new TessellatorType<double>(), true, true);
+  cout << "   Distributed " << ftessellator.name() << endl;
+
+  const unsigned n = 400;
+  vector<float> fpoints;
+  for (unsigned i = 0; i != n; ++i) {
+    const float x = float(random01()), y = float(random01());
+    if (min(int(x*numProcs), numProcs - 1) == rank) {
+      fpoints.push_back(x);
+      fpoints.push_back(y);
+    }
+  }
+  const vector<double> dpoints(fpoints.begin(), fpoints.end());
+  float flow[2] = {0.0f, 0.0f}, fhigh[2] = {1.0f, 1.0f};
+  double dlow[2] = {0.0, 0.0}, dhigh[2] = {1.0, 1.0};
+  Tessellation<2, float> fmesh;
+  Tessellation<2, double> dmesh;
+  ftessellator.tessellate(fpoints, flow, fhigh, fmesh);
+  dtessellator.tessellate(dpoints, dlow, dhigh, dmesh);
+  POLY_CHECK(fmesh.cells.size() == fpoints.size()/2);
+  POLY_CHECK(dmesh.cells.size() == fpoints.size()/2);
+
+  // The distributed tessellator quantizes over a box computed in RealType,
+  // so an edge between nearly cocircular generators may flip between the two
+  // precisions.  We only hold the cell areas to single precision.
+  const vector<double> fareas = cellAreas(fmesh), dareas = cellAreas(dmesh);
+  for (unsigned i = 0; i != fareas.size(); ++i) {
+    POLY_CHECK2(std::abs(fareas[i] - dareas[i]) < 1.0e-5,
+                "Cell " << i << " area mismatch: " << fareas[i] << " != " << dareas[i]);
+  }
+  double farea = accumulate(fareas.begin(), fareas.end(), 0.0), area;
+  MPI_Allreduce(&farea, &area, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  POLY_CHECK2(std::abs(area - 1.0) < 1.0e-5, "Total area " << area << " != 1");
+}
+#endif
+
+}
+
+// -----------------------------------------------------------------------
+// main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+#ifdef HAVE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+#ifdef HAVE_TRIANGLE
+  cout << "\nTriangle Tessellator:\n" << endl;
+  testTessellator<TriangleTessellator>();
+#endif
+
+#ifdef HAVE_BOOST_VORONOI
+  cout << "\nBoost Tessellator:\n" << endl;
+  testTessellator<BoostTessellator>();
+#ifdef HAVE_MPI
+  testDistributed<BoostTessellator>();
+#endif
+#endif
+
+  cout << "PASS" << endl;
+
+#ifdef HAVE_MPI
+  MPI_Finalize();
+#endif
+  return 0;
+}
@@ -0,0 +1,246 @@
+// -----------------------------------------------------------------------
+// test_SpatialSort
+//
+// Check the space filling curve orderings in spatialOrderIndices, and that
+// tessellating with spatially sorted generators gives back the same cells
+// in the caller's order.  Also times the tessellation of a shuffled set of
+// generators with and without sorting.
+// Triangle and Boost tessellators are tested here.
+// -----------------------------------------------------------------------
+
+#include <iostream>
+#include <vector>
+#include <set>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+#include "polytope.hh"
+#include "spatialOrderIndices.hh"
+#include "polytope_test_utilities.hh"
+
+#include "timingUtilities.hh"
+
+#ifdef HAVE_MPI
+#include "mpi.h"
+#endif
+
+using namespace std;
+using namespace polytope;
+
+namespace {
+
+//------------------------------------------------------------------------------
+// Fisher-Yates shuffle of a set of 2D points.
+//------------------------------------------------------------------------------
+void shufflePoints(vector<double>& points) {
+  const unsigned n = points.size()/2;
+  for (unsigned i = n - 1; i > 0; --i) {
+    const unsigned j = std::min(i, unsigned(random01()*(i + 1)));
+    std::swap(points[2*i  ], points[2*j  ]);
+    std::swap(points[2*i+1], points[2*j+1]);
+  }
+}
+
+//------------------------------------------------------------------------------
+// A lattice traversed along a Hilbert curve only ever steps to a neighbor.
+//------------------------------------------------------------------------------
+void testCurves() {
+  const unsigned nx = 32;
+  vector<double> points2d, points3d;
+  for (unsigned iy = 0; iy != nx; ++iy) {
+    for (unsigned ix = 0; ix != nx; ++ix) {
+      points2d.push_back(ix);
+      points2d.push_back(iy);
+    }
+  }
+  shufflePoints(points2d);
+  for (unsigned iz = 0; iz != 8; ++iz) {
+    for (unsigned iy = 0; iy != 8; ++iy) {
+      for (unsigned ix = 0; ix != 8; ++ix) {
+        points3d.push_back(ix);
+        points3d.push_back(iy);
+        points3d.push_back(iz);
+      }
+    }
+  }
+
+  // 2D
+  {
+    const vector<unsigned> order = spatialOrderIndices<2, double>(points2d, HilbertSort);
+    POLY_CHECK(order.size() == nx*nx);
+    POLY_CHECK(set<unsigned>(order.begin(), order.end()).size() == nx*nx);
+    for (unsigned i = 1; i != order.size(); ++i) {
+      const double d = (std::abs(points2d[2*order[i]  ] - points2d[2*order[i-1]  ]) +
+                        std::abs(points2d[2*order[i]+1] - points2d[2*order[i-1]+1]));
+      POLY_CHECK2(d == 1.0, "2D Hilbert step " << i << " jumps " << d);
+    }
+    const vector<unsigned> morder = spatialOrderIndices<2, double>(points2d, MortonSort);
+    POLY_CHECK(set<unsigned>(morder.begin(), morder.end()).size() == nx*nx);
+  }
+
+  // 3D
+  {
+    const vector<unsigned> order = spatialOrderIndices<3, double>(points3d, HilbertSort);
+    POLY_CHECK(order.size() == 512);
+    POLY_CHECK(set<unsigned>(order.begin(), order.end()).size() == 512);
+    for (unsigned i = 1; i != order.size(); ++i) {
+      double d = 0.0;
+      for (unsigned j = 0; j != 3; ++j) d += std::abs(points3d[3*order[i]+j] - points3d[3*order[i-1]+j]);
+      POLY_CHECK2(d == 1.0, "3D Hilbert step " << i << " jumps " << d);
+    }
+  }
+
+  // No sorting is the identity.
+  {
+    const vector<unsigned> order = spatialOrderIndices<2, double>(points2d, NoSpatialSort);
+    for (unsigned i = 0; i != order.size(); ++i) POLY_CHECK(order[i] == i);
+  }
+}
+
+//------------------------------------------------------------------------------
+// The signed area of each cell.
+//------------------------------------------------------------------------------
+vector<double> cellAreas(const Tessellation<2, double>& mesh) {
+  vector<double> result(mesh.cells.size());
+  double ccent[2];
+  for (unsigned i = 0; i != mesh.cells.size(); ++i) {
+    geometry::computeCellCentroidAndSignedArea(mesh, i, 1.0e-12, ccent, result[i]);
+  }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// The sorted set of neighbors of each cell.
+//------------------------------------------------------------------------------
+vector<set<int> > cellNeighbors(const Tessellation<2, double>& mesh) {
+  vector<set<int> > result(mesh.cells.size());
+  for (unsigned i = 0; i != mesh.cells.size(); ++i) {
+    for (unsigned k = 0; k != mesh.cells[i].size(); ++k) {
+      const vector<int>& fcells = mesh.faceCells[internal::positiveID(mesh.cells[i][k])];
+      POLY_CHECK(fcells.size() == 1 or fcells.size() == 2);
+      bool found = false;
+      for (unsigned j = 0; j != fcells.size(); ++j) {
+        const int icell = internal::positiveID(fcells[j]);
+        if (icell == int(i)) found = true;
+        else result[i].insert(icell);
+      }
+      POLY_CHECK(found);
+    }
+  }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// Tessellate shuffled generators with each ordering and compare.
+//------------------------------------------------------------------------------
+void testTessellator(Tessellator<2, double>& tessellator) {
+  const unsigned n = 400;
+  vector<double> points;
+  for (unsigned i = 0; i != n; ++i) {
+    points.push_back(random01());
+    points.push_back(random01());
+  }
+  double low[2] = {0.0, 0.0}, high[2] = {1.0, 1.0};
+
+  tessellator.spatialSort(NoSpatialSort);
+  Tessellation<2, double> mesh0;
+  tessellator.tessellate(points, low, high, mesh0);
+  const vector<double> areas0 = cellAreas(mesh0);
+  const vector<set<int> > neighbors0 = cellNeighbors(mesh0);
+
+  const SpatialSort methods[2] = {MortonSort, HilbertSort};
+  for (unsigned m = 0; m != 2; ++m) {
+    tessellator.spatialSort(methods[m]);
+    POLY_CHECK(tessellator.spatialSort() == methods[m]);
+    Tessellation<2, double> mesh;
+    tessellator.tessellate(points, low, high, mesh);
+    POLY_CHECK(mesh.cells.size() == n);
+    const vector<double> areas = cellAreas(mesh);
+    const vector<set<int> > neighbors = cellNeighbors(mesh);
+    for (unsigned i = 0; i != n; ++i) {
+      POLY_CHECK2(std::abs(areas[i] - areas0[i]) < 1.0e-8*std::max(1.0, std::abs(areas0[i])),
+                  "Cell " << i << " area mismatch: " << areas[i] << " != " << areas0[i]);
+      POLY_CHECK2(neighbors[i] == neighbors0[i], "Cell " << i << " neighbor mismatch.");
+    }
+
+    // Unbounded tessellations have the same cells too.
+    Tessellation<2, double> umesh0, umesh;
+    tessellator.spatialSort(NoSpatialSort);
+    tessellator.tessellate(points, umesh0);
+    tessellator.spatialSort(methods[m]);
+    tessellator.tessellate(points, umesh);
+    POLY_CHECK(cellNeighbors(umesh) == cellNeighbors(umesh0));
+  }
+  tessellator.spatialSort(NoSpatialSort);
+}
+
+//------------------------------------------------------------------------------
+// Time a shuffled set of generators with and without sorting.
+//------------------------------------------------------------------------------
+void timeTessellator(Tessellator<2, double>& tessellator) {
+  const unsigned nx = 60;
+  vector<double> points;
+  for (unsigned iy = 0; iy != nx; ++iy) {
+    for (unsigned ix = 0; ix != nx; ++ix) {
+      points.push_back((ix + 0.5 + 0.25*(random01() - 0.5))/nx);
+      points.push_back((iy + 0.5 + 0.25*(random01() - 0.5))/nx);
+    }
+  }
+  shufflePoints(points);
+  double low[2] = {0.0, 0.0}, high[2] = {1.0, 1.0};
+
+  const SpatialSort methods[3] = {NoSpatialSort, MortonSort, HilbertSort};
+  const char* names[3] = {"unsorted", "Morton", "Hilbert"};
+  for (unsigned m = 0; m != 3; ++m) {
+    tessellator.spatialSort(methods[m]);
+    Tessellation<2, double> mesh;
+    Timing::Time start = Timing::currentTime();
+    tessellator.tessellate(points, low, high, mesh);
+    const double time = Timing::difference(start, Timing::currentTime());
+    POLY_CHECK(mesh.cells.size() == nx*nx);
+    cout << "   " << nx*nx << " shuffled generators, " << names[m] << ": "
+         << time << " seconds." << endl;
+  }
+  tessellator.spatialSort(NoSpatialSort);
+}
+
+}
+
+// -----------------------------------------------------------------------
+// main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+#ifdef HAVE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  cout << "Space filling curves:" << endl;
+  testCurves();
+
+#ifdef HAVE_TRIANGLE
+  {
+    cout << "\nTriangle Tessellator:\n" << endl;
+    TriangleTessellator<double> tessellator;
+    testTessellator(tessellator);
+    timeTessellator(tessellator);
+  }
+#endif
+
+#ifdef HAVE_BOOST_VORONOI
+  {
+    cout << "\nBoost Tessellator:\n" << endl;
+    BoostTessellator<double> tessellator;
+    testTessellator(tessellator);
+    timeTessellator(tessellator);
+  }
+#endif
+
+  cout << "PASS" << endl;
+
+#ifdef HAVE_MPI
+  MPI_Finalize();
+#endif
+  return 0;
+}
@@ -0,0 +1,110 @@
+// -----------------------------------------------------------------------
+// test_Timers
+//
+// Check the tessellation timers and counters in timingUtilities.hh record
+// the stages of a tessellation only while enabled, and reset cleanly.
+// -----------------------------------------------------------------------
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "polytope.hh"
+#include "timingUtilities.hh"
+#include "polytope_test_utilities.hh"
+
+#ifdef HAVE_MPI
+#include "mpi.h"
+#endif
+
+using namespace std;
+using namespace polytope;
+
+// -----------------------------------------------------------------------
+// main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+#ifdef HAVE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  // The clock.
+  {
+    const Timing::Time t0 = Timing::currentTime();
+    double x = 0.0;
+    for (unsigned i = 0; i != 100000; ++i) x += 1.0/(i + 1.0);
+    const double dt = Timing::difference(t0, Timing::currentTime());
+    POLY_CHECK(dt >= 0.0 and dt < 10.0 and x > 0.0);
+  }
+
+  // Timers and counters only record while enabled.
+  {
+    POLY_CHECK(not timersEnabled());
+    {
+      ScopedTimer timer("outer");
+      incrementCounter("things", 3);
+    }
+    POLY_CHECK(timerNames().empty() and counterNames().empty());
+    enableTimers();
+    POLY_CHECK(timersEnabled());
+    for (unsigned i = 0; i != 3; ++i) {
+      ScopedTimer timer("outer");
+      incrementCounter("things", 3);
+      timer.stop();
+      timer.stop();
+    }
+    POLY_CHECK(timerCalls("outer") == 3);
+    POLY_CHECK(timerSeconds("outer") >= 0.0);
+    POLY_CHECK(counterValue("things") == 9);
+    POLY_CHECK(timerCalls("unknown") == 0 and timerSeconds("unknown") == 0.0 and counterValue("unknown") == 0);
+    POLY_CHECK(timersReport().find("things") != string::npos);
+    resetTimers();
+    POLY_CHECK(timerNames().empty() and counterNames().empty());
+    enableTimers(false);
+  }
+
+#ifdef HAVE_BOOST_VORONOI
+  // The stages of a tessellation in a box.
+  {
+    const unsigned n = 1000;
+    vector<double> points;
+    for (unsigned i = 0; i != 2*n; ++i) points.push_back(random01());
+    double low[2] = {0.0, 0.0}, high[2] = {1.0, 1.0};
+    BoostTessellator<double> tessellator;
+    {
+      Tessellation<2, double> mesh;
+      tessellator.tessellate(points, low, high, mesh);
+      POLY_CHECK(timerNames().empty());
+    }
+    enableTimers();
+    for (unsigned k = 0; k != 2; ++k) {
+      Tessellation<2, double> mesh;
+      tessellator.tessellate(points, low, high, mesh);
+    }
+    cout << timersReport();
+    const char* stages[] = {"tessellate", "tessellateQuantized", "delaunay", "voronoiWalk",
+                            "clipQuantizedTessellation", "adoptOrphans", "fillTessellation",
+                            "findBoundaryElements", "snapToBoundary"};
+    const vector<string> names = timerNames();
+    for (unsigned i = 0; i != sizeof(stages)/sizeof(stages[0]); ++i) {
+      POLY_CHECK2(count(names.begin(), names.end(), stages[i]) == 1, "Missing timer " << stages[i]);
+      POLY_CHECK(timerCalls(stages[i]) == 2);
+      POLY_CHECK(timerSeconds(stages[i]) <= timerSeconds("tessellate"));
+    }
+    POLY_CHECK(timerCalls("spatialSort") == 0);
+    POLY_CHECK(counterValue("cells") == 2*n);
+    POLY_CHECK(counterValue("cellsClipped") > 0 and counterValue("cellsClipped") < 2*n);
+    enableTimers(false);
+    resetTimers();
+  }
+#endif
+
+  cout << "PASS" << endl;
+
+#ifdef HAVE_MPI
+  MPI_Finalize();
+#endif
+  return 0;
+}
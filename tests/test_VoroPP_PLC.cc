@@ -0,0 +1,214 @@
+// test_VoroPP_PLC
+//
+// Tessellate random generators with VoroPP_3d inside PLCs: a box, which is
+// clipped as a convex boundary, and an L and a cube with a cubic hole, which
+// are not.  Every cell has to be closed, in one piece, and of positive
+// volume, and the cell volumes have to sum to the volume inside the PLC.
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <set>
+#include <cmath>
+
+#include "polytope.hh"
+#include "polytope_test_utilities.hh"
+
+using namespace std;
+using namespace polytope;
+
+namespace {
+
+//------------------------------------------------------------------------------
+// Add a box to a PLC, as the outer boundary or as a hole.
+//------------------------------------------------------------------------------
+void
+addBox(const double* low, const double* high,
+       vector<double>& points,
+       vector<vector<int> >& facets) {
+  const int offset = points.size()/3;
+  for (unsigned i = 0; i != 8; ++i) {
+    points.push_back((i & 1) ? high[0] : low[0]);
+    points.push_back((i & 2) ? high[1] : low[1]);
+    points.push_back((i & 4) ? high[2] : low[2]);
+  }
+  const int corners[6][4] = {{0, 4, 6, 2}, {1, 3, 7, 5}, {0, 1, 5, 4},
+                             {2, 6, 7, 3}, {0, 2, 3, 1}, {4, 5, 7, 6}};
+  for (unsigned f = 0; f != 6; ++f) {
+    facets.push_back(vector<int>());
+    for (unsigned k = 0; k != 4; ++k) facets.back().push_back(offset + corners[f][k]);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Random generators in the unit cube, inside the region.
+//------------------------------------------------------------------------------
+template<typename Inside>
+vector<double>
+randomGenerators(const unsigned n, const Inside& inside) {
+  vector<double> result;
+  while (result.size() != 3*n) {
+    const double p[3] = {random01(), random01(), random01()};
+    if (inside(p)) result.insert(result.end(), p, p + 3);
+  }
+  return result;
+}
+
+struct InCube {
+  bool operator()(const double* p) const { return true; }
+};
+
+struct InL {
+  double xcut;
+  InL(const double x): xcut(x) {}
+  bool operator()(const double* p) const { return p[0] < xcut or p[1] < xcut; }
+};
+
+struct OutsideHole {
+  double low, high;
+  OutsideHole(const double l, const double h): low(l), high(h) {}
+  bool operator()(const double* p) const {
+    return not (p[0] > low and p[0] < high and p[1] > low and p[1] < high and p[2] > low and p[2] < high);
+  }
+};
+
+//------------------------------------------------------------------------------
+// Check the mesh and return its volume.
+//------------------------------------------------------------------------------
+double
+checkMesh(const Tessellation<3, double>& mesh, const unsigned ncells) {
+  POLY_CHECK(mesh.cells.size() == ncells);
+  POLY_CHECK(mesh.faceCells.size() == mesh.faces.size());
+  for (unsigned i = 0; i != mesh.faces.size(); ++i) {
+    POLY_CHECK(mesh.faces[i].size() >= 3);
+    POLY_CHECK(mesh.faceCells[i].size() == 1 or mesh.faceCells[i].size() == 2);
+    if (mesh.faceCells[i].size() == 2) POLY_CHECK(mesh.faceCells[i][0] >= 0 and mesh.faceCells[i][1] < 0);
+  }
+
+  double volume = 0.0;
+  for (unsigned i = 0; i != ncells; ++i) {
+
+    // Each cell edge is traversed once in each direction by the cell faces.
+    map<pair<unsigned, unsigned>, int> edgeCount;
+    map<pair<unsigned, unsigned>, unsigned> edgeFace;
+    const unsigned nf = mesh.cells[i].size();
+    for (unsigned j = 0; j != nf; ++j) {
+      const int f = mesh.cells[i][j];
+      const vector<unsigned>& face = mesh.faces[f < 0 ? ~f : f];
+      const unsigned n = face.size();
+      for (unsigned k = 0; k != n; ++k) {
+        const unsigned a = face[k], b = face[(k + 1) % n];
+        const pair<unsigned, unsigned> edge = (f < 0 ? make_pair(b, a) : make_pair(a, b));
+        ++edgeCount[edge];
+        edgeFace[edge] = j;
+      }
+    }
+    for (map<pair<unsigned, unsigned>, int>::const_iterator itr = edgeCount.begin(); itr != edgeCount.end(); ++itr) {
+      POLY_CHECK2(itr->second == 1 and edgeCount.find(make_pair(itr->first.second, itr->first.first)) != edgeCount.end(),
+                  "Cell " << i << " is not closed at edge (" << itr->first.first << " " << itr->first.second << ")");
+    }
+
+    // The faces are all connected through their edges.
+    vector<bool> reached(nf, false);
+    vector<unsigned> stack(1, 0);
+    reached[0] = true;
+    unsigned nreached = 1;
+    while (not stack.empty()) {
+      const int f = mesh.cells[i][stack.back()];
+      stack.pop_back();
+      const vector<unsigned>& face = mesh.faces[f < 0 ? ~f : f];
+      const unsigned n = face.size();
+      for (unsigned k = 0; k != n; ++k) {
+        const unsigned a = face[k], b = face[(k + 1) % n];
+        const unsigned j = edgeFace[f < 0 ? make_pair(a, b) : make_pair(b, a)];
+        if (not reached[j]) {
+          reached[j] = true;
+          ++nreached;
+          stack.push_back(j);
+        }
+      }
+    }
+    POLY_CHECK2(nreached == nf, "Cell " << i << " is in more than one piece");
+
+    double centroid[3], vol;
+    geometry::computeCellCentroidAndSignedVolume(mesh, i, centroid, vol);
+    POLY_CHECK2(vol > 0.0, "Cell " << i << " volume " << vol);
+    volume += vol;
+  }
+  return volume;
+}
+
+}
+
+// -----------------------------------------------------------------------
+// main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+  const unsigned n = 400;
+  VoroPP_3d<double> voro;
+  POLY_CHECK(voro.handlesPLCs());
+
+  // The unit box.
+  {
+    const vector<double> generators = randomGenerators(n, InCube());
+    ReducedPLC<3, double> boundary;
+    const double low[3] = {0.0, 0.0, 0.0}, high[3] = {1.0, 1.0, 1.0};
+    addBox(low, high, boundary.points, boundary.facets);
+    Tessellation<3, double> mesh;
+    voro.tessellate(generators, boundary, mesh);
+    const double volume = checkMesh(mesh, n);
+    POLY_CHECK2(std::abs(volume - 1.0) < 1.0e-6, volume);
+    cout << "Box: " << mesh.faces.size() << " faces, volume " << volume << endl;
+  }
+
+  // A non-convex L.
+  {
+    const double xcut = 0.6;
+    const vector<double> generators = randomGenerators(n, InL(xcut));
+    ReducedPLC<3, double> boundary;
+    const double xy[6][2] = {{0.0, 0.0}, {1.0, 0.0}, {1.0, xcut}, {xcut, xcut}, {xcut, 1.0}, {0.0, 1.0}};
+    for (unsigned iz = 0; iz != 2; ++iz) {
+      for (unsigned i = 0; i != 6; ++i) {
+        boundary.points.push_back(xy[i][0]);
+        boundary.points.push_back(xy[i][1]);
+        boundary.points.push_back(double(iz));
+      }
+    }
+    boundary.facets.push_back(vector<int>());
+    boundary.facets.push_back(vector<int>());
+    for (unsigned i = 0; i != 6; ++i) {
+      boundary.facets[0].push_back(5 - i);     // bottom, looking from below
+      boundary.facets[1].push_back(6 + i);     // top
+      boundary.facets.push_back(vector<int>());
+      boundary.facets.back().push_back(i);
+      boundary.facets.back().push_back((i + 1) % 6);
+      boundary.facets.back().push_back(6 + (i + 1) % 6);
+      boundary.facets.back().push_back(6 + i);
+    }
+    Tessellation<3, double> mesh;
+    voro.tessellate(generators, boundary, mesh);
+    const double volume = checkMesh(mesh, n);
+    POLY_CHECK2(std::abs(volume - (1.0 - (1.0 - xcut)*(1.0 - xcut))) < 1.0e-6, volume);
+    cout << "L: " << mesh.faces.size() << " faces, volume " << volume << endl;
+  }
+
+  // The unit box with a cubic hole in the middle.
+  {
+    const double hlow = 0.35, hhigh = 0.65;
+    const vector<double> generators = randomGenerators(n, OutsideHole(hlow, hhigh));
+    ReducedPLC<3, double> boundary;
+    const double low[3] = {0.0, 0.0, 0.0}, high[3] = {1.0, 1.0, 1.0};
+    const double holeLow[3] = {hlow, hlow, hlow}, holeHigh[3] = {hhigh, hhigh, hhigh};
+    addBox(low, high, boundary.points, boundary.facets);
+    boundary.holes.resize(1);
+    addBox(holeLow, holeHigh, boundary.points, boundary.holes[0]);
+    Tessellation<3, double> mesh;
+    voro.tessellate(generators, boundary, mesh);
+    const double volume = checkMesh(mesh, n);
+    POLY_CHECK2(std::abs(volume - (1.0 - pow(hhigh - hlow, 3))) < 1.0e-6, volume);
+    cout << "Hole: " << mesh.faces.size() << " faces, volume " << volume << endl;
+  }
+
+  cout << "PASS" << endl;
+  return 0;
+}
@@ -0,0 +1,190 @@
+// test_VoroPP_Periodic
+//
+// Tessellate random generators in periodic boxes with VoroPP_2d and
+// VoroPP_3d, and check the faces wrap consistently: every face has two
+// cells, and each face lies on the bisector between each of its cells and
+// the other cell's image shifted by the face's periodic shift (negated when
+// seen from the second cell).  Unwrapping every cell about its generator,
+// the cell volumes also have to sum to the box volume.
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <stdlib.h>
+
+#include "polytope.hh"
+#include "polytope_test_utilities.hh"
+
+using namespace std;
+using namespace polytope;
+
+//------------------------------------------------------------------------------
+// The periodic image of the node position x closest to the generator g.
+//------------------------------------------------------------------------------
+template<int Dimension>
+void
+unwrap(const double* x, const double* g, const double* length, double* result) {
+  for (unsigned j = 0; j != Dimension; ++j) {
+    result[j] = x[j] - length[j]*floor((x[j] - g[j])/length[j] + 0.5);
+  }
+}
+
+//------------------------------------------------------------------------------
+// The shift of each face, as seen from its first cell.
+//------------------------------------------------------------------------------
+template<int Dimension>
+vector<int>
+faceShifts(const Tessellation<Dimension, double>& mesh) {
+  POLY_CHECK(mesh.periodicFaceShifts.size() == Dimension*mesh.periodicFaces.size());
+  vector<int> result(Dimension*mesh.faces.size(), 0);
+  for (unsigned k = 0; k != mesh.periodicFaces.size(); ++k) {
+    const unsigned iface = mesh.periodicFaces[k];
+    POLY_CHECK(iface < mesh.faces.size());
+    for (unsigned j = 0; j != Dimension; ++j) {
+      POLY_CHECK(result[Dimension*iface + j] == 0);
+      result[Dimension*iface + j] = mesh.periodicFaceShifts[Dimension*k + j];
+    }
+  }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// Check the face f lies on the bisector between the generator of cell i and
+// the image of the generator of cell j shifted by shift.
+//------------------------------------------------------------------------------
+template<int Dimension>
+void
+checkBisector(const Tessellation<Dimension, double>& mesh,
+              const vector<double>& points,
+              const double* length,
+              const unsigned iface,
+              const unsigned i,
+              const unsigned j,
+              const int* shift) {
+  const double* gi = &points[Dimension*i];
+  const double* gj = &points[Dimension*j];
+  const vector<unsigned>& face = mesh.faces[iface];
+  double xn[Dimension], xf[Dimension] = {0.0}, di = 0.0, dj = 0.0;
+  for (unsigned k = 0; k != face.size(); ++k) {
+    unwrap<Dimension>(&mesh.nodes[Dimension*face[k]], gi, length, xn);
+    for (unsigned m = 0; m != Dimension; ++m) xf[m] += xn[m]/face.size();
+  }
+  for (unsigned m = 0; m != Dimension; ++m) {
+    di += (xf[m] - gi[m])*(xf[m] - gi[m]);
+    dj += (xf[m] - gj[m] - shift[m]*length[m])*(xf[m] - gj[m] - shift[m]*length[m]);
+  }
+  POLY_CHECK2(std::abs(sqrt(di) - sqrt(dj)) < 1.0e-6,
+              "face " << iface << " between cells " << i << " and " << j << " : " << sqrt(di) << " != " << sqrt(dj));
+}
+
+//------------------------------------------------------------------------------
+// The shared checks.
+//------------------------------------------------------------------------------
+template<int Dimension>
+void
+checkPeriodicMesh(const Tessellation<Dimension, double>& mesh,
+                  const vector<double>& points,
+                  const double* length) {
+  const unsigned ncells = points.size()/Dimension;
+  POLY_CHECK(mesh.cells.size() == ncells);
+  POLY_CHECK(mesh.faceCells.size() == mesh.faces.size());
+  POLY_CHECK(!mesh.periodicFaces.empty());
+  const vector<int> shifts = faceShifts(mesh);
+  vector<int> negShift(Dimension);
+  for (unsigned iface = 0; iface != mesh.faces.size(); ++iface) {
+    POLY_CHECK2(mesh.faceCells[iface].size() == 2, "face " << iface << " has " << mesh.faceCells[iface].size() << " cells");
+    const int c0 = mesh.faceCells[iface][0], c1 = mesh.faceCells[iface][1];
+    POLY_CHECK(c0 >= 0 and c1 < 0);
+    const int* shift = &shifts[Dimension*iface];
+    for (unsigned j = 0; j != Dimension; ++j) negShift[j] = -shift[j];
+    checkBisector(mesh, points, length, iface, c0, ~c1, shift);
+    checkBisector(mesh, points, length, iface, ~c1, c0, &negShift[0]);
+  }
+}
+
+//------------------------------------------------------------------------------
+// 2D
+//------------------------------------------------------------------------------
+void test2d() {
+  const unsigned n = 200;
+  double xmin[2] = {0.0, 0.0}, xmax[2] = {2.0, 1.0};
+  const double length[2] = {xmax[0] - xmin[0], xmax[1] - xmin[1]};
+  vector<double> points;
+  for (unsigned i = 0; i != n; ++i) {
+    points.push_back(xmin[0] + length[0]*random01());
+    points.push_back(xmin[1] + length[1]*random01());
+  }
+  Tessellation<2, double> mesh;
+  VoroPP_2d<double> voro;
+  POLY_CHECK(voro.handlesPeriodicBoxes());
+  voro.tessellatePeriodic(points, xmin, xmax, mesh);
+  checkPeriodicMesh(mesh, points, length);
+
+  // The unwrapped cell areas fill the box.
+  double area = 0.0, x0[2], x1[2];
+  for (unsigned i = 0; i != n; ++i) {
+    const double* gi = &points[2*i];
+    for (unsigned k = 0; k != mesh.cells[i].size(); ++k) {
+      const vector<unsigned>& face = mesh.faces[mesh.cells[i][k] < 0 ? ~mesh.cells[i][k] : mesh.cells[i][k]];
+      unwrap<2>(&mesh.nodes[2*face[0]], gi, length, x0);
+      unwrap<2>(&mesh.nodes[2*face[1]], gi, length, x1);
+      area += 0.5*std::abs((x0[0] - gi[0])*(x1[1] - gi[1]) - (x0[1] - gi[1])*(x1[0] - gi[0]));
+    }
+  }
+  POLY_CHECK2(std::abs(area - length[0]*length[1]) < 1.0e-8, area << " != " << length[0]*length[1]);
+  cout << "2D: " << mesh.faces.size() << " faces, " << mesh.periodicFaces.size() << " periodic" << endl;
+}
+
+//------------------------------------------------------------------------------
+// 3D
+//------------------------------------------------------------------------------
+void test3d() {
+  const unsigned n = 300;
+  double xmin[3] = {-1.0, 0.0, 0.0}, xmax[3] = {1.0, 1.0, 2.0};
+  const double length[3] = {xmax[0] - xmin[0], xmax[1] - xmin[1], xmax[2] - xmin[2]};
+  vector<double> points;
+  for (unsigned i = 0; i != n; ++i) {
+    for (unsigned j = 0; j != 3; ++j) points.push_back(xmin[j] + length[j]*random01());
+  }
+  Tessellation<3, double> mesh;
+  VoroPP_3d<double> voro;
+  POLY_CHECK(voro.handlesPeriodicBoxes());
+  voro.tessellatePeriodic(points, xmin, xmax, mesh);
+  checkPeriodicMesh(mesh, points, length);
+
+  // The unwrapped cell volumes fill the box.
+  double volume = 0.0, x0[3], x1[3], x2[3];
+  for (unsigned i = 0; i != n; ++i) {
+    const double* gi = &points[3*i];
+    for (unsigned k = 0; k != mesh.cells[i].size(); ++k) {
+      const vector<unsigned>& face = mesh.faces[mesh.cells[i][k] < 0 ? ~mesh.cells[i][k] : mesh.cells[i][k]];
+      unwrap<3>(&mesh.nodes[3*face[0]], gi, length, x0);
+      for (unsigned m = 1; m + 1 < face.size(); ++m) {
+        unwrap<3>(&mesh.nodes[3*face[m]], gi, length, x1);
+        unwrap<3>(&mesh.nodes[3*face[m + 1]], gi, length, x2);
+        for (unsigned j = 0; j != 3; ++j) {
+          x1[j] -= x0[j];
+          x2[j] -= x0[j];
+        }
+        volume += std::abs((gi[0] - x0[0])*(x1[1]*x2[2] - x1[2]*x2[1]) +
+                           (gi[1] - x0[1])*(x1[2]*x2[0] - x1[0]*x2[2]) +
+                           (gi[2] - x0[2])*(x1[0]*x2[1] - x1[1]*x2[0]))/6.0;
+      }
+    }
+  }
+  const double boxVolume = length[0]*length[1]*length[2];
+  POLY_CHECK2(std::abs(volume - boxVolume) < 1.0e-8, volume << " != " << boxVolume);
+  cout << "3D: " << mesh.faces.size() << " faces, " << mesh.periodicFaces.size() << " periodic" << endl;
+}
+
+//------------------------------------------------------------------------------
+// main
+//------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+  srand(10489591);
+  test2d();
+  test3d();
+  cout << "PASS" << endl;
+  return 0;
+}
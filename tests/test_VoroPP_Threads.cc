@@ -0,0 +1,95 @@
+// test_VoroPP_Threads
+//
+// VoroPP_2d and VoroPP_3d compute their cells concurrently, but merge them
+// into the mesh in generator order.  Check the box and periodic
+// tessellations of random generators come out identical with one thread and
+// with several.  Without OpenMP both runs are serial, and this only checks
+// the tessellations are repeatable.
+
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+
+#include "polytope.hh"
+#include "polytope_test_utilities.hh"
+#include "polytope_thread_utilities.hh"
+
+using namespace std;
+using namespace polytope;
+
+//------------------------------------------------------------------------------
+// Check two tessellations are identical.
+//------------------------------------------------------------------------------
+template<int Dimension>
+void
+checkIdentical(const Tessellation<Dimension, double>& mesh0,
+               const Tessellation<Dimension, double>& mesh1) {
+  POLY_CHECK(mesh1.nodes == mesh0.nodes);
+  POLY_CHECK(mesh1.cells == mesh0.cells);
+  POLY_CHECK(mesh1.faces == mesh0.faces);
+  POLY_CHECK(mesh1.faceCells == mesh0.faceCells);
+  POLY_CHECK(mesh1.periodicFaces == mesh0.periodicFaces);
+  POLY_CHECK(mesh1.periodicFaceShifts == mesh0.periodicFaceShifts);
+}
+
+//------------------------------------------------------------------------------
+// Tessellate the generators with one thread and with nthreads, both in the
+// box and periodically.
+//------------------------------------------------------------------------------
+template<int Dimension, typename TessellatorType>
+void
+testThreads(const TessellatorType& tessellator,
+            const vector<double>& points,
+            double* xmin,
+            double* xmax,
+            const int nthreads) {
+  Tessellation<Dimension, double> mesh0, mesh1, pmesh0, pmesh1;
+  internal::setMaxThreads(1);
+  tessellator.tessellate(points, xmin, xmax, mesh0);
+  tessellator.tessellatePeriodic(points, xmin, xmax, pmesh0);
+  internal::setMaxThreads(nthreads);
+#ifdef _OPENMP
+  POLY_CHECK(internal::maxThreads() == nthreads);
+#endif
+  tessellator.tessellate(points, xmin, xmax, mesh1);
+  tessellator.tessellatePeriodic(points, xmin, xmax, pmesh1);
+  POLY_CHECK(mesh0.cells.size() == points.size()/Dimension);
+  checkIdentical(mesh0, mesh1);
+  checkIdentical(pmesh0, pmesh1);
+  cout << tessellator.name() << ": " << mesh0.cells.size() << " cells identical on 1 and "
+       << nthreads << " threads" << endl;
+}
+
+//------------------------------------------------------------------------------
+// main
+//------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+  const int nthreads = 4;
+  srand(10489591);
+
+  // 2D
+  {
+    const unsigned n = 5000;
+    double xmin[2] = {0.0, 0.0}, xmax[2] = {1.0, 2.0};
+    vector<double> points;
+    for (unsigned i = 0; i != n; ++i) {
+      points.push_back(xmin[0] + (xmax[0] - xmin[0])*random01());
+      points.push_back(xmin[1] + (xmax[1] - xmin[1])*random01());
+    }
+    testThreads<2>(VoroPP_2d<double>(), points, xmin, xmax, nthreads);
+  }
+
+  // 3D
+  {
+    const unsigned n = 2000;
+    double xmin[3] = {0.0, 0.0, 0.0}, xmax[3] = {2.0, 1.0, 1.0};
+    vector<double> points;
+    for (unsigned i = 0; i != n; ++i) {
+      for (unsigned j = 0; j != 3; ++j) points.push_back(xmin[j] + (xmax[j] - xmin[j])*random01());
+    }
+    testThreads<3>(VoroPP_3d<double>(), points, xmin, xmax, nthreads);
+  }
+
+  cout << "PASS" << endl;
+  return 0;
+}
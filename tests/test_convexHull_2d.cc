@@ -116,6 +116,30 @@ int main(int argc, char** argv) {
   t1 = clock();
   cout << "required " << double(t1 - t0)/CLOCKS_PER_SEC << " seconds." << endl;
 
+  // A square with repeated and nearly repeated corners and interior points:
+  // the hull should be the four corners, each represented by the first input
+  // point at that position.
+  {
+    cout << "Checking hull of a square with duplicate corners... ";
+    const double corners[8] = {0.0, 0.0,  1.0, 0.0,  1.0, 1.0,  0.0, 1.0};
+    vector<double> squarePoints;
+    for (unsigned i = 0; i != 50; ++i) {
+      squarePoints.push_back(0.1 + 0.8*random01());
+      squarePoints.push_back(0.1 + 0.8*random01());
+      const unsigned k = i % 4;
+      squarePoints.push_back(corners[2*k]     + (i/4 % 2)*0.25*tolerance);
+      squarePoints.push_back(corners[2*k + 1] + (i/4 % 2)*0.25*tolerance);
+    }
+    polytope::PLC<2, double> squareHull = polytope::convexHull_2d(squarePoints, low, tolerance);
+    POLY_CHECK(squareHull.facets.size() == 4);
+    for (unsigned k = 0; k != 4; ++k) {
+      POLY_CHECK(squareHull.facets[k].size() == 2);
+      POLY_CHECK(squareHull.facets[k][1] == squareHull.facets[(k + 1) % 4][0]);
+      POLY_CHECK(squareHull.facets[k][0] < 8 and squareHull.facets[k][0] % 2 == 1);
+    }
+    cout << "done." << endl;
+  }
+
   // for (unsigned k = 0; k != hull.facets.size(); ++k) {
   //   cerr << "Facet " << k << " : ";
   //   for (unsigned j = 0; j != hull.facets[k].size(); ++j) cerr << " " << hull.facets[k][j];
@@ -8,6 +8,8 @@
 #include <limits>
 #include <sstream>
 #include <ctime>
+#include <set>
+#include <map>
 
 #include "polytope.hh"
 #include "convexHull_3d.hh"
@@ -194,6 +196,56 @@ int main(int argc, char** argv) {
     // escapePod("simple_random", simple_random_hull, simple_random_hull.points);
   }
 
+  // Points on a sphere: every point is on the hull, so this is the worst case
+  // for the hull algorithm and a strict check of the topology.
+  {
+    cout << "Sphere test." << endl;
+    const unsigned n = 5000;
+    double low[3] = {-1.0, -1.0, -1.0};
+    vector<double> points;
+    while (points.size() < 3*n) {
+      const double x = 2.0*random01() - 1.0, y = 2.0*random01() - 1.0, z = 2.0*random01() - 1.0;
+      const double r = sqrt(x*x + y*y + z*z);
+      if (r > 0.1 and r < 1.0) {
+        points.push_back(x/r);
+        points.push_back(y/r);
+        points.push_back(z/r);
+      }
+    }
+
+    // Get the hull.
+    cout << "Generating convex hull... ";
+    clock_t t0 = clock();
+    const double tolerance = 1.0e-8;
+    polytope::PLC<3, double> hull = polytope::convexHull_3d(points, low, tolerance);
+    clock_t t1 = clock();
+    cout << "required " << double(t1 - t0)/CLOCKS_PER_SEC << " seconds." << endl;
+
+    // A closed triangulated surface with every point as a vertex, in which
+    // each edge is used once in each direction.
+    POLY_CHECK2(hull.facets.size() == 2*n - 4, hull.facets.size() << " != " << 2*n - 4);
+    std::set<int> vertices;
+    std::map<std::pair<int, int>, unsigned> edges;
+    for (unsigned i = 0; i != hull.facets.size(); ++i) {
+      POLY_CHECK(hull.facets[i].size() == 3);
+      for (unsigned j = 0; j != 3; ++j) {
+        vertices.insert(hull.facets[i][j]);
+        ++edges[std::make_pair(hull.facets[i][j], hull.facets[i][(j + 1) % 3])];
+      }
+    }
+    POLY_CHECK(vertices.size() == n);
+    for (std::map<std::pair<int, int>, unsigned>::const_iterator itr = edges.begin();
+         itr != edges.end();
+         ++itr) {
+      POLY_CHECK(itr->second == 1);
+      POLY_CHECK(edges.find(std::make_pair(itr->first.second, itr->first.first)) != edges.end());
+    }
+    const unsigned nFacets = hull.facets.size();
+    for (unsigned i = 0; i != n; ++i) {
+      POLY_CHECK(convexContains(hull, &points.front(), &points[3*i], tolerance) == nFacets);
+    }
+  }
+
   cout << "PASS" << endl;
 
 #ifdef HAVE_MPI
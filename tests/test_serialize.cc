@@ -81,6 +81,11 @@ int main(int argc, char** argv) {
     for (unsigned i = 0; i != n1; ++i) val[i] = numeric_limits<double>::max() * random01();
     checkSerialization(val);
   }
+  {
+    std::vector<bool> val(n1);
+    for (unsigned i = 0; i != n1; ++i) val[i] = (rand() % 2 == 0);
+    checkSerialization(val);
+  }
   {
     std::vector<Point2<uint64_t> > val(n1);
     for (unsigned i = 0; i != n1; ++i) val[i] = Point2<uint64_t>((uint64_t) abs(rand()), (uint64_t) abs(rand()));
@@ -117,6 +122,15 @@ int main(int argc, char** argv) {
     }
     checkSerialization(val);
   }
+  {
+    std::vector<std::vector<bool> > val(n1, std::vector<bool>(n2));
+    for (unsigned i = 0; i != n1; ++i) {
+      for (unsigned j = 0; j != n2; ++j) {
+        val[i][j] = (rand() % 2 == 0);
+      }
+    }
+    checkSerialization(val);
+  }
   {
     std::vector<std::vector<unsigned> > val(n1, std::vector<unsigned>(n2));
     for (unsigned i = 0; i != n1; ++i) {
@@ -193,6 +207,42 @@ int main(int argc, char** argv) {
     checkSerialization(val);
   }
 
+  //------------------------------------------------------------------------------
+  // Deserializing vectors appends, in bulk or not.
+  {
+    std::vector<double> val0(n1), val1(n1);
+    for (unsigned i = 0; i != n1; ++i) val0[i] = random01();
+    for (unsigned i = 0; i != n1; ++i) val1[i] = random01();
+    vector<char> buffer;
+    serialize(val0, buffer);
+    serialize(val1, buffer);
+    POLY_CHECK(buffer.size() == 2*(sizeof(unsigned) + n1*sizeof(double)));
+    std::vector<double> val;
+    vector<char>::const_iterator bufItr = buffer.begin();
+    deserialize(val, bufItr, buffer.end());
+    deserialize(val, bufItr, buffer.end());
+    POLY_CHECK(bufItr == buffer.end());
+    POLY_CHECK(std::vector<double>(val.begin(), val.begin() + n1) == val0);
+    POLY_CHECK(std::vector<double>(val.begin() + n1, val.end()) == val1);
+  }
+  {
+    std::vector<std::vector<int> > val0(n1);
+    unsigned nelements = 0;
+    for (unsigned i = 0; i != n1; ++i) {
+      val0[i].resize(i % 7, rand());
+      nelements += i % 7;
+    }
+    vector<char> buffer;
+    serialize(val0, buffer);
+    POLY_CHECK(buffer.size() == sizeof(unsigned)*(n1 + 1) + sizeof(int)*nelements);
+    std::vector<std::vector<int> > val(1, std::vector<int>(3, 1));
+    vector<char>::const_iterator bufItr = buffer.begin();
+    deserialize(val, bufItr, buffer.end());
+    POLY_CHECK(bufItr == buffer.end());
+    POLY_CHECK(val.size() == n1 + 1);
+    POLY_CHECK(std::vector<std::vector<int> >(val.begin() + 1, val.end()) == val0);
+  }
+
   // That's all!
   cout << "PASS" << endl;
   return 0;
@@ -281,9 +281,9 @@ class container_2d : public container_base_2d, public radius_mono {
 			     int nx_,int ny_,bool xperiodic_,bool yperiodic_,int init_mem);
 		void clear();
 		void put(int n,double x,double y);
-		void put(particle_order &vo,int n,double x,double y);
+		void put(particle_order_2d &vo,int n,double x,double y);
 		void import(FILE *fp=stdin);
-		void import(particle_order &vo,FILE *fp=stdin);
+		void import(particle_order_2d &vo,FILE *fp=stdin);
 		/** Imports a list of particles from an open file stream into
 		 * the container. Entries of three numbers (Particle ID, x
 		 * position, y position) are searched for. If the file cannot
@@ -304,7 +304,7 @@ class container_2d : public container_base_2d, public radius_mono {
 		 * \param[in,out] vo the ordering class to use.
 		 * \param[in] filename the name of the file to open and read
 		 *                     from. */
-		inline void import(particle_order &vo,const char* filename) {
+		inline void import(particle_order_2d &vo,const char* filename) {
 			FILE *fp=safe_fopen(filename,"r");
 			import(vo,fp);
 			fclose(fp);
@@ -482,9 +482,9 @@ class container_poly_2d : public container_base_2d, public radius_poly {
 			       int nx_,int ny_,bool xperiodic_,bool yperiodic_,int init_mem);
 		void clear();
 		void put(int n,double x,double y,double r);
-		void put(particle_order &vo,int n,double x,double y,double r);
+		void put(particle_order_2d &vo,int n,double x,double y,double r);
 		void import(FILE *fp=stdin);
-		void import(particle_order &vo,FILE *fp=stdin);
+		void import(particle_order_2d &vo,FILE *fp=stdin);
 		/** Imports a list of particles from an open file stream into
 		 * the container_poly class. Entries of four numbers (Particle
 		 * ID, x position, y position, radius) are searched for. If the
@@ -506,7 +506,7 @@ class container_poly_2d : public container_base_2d, public radius_poly {
 		 * \param[in,out] vo the ordering class to use.
 		 * \param[in] filename the name of the file to open and read
 		 *                     from. */
-		inline void import(particle_order &vo,const char* filename) {
+		inline void import(particle_order_2d &vo,const char* filename) {
 			FILE *fp=safe_fopen(filename,"r");
 			import(vo,fp);
 			fclose(fp);
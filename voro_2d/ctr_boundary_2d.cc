@@ -95,7 +95,7 @@ void container_boundary_2d::put(int n,double x,double y) {
  * \param[in] vo the ordering class in which to record the region.
  * \param[in] n the numerical ID of the inserted particle.
  * \param[in] (x,y) the position vector of the inserted particle. */
-void container_boundary_2d::put(particle_order &vo,int n,double x,double y) {
+void container_boundary_2d::put(particle_order_2d &vo,int n,double x,double y) {
 	int ij;
 	if(put_locate_block(ij,x,y)) {
 		totpar++;
@@ -263,23 +263,22 @@ void container_boundary_2d::draw_domain_pov(FILE *fp) {
  * proceed to setup **wid, *soi, and THE PROBLEM POINTS BOOLEAN ARRAY.
  * This algorithm keeps the importing seperate from the set-up */
 void container_boundary_2d::setup(){
-	double lx,ly,cx,cy,nx,ny;//last (x,y),current (x,y),next (x,y)
-	int widl=1,maxwid=1,fwid=1,nwid,lwid;
-	bool first=true;
+	double cx,cy,nx,ny;//current (x,y),next (x,y)
+	int widl=1,maxwid=1,fwid=1,nwid;
 	
 	tmp=tmpp=new int[3*init_temp_label_size];
 	tmpe=tmp+3*init_temp_label_size;
 	
 	while(widl!=edbc){
 		cx=bnds[2*widl];cy=bnds[2*widl+1];
-		nwid=edb[2*widl];lwid=edb[2*widl+1];
-		lx=bnds[lwid*2];ly=bnds[lwid*2+1];
+		nwid=edb[2*widl];
 		nx=bnds[2*nwid];ny=bnds[2*nwid+1];
 		
 		tag_walls(cx,cy,nx,ny,widl);
 		semi_circle_labeling(cx,cy,nx,ny,widl);
 	
-		//make sure that the cos(angle)>1 and the angle points inward	
+		//make sure that the cos(angle)>1 and the angle points inward, where
+		//(lx,ly) is the last vertex, bnds[2*edb[2*widl+1]]
 		//probpts=(lx-cx)*(nx-cx)+(ly-cy)*(ny-cy)>tolerance && 
 		//	cross_product(lx-cx,ly-cy,nx-cx,ny-cy);
 		
@@ -289,7 +288,6 @@ void container_boundary_2d::setup(){
 			widl=maxwid+1;
 			fwid=widl;
 			maxwid++;
-			first=false;
 		}		
 	}
 
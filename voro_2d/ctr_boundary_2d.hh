@@ -216,7 +216,7 @@ class container_boundary_2d : public voro_base_2d, public radius_mono {
 		void register_boundary(double x,double y);
 		void clear();
 		void put(int n,double x,double y);
-		void put(particle_order &vo,int n,double x,double y);
+		void put(particle_order_2d &vo,int n,double x,double y);
 
 
 